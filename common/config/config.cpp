@@ -11,6 +11,15 @@
 
 namespace config
 {
+    //Holds the mutex of a Config till the end of the scope
+    class ScopedMutex
+    {
+        public:
+            ScopedMutex(pthread_mutex_t & mutex): m_mutex(mutex) { pthread_mutex_lock(&m_mutex); }
+            ~ScopedMutex() { pthread_mutex_unlock(&m_mutex); }
+        private:
+            pthread_mutex_t & m_mutex;
+    };
 
     bool Config::isLeaf(const std::string & path)
     {
@@ -20,6 +29,8 @@ namespace config
     //Configuration Management
     const Section & Config::getSection(const std::string & path)
     {
+        ScopedMutex sm(m_mutex);
+
         return getSection_unsafe(path);
     }
 
@@ -68,6 +79,8 @@ namespace config
 
     const Key & Config::getKey(const std::string & path)
     {
+        ScopedMutex sm(m_mutex);
+
         //Handle the base case
         if(isLeaf(path))
         {
@@ -93,6 +106,8 @@ namespace config
 
     const Key & Config::getKey(const std::string & path, int default_val)
     {
+        ScopedMutex sm(m_mutex);
+
         //Handle the base case
         if(isLeaf(path))
         {
@@ -116,6 +131,8 @@ namespace config
 
     const Key & Config::getKey(const std::string & path, double default_val)
     {
+        ScopedMutex sm(m_mutex);
+
         //Handle the base case
         if(isLeaf(path))
         {
@@ -139,6 +156,8 @@ namespace config
 
     const Key & Config::getKey(const std::string & path, const std::string &default_val)
     {
+        ScopedMutex sm(m_mutex);
+
         //Handle the base case
         if(isLeaf(path))
         {
@@ -162,6 +181,8 @@ namespace config
 
     const Section & Config::addSection(const std::string & path)
     {
+        ScopedMutex sm(m_mutex);
+
         //Disect the path
         PathPair path_pair = Config::splitPath(path);
         Section &parent = getSection_unsafe(path_pair.first);
@@ -193,6 +214,8 @@ namespace config
 
     const Key & Config::addKey(const std::string & path, const std::string & value)
     {
+        ScopedMutex sm(m_mutex);
+
         //Handle the base case
         if(isLeaf(path))
             return m_root.addKey(path, value);
@@ -204,6 +227,8 @@ namespace config
 
     const Key & Config::addKey(const std::string & path, int value)
     {
+        ScopedMutex sm(m_mutex);
+
         //Handle the base case
         if(isLeaf(path))
             return m_root.addKey(path, value);
@@ -215,6 +240,8 @@ namespace config
 
     const Key & Config::addKey(const std::string & path, double value)
     {
+        ScopedMutex sm(m_mutex);
+
         //Handle the base case
         if(isLeaf(path))
             return m_root.addKey(path, value);
@@ -14,6 +14,7 @@
 #include <map>
 #include <string>
 #include <iostream>
+#include <pthread.h>
 
 #include "key.hpp"
 #include "section.hpp"
@@ -34,9 +35,9 @@ namespace config
     class Config
     {
         public:
-            Config(bool case_sensitive = false): m_case_sensitive(case_sensitive), m_root("", case_sensitive){}
-            Config(const Section & root, bool case_sensitive = false): m_case_sensitive(case_sensitive), m_root(root, "", case_sensitive){}
-            virtual ~Config(){}
+            Config(bool case_sensitive = false): m_case_sensitive(case_sensitive), m_root("", case_sensitive){ pthread_mutex_init(&m_mutex, NULL); }
+            Config(const Section & root, bool case_sensitive = false): m_case_sensitive(case_sensitive), m_root(root, "", case_sensitive){ pthread_mutex_init(&m_mutex, NULL); }
+            virtual ~Config(){ pthread_mutex_destroy(&m_mutex); }
 
             /*! \brief A function for saving the entire configuration
              * tree to the specified path.
@@ -193,6 +194,10 @@ namespace config
 
             //Utility function to determine if a given path is a leaf (i.e. it has no '/'s in it)
             bool isLeaf(const std::string & path);
+
+            //Lookups add the missing sections and keys (with their defaults)
+            //to the tree, so they are serialized for callers on different threads
+            pthread_mutex_t m_mutex;
     };
 
 }//end of namespace config
@@ -2,9 +2,15 @@
  * Graphite-McPAT Cache Interface
  ***************************************************************************/
 
+#include <cstring>
+#include <cmath>
 #include "mcpat_cache_interface.h"
 #include "simulator.h"
 #include "dvfs_manager.h"
+#include "packetize.h"
+
+ModelRegistry<McPATCacheInterface::EnergyModel> McPATCacheInterface::_energy_model_registry;
+DB* McPATCacheInterface::_database = NULL;
 
 //---------------------------------------------------------------------------
 // McPAT Cache Interface Constructor
@@ -25,27 +31,18 @@ McPATCacheInterface::McPATCacheInterface(Cache* cache)
       LOG_PRINT_ERROR("Could not read [general/technology_node] or [general/temperature] from the cfg file");
    }
 
-   // Make a ParseXML Object and Initialize it
-   _xml = new McPAT::ParseXML();
-
-   // Initialize ParseXML Params and Stats
-   _xml->initialize();
-
-   // Fill the ParseXML's Core Params from McPATCacheInterface
-   fillCacheParamsIntoXML(technology_node, temperature);
-
-   // Create the cache wrappers
+   // Get the energy models
    const DVFSManager::DVFSLevels& dvfs_levels = DVFSManager::getDVFSLevels();
    for (DVFSManager::DVFSLevels::const_iterator it = dvfs_levels.begin(); it != dvfs_levels.end(); it++)
    {
       double current_voltage = (*it).first;
       double current_frequency = (*it).second;
-      // Create core wrapper (and) save for future use
-      _cache_wrapper_map[current_voltage] = createCacheWrapper(current_voltage, current_frequency);
+      // Get energy model (and) save for future use
+      _energy_model_map[current_voltage] = getEnergyModel(technology_node, temperature, current_voltage, current_frequency);
    }
    
-   // Initialize current cache wrapper
-   _cache_wrapper = _cache_wrapper_map[_cache->_voltage];
+   // Initialize current energy model
+   _energy_model = _energy_model_map[_cache->_voltage];
 
    // Initialize event counters
    initializeEventCounters();
@@ -59,24 +56,175 @@ McPATCacheInterface::McPATCacheInterface(Cache* cache)
 //---------------------------------------------------------------------------
 McPATCacheInterface::~McPATCacheInterface()
 {
-   for (CacheWrapperMap::iterator it = _cache_wrapper_map.begin(); it != _cache_wrapper_map.end(); it++)
-      delete (*it).second;
-   delete _xml;
+   // The energy models are shared, and owned by the registry
 }
 
 //---------------------------------------------------------------------------
-// Create cache wrapper
+// Open the on-disk cache of energy models
 //---------------------------------------------------------------------------
-McPAT::CacheWrapper* McPATCacheInterface::createCacheWrapper(double voltage, double max_frequency_at_voltage)
+void McPATCacheInterface::initializeDatabase(const string& mcpat_path)
 {
+   // The energy models are dropped when McPAT is rebuilt
+   string mcpat_libname = mcpat_path + "/libmcpat.a";
+   DBUtils::initialize(_database, "mcpat_cache_energy", mcpat_libname);
+}
+
+//---------------------------------------------------------------------------
+// Get energy model
+//---------------------------------------------------------------------------
+const McPATCacheInterface::EnergyModel*
+McPATCacheInterface::getEnergyModel(UInt32 technology_node, UInt32 temperature,
+                                    double voltage, double max_frequency_at_voltage)
+{
+   UInt64 access_cycles = _cache->_perf_model->getLatency(CachePerfModel::ACCESS_DATA_AND_TAGS).toCycles(_cache->_frequency);
+
+   // Create key from everything that is filled into the XML object
+   UnstructuredBuffer key_buf;
+   key_buf << (UInt32) ENERGY_MODEL_VERSION << technology_node << temperature
+           << _cache->_cache_size << _cache->_line_size << _cache->_associativity << _cache->_num_banks << access_cycles
+           << voltage << max_frequency_at_voltage;
+   string key((const char*) key_buf.getBuffer(), key_buf.size());
+
+   ScopedLock sl(_energy_model_registry.getLock());
+
+   EnergyModel* energy_model = _energy_model_registry.find(key);
+   if (energy_model)
+      return energy_model;
+
+   DBT db_key, db_data;
+   memset(&db_key, 0, sizeof(DBT));
+   memset(&db_data, 0, sizeof(DBT));
+   db_key.data = (char*) key.data();
+   db_key.size = key.size();
+
+   if (_database && (DBUtils::getRecord(_database, db_key, db_data) == 0))
+   {
+      // Read from database
+      LOG_ASSERT_ERROR(db_data.size == sizeof(EnergyModel), "Energy model in database has size(%u), expected(%u)",
+                       db_data.size, (UInt32) sizeof(EnergyModel));
+      energy_model = new EnergyModel;
+      memcpy(energy_model, db_data.data, sizeof(EnergyModel));
+   }
+   else
+   {
+      energy_model = createEnergyModel(technology_node, temperature, voltage, max_frequency_at_voltage);
+      if (_database)
+      {
+         // Write in database
+         db_data.data = energy_model;
+         db_data.size = sizeof(EnergyModel);
+         DBUtils::putRecord(_database, db_key, db_data);
+      }
+   }
+
+   _energy_model_registry.insert(key, energy_model);
+   return energy_model;
+}
+
+//---------------------------------------------------------------------------
+// Create energy model from McPAT
+//---------------------------------------------------------------------------
+McPATCacheInterface::EnergyModel*
+McPATCacheInterface::createEnergyModel(UInt32 technology_node, UInt32 temperature,
+                                       double voltage, double max_frequency_at_voltage)
+{
+   // Make a ParseXML Object and Initialize it
+   McPAT::ParseXML* xml = new McPAT::ParseXML();
+
+   // Initialize ParseXML Params and Stats
+   xml->initialize();
+
+   // Fill the ParseXML's Core Params from McPATCacheInterface
+   fillCacheParamsIntoXML(xml, technology_node, temperature);
+
    // Set frequency and voltage in XML object
-   _xml->sys.L2[0].vdd = voltage;
+   xml->sys.L2[0].vdd = voltage;
    // Frequency (in MHz)
-   _xml->sys.target_core_clockrate = max_frequency_at_voltage * 1000;
-   _xml->sys.L2[0].clockrate = max_frequency_at_voltage * 1000;
+   xml->sys.target_core_clockrate = max_frequency_at_voltage * 1000;
+   xml->sys.L2[0].clockrate = max_frequency_at_voltage * 1000;
 
    // Create McPAT cache object
-   return new McPAT::CacheWrapper(_xml);
+   McPAT::CacheWrapper* cache_wrapper = new McPAT::CacheWrapper(xml);
+
+   EnergyModel* energy_model = new EnergyModel;
+
+   // McPAT charges some energy on every computation, even with no events
+   // (e.g., the miss/fill/prefetch buffers keep their peak access counts)
+   double baseline_energy = computeDynamicEnergy(cache_wrapper, xml, 0, 0, 0, 0, 0);
+   energy_model->baseline_energy = baseline_energy;
+
+   // Runtime dynamic energy of a single event of each type, over the baseline
+   energy_model->tag_array_read_energy   = computeDynamicEnergy(cache_wrapper, xml, 1, 0, 0, 0, 0) - baseline_energy;
+   energy_model->tag_array_write_energy  = computeDynamicEnergy(cache_wrapper, xml, 0, 1, 0, 0, 0) - baseline_energy;
+   energy_model->data_array_read_energy  = computeDynamicEnergy(cache_wrapper, xml, 0, 0, 1, 0, 0) - baseline_energy;
+   energy_model->data_array_write_energy = computeDynamicEnergy(cache_wrapper, xml, 0, 0, 0, 1, 0) - baseline_energy;
+   energy_model->miss_energy             = computeDynamicEnergy(cache_wrapper, xml, 0, 0, 0, 0, 1) - baseline_energy;
+
+   checkEnergyModel(cache_wrapper, xml, energy_model);
+
+   // Is long channel device?
+   bool long_channel = xml->sys.longer_channel_device;
+
+   // Area and leakage power do not depend on the events
+   energy_model->leakage_power = cache_wrapper->cache->power.readOp.gate_leakage +
+                                 (long_channel ? cache_wrapper->cache->power.readOp.longer_channel_leakage
+                                  : cache_wrapper->cache->power.readOp.leakage);
+   energy_model->area          = cache_wrapper->cache->area.get_area() * 1e-6;
+
+   delete cache_wrapper;
+   delete xml;
+
+   return energy_model;
+}
+
+//---------------------------------------------------------------------------
+// Compute runtime dynamic energy for the given events from McPAT
+//---------------------------------------------------------------------------
+double McPATCacheInterface::computeDynamicEnergy(McPAT::CacheWrapper* cache_wrapper, McPAT::ParseXML* xml,
+                                                 UInt64 tag_array_reads, UInt64 tag_array_writes,
+                                                 UInt64 data_array_reads, UInt64 data_array_writes,
+                                                 UInt64 read_misses)
+{
+   xml->sys.total_cycles              = 1;
+   xml->sys.L2[0].read_accesses       = read_misses;
+   xml->sys.L2[0].write_accesses      = 0;
+   xml->sys.L2[0].read_misses         = read_misses;
+   xml->sys.L2[0].write_misses        = 0;
+   xml->sys.L2[0].tag_array_reads     = tag_array_reads;
+   xml->sys.L2[0].tag_array_writes    = tag_array_writes;
+   xml->sys.L2[0].data_array_reads    = data_array_reads;
+   xml->sys.L2[0].data_array_writes   = data_array_writes;
+
+   cache_wrapper->computeEnergy();
+   return cache_wrapper->cache->rt_power.readOp.dynamic;
+}
+
+//---------------------------------------------------------------------------
+// Check the energy model against McPAT
+//---------------------------------------------------------------------------
+void McPATCacheInterface::checkEnergyModel(McPAT::CacheWrapper* cache_wrapper, McPAT::ParseXML* xml,
+                                           const EnergyModel* energy_model)
+{
+   // Tag array reads, tag array writes, data array reads, data array writes, misses
+   UInt64 event_mixes[][5] = {
+      {1000, 0, 0, 0, 0},
+      {100, 10, 60, 40, 10},
+      {5000, 200, 3000, 1500, 200}
+   };
+   for (UInt32 i = 0; i < sizeof(event_mixes) / sizeof(event_mixes[0]); i++)
+   {
+      UInt64* events = event_mixes[i];
+      double mcpat_energy = computeDynamicEnergy(cache_wrapper, xml, events[0], events[1], events[2], events[3], events[4]);
+      double model_energy = energy_model->baseline_energy +
+                            events[0] * energy_model->tag_array_read_energy +
+                            events[1] * energy_model->tag_array_write_energy +
+                            events[2] * energy_model->data_array_read_energy +
+                            events[3] * energy_model->data_array_write_energy +
+                            events[4] * energy_model->miss_energy;
+      LOG_ASSERT_WARNING(fabs(model_energy - mcpat_energy) <= 1e-6 * fabs(mcpat_energy),
+                         "Cache energy model gives (%g J) for event mix (%u), McPAT gives (%g J)",
+                         model_energy, i, mcpat_energy);
+   }
 }
 
 //---------------------------------------------------------------------------
@@ -87,13 +235,13 @@ void McPATCacheInterface::setDVFS(double old_frequency, double new_voltage, doub
    // Compute leakage/dynamic energy for the previous interval of time
    computeEnergy(curr_time, old_frequency);
    
-   // Check if a McPATInterface object has already been created
-   _cache_wrapper = _cache_wrapper_map[new_voltage];
-   LOG_ASSERT_ERROR(_cache_wrapper, "McPAT cache power model with Voltage(%g) has NOT been created", new_voltage);
+   // Check if an energy model has already been created
+   _energy_model = _energy_model_map[new_voltage];
+   LOG_ASSERT_ERROR(_energy_model, "McPAT cache power model with Voltage(%g) has NOT been created", new_voltage);
 }
 
 //---------------------------------------------------------------------------
-// Compute Energy from McPAT
+// Compute Energy
 //---------------------------------------------------------------------------
 void McPATCacheInterface::computeEnergy(const Time& curr_time, double frequency)
 {
@@ -102,16 +250,22 @@ void McPATCacheInterface::computeEnergy(const Time& curr_time, double frequency)
       energy_compute_time = _last_energy_compute_time;
 
    Time time_interval = energy_compute_time - _last_energy_compute_time;
-   UInt64 interval_cycles = time_interval.toCycles(frequency);
 
-   // Fill the ParseXML's Core Event Stats from McPATCacheInterface
-   fillCacheStatsIntoXML(interval_cycles);
+   // Runtime dynamic energy of the events since the last computation, plus
+   // the baseline McPAT would have charged for computing them at once
+   UInt64 misses = (_cache->_total_read_misses - _prev_read_misses) + (_cache->_total_write_misses - _prev_write_misses);
+   double dynamic_energy = _energy_model->baseline_energy +
+      (_cache->_event_counters[Cache::TAG_ARRAY_READ]   - _prev_event_counters[Cache::TAG_ARRAY_READ])   * _energy_model->tag_array_read_energy +
+      (_cache->_event_counters[Cache::TAG_ARRAY_WRITE]  - _prev_event_counters[Cache::TAG_ARRAY_WRITE])  * _energy_model->tag_array_write_energy +
+      (_cache->_event_counters[Cache::DATA_ARRAY_READ]  - _prev_event_counters[Cache::DATA_ARRAY_READ])  * _energy_model->data_array_read_energy +
+      (_cache->_event_counters[Cache::DATA_ARRAY_WRITE] - _prev_event_counters[Cache::DATA_ARRAY_WRITE]) * _energy_model->data_array_write_energy +
+      misses * _energy_model->miss_energy;
 
-   // Compute Energy from Processor
-   _cache_wrapper->computeEnergy();
+   // Update the prev counters
+   updateEventCounters();
 
    // Update the output data structure
-   updateOutputDataStructure(time_interval.toSec());
+   updateOutputDataStructure(time_interval.toSec(), dynamic_energy);
 
    // Set _last_energy_compute_time to energy_compute_time
    _last_energy_compute_time = energy_compute_time;
@@ -130,18 +284,12 @@ void McPATCacheInterface::initializeOutputDataStructure()
 //---------------------------------------------------------------------------
 // Update the Output Data Structure
 // --------------------------------------------------------------------------
-void McPATCacheInterface::updateOutputDataStructure(double time_interval)
+void McPATCacheInterface::updateOutputDataStructure(double time_interval, double dynamic_energy)
 {
-   // Is long channel device?
-   bool long_channel = _xml->sys.longer_channel_device;
-   
    // Store Energy into Data Structure
-   double leakage_power = _cache_wrapper->cache->power.readOp.gate_leakage +
-                          (long_channel ? _cache_wrapper->cache->power.readOp.longer_channel_leakage
-                           : _cache_wrapper->cache->power.readOp.leakage);
-   _mcpat_cache_out.area            = _cache_wrapper->cache->area.get_area() * 1e-6;
-   _mcpat_cache_out.leakage_energy += (leakage_power * time_interval);
-   _mcpat_cache_out.dynamic_energy += _cache_wrapper->cache->rt_power.readOp.dynamic;
+   _mcpat_cache_out.area            = _energy_model->area;
+   _mcpat_cache_out.leakage_energy += (_energy_model->leakage_power * time_interval);
+   _mcpat_cache_out.dynamic_energy += dynamic_energy;
 }
 
 //---------------------------------------------------------------------------
@@ -188,71 +336,61 @@ void McPATCacheInterface::displayEnergy(ostream& os, const Time& target_completi
 //---------------------------------------------------------------------------
 // Fill Cache Params into XML Structure
 //---------------------------------------------------------------------------
-void McPATCacheInterface::fillCacheParamsIntoXML(UInt32 technology_node, UInt32 temperature)
+void McPATCacheInterface::fillCacheParamsIntoXML(McPAT::ParseXML* xml, UInt32 technology_node, UInt32 temperature)
 {
    // System parameters
-   _xml->sys.number_of_cores = 0;
-   _xml->sys.number_of_L1Directories = 0;
-   _xml->sys.number_of_L2Directories = 0;
-   _xml->sys.number_of_L2s = 1;
-   _xml->sys.number_of_L3s = 0;
-   _xml->sys.number_of_NoCs = 0;
-   _xml->sys.homogeneous_cores = 1;
-   _xml->sys.homogeneous_L2s = 1;
-   _xml->sys.homogeneous_L1Directories = 1;
-   _xml->sys.homogeneous_L2Directories = 1;
-   _xml->sys.homogeneous_L3s = 1;
-   _xml->sys.homogeneous_ccs = 1;
-   _xml->sys.homogeneous_NoCs = 1;
-   _xml->sys.core_tech_node = technology_node;
-   _xml->sys.temperature = temperature;                        // In Kelvin (K)
-   _xml->sys.number_cache_levels = 2;
-   _xml->sys.interconnect_projection_type = 0;
-   _xml->sys.device_type = 0;                                  // 0 - HP (High Performance), 1 - LSTP (Low Standby Power)
-   _xml->sys.longer_channel_device = 1;
-   _xml->sys.machine_bits = 64; 
-   _xml->sys.virtual_address_width = 64;
-   _xml->sys.physical_address_width = 52;
-   _xml->sys.virtual_memory_page_size = 4096;
-
-   _xml->sys.L2[0].ports[0] = 1;                               // Number of read ports
-   _xml->sys.L2[0].ports[1] = 1;                               // Number of write ports
-   _xml->sys.L2[0].ports[2] = 1;                               // Number of read/write ports
-   _xml->sys.L2[0].device_type = 0;                            // 0 - HP (High Performance), 1 - LSTP (Low Standby Power)
-
-   _xml->sys.L2[0].L2_config[0] = _cache->_cache_size;         // Cache size (in bytes)
-   _xml->sys.L2[0].L2_config[1] = _cache->_line_size;          // Cache line size (in bytes)
-   _xml->sys.L2[0].L2_config[2] = _cache->_associativity;      // Cache associativity
-   _xml->sys.L2[0].L2_config[3] = _cache->_num_banks;          // Number of banks
-   _xml->sys.L2[0].L2_config[4] = 1;                           // Throughput = 1 access per cycle
-   _xml->sys.L2[0].L2_config[5] = _cache->_perf_model->getLatency(CachePerfModel::ACCESS_DATA_AND_TAGS).toCycles(_cache->_frequency);  // Cache access latency
-   _xml->sys.L2[0].L2_config[6] = _cache->_line_size;          // Output width
-   _xml->sys.L2[0].L2_config[7] = 1;                           // Cache policy (initialized from Niagara1.xml)
-
-   _xml->sys.L2[0].buffer_sizes[0] = 4;                        // Miss buffer size
-   _xml->sys.L2[0].buffer_sizes[1] = 4;                        // Fill buffer size
-   _xml->sys.L2[0].buffer_sizes[2] = 4;                        // Prefetch buffer size
-   _xml->sys.L2[0].buffer_sizes[3] = 4;                        // Writeback buffer size
+   xml->sys.number_of_cores = 0;
+   xml->sys.number_of_L1Directories = 0;
+   xml->sys.number_of_L2Directories = 0;
+   xml->sys.number_of_L2s = 1;
+   xml->sys.number_of_L3s = 0;
+   xml->sys.number_of_NoCs = 0;
+   xml->sys.homogeneous_cores = 1;
+   xml->sys.homogeneous_L2s = 1;
+   xml->sys.homogeneous_L1Directories = 1;
+   xml->sys.homogeneous_L2Directories = 1;
+   xml->sys.homogeneous_L3s = 1;
+   xml->sys.homogeneous_ccs = 1;
+   xml->sys.homogeneous_NoCs = 1;
+   xml->sys.core_tech_node = technology_node;
+   xml->sys.temperature = temperature;                        // In Kelvin (K)
+   xml->sys.number_cache_levels = 2;
+   xml->sys.interconnect_projection_type = 0;
+   xml->sys.device_type = 0;                                  // 0 - HP (High Performance), 1 - LSTP (Low Standby Power)
+   xml->sys.longer_channel_device = 1;
+   xml->sys.machine_bits = 64; 
+   xml->sys.virtual_address_width = 64;
+   xml->sys.physical_address_width = 52;
+   xml->sys.virtual_memory_page_size = 4096;
+
+   xml->sys.L2[0].ports[0] = 1;                               // Number of read ports
+   xml->sys.L2[0].ports[1] = 1;                               // Number of write ports
+   xml->sys.L2[0].ports[2] = 1;                               // Number of read/write ports
+   xml->sys.L2[0].device_type = 0;                            // 0 - HP (High Performance), 1 - LSTP (Low Standby Power)
+
+   xml->sys.L2[0].L2_config[0] = _cache->_cache_size;         // Cache size (in bytes)
+   xml->sys.L2[0].L2_config[1] = _cache->_line_size;          // Cache line size (in bytes)
+   xml->sys.L2[0].L2_config[2] = _cache->_associativity;      // Cache associativity
+   xml->sys.L2[0].L2_config[3] = _cache->_num_banks;          // Number of banks
+   xml->sys.L2[0].L2_config[4] = 1;                           // Throughput = 1 access per cycle
+   xml->sys.L2[0].L2_config[5] = _cache->_perf_model->getLatency(CachePerfModel::ACCESS_DATA_AND_TAGS).toCycles(_cache->_frequency);  // Cache access latency
+   xml->sys.L2[0].L2_config[6] = _cache->_line_size;          // Output width
+   xml->sys.L2[0].L2_config[7] = 1;                           // Cache policy (initialized from Niagara1.xml)
+
+   xml->sys.L2[0].buffer_sizes[0] = 4;                        // Miss buffer size
+   xml->sys.L2[0].buffer_sizes[1] = 4;                        // Fill buffer size
+   xml->sys.L2[0].buffer_sizes[2] = 4;                        // Prefetch buffer size
+   xml->sys.L2[0].buffer_sizes[3] = 4;                        // Writeback buffer size
    
-   _xml->sys.L2[0].conflicts = 0;                              // Initialized from Niagara1.xml
-   _xml->sys.L2[0].duty_cycle = 0.5;                           // Initialized from Niagara1.xml
+   xml->sys.L2[0].conflicts = 0;                              // Initialized from Niagara1.xml
+   xml->sys.L2[0].duty_cycle = 0.5;                           // Initialized from Niagara1.xml
 }
 
 //---------------------------------------------------------------------------
-// Fill Cache Stats into XML Structure
+// Update Event Counters
 //---------------------------------------------------------------------------
-void McPATCacheInterface::fillCacheStatsIntoXML(UInt64 interval_cycles)
+void McPATCacheInterface::updateEventCounters()
 {
-   _xml->sys.total_cycles              = interval_cycles;
-   _xml->sys.L2[0].read_accesses       = _cache->_total_read_accesses  - _prev_read_accesses;
-   _xml->sys.L2[0].write_accesses      = _cache->_total_write_accesses - _prev_write_accesses;
-   _xml->sys.L2[0].read_misses         = _cache->_total_read_misses    - _prev_read_misses;
-   _xml->sys.L2[0].write_misses        = _cache->_total_write_misses   - _prev_write_misses;
-   _xml->sys.L2[0].tag_array_reads     = _cache->_event_counters[Cache::TAG_ARRAY_READ]   - _prev_event_counters[Cache::TAG_ARRAY_READ];
-   _xml->sys.L2[0].tag_array_writes    = _cache->_event_counters[Cache::TAG_ARRAY_WRITE]  - _prev_event_counters[Cache::TAG_ARRAY_WRITE];
-   _xml->sys.L2[0].data_array_reads    = _cache->_event_counters[Cache::DATA_ARRAY_READ]  - _prev_event_counters[Cache::DATA_ARRAY_READ];
-   _xml->sys.L2[0].data_array_writes   = _cache->_event_counters[Cache::DATA_ARRAY_WRITE] - _prev_event_counters[Cache::DATA_ARRAY_WRITE];
-
    // Update the prev counters
    _prev_read_accesses  = _cache->_total_read_accesses;
    _prev_write_accesses = _cache->_total_write_accesses;
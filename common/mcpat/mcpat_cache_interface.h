@@ -5,9 +5,13 @@
 #pragma once
 
 #include <map>
+#include <string>
 using std::map;
+using std::string;
 #include "contrib/mcpat/mcpat.h"
+#include "contrib/db_utils/api.h"
 #include "cache.h"
+#include "model_registry.h"
 
 //---------------------------------------------------------------------------
 // McPAT Cache Interface Data Structures for Area and Power
@@ -40,12 +44,40 @@ public:
    // Output energy/area summary from McPAT
    void outputSummary(ostream& os, const Time& target_completion_time, double frequency);
 
+   // Open the on-disk cache of energy models (kept next to McPAT's own database)
+   static void initializeDatabase(const string& mcpat_path);
+
 private:
-   // McPAT Objects
-   typedef map<double,McPAT::CacheWrapper*> CacheWrapperMap;
-   CacheWrapperMap _cache_wrapper_map;
-   McPAT::CacheWrapper* _cache_wrapper;
-   McPAT::ParseXML* _xml;
+   // Area, leakage power and runtime dynamic energy per event of a cache at
+   // one voltage. McPAT computes the runtime dynamic energy of a cache as a
+   // constant baseline (charged once per computation) plus a sum of per-event
+   // energies, so the McPAT objects are only needed once, to derive these.
+   // The models are shared by all the caches with the same parameters, and
+   // saved on disk for later runs.
+   struct EnergyModel
+   {
+      double area;
+      double leakage_power;
+      double baseline_energy;
+      double tag_array_read_energy;
+      double tag_array_write_energy;
+      double data_array_read_energy;
+      double data_array_write_energy;
+      double miss_energy;
+   };
+
+   // Bump this when the parameters hardwired in fillCacheParamsIntoXML() or
+   // the layout of EnergyModel change, so that the energy models saved on
+   // disk are not used anymore
+   static const UInt32 ENERGY_MODEL_VERSION = 2;
+
+   static ModelRegistry<EnergyModel> _energy_model_registry;
+   static DB* _database;
+
+   // Energy models at each voltage
+   typedef map<double,const EnergyModel*> EnergyModelMap;
+   EnergyModelMap _energy_model_map;
+   const EnergyModel* _energy_model;
    // Performance model of cache
    Cache* _cache;
    // McPAT Output Data Structure
@@ -60,17 +92,27 @@ private:
    UInt64 _prev_write_misses;
    UInt64 _prev_event_counters[Cache::NUM_OPERATION_TYPES];
    
-   // Create core wrapper
-   McPAT::CacheWrapper* createCacheWrapper(double voltage, double max_frequency_at_voltage);
+   // Get energy model from the registry, the on-disk cache or McPAT (in that order)
+   const EnergyModel* getEnergyModel(UInt32 technology_node, UInt32 temperature,
+                                     double voltage, double max_frequency_at_voltage);
+   EnergyModel* createEnergyModel(UInt32 technology_node, UInt32 temperature,
+                                  double voltage, double max_frequency_at_voltage);
+   static double computeDynamicEnergy(McPAT::CacheWrapper* cache_wrapper, McPAT::ParseXML* xml,
+                                      UInt64 tag_array_reads, UInt64 tag_array_writes,
+                                      UInt64 data_array_reads, UInt64 data_array_writes,
+                                      UInt64 read_misses);
+   // Check the energy model against McPAT on a few mixes of events
+   static void checkEnergyModel(McPAT::CacheWrapper* cache_wrapper, McPAT::ParseXML* xml,
+                                const EnergyModel* energy_model);
    // Initialize XML Object
-   void fillCacheParamsIntoXML(UInt32 technology_node, UInt32 temperature);
-   void fillCacheStatsIntoXML(UInt64 interval_cycles);
+   void fillCacheParamsIntoXML(McPAT::ParseXML* xml, UInt32 technology_node, UInt32 temperature);
 
-   // Initialize event counters
+   // Initialize/Update event counters
    void initializeEventCounters();
+   void updateEventCounters();
    // Initialize/Update leakage/dynamic energy counters
    void initializeOutputDataStructure();
-   void updateOutputDataStructure(double time_interval);
+   void updateOutputDataStructure(double time_interval, double dynamic_energy);
 
    // Display energy
    void displayEnergy(ostream& os, const Time& target_completion_time);
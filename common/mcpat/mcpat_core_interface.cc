@@ -8,12 +8,16 @@
 #include "core_model.h"
 #include "core.h"
 #include "tile.h"
+#include "packetize.h"
+
+ModelRegistry<McPATCoreInterface::SharedModel> McPATCoreInterface::_shared_model_registry;
 
 //---------------------------------------------------------------------------
 // McPAT Core Interface Constructor
 //---------------------------------------------------------------------------
 McPATCoreInterface::McPATCoreInterface(CoreModel* core_model, double frequency, double voltage, UInt32 load_queue_size, UInt32 store_queue_size)
    : _core_model(core_model)
+   , _shared_model(NULL)
    , _last_energy_compute_time(Time(0))
 {
    LOG_ASSERT_ERROR(frequency != 0 && voltage != 0, "Frequency and voltage must be greater than zero.");
@@ -42,28 +46,12 @@ McPATCoreInterface::McPATCoreInterface(CoreModel* core_model, double frequency,
    _enable_area_or_power_modeling = Config::getSingleton()->getEnableAreaModeling() || Config::getSingleton()->getEnablePowerModeling();
    if (_enable_area_or_power_modeling)
    {
-      // Make a ParseXML Object and Initialize it
-      _xml = new McPAT::ParseXML();
-
-      // Initialize ParseXML Params and Stats
-      _xml->initialize();
-      _xml->setNiagara1();
-
-      // Fill the ParseXML's Core Params from McPATCoreInterface
-      fillCoreParamsIntoXML(technology_node, temperature);
-
-      // Create the core wrappers
-      const DVFSManager::DVFSLevels& dvfs_levels = DVFSManager::getDVFSLevels();
-      for (DVFSManager::DVFSLevels::const_iterator it = dvfs_levels.begin(); it != dvfs_levels.end(); it++)
-      {
-         double current_voltage = (*it).first;
-         double current_frequency = (*it).second;
-         // Create core wrapper (and) save for future use
-         _core_wrapper_map[current_voltage] = createCoreWrapper(current_voltage, current_frequency);
-      }
+      // Get the McPAT objects of the cores with these parameters
+      _shared_model = getSharedModel(technology_node, temperature);
+      _xml = _shared_model->xml;
 
       // Initialize current core wrapper
-      _core_wrapper = _core_wrapper_map[voltage];
+      _core_wrapper = _shared_model->core_wrapper_map[voltage];
    }
 }
 
@@ -72,12 +60,60 @@ McPATCoreInterface::McPATCoreInterface(CoreModel* core_model, double frequency,
 //---------------------------------------------------------------------------
 McPATCoreInterface::~McPATCoreInterface()
 {
-   if (_enable_area_or_power_modeling)
+   // The McPAT objects are shared, and owned by the registry
+}
+
+//---------------------------------------------------------------------------
+// Get the McPAT objects shared by the cores with the same parameters
+//---------------------------------------------------------------------------
+McPATCoreInterface::SharedModel* McPATCoreInterface::getSharedModel(UInt32 technology_node, UInt32 temperature)
+{
+   // Create key from everything that is filled into the XML object
+   UnstructuredBuffer key_buf;
+   key_buf << technology_node << temperature
+           << _instruction_length << _opcode_width << _machine_type << _num_hardware_threads
+           << _fetch_width << _num_instruction_fetch_ports << _decode_width << _issue_width
+           << _commit_width << _fp_issue_width << _prediction_width
+           << _integer_pipeline_depth << _fp_pipeline_depth
+           << _ALU_per_core << _MUL_per_core << _FPU_per_core
+           << _instruction_buffer_size << _decoded_stream_buffer_size
+           << _arch_regs_IRF_size << _arch_regs_FRF_size << _phy_regs_IRF_size << _phy_regs_FRF_size
+           << _store_buffer_size << _load_buffer_size << _num_memory_ports << _RAS_size
+           << _instruction_window_scheme << _instruction_window_size << _fp_instruction_window_size
+           << _ROB_size << _rename_scheme << _register_windows_size
+           << make_pair((const void*) _LSU_order.c_str(), (int) _LSU_order.size());
+   string key((const char*) key_buf.getBuffer(), key_buf.size());
+
+   ScopedLock sl(_shared_model_registry.getLock());
+
+   SharedModel* shared_model = _shared_model_registry.find(key);
+   if (shared_model)
+      return shared_model;
+
+   shared_model = new SharedModel;
+
+   // Make a ParseXML Object and Initialize it
+   _xml = shared_model->xml = new McPAT::ParseXML();
+
+   // Initialize ParseXML Params and Stats
+   _xml->initialize();
+   _xml->setNiagara1();
+
+   // Fill the ParseXML's Core Params from McPATCoreInterface
+   fillCoreParamsIntoXML(technology_node, temperature);
+
+   // Create the core wrappers
+   const DVFSManager::DVFSLevels& dvfs_levels = DVFSManager::getDVFSLevels();
+   for (DVFSManager::DVFSLevels::const_iterator it = dvfs_levels.begin(); it != dvfs_levels.end(); it++)
    {
-      for (CoreWrapperMap::iterator it = _core_wrapper_map.begin(); it != _core_wrapper_map.end(); it++)
-         delete (*it).second;
-      delete _xml;
+      double current_voltage = (*it).first;
+      double current_frequency = (*it).second;
+      // Create core wrapper (and) save for future use
+      shared_model->core_wrapper_map[current_voltage] = createCoreWrapper(current_voltage, current_frequency);
    }
+
+   _shared_model_registry.insert(key, shared_model);
+   return shared_model;
 }
 
 //---------------------------------------------------------------------------
@@ -107,7 +143,7 @@ void McPATCoreInterface::setDVFS(double old_frequency, double new_voltage, doubl
    computeEnergy(curr_time, old_frequency);
    
    // Check if a McPATInterface object has already been created
-   _core_wrapper = _core_wrapper_map[new_voltage];
+   _core_wrapper = _shared_model->core_wrapper_map[new_voltage];
    LOG_ASSERT_ERROR(_core_wrapper, "McPAT core power model with Voltage(%g) has NOT been created", new_voltage);
 }
 
@@ -478,6 +514,8 @@ void McPATCoreInterface::computeEnergy(const Time& curr_time, double frequency)
    Time time_interval = energy_compute_time - _last_energy_compute_time;
    UInt64 interval_cycles = time_interval.toCycles(frequency);
 
+   ScopedLock sl(_shared_model->lock);
+
    // Fill the ParseXML's Core Stats with the event counters
    fillCoreStatsIntoXML(interval_cycles);
 
@@ -10,6 +10,7 @@ using std::map;
 #include "instruction.h"
 #include "mcpat_instruction.h"
 #include "contrib/mcpat/mcpat.h"
+#include "model_registry.h"
 
 class CoreModel;
 
@@ -106,7 +107,17 @@ private:
    CoreModel* _core_model;
    // McPAT Objects
    typedef map<double,McPAT::CoreWrapper*> CoreWrapperMap;
-   CoreWrapperMap _core_wrapper_map;
+   // Shared by all the cores with the same parameters. McPAT keeps the event
+   // counters and the results of an energy computation in these objects, so
+   // each computation holds the lock.
+   struct SharedModel
+   {
+      McPAT::ParseXML* xml;
+      CoreWrapperMap core_wrapper_map;
+      Lock lock;
+   };
+   static ModelRegistry<SharedModel> _shared_model_registry;
+   SharedModel* _shared_model;
    McPAT::CoreWrapper* _core_wrapper;
    McPAT::ParseXML* _xml;
    // Output Data Structure
@@ -245,6 +256,8 @@ private:
    void updateRegFileAccessCounters(const McPATInstruction* instruction);
    void updateExecutionUnitCounters(const McPATInstruction* instruction);
 
+   // Get the McPAT objects from the registry (or) create them
+   SharedModel* getSharedModel(UInt32 technology_node, UInt32 temperature);
    // Create core wrapper
    McPAT::CoreWrapper* createCoreWrapper(double voltage, double max_frequency_at_voltage);
    // Initialize XML Object
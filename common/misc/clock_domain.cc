@@ -0,0 +1,43 @@
+#include <algorithm>
+#include "clock_domain.h"
+
+ClockDomain::ClockDomain(double frequency)
+   : _frequency(frequency)
+   , _period(0)
+   , _exact_cycles_limit(0)
+   , _exact_picosec_limit(0)
+{
+   if (!(frequency > 0))
+      return;
+
+   double period = floor(1000.0 / frequency + 0.5);
+   if ((period < 1.0) || (period > (double) (1 << 20)))
+      return;
+
+   // 'frequency' is (1000 / period) * (1 + delta). Compare 'period * frequency'
+   // with 1000 exactly, as 'period * mantissa' against '1000 * 2^-exponent'
+   int exponent;
+   double fraction = frexp(frequency, &exponent);
+   UInt64 mantissa = (UInt64) ldexp(fraction, 53);
+   exponent -= 53;
+   if ((exponent >= 0) || (exponent < -100))
+      return;
+
+   unsigned __int128 product = ((unsigned __int128) period) * mantissa;
+   unsigned __int128 target = ((unsigned __int128) 1000) << (-exponent);
+
+   // toPicosec(): with 0 <= delta <= 2^-50, '1000 * cycles / frequency' lies
+   // within 1/4 below 'cycles * period' as long as that is below 2^48, so its
+   // ceil is 'cycles * period'. '1000 * cycles' must also stay exact (< 2^53).
+   if ((product < target) || ((product - target) > (target >> 50)))
+      return;
+
+   _period = (UInt64) period;
+   _exact_cycles_limit = std::min((1ULL << 48) / _period, 1ULL << 43);
+
+   // toCycles(): with delta == 0, 'picosec * frequency / 1000' is rounded by
+   // less than 2^-12 for picosec below 2^40, which cannot move it across an
+   // integer unless it is one (and then it is exact)
+   if (product == target)
+      _exact_picosec_limit = 1ULL << 40;
+}
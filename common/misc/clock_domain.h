@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cmath>
+#include "fixed_types.h"
+
+// Clock of a frequency (in GHz), for converting between cycles and
+// picoseconds. Most frequencies of interest have a period that is a whole
+// number of picoseconds; for those, the conversions are done with integers
+// instead of a floating point divide and ceil. The integer results are only
+// used where they are provably identical to the floating point ones (see
+// the constructor), so the rounding is bit-identical to computePicosec()
+// and computeCycles().
+class ClockDomain
+{
+public:
+   ClockDomain(double frequency);
+   ~ClockDomain() {}
+
+   double getFrequency() const { return _frequency; }
+   // Period in picoseconds (0 if it is not a whole number of picoseconds)
+   UInt64 getPeriod() const { return _period; }
+
+   UInt64 toPicosec(UInt64 cycles) const
+   {
+      if (cycles < _exact_cycles_limit)
+         return cycles * _period;
+      return computePicosec(cycles, _frequency);
+   }
+
+   UInt64 toCycles(UInt64 picosec) const
+   {
+      if (picosec < _exact_picosec_limit)
+         return (picosec + _period - 1) / _period;
+      return computeCycles(picosec, _frequency);
+   }
+
+   static UInt64 computePicosec(UInt64 cycles, double frequency)
+   { return (UInt64) ceil( ((double) 1000*cycles) /  ((double) frequency) ); }
+
+   static UInt64 computeCycles(UInt64 picosec, double frequency)
+   { return (UInt64) ceil(((double) (picosec) * ((double) frequency)) / double(1.0e3)); }
+
+private:
+   double _frequency;
+   UInt64 _period;
+   // The integer conversions are exact below these
+   UInt64 _exact_cycles_limit;
+   UInt64 _exact_picosec_limit;
+};
@@ -0,0 +1,93 @@
+#include <stdio.h>
+
+#include "free_interval_list.h"
+#include "packetize.h"
+
+FreeIntervalList::FreeIntervalList(UInt32 max_size)
+{
+   // Models may go one or two intervals over their limit before pruning
+   _intervals.reserve(max_size + 2);
+}
+
+FreeIntervalList::~FreeIntervalList()
+{}
+
+UInt32
+FreeIntervalList::lowerBound(UInt64 time) const
+{
+   UInt32 low = 0;
+   UInt32 high = _intervals.size();
+   while (low < high)
+   {
+      UInt32 mid = (low + high) / 2;
+      if (_intervals[mid].second < time)
+         low = mid + 1;
+      else
+         high = mid;
+   }
+   return low;
+}
+
+UInt32
+FreeIntervalList::findFirstFit(UInt64 pkt_time, UInt64 processing_time) const
+{
+   // An interval that ends before the packet would complete can neither
+   // hold it now nor later, so start at the first one that does not
+   UInt32 index = lowerBound(pkt_time + processing_time);
+   for ( ; index < _intervals.size(); index++)
+   {
+      const Interval& interval = _intervals[index];
+      if (pkt_time >= interval.first)
+      {
+         if ((pkt_time + processing_time) <= interval.second)
+            break;
+      }
+      else if ((interval.second - interval.first) >= processing_time)
+      {
+         break;
+      }
+   }
+   return index;
+}
+
+void
+FreeIntervalList::insert(UInt32 index, const Interval& interval)
+{
+   _intervals.insert(_intervals.begin() + index, interval);
+}
+
+void
+FreeIntervalList::erase(UInt32 index)
+{
+   _intervals.erase(_intervals.begin() + index);
+}
+
+void
+FreeIntervalList::checkpoint(UnstructuredBuffer& buffer) const
+{
+   buffer << (UInt32) _intervals.size();
+   for (UInt32 i = 0; i < _intervals.size(); i++)
+      buffer << _intervals[i].first << _intervals[i].second;
+}
+
+void
+FreeIntervalList::restore(UnstructuredBuffer& buffer)
+{
+   UInt32 size;
+   buffer >> size;
+   _intervals.resize(size);
+   for (UInt32 i = 0; i < size; i++)
+      buffer >> _intervals[i].first >> _intervals[i].second;
+}
+
+void
+FreeIntervalList::print() const
+{
+   for (UInt32 i = 0; i < _intervals.size(); i++)
+   {
+      fprintf(stderr, "(%llu, %llu)\n",
+            (long long unsigned int) _intervals[i].first,
+            (long long unsigned int) _intervals[i].second);
+   }
+   fprintf(stderr, "Size(%u)\n", (UInt32) _intervals.size());
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+using std::vector;
+using std::pair;
+
+#include "fixed_types.h"
+
+class UnstructuredBuffer;
+
+// Free intervals [first, second) of a queue, kept sorted in a flat array.
+// The intervals are disjoint, so they are sorted by both their start and
+// their end time, and the first interval that can still be used by a
+// packet is found with a binary search. Queue models bound the number of
+// intervals to a few hundred, so inserting and erasing by moving the
+// tail of the array is cheaper than following list or tree nodes.
+
+class FreeIntervalList
+{
+public:
+   typedef pair<UInt64,UInt64> Interval;
+
+   FreeIntervalList(UInt32 max_size);
+   ~FreeIntervalList();
+
+   UInt32 size() const
+   { return _intervals.size(); }
+   const Interval& operator[](UInt32 index) const
+   { return _intervals[index]; }
+   const Interval& front() const
+   { return _intervals.front(); }
+
+   // Index of the first interval that ends at or after 'time' (size() if none).
+   // Intervals before it cannot be used by a packet arriving at 'time'.
+   UInt32 lowerBound(UInt64 time) const;
+   // Index of the first interval that can hold a packet arriving at
+   // 'pkt_time' for 'processing_time', either right away or once the
+   // interval starts (size() if none)
+   UInt32 findFirstFit(UInt64 pkt_time, UInt64 processing_time) const;
+
+   void insert(UInt32 index, const Interval& interval);
+   void erase(UInt32 index);
+   void set(UInt32 index, const Interval& interval)
+   { _intervals[index] = interval; }
+
+   void checkpoint(UnstructuredBuffer& buffer) const;
+   void restore(UnstructuredBuffer& buffer);
+
+   // Debug
+   void print() const;
+
+private:
+   vector<Interval> _intervals;
+};
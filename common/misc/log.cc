@@ -2,8 +2,11 @@
 #include <sys/syscall.h>
 #include <stdarg.h>
 #include <string.h>
+#include <algorithm>
 
 #include "log.h"
+#include "log_buffer.h"
+#include "tls.h"
 #include "config.h"
 #include "simulator.h"
 #include "tile_manager.h"
@@ -14,6 +17,11 @@ Log *Log::_singleton;
 
 const size_t Log::MODULE_LENGTH;
 
+char Log::_moduleNames[MAX_MODULES][MODULE_LENGTH + 1];
+volatile bool Log::_moduleEnabled[MAX_MODULES];
+UInt32 Log::_numModules = 0;
+Lock Log::_modulesLock;
+
 static string formatFileName(const char* s)
 {
    return Sim()->getConfig()->formatOutputFileName(s);
@@ -22,6 +30,9 @@ static string formatFileName(const char* s)
 Log::Log(Config &config)
    : _tileCount(config.getTotalTiles())
    , _startTime(0)
+   , _mode(TEXT)
+   , _bufferSize(0)
+   , _bufferTLS(NULL)
 {
    assert(Config::getSingleton()->getProcessCount() != 0);
 
@@ -31,14 +42,35 @@ Log::Log(Config &config)
 
    _loggingEnabled = initIsLoggingEnabled();
 
+   try
+   {
+      _mode = parseMode(Sim()->getCfg()->getString("log/mode", "text"));
+      _bufferSize = Sim()->getCfg()->getInt("log/buffer_size", 4096);
+   }
+   catch (...)
+   {
+      assert(false);
+   }
+   assert(_bufferSize > 0);
+
+   if (_mode != TEXT)
+      _bufferTLS = TLS::create();
+
    assert(_singleton == NULL);
    _singleton = this;
+
+   initModulesEnabled();
 }
 
 Log::~Log()
 {
    _singleton = NULL;
 
+   // Writes out the records still in the rings
+   for (UInt32 i = 0; i < _buffers.size(); i++)
+      delete _buffers[i];
+   delete _bufferTLS;
+
    for (tile_id_t i = 0; i < _tileCount; i++)
    {
       if (_tileFiles[i])
@@ -63,7 +95,21 @@ Log* Log::getSingleton()
    return _singleton;
 }
 
-bool Log::isEnabled(const char* module)
+Log::Mode Log::parseMode(string mode)
+{
+   if (mode == "text")
+      return TEXT;
+   else if (mode == "binary")
+      return BINARY;
+   else if (mode == "flight_recorder")
+      return FLIGHT_RECORDER;
+
+   fprintf(stderr, "*ERROR* [log.cc] Unrecognized log/mode(%s)\n", mode.c_str());
+   abort();
+   return TEXT;
+}
+
+bool Log::computeModuleEnabled(const char* module)
 {
    // either the module is specifically enabled, or all logging is
    // enabled and this one isn't disabled
@@ -79,6 +125,54 @@ bool Log::isLoggingEnabled()
    return (!_enabledModules.empty()) || _loggingEnabled;
 }
 
+void Log::initModulesEnabled()
+{
+   ScopedLock sl(_modulesLock);
+   for (UInt32 i = 0; i < _numModules; i++)
+      _moduleEnabled[i] = computeModuleEnabled(_moduleNames[i]);
+}
+
+UInt32 Log::getModuleId(const char *filename)
+{
+   // find actual file name ...
+   const char *ptr = strrchr(filename, '/');
+   if (ptr != NULL)
+      filename = ptr + 1;
+
+   char module[MODULE_LENGTH + 1];
+   UInt32 length = 0;
+   for ( ; length < MODULE_LENGTH && filename[length] != '\0'; length++)
+      module[length] = filename[length];
+   for ( ; length < MODULE_LENGTH; length++)
+      module[length] = ' ';
+   module[MODULE_LENGTH] = '\0';
+
+   ScopedLock sl(_modulesLock);
+
+   for (UInt32 i = 0; i < _numModules; i++)
+   {
+      if (strcmp(_moduleNames[i], module) == 0)
+         return i;
+   }
+
+   assert(_numModules < MAX_MODULES);
+   UInt32 module_id = _numModules;
+   strcpy(_moduleNames[module_id], module);
+   if (_singleton)
+      _moduleEnabled[module_id] = _singleton->computeModuleEnabled(module);
+   // Readers look at the new module only once they know its id
+   __sync_synchronize();
+   _numModules++;
+
+   return module_id;
+}
+
+const char* Log::getModuleName(UInt32 module_id)
+{
+   assert(module_id < _numModules);
+   return _moduleNames[module_id];
+}
+
 void Log::initFileDescriptors()
 {
    _tileFiles = new FILE* [_tileCount];
@@ -268,50 +362,116 @@ void Log::getFile(tile_id_t tile_id, bool sim_thread, FILE **file, Lock **lock)
    }
 }
 
-string Log::getModule(const char *filename)
+LogBuffer* Log::getBuffer()
 {
-   // TODO: Give each thread a _module map to cache entries. (Hash table?)
+   LogBuffer* buffer = _bufferTLS->get<LogBuffer>();
+   if (buffer)
+      return buffer;
 
-   // ScopedLock sl(_modules_lock);
-   // map<const char*, string>::const_iterator it = _modules.find(filename);
+   int tid = syscall(__NR_gettid);
 
-   // if (it != _modules.end())
-   // {
-   //    return it->second;
-   // }
-   // else
-   // {
-      // build module string
-      string mod;
+   FILE* file = NULL;
+   if (_mode == BINARY)
+   {
+      char filename[256];
+      sprintf(filename, "log_%d.bin", tid);
+      file = fopen(formatFileName(filename).c_str(), "wb");
+      assert(file != NULL);
+   }
 
-      // find actual file name ...
-      const char *ptr = strrchr(filename, '/');
-      if (ptr != NULL)
-         filename = ptr + 1;
+   buffer = new LogBuffer(_bufferSize, file, tid);
+   _bufferTLS->insert(buffer);
 
-      for (UInt32 i = 0; i < MODULE_LENGTH && filename[i] != '\0'; i++)
-         mod.push_back(filename[i]);
+   ScopedLock sl(_buffersLock);
+   _buffers.push_back(buffer);
+   return buffer;
+}
 
-      while (mod.length() < MODULE_LENGTH)
-         mod.push_back(' ');
+void Log::logBinary(ErrorState err, UInt32 module_id, SInt32 source_line, const char* format, va_list args)
+{
+   tile_id_t tile_id;
+   bool sim_thread;
+   discoverCore(&tile_id, &sim_thread);
+
+   LogBuffer* buffer = getBuffer();
+   LogRecord* record = buffer->next();
+
+   record->timestamp = getTimestamp();
+   record->tile_id = tile_id;
+   record->module_id = module_id;
+   record->err = err;
+   record->sim_thread = sim_thread;
+   record->line = source_line;
+   record->capture(format, args);
+
+   buffer->commit();
+}
+
+static bool compareTimestamps(const pair<LogRecord,SInt32>& r1, const pair<LogRecord,SInt32>& r2)
+{
+   return r1.first.timestamp < r2.first.timestamp;
+}
+
+void Log::dumpFlightRecorder()
+{
+   // The other threads may still be logging, so this is a best effort
+   vector<pair<LogRecord,SInt32> > records;
+   LogRecord* latest = new LogRecord[_bufferSize];
+   {
+      ScopedLock sl(_buffersLock);
+      for (UInt32 i = 0; i < _buffers.size(); i++)
+      {
+         UInt32 count = _buffers[i]->getLatest(latest, _bufferSize);
+         for (UInt32 j = 0; j < count; j++)
+            records.push_back(make_pair(latest[j], _buffers[i]->getThreadId()));
+      }
+   }
+   delete [] latest;
 
-   //   pair<const char*, string> p(filename, mod);
-   //   _modules.insert(p);
+   stable_sort(records.begin(), records.end(), compareTimestamps);
 
-      return mod;
-   // }
+   string filename = formatFileName("flight_recorder.log");
+   FILE* file = fopen(filename.c_str(), "w");
+   if (!file)
+      return;
+
+   for (UInt32 i = 0; i < records.size(); i++)
+   {
+      const LogRecord& record = records[i].first;
+      char message[512];
+      record.print(message, sizeof(message));
+      fprintf(file, "%-10llu [%5d]  [%2i]%s[%s:%4d]  %s%s\n",
+              (long long unsigned int) record.timestamp, records[i].second, record.tile_id,
+              (record.sim_thread ? "* " : "  "), getModuleName(record.module_id), record.line,
+              (record.err == Error) ? "*ERROR* " : ((record.err == Warning) ? "*WARNING* " : ""),
+              message);
+   }
+   fclose(file);
+
+   fprintf(stderr, "Last %u log records of each thread written to %s\n", _bufferSize, filename.c_str());
 }
 
-void Log::log(ErrorState err, const char* source_file, SInt32 source_line, const char *format, ...)
+void Log::log(ErrorState err, UInt32 module_id, SInt32 source_line, const char *format, ...)
 {
+   va_list args;
+
+   if (_mode != TEXT)
+   {
+      va_start(args, format);
+      logBinary(err, module_id, source_line, format, args);
+      va_end(args);
+
+      // Warnings and errors are printed as well
+      if (err == None)
+         return;
+   }
+
+   const char* source_file = getModuleName(module_id);
+
    tile_id_t tile_id;
    bool sim_thread;
    discoverCore(&tile_id, &sim_thread);
    
-   FILE *file;
-   Lock *lock;
-
-   getFile(tile_id, sim_thread, &file, &lock);
    int tid = syscall(__NR_gettid);
 
 
@@ -341,24 +501,36 @@ void Log::log(ErrorState err, const char* source_file, SInt32 source_line, const
       break;
    };
 
-   va_list args;
    va_start(args, format);
    p += vsprintf(p, format, args);
    va_end(args);
 
    p += sprintf(p, "\n");
 
-   lock->acquire();
+   if (_mode == TEXT)
+   {
+      FILE *file;
+      Lock *lock;
+      getFile(tile_id, sim_thread, &file, &lock);
+
+      lock->acquire();
 
-   fputs(message, file);
-   fflush(file);
+      fputs(message, file);
+      fflush(file);
 
-   lock->release();
+      lock->release();
+   }
 
    switch (err)
    {
    case Error:
       fputs(message, stderr);
+      // Only this thread's ring can be safely written out to its file; the
+      // records the other threads have not written out yet go to the dump
+      if (_mode == BINARY)
+         getBuffer()->flush();
+      if (_mode != TEXT)
+         dumpFlightRecorder();
       abort();
       break;
 
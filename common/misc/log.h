@@ -5,10 +5,14 @@
 #include <set>
 #include <string>
 #include <map>
+#include <vector>
+#include <stdarg.h>
 #include "fixed_types.h"
 #include "lock.h"
 
 class Config;
+class TLS;
+class LogBuffer;
 
 class Log
 {
@@ -25,15 +29,39 @@ class Log
          Error,
       };
 
-      void log(ErrorState err, const char *source_file, SInt32 source_line, const char* format, ...);
+      // text: formatted records in per-tile files
+      // binary: raw records in per-thread rings, written out to per-thread
+      //    files (decoded with tools/decode_log.py)
+      // flight_recorder: raw records in per-thread rings that only keep the
+      //    latest ones, which are written out on error
+      enum Mode
+      {
+         TEXT,
+         BINARY,
+         FLIGHT_RECORDER
+      };
 
-      bool isEnabled(const char* module);
+      void log(ErrorState err, UInt32 module_id, SInt32 source_line, const char* format, ...);
+
+      bool isEnabled(UInt32 module_id) { return _moduleEnabled[module_id]; }
       bool isLoggingEnabled();
-      std::string getModule(const char *filename);
+
+      // Modules are named after (the first MODULE_LENGTH characters of) the
+      // source file name. Each LOG_PRINT looks its module id up once.
+      static UInt32 getModuleId(const char *filename);
+      static const char* getModuleName(UInt32 module_id);
 
    private:
       UInt64 getTimestamp();
 
+      void logBinary(ErrorState err, UInt32 module_id, SInt32 source_line, const char* format, va_list args);
+      LogBuffer* getBuffer();
+      void dumpFlightRecorder();
+
+      bool computeModuleEnabled(const char* module);
+      void initModulesEnabled();
+      static Mode parseMode(std::string mode);
+
       void initFileDescriptors();
       static void parseModules(std::set<std::string> &mods, std::string list);
       void getDisabledModules();
@@ -67,10 +95,19 @@ class Log
       std::set<std::string> _enabledModules;
       bool _loggingEnabled;
 
-      /* std::map<const char*, std::string> _modules; */
-      /* Lock _modules_lock; */
+      Mode _mode;
+      UInt32 _bufferSize;
+      TLS* _bufferTLS;
+      std::vector<LogBuffer*> _buffers;
+      Lock _buffersLock;
 
       static const size_t MODULE_LENGTH = 10;
+      static const UInt32 MAX_MODULES = 1024;
+
+      static char _moduleNames[MAX_MODULES][MODULE_LENGTH + 1];
+      static volatile bool _moduleEnabled[MAX_MODULES];
+      static UInt32 _numModules;
+      static Lock _modulesLock;
 
       static Log *_singleton;
 };
@@ -91,22 +128,28 @@ class Log
 
 #else
 
-#define __LOG_PRINT(err, file, line, ...)                               \
+// 'module_id' is only evaluated if logging is enabled
+#define __LOG_PRINT(err, module_id, line, ...)                          \
    {                                                                    \
       if (Log::getSingleton()->isLoggingEnabled() || err != Log::None)  \
       {                                                                 \
-         std::string module = Log::getSingleton()->getModule(file);     \
+         UInt32 _log_module_id = (module_id);                           \
          if (err != Log::None ||                                        \
-             Log::getSingleton()->isEnabled(module.c_str()))            \
+             Log::getSingleton()->isEnabled(_log_module_id))            \
          {                                                              \
-            Log::getSingleton()->log(err, module.c_str(), line, __VA_ARGS__); \
+            Log::getSingleton()->log(err, _log_module_id, line, __VA_ARGS__); \
          }                                                              \
       }                                                                 \
    }                                                                    \
 
+// The module id of each call site is looked up on its first use
 #define _LOG_PRINT(err, ...)                                            \
    {                                                                    \
-   __LOG_PRINT(err, __FILE__, __LINE__, __VA_ARGS__);                   \
+   static SInt32 _log_site_module_id = -1;                              \
+   __LOG_PRINT(err,                                                     \
+               (_log_site_module_id >= 0) ? _log_site_module_id         \
+                  : (_log_site_module_id = Log::getModuleId(__FILE__)), \
+               __LINE__, __VA_ARGS__);                                  \
    }                                                                    \
  
 #define LOG_PRINT(...)                                                  \
@@ -146,12 +189,12 @@ public:
       , m_line(line)
       , m_fn(fn)
    {
-      __LOG_PRINT(Log::None, m_file, m_line, "Entering: %s", m_fn);
+      __LOG_PRINT(Log::None, Log::getModuleId(m_file), m_line, "Entering: %s", m_fn);
    }
 
    ~FunctionTracer()
    {
-      __LOG_PRINT(Log::None, m_file, m_line, "Exiting: %s", m_fn);
+      __LOG_PRINT(Log::None, Log::getModuleId(m_file), m_line, "Exiting: %s", m_fn);
    }
 
 private:
@@ -0,0 +1,421 @@
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+
+#include "log_buffer.h"
+#include "log.h"
+
+namespace
+{
+
+enum LengthModifier
+{
+   LENGTH_NONE = 0,
+   LENGTH_HH,
+   LENGTH_H,
+   LENGTH_L,
+   LENGTH_LL,
+   LENGTH_LONG_DOUBLE,
+   LENGTH_J,
+   LENGTH_Z,
+   LENGTH_T
+};
+
+// A printf conversion specification
+struct Conversion
+{
+   char flags[8];
+   char width[16];
+   char precision[16];
+   bool star_width;
+   bool star_precision;
+   LengthModifier length;
+   char type;
+};
+
+// Parses the conversion at 'p' (which points to a '%') and returns the
+// position following it
+const char* parseConversion(const char* p, Conversion& conv)
+{
+   conv.flags[0] = conv.width[0] = conv.precision[0] = '\0';
+   conv.star_width = conv.star_precision = false;
+   conv.length = LENGTH_NONE;
+
+   p++;
+   UInt32 n = 0;
+   while (*p != '\0' && strchr("-+ #0'", *p) && n < sizeof(conv.flags) - 1)
+      conv.flags[n++] = *p++;
+   conv.flags[n] = '\0';
+
+   if (*p == '*')
+   {
+      conv.star_width = true;
+      p++;
+   }
+   else
+   {
+      for (n = 0; (*p >= '0' && *p <= '9') && n < sizeof(conv.width) - 1; n++)
+         conv.width[n] = *p++;
+      conv.width[n] = '\0';
+   }
+
+   if (*p == '.')
+   {
+      p++;
+      if (*p == '*')
+      {
+         conv.star_precision = true;
+         p++;
+      }
+      else
+      {
+         conv.precision[0] = '.';
+         for (n = 1; (*p >= '0' && *p <= '9') && n < sizeof(conv.precision) - 1; n++)
+            conv.precision[n] = *p++;
+         conv.precision[n] = '\0';
+      }
+   }
+
+   switch (*p)
+   {
+   case 'h':
+      conv.length = (*(p+1) == 'h') ? LENGTH_HH : LENGTH_H;
+      p += (conv.length == LENGTH_HH) ? 2 : 1;
+      break;
+   case 'l':
+      conv.length = (*(p+1) == 'l') ? LENGTH_LL : LENGTH_L;
+      p += (conv.length == LENGTH_LL) ? 2 : 1;
+      break;
+   case 'q':
+      conv.length = LENGTH_LL;
+      p++;
+      break;
+   case 'L':
+      conv.length = LENGTH_LONG_DOUBLE;
+      p++;
+      break;
+   case 'j':
+      conv.length = LENGTH_J;
+      p++;
+      break;
+   case 'z':
+      conv.length = LENGTH_Z;
+      p++;
+      break;
+   case 't':
+      conv.length = LENGTH_T;
+      p++;
+      break;
+   default:
+      break;
+   }
+
+   conv.type = *p;
+   return (*p != '\0') ? p + 1 : p;
+}
+
+// Integers take up the width of their length modifier (char and short are
+// promoted to int)
+UInt64 readInteger(va_list& args, LengthModifier length)
+{
+   switch (length)
+   {
+   case LENGTH_L:
+      return (UInt64) va_arg(args, long);
+   case LENGTH_LL:
+   case LENGTH_LONG_DOUBLE:
+      return (UInt64) va_arg(args, long long);
+   case LENGTH_J:
+      return (UInt64) va_arg(args, intmax_t);
+   case LENGTH_Z:
+      return (UInt64) va_arg(args, size_t);
+   case LENGTH_T:
+      return (UInt64) va_arg(args, ptrdiff_t);
+   default:
+      return (UInt64) va_arg(args, int);
+   }
+}
+
+SInt64 toSigned(UInt64 value, LengthModifier length)
+{
+   switch (length)
+   {
+   case LENGTH_HH:
+      return (signed char) value;
+   case LENGTH_H:
+      return (short) value;
+   case LENGTH_NONE:
+      return (int) value;
+   default:
+      return (SInt64) value;
+   }
+}
+
+UInt64 toUnsigned(UInt64 value, LengthModifier length)
+{
+   switch (length)
+   {
+   case LENGTH_HH:
+      return (unsigned char) value;
+   case LENGTH_H:
+      return (unsigned short) value;
+   case LENGTH_NONE:
+      return (unsigned int) value;
+   default:
+      return value;
+   }
+}
+
+}
+
+void
+LogRecord::capture(const char* format_, va_list args_)
+{
+   format = (UInt64) format_;
+   num_args = 0;
+   strings_size = 0;
+
+   va_list ap;
+   va_copy(ap, args_);
+
+   const char* p = format_;
+   while ((p = strchr(p, '%')) != NULL)
+   {
+      Conversion conv;
+      p = parseConversion(p, conv);
+      if (conv.type == '%' || conv.type == '\0')
+         continue;
+
+      // The remaining arguments are shown as missing
+      UInt32 num_conv_args = 1 + (conv.star_width ? 1 : 0) + (conv.star_precision ? 1 : 0);
+      if (num_args + num_conv_args > MAX_ARGS)
+         break;
+
+      if (conv.star_width)
+         args[num_args++] = (UInt64) va_arg(ap, int);
+      if (conv.star_precision)
+         args[num_args++] = (UInt64) va_arg(ap, int);
+
+      switch (conv.type)
+      {
+      case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+         args[num_args++] = readInteger(ap, conv.length);
+         break;
+
+      case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+         {
+            double value = (conv.length == LENGTH_LONG_DOUBLE) ? (double) va_arg(ap, long double)
+                                                               : va_arg(ap, double);
+            memcpy(&args[num_args++], &value, sizeof(value));
+         }
+         break;
+
+      case 's':
+         {
+            const char* str = va_arg(ap, const char*);
+            if (str == NULL)
+               str = "(null)";
+            // Strings that do not fit are truncated
+            UInt32 length = std::min((UInt32) strlen(str), STRINGS_SIZE - strings_size - 1);
+            args[num_args++] = strings_size;
+            memcpy(&strings[strings_size], str, length);
+            strings_size += length;
+            strings[strings_size++] = '\0';
+            if (strings_size == STRINGS_SIZE)
+               strings_size--;
+         }
+         break;
+
+      case 'p':
+      case 'n':
+         args[num_args++] = (UInt64) va_arg(ap, void*);
+         break;
+
+      default:
+         break;
+      }
+   }
+
+   va_end(ap);
+}
+
+void
+LogRecord::print(char* buf, size_t size) const
+{
+   const char* p = (const char*) format;
+   size_t pos = 0;
+   UInt32 arg = 0;
+
+   while (*p != '\0' && pos < size - 1)
+   {
+      if (*p != '%')
+      {
+         buf[pos++] = *p++;
+         continue;
+      }
+
+      Conversion conv;
+      p = parseConversion(p, conv);
+      if (conv.type == '%')
+      {
+         buf[pos++] = '%';
+         continue;
+      }
+
+      UInt32 num_conv_args = 1 + (conv.star_width ? 1 : 0) + (conv.star_precision ? 1 : 0);
+      if (conv.type == '\0' || arg + num_conv_args > num_args)
+      {
+         pos += snprintf(buf + pos, size - pos, "<?>");
+         pos = std::min(pos, size - 1);
+         continue;
+      }
+
+      // Rebuild the conversion with the captured '*' values
+      char spec[64];
+      SInt32 width = conv.star_width ? (SInt32) args[arg++] : 0;
+      SInt32 precision = conv.star_precision ? (SInt32) args[arg++] : 0;
+      int n = snprintf(spec, sizeof(spec), "%%%s", conv.flags);
+      if (conv.star_width)
+         n += snprintf(spec + n, sizeof(spec) - n, "%d", width);
+      else
+         n += snprintf(spec + n, sizeof(spec) - n, "%s", conv.width);
+      if (conv.star_precision)
+         n += snprintf(spec + n, sizeof(spec) - n, ".%d", precision);
+      else
+         n += snprintf(spec + n, sizeof(spec) - n, "%s", conv.precision);
+
+      UInt64 value = args[arg++];
+      switch (conv.type)
+      {
+      case 'd': case 'i':
+         snprintf(spec + n, sizeof(spec) - n, "ll%c", conv.type);
+         pos += snprintf(buf + pos, size - pos, spec, (long long) toSigned(value, conv.length));
+         break;
+
+      case 'o': case 'u': case 'x': case 'X':
+         snprintf(spec + n, sizeof(spec) - n, "ll%c", conv.type);
+         pos += snprintf(buf + pos, size - pos, spec, (unsigned long long) toUnsigned(value, conv.length));
+         break;
+
+      case 'c':
+         snprintf(spec + n, sizeof(spec) - n, "c");
+         pos += snprintf(buf + pos, size - pos, spec, (int) value);
+         break;
+
+      case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+         {
+            double d;
+            memcpy(&d, &value, sizeof(d));
+            snprintf(spec + n, sizeof(spec) - n, "%c", conv.type);
+            pos += snprintf(buf + pos, size - pos, spec, d);
+         }
+         break;
+
+      case 's':
+         snprintf(spec + n, sizeof(spec) - n, "s");
+         pos += snprintf(buf + pos, size - pos, spec, &strings[std::min(value, (UInt64) STRINGS_SIZE - 1)]);
+         break;
+
+      case 'p':
+         snprintf(spec + n, sizeof(spec) - n, "p");
+         pos += snprintf(buf + pos, size - pos, spec, (void*) value);
+         break;
+
+      default:
+         break;
+      }
+      pos = std::min(pos, size - 1);
+   }
+
+   buf[pos] = '\0';
+}
+
+LogBuffer::LogBuffer(UInt32 size, FILE* file, SInt32 thread_id)
+   : _size(size)
+   , _head(0)
+   , _flushed(0)
+   , _file(file)
+   , _thread_id(thread_id)
+{
+   _records = new LogRecord[_size];
+   if (_file)
+      writeHeader();
+}
+
+LogBuffer::~LogBuffer()
+{
+   if (_file)
+   {
+      flush();
+      fclose(_file);
+   }
+   delete [] _records;
+}
+
+void
+LogBuffer::commit()
+{
+   // Readers of the flight recorder only look at published records
+   __sync_synchronize();
+   _head = _head + 1;
+
+   if (_file && (_head - _flushed) == _size)
+      flush();
+}
+
+void
+LogBuffer::flush()
+{
+   if (!_file)
+      return;
+
+   for ( ; _flushed < _head; _flushed++)
+      writeRecord(_records[_flushed % _size]);
+   fflush(_file);
+}
+
+UInt32
+LogBuffer::getLatest(LogRecord* records, UInt32 count) const
+{
+   UInt64 head = _head;
+   __sync_synchronize();
+
+   count = std::min(count, (UInt32) std::min(head, (UInt64) _size));
+   for (UInt32 i = 0; i < count; i++)
+      records[i] = _records[(head - count + i) % _size];
+   return count;
+}
+
+void
+LogBuffer::writeHeader()
+{
+   UInt32 header[4] = { MAGIC, VERSION, sizeof(LogRecord), (UInt32) _thread_id };
+   fwrite(header, sizeof(header), 1, _file);
+}
+
+void
+LogBuffer::writeRecord(const LogRecord& record)
+{
+   // Format strings and module names are written once per file, before the
+   // first record that uses them
+   if (_written_formats.insert(record.format).second)
+   {
+      const char* format = (const char*) record.format;
+      UInt32 entry[2] = { FORMAT, (UInt32) strlen(format) };
+      fwrite(entry, sizeof(entry), 1, _file);
+      fwrite(&record.format, sizeof(record.format), 1, _file);
+      fwrite(format, entry[1], 1, _file);
+   }
+   if (_written_modules.insert(record.module_id).second)
+   {
+      const char* module = Log::getModuleName(record.module_id);
+      UInt32 entry[3] = { MODULE, (UInt32) strlen(module), record.module_id };
+      fwrite(entry, sizeof(entry), 1, _file);
+      fwrite(module, entry[1], 1, _file);
+   }
+
+   UInt32 type = RECORD;
+   fwrite(&type, sizeof(type), 1, _file);
+   fwrite(&record, sizeof(record), 1, _file);
+}
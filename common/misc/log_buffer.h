@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <set>
+
+#include "fixed_types.h"
+
+// Binary log record: the arguments of a LOG_PRINT are stored as they were
+// passed (walking the format string to learn their types) and are only
+// formatted when the record is read, either in-process (flight recorder)
+// or offline from the binary log files (tools/decode_log.py).
+//
+// The layout has no padding and is written to the files as is; keep
+// tools/decode_log.py in sync with it.
+struct LogRecord
+{
+   static const UInt32 MAX_ARGS = 12;
+   static const UInt32 STRINGS_SIZE = 96;
+
+   UInt64 timestamp;
+   UInt64 format;             // Address of the format string
+   SInt32 tile_id;
+   UInt16 module_id;
+   UInt8 err;
+   UInt8 sim_thread;
+   SInt32 line;
+   UInt16 num_args;
+   UInt16 strings_size;
+   UInt64 args[MAX_ARGS];     // Integers, pointers and double bits; offsets into 'strings' for %s
+   char strings[STRINGS_SIZE];
+
+   void capture(const char* format_, va_list args_);
+   // Formats the record (its format string must be in this process)
+   void print(char* buf, size_t size) const;
+};
+
+// Per-thread ring of log records. Only the owning thread appends to it;
+// other threads only read it to dump a flight recorder on error.
+//
+// In binary mode, the owning thread writes the records out to its own file
+// whenever the ring fills up, preceded by the format strings and module
+// names the file has not seen yet. As a flight recorder, the ring just
+// keeps the latest records.
+class LogBuffer
+{
+public:
+   // Each file starts with MAGIC, VERSION, sizeof(LogRecord) and the thread
+   // id (all UInt32), followed by entries that start with their (UInt32) type
+   static const UInt32 MAGIC = 0x474f4c47;   // "GLOG"
+   static const UInt32 VERSION = 1;
+   enum EntryType
+   {
+      FORMAT = 1,    // length, address (UInt64), string
+      MODULE,        // length, module id, string
+      RECORD         // LogRecord
+   };
+
+   // 'file' is NULL for a flight recorder
+   LogBuffer(UInt32 size, FILE* file, SInt32 thread_id);
+   ~LogBuffer();
+
+   LogRecord* next()
+   { return &_records[_head % _size]; }
+   void commit();
+
+   // Writes out the records not written yet (binary mode)
+   void flush();
+
+   // Copies out up to 'count' of the latest records, oldest first
+   UInt32 getLatest(LogRecord* records, UInt32 count) const;
+
+   SInt32 getThreadId() const { return _thread_id; }
+
+private:
+   LogRecord* _records;
+   UInt32 _size;
+   volatile UInt64 _head;
+   UInt64 _flushed;
+
+   FILE* _file;
+   SInt32 _thread_id;
+   std::set<UInt64> _written_formats;
+   std::set<UInt16> _written_modules;
+
+   void writeHeader();
+   void writeRecord(const LogRecord& record);
+};
@@ -0,0 +1,44 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "mapped_file.h"
+#include "log.h"
+
+using namespace std;
+
+MappedFile::MappedFile()
+   : _data(NULL)
+   , _length(0)
+{}
+
+MappedFile::~MappedFile()
+{
+   if (_data)
+      munmap((void*) _data, _length);
+}
+
+bool
+MappedFile::open(const string& filename, size_t min_length)
+{
+   LOG_ASSERT_ERROR(_data == NULL, "File(%s) opened twice", filename.c_str());
+
+   int fd = ::open(filename.c_str(), O_RDONLY);
+   if (fd < 0)
+      return false;
+
+   struct stat st;
+   __attribute__((unused)) int ret = fstat(fd, &st);
+   LOG_ASSERT_ERROR(ret == 0, "Could not stat file(%s)", filename.c_str());
+   LOG_ASSERT_ERROR((size_t) st.st_size >= min_length, "Truncated file(%s)", filename.c_str());
+
+   _length = st.st_size;
+   void* data = mmap(NULL, _length, PROT_READ, MAP_PRIVATE, fd, 0);
+   LOG_ASSERT_ERROR(data != MAP_FAILED, "Could not map file(%s)", filename.c_str());
+   close(fd);
+   madvise(data, _length, MADV_SEQUENTIAL);
+
+   _data = (const Byte*) data;
+   return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include "fixed_types.h"
+
+// Read-only mapping of a whole file, for the trace readers, which decode it
+// sequentially
+class MappedFile
+{
+public:
+   MappedFile();
+   ~MappedFile();
+
+   // Returns false if the file does not exist. Any other failure, or a file
+   // shorter than 'min_length', is an error.
+   bool open(const std::string& filename, size_t min_length);
+
+   const Byte* getData() const { return _data; }
+   size_t getLength() const { return _length; }
+
+private:
+   const Byte* _data;
+   size_t _length;
+};
@@ -0,0 +1,3 @@
+#include "model_registry.h"
+
+Lock ModelRegistryBase::_lock;
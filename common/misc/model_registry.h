@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>
+#include <string>
+using std::map;
+using std::string;
+
+#include "lock.h"
+
+// Process-wide registry of (area/power) models, keyed by the serialized
+// parameters they were built with. Components with identical parameters
+// on different tiles look their model up here instead of building it again.
+// The models are shared, so they are either immutable once registered or
+// guard their own state, and they live till the process exits.
+//
+// Callers hold getLock() across find() and insert(), so that each model is
+// built once even if several tiles are being set up at the same time.
+// McPAT and DSENT keep global state while they build a model, so all the
+// registries share one lock, and models of different kinds are not built
+// at the same time either.
+class ModelRegistryBase
+{
+public:
+   static Lock& getLock() { return _lock; }
+
+private:
+   static Lock _lock;
+};
+
+template <typename T>
+class ModelRegistry : public ModelRegistryBase
+{
+public:
+   T* find(const string& key) const
+   {
+      typename map<string,T*>::const_iterator it = _model_map.find(key);
+      return (it != _model_map.end()) ? it->second : NULL;
+   }
+   void insert(const string& key, T* model)
+   { _model_map[key] = model; }
+
+private:
+   map<string,T*> _model_map;
+};
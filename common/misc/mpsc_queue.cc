@@ -0,0 +1,115 @@
+#include "mpsc_queue.h"
+
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <stddef.h>
+
+MPSCQueue::MPSCQueue()
+   : _head(&_stub)
+   , _tail(&_stub)
+   , _futx(0)
+   , _spin_count(MIN_SPIN_COUNT)
+{
+   _stub._next = NULL;
+}
+
+MPSCQueue::~MPSCQueue()
+{
+}
+
+void MPSCQueue::insert(Node* node)
+{
+   node->_next = NULL;
+   // xchg is a full barrier on x86
+   Node* prev = __sync_lock_test_and_set(&_head, node);
+   prev->_next = node;
+}
+
+void MPSCQueue::push(Node* node)
+{
+   insert(node);
+
+   // Wake the consumer if it announced that it is going to sleep
+   __sync_synchronize();
+   if (_futx == 1 && __sync_bool_compare_and_swap(&_futx, 1, 0))
+      syscall(SYS_futex, (void*) &_futx, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+MPSCQueue::Node* MPSCQueue::pop()
+{
+   Node* tail = _tail;
+   Node* next = tail->_next;
+
+   if (tail == &_stub)
+   {
+      if (next == NULL)
+         return NULL;
+      _tail = next;
+      tail = next;
+      next = next->_next;
+   }
+
+   if (next)
+   {
+      _tail = next;
+      return tail;
+   }
+
+   // A producer is between the xchg and the link in insert()
+   if (tail != _head)
+      return NULL;
+
+   // 'tail' is the last element; put the stub behind it so it can be
+   // unlinked
+   insert(&_stub);
+
+   next = tail->_next;
+   if (next)
+   {
+      _tail = next;
+      return tail;
+   }
+   return NULL;
+}
+
+MPSCQueue::Node* MPSCQueue::waitPop()
+{
+   while (true)
+   {
+      for (UInt32 i = 0; i < _spin_count; i++)
+      {
+         Node* node = pop();
+         if (node)
+         {
+            // Spinning paid off, allow a longer spin next time
+            if (_spin_count < MAX_SPIN_COUNT)
+               _spin_count <<= 1;
+            return node;
+         }
+         __asm__ __volatile__("pause" ::: "memory");
+      }
+
+      if (_spin_count > MIN_SPIN_COUNT)
+         _spin_count >>= 1;
+
+      // Announce that we are going to sleep, then re-check so that a
+      // push() racing with us cannot be missed
+      __sync_lock_test_and_set(&_futx, 1);
+
+      Node* node = pop();
+      if (node)
+      {
+         _futx = 0;
+         return node;
+      }
+
+      syscall(SYS_futex, (void*) &_futx, FUTEX_WAIT, 1, NULL, NULL, 0);
+      _futx = 0;
+   }
+}
+
+bool MPSCQueue::empty() const
+{
+   return (_tail == &_stub) && (_stub._next == NULL);
+}
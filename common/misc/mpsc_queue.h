@@ -0,0 +1,46 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "fixed_types.h"
+
+// Intrusive lock-free multi-producer / single-consumer FIFO queue
+// (after D. Vyukov's non-blocking MPSC queue). Any number of threads
+// may push(); only a single thread may pop() or waitPop().
+//
+// Elements embed an MPSCQueue::Node; the queue never allocates.
+
+class MPSCQueue
+{
+public:
+   struct Node
+   {
+      Node* volatile _next;
+   };
+
+   MPSCQueue();
+   ~MPSCQueue();
+
+   void push(Node* node);
+   // Returns NULL if the queue is (momentarily) empty
+   Node* pop();
+   // Spins for a while, then sleeps on a futex until an element arrives
+   Node* waitPop();
+   bool empty() const;
+
+private:
+   Node* volatile _head;   // producers push here
+   Node* _tail;            // consumer pops here
+   Node _stub;
+
+   // Futex word: 1 while the consumer is (about to be) asleep
+   volatile int _futx;
+   // Adaptive spin budget of the consumer before it goes to sleep
+   UInt32 _spin_count;
+
+   static const UInt32 MIN_SPIN_COUNT = 16;
+   static const UInt32 MAX_SPIN_COUNT = 4096;
+
+   void insert(Node* node);
+};
+
+#endif // MPSC_QUEUE_H
@@ -2,22 +2,122 @@
 #include "fixed_types.h"
 
 UnstructuredBuffer::UnstructuredBuffer()
+   : m_data(m_small_buffer)
+   , m_capacity(SMALL_BUFFER_SIZE)
+   , m_begin(0)
+   , m_end(0)
+   , m_wrapped(false)
 {
 }
 
+UnstructuredBuffer::UnstructuredBuffer(const void* data, int size)
+   : m_data(m_small_buffer)
+   , m_capacity(SMALL_BUFFER_SIZE)
+   , m_begin(0)
+   , m_end(0)
+   , m_wrapped(false)
+{
+   wrap(data, size);
+}
+
+UnstructuredBuffer::UnstructuredBuffer(const UnstructuredBuffer& other)
+   : m_data(m_small_buffer)
+   , m_capacity(SMALL_BUFFER_SIZE)
+   , m_begin(0)
+   , m_end(0)
+   , m_wrapped(false)
+{
+   put<char>(other.m_data + other.m_begin, other.m_end - other.m_begin);
+}
+
+UnstructuredBuffer::~UnstructuredBuffer()
+{
+   release();
+}
+
+UnstructuredBuffer& UnstructuredBuffer::operator=(const UnstructuredBuffer& other)
+{
+   if (this != &other)
+   {
+      clear();
+      put<char>(other.m_data + other.m_begin, other.m_end - other.m_begin);
+   }
+   return *this;
+}
+
 const void* UnstructuredBuffer::getBuffer()
 {
-   return m_chars.data();
+   return m_data + m_begin;
 }
 
 void UnstructuredBuffer::clear()
 {
-   m_chars.erase();
+   if (m_wrapped)
+   {
+      m_data = m_small_buffer;
+      m_capacity = SMALL_BUFFER_SIZE;
+      m_wrapped = false;
+   }
+   m_begin = m_end = 0;
 }
 
 int UnstructuredBuffer::size()
 {
-   return m_chars.size();
+   return m_end - m_begin;
+}
+
+void UnstructuredBuffer::wrap(const void* data, int size)
+{
+   assert(size >= 0);
+   release();
+   m_data = (char*) data;
+   m_capacity = size;
+   m_begin = 0;
+   m_end = size;
+   m_wrapped = true;
+}
+
+void UnstructuredBuffer::reserve(int num_bytes)
+{
+   if (!m_wrapped && ((m_end + num_bytes) <= m_capacity))
+      return;
+
+   int size = m_end - m_begin;
+
+   // Reclaim the space of the data already read
+   if (!m_wrapped && ((size + num_bytes) <= m_capacity))
+   {
+      memmove(m_data, m_data + m_begin, size);
+      m_begin = 0;
+      m_end = size;
+      return;
+   }
+
+   int capacity = SMALL_BUFFER_SIZE;
+   while (capacity < (size + num_bytes))
+      capacity *= 2;
+
+   // Only a wrapped buffer can move (back) to the small buffer
+   assert((capacity > SMALL_BUFFER_SIZE) || m_wrapped);
+   char* data = (capacity == SMALL_BUFFER_SIZE) ? m_small_buffer : new char[capacity];
+   memcpy(data, m_data + m_begin, size);
+
+   release();
+   m_data = data;
+   m_capacity = capacity;
+   m_begin = 0;
+   m_end = size;
+   m_wrapped = false;
+}
+
+void UnstructuredBuffer::release()
+{
+   if (!m_wrapped && (m_data != m_small_buffer))
+      delete [] m_data;
+   m_data = m_small_buffer;
+   m_capacity = SMALL_BUFFER_SIZE;
+   m_begin = m_end = 0;
+   m_wrapped = false;
 }
 
 // put buffer
@@ -97,6 +197,34 @@ int main(int argc, char* argv[])
    assert(data7 == data7prime);
    cout << "success: test 4" << endl;
 
+   char data8[] = "wrapped";
+   UInt32 data9 = 9;
+   UnstructuredBuffer wrapped_buff(data8, sizeof(data8));
+   char data8prime[sizeof(data8)];
+   wrapped_buff >> std::make_pair(data8prime, 4);
+   wrapped_buff << data9;
+   data8[0] = 'x';
+   wrapped_buff >> std::make_pair(data8prime + 4, (int) sizeof(data8) - 4);
+   UInt32 data9prime = 0;
+   wrapped_buff >> data9prime;
+
+   cout << data8prime << " " << data9prime << endl;
+   assert(strcmp(data8prime, "wrapped") == 0);
+   assert(data9 == data9prime);
+   assert(wrapped_buff.size() == 0);
+   cout << "success: test 5" << endl;
+
+   UInt32 data10[1000];
+   for (UInt32 i = 0; i < 1000; i++)
+      data10[i] = i;
+   buff << std::make_pair(data10, (int) sizeof(data10)) << data9;
+   UInt32 data10prime[1000];
+   buff >> std::make_pair(data10prime, (int) sizeof(data10prime)) >> data9prime;
+
+   assert(memcmp(data10, data10prime, sizeof(data10)) == 0);
+   assert(data9 == data9prime);
+   cout << "success: test 6" << endl;
+
    cout << "All tests passed" << endl;
 
    return 0;
@@ -5,22 +5,50 @@
 
 //#define DEBUG_UNSTRUCTURED_BUFFER
 #include <assert.h>
+#include <string.h>
 #include <string>
 #include <utility>
 
+// Data is put at the end of the buffer and got from a read cursor, so
+// consuming a message is linear in its size. Small messages are kept in an
+// inline buffer. A received packet can be wrapped, so that it is read in
+// place; it is copied only if more data is put in the buffer.
 class UnstructuredBuffer
 {
 
 private:
-    std::string m_chars;
+    enum { SMALL_BUFFER_SIZE = 128 };
+
+    char m_small_buffer[SMALL_BUFFER_SIZE];
+    // Unread data is [m_begin, m_end) of m_data, which is m_small_buffer,
+    // a heap buffer or, when m_wrapped, the caller's buffer
+    char* m_data;
+    int m_capacity;
+    int m_begin;
+    int m_end;
+    bool m_wrapped;
+
+    // Make room to put 'num_bytes' more bytes in a buffer of our own
+    void reserve(int num_bytes);
+    void release();
 
 public:
 
     UnstructuredBuffer();
+    // Wraps 'data' without copying it (see wrap())
+    UnstructuredBuffer(const void* data, int size);
+    UnstructuredBuffer(const UnstructuredBuffer& other);
+    ~UnstructuredBuffer();
+    UnstructuredBuffer& operator=(const UnstructuredBuffer& other);
+
     const void* getBuffer();
     void clear();
     int size();
 
+    // Read 'data' in place. It must stay valid until the buffer is cleared,
+    // wrapped again or destroyed, or more data is put in it
+    void wrap(const void* data, int size);
+
     // These put / get scalars
     template<class T> void put(const T & data);
     template<class T> bool get(T& data);
@@ -48,17 +76,30 @@ public:
 template<class T> void UnstructuredBuffer::put(const T* data, int num)
 {
     assert(num >= 0);
-    m_chars.append((const char *) data, num * sizeof(T));
+    int num_bytes = num * sizeof(T);
+    reserve(num_bytes);
+    memcpy(m_data + m_end, (const void*) data, num_bytes);
+    m_end += num_bytes;
 }
 
 template<class T> bool UnstructuredBuffer::get(T* data, int num)
 {
     assert(num >= 0);
-    if (m_chars.size() < (num * sizeof(T)))
+    int num_bytes = num * sizeof(T);
+    if ((m_end - m_begin) < num_bytes)
+    {
+        // Short read: the target is still written, so it is never used
+        // uninitialized
+        memset((void*) data, 0, num_bytes);
         return false;
+    }
+
+    memcpy((void*) data, m_data + m_begin, num_bytes);
+    m_begin += num_bytes;
 
-    m_chars.copy((char *) data, num * sizeof(T));
-    m_chars.erase(0, num * sizeof(T));
+    // Reuse the space once everything has been read
+    if ((m_begin == m_end) && !m_wrapped)
+        m_begin = m_end = 0;
 
     return true;
 }
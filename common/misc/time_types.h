@@ -2,20 +2,27 @@
 
 #include <cmath>
 #include "fixed_types.h"
+#include "clock_domain.h"
 #include "log.h"
 
 class Latency
 {
    public:
-      Latency(UInt64 cycles = 0, double frequency = 0):_cycles(cycles), _frequency(frequency){};
+      Latency(UInt64 cycles = 0, double frequency = 0):_cycles(cycles), _frequency(frequency),
+                                                       _clock_domain(NULL){};
+      // Latencies of a clock domain are converted with integer arithmetic
+      Latency(UInt64 cycles, const ClockDomain* clock_domain):_cycles(cycles),
+                                                              _frequency(clock_domain->getFrequency()),
+                                                              _clock_domain(clock_domain){};
       Latency(const Latency& lat):_cycles(lat._cycles),
-                                  _frequency(lat._frequency) {};
+                                  _frequency(lat._frequency),
+                                  _clock_domain(lat._clock_domain) {};
       ~Latency(){};
 
       Latency operator+(const Latency& lat) const;
 
       Latency operator=(const Latency& lat)
-            { return Latency(lat._cycles, lat._frequency);}
+            { return Latency(lat);}
 
       Latency operator+=(const Latency& lat);
 
@@ -26,6 +33,10 @@ class Latency
    private:
       UInt64 _cycles;
       double _frequency;
+      const ClockDomain* _clock_domain;
+
+      bool hasSameFrequency(const Latency& lat) const
+            { return (_clock_domain && (_clock_domain == lat._clock_domain)) || (_frequency == lat._frequency); }
 };
 
 class Time
@@ -67,6 +78,8 @@ class Time
             { _picosec -= time._picosec; }
 
       UInt64 toCycles(double frequency) const;
+      UInt64 toCycles(const ClockDomain* clock_domain) const
+            { return clock_domain->toCycles(_picosec); }
       UInt64 getTime() const { return _picosec; }
       
       UInt64 toPicosec() const { return _picosec; }
@@ -80,22 +93,25 @@ class Time
 
 inline UInt64 Latency::toPicosec() const
 {
-   UInt64 picosec = (UInt64) ceil( ((double) 1000*_cycles) /  ((double) _frequency) );
+   if (_clock_domain)
+      return _clock_domain->toPicosec(_cycles);
 
-   return picosec;
+   return ClockDomain::computePicosec(_cycles, _frequency);
 }
 
 inline Latency Latency::operator+(const Latency& lat) const
 {
-   LOG_ASSERT_ERROR(_frequency == lat._frequency,
+   LOG_ASSERT_ERROR(hasSameFrequency(lat),
       "Attempting to add latencies from different frequencies");
 
-   return Latency(_cycles + lat._cycles, _frequency);
+   Latency sum(*this);
+   sum._cycles += lat._cycles;
+   return sum;
 }
 
 inline Latency Latency::operator+=(const Latency& lat)
 {
-   LOG_ASSERT_ERROR(_frequency == lat._frequency,
+   LOG_ASSERT_ERROR(hasSameFrequency(lat),
       "Attempting to add latencies from different frequencies");
    _cycles += lat._cycles;
    return *this;
@@ -103,13 +119,15 @@ inline Latency Latency::operator+=(const Latency& lat)
 
 inline UInt64 Time::toCycles(double frequency) const
 {
-   UInt64 cycles = (UInt64) ceil(((double) (_picosec) * ((double) frequency)) / double(1.0e3));
-
-   return cycles;
+   return ClockDomain::computeCycles(_picosec, frequency);
 }
 
 inline UInt64 Time::toNanosec() const
 {
+   // Same as ceil(_picosec / 1e3) in double precision: below 2^52, the
+   // quotient is rounded by less than 1e-3 and cannot cross an integer
+   if (_picosec < (1ULL << 52))
+      return (_picosec + 999) / 1000;
    return (UInt64) ceil(((double) _picosec)/double(1.0e3));
 }
 
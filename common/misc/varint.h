@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "fixed_types.h"
+
+// LEB128 encoding of integers, as used by the trace and counter sample
+// files: 7 bits per byte, least significant first, with the top bit set on
+// all the bytes but the last. Signed integers are zig-zag encoded first, so
+// that small negative values take few bytes as well.
+
+inline void encodeVarint(std::vector<Byte>& buffer, UInt64 value)
+{
+   while (value >= 0x80)
+   {
+      buffer.push_back((Byte) (value | 0x80));
+      value >>= 7;
+   }
+   buffer.push_back((Byte) value);
+}
+
+inline void encodeSignedVarint(std::vector<Byte>& buffer, SInt64 value)
+{
+   encodeVarint(buffer, (((UInt64) value) << 1) ^ (UInt64) (value >> 63));
+}
+
+// Decodes the integer at 'curr' and moves 'curr' past it. Returns false if
+// the integer runs past 'end' (or is too long); 'value' then holds the bits
+// decoded so far.
+inline bool decodeVarint(const Byte*& curr, const Byte* end, UInt64& value)
+{
+   value = 0;
+   for (UInt32 shift = 0; (curr != end) && (shift < 64); shift += 7)
+   {
+      Byte b = *curr++;
+      value |= ((UInt64) (b & 0x7f)) << shift;
+      if (!(b & 0x80))
+         return true;
+   }
+   return false;
+}
+
+inline bool decodeSignedVarint(const Byte*& curr, const Byte* end, SInt64& value)
+{
+   UInt64 zigzag;
+   bool ok = decodeVarint(curr, end, zigzag);
+   value = (SInt64) (zigzag >> 1) ^ -((SInt64) (zigzag & 1));
+   return ok;
+}
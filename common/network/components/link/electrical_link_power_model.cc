@@ -1,9 +1,14 @@
 #include "electrical_link_power_model.h"
 #include "dvfs_manager.h"
+#include "model_registry.h"
+#include "packetize.h"
 #include "log.h"
 
 using namespace dsent_contrib;
 
+// DSENT link models shared by the electrical links with the same parameters
+static ModelRegistry<DSENTElectricalLink> _dsent_link_registry;
+
 ElectricalLinkPowerModel::ElectricalLinkPowerModel(string link_type, double frequency, double voltage,
                                                    double link_length, UInt32 link_width)
    : LinkPowerModel()
@@ -16,11 +21,7 @@ ElectricalLinkPowerModel::ElectricalLinkPowerModel(string link_type, double freq
       double current_voltage = (*it).first;
       double current_frequency = (*it).second;
 
-      // DSENT expects link length to be in meters(m)
-      // DSENT expects link frequency to be in hertz (Hz)
-      _dsent_link_map[current_voltage] = new DSENTElectricalLink(current_frequency * 1e9, current_voltage,
-                                                                 link_length / 1000, link_width,
-                                                                 DSENTInterface::getSingleton());
+      _dsent_link_map[current_voltage] = getDSENTLink(current_frequency, current_voltage, link_length, link_width);
    }
 
    // Set current DSENT electrical link model
@@ -29,7 +30,29 @@ ElectricalLinkPowerModel::ElectricalLinkPowerModel(string link_type, double freq
 
 ElectricalLinkPowerModel::~ElectricalLinkPowerModel()
 {
-   delete _dsent_link;
+   // The DSENT link models are shared, and owned by the registry
+}
+
+const DSENTElectricalLink*
+ElectricalLinkPowerModel::getDSENTLink(double frequency, double voltage, double link_length, UInt32 link_width)
+{
+   UnstructuredBuffer key_buf;
+   key_buf << frequency << voltage << link_length << link_width;
+   string key((const char*) key_buf.getBuffer(), key_buf.size());
+
+   ScopedLock sl(_dsent_link_registry.getLock());
+
+   DSENTElectricalLink* dsent_link = _dsent_link_registry.find(key);
+   if (dsent_link == NULL)
+   {
+      // DSENT expects link length to be in meters(m)
+      // DSENT expects link frequency to be in hertz (Hz)
+      dsent_link = new DSENTElectricalLink(frequency * 1e9, voltage,
+                                           link_length / 1000, link_width,
+                                           DSENTInterface::getSingleton());
+      _dsent_link_registry.insert(key, dsent_link);
+   }
+   return dsent_link;
 }
 
 void
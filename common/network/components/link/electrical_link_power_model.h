@@ -20,7 +20,10 @@ public:
    void updateDynamicEnergy(UInt32 num_flits);
 
 private:
-   // DSENT model for the electrical link
-   map<double, dsent_contrib::DSENTElectricalLink*> _dsent_link_map;
-   dsent_contrib::DSENTElectricalLink* _dsent_link;
+   // DSENT models for the electrical link at each voltage, shared with the links with the same parameters
+   map<double, const dsent_contrib::DSENTElectricalLink*> _dsent_link_map;
+   const dsent_contrib::DSENTElectricalLink* _dsent_link;
+
+   static const dsent_contrib::DSENTElectricalLink* getDSENTLink(double frequency, double voltage,
+                                                                 double link_length, UInt32 link_width);
 };
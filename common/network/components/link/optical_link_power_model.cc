@@ -2,6 +2,7 @@
 
 #include "optical_link_power_model.h"
 #include "dvfs_manager.h"
+#include "model_registry.h"
 #include "utils.h"
 #include "log.h"
 
@@ -25,6 +26,10 @@ OpticalLinkPowerModel::OpticalLinkPowerModel(OpticalLinkModel::LaserModes laser_
    else if (laser_modes.unicast)
       max_simultaneous_readers = 1;
  
+   // DSENT is not re-entrant, so the links are built under the lock of the
+   // power model registries (see ModelRegistryBase)
+   ScopedLock sl(ModelRegistryBase::getLock());
+
    const DVFSManager::DVFSLevels& dvfs_levels = DVFSManager::getDVFSLevels();
    for (DVFSManager::DVFSLevels::const_iterator it = dvfs_levels.begin(); it != dvfs_levels.end(); it++)
    {
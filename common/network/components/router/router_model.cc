@@ -4,6 +4,7 @@
 #include "utils.h"
 #include "queue_model_history_list.h"
 #include "queue_model_history_tree.h"
+#include "packetize.h"
 #include "log.h"
 #include "time_types.h"
 
@@ -48,6 +49,26 @@ RouterModel::~RouterModel()
    }
 }
 
+void
+RouterModel::checkpoint(UnstructuredBuffer& buffer)
+{
+   buffer << (UInt32) _contention_model_list.size();
+   for (UInt32 i = 0; i < _contention_model_list.size(); i++)
+      _contention_model_list[i]->checkpoint(buffer);
+}
+
+void
+RouterModel::restore(UnstructuredBuffer& buffer)
+{
+   UInt32 num_contention_models;
+   buffer >> num_contention_models;
+   LOG_ASSERT_ERROR(num_contention_models == _contention_model_list.size(),
+                    "%u router contention models in checkpoint, expected %u",
+                    num_contention_models, (UInt32) _contention_model_list.size());
+   for (UInt32 i = 0; i < _contention_model_list.size(); i++)
+      _contention_model_list[i]->restore(buffer);
+}
+
 void
 RouterModel::processPacket(const NetPacket& pkt, SInt32 output_port,
                            UInt64& zero_load_delay, UInt64& contention_delay)
@@ -11,6 +11,7 @@ using std::vector;
 
 class NetworkModel;
 class NetPacket;
+class UnstructuredBuffer;
 
 class RouterModel
 {
@@ -43,6 +44,10 @@ public:
    // Percent Analytical Model Used
    float getPercentAnalyticalModelsUsed(SInt32 output_port_start, SInt32 output_port_end = INVALID_PORT);
 
+   // Checkpoint of the contention models
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
+
    static const SInt32 OUTPUT_PORT_ALL = 0xbabecafe;
    static const SInt32 INVALID_PORT = 0xdeadbeef;
 
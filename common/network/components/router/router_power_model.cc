@@ -1,10 +1,15 @@
 #include <cmath>
 #include "router_power_model.h"
 #include "dvfs_manager.h"
+#include "model_registry.h"
+#include "packetize.h"
 #include "log.h"
 
 using namespace dsent_contrib;
 
+// DSENT router models shared by the routers with the same parameters
+static ModelRegistry<DSENTRouter> _dsent_router_registry;
+
 RouterPowerModel::RouterPowerModel(double frequency, double voltage, UInt32 num_input_ports, UInt32 num_output_ports,
                                    UInt32 num_flits_per_port_buffer, UInt32 flit_width)
    : _num_input_ports(num_input_ports)
@@ -17,14 +22,10 @@ RouterPowerModel::RouterPowerModel(double frequency, double voltage, UInt32 num_
       double current_voltage = (*it).first;
       double current_frequency = (*it).second;
 
-      // Create DSENT router (and) save for future use
-      // DSENT expects voltage in volts (V)
-      // DSENT expects frequency in hertz (Hz)
-      _dsent_router_map[current_voltage] =  new DSENTRouter(current_frequency * 1e9, current_voltage,
-                                                            num_input_ports, num_output_ports,
-                                                            1, 1,
-                                                            num_flits_per_port_buffer, flit_width,
-                                                            DSENTInterface::getSingleton());
+      // Get DSENT router (and) save for future use
+      _dsent_router_map[current_voltage] = getDSENTRouter(current_frequency, current_voltage,
+                                                          num_input_ports, num_output_ports,
+                                                          num_flits_per_port_buffer, flit_width);
    }
    
    // Initialize the current DSENT router model
@@ -36,7 +37,32 @@ RouterPowerModel::RouterPowerModel(double frequency, double voltage, UInt32 num_
 
 RouterPowerModel::~RouterPowerModel()
 {
-   delete _dsent_router;
+   // The DSENT router models are shared, and owned by the registry
+}
+
+const DSENTRouter*
+RouterPowerModel::getDSENTRouter(double frequency, double voltage, UInt32 num_input_ports, UInt32 num_output_ports,
+                                 UInt32 num_flits_per_port_buffer, UInt32 flit_width)
+{
+   UnstructuredBuffer key_buf;
+   key_buf << frequency << voltage << num_input_ports << num_output_ports << num_flits_per_port_buffer << flit_width;
+   string key((const char*) key_buf.getBuffer(), key_buf.size());
+
+   ScopedLock sl(_dsent_router_registry.getLock());
+
+   DSENTRouter* dsent_router = _dsent_router_registry.find(key);
+   if (dsent_router == NULL)
+   {
+      // DSENT expects voltage in volts (V)
+      // DSENT expects frequency in hertz (Hz)
+      dsent_router = new DSENTRouter(frequency * 1e9, voltage,
+                                     num_input_ports, num_output_ports,
+                                     1, 1,
+                                     num_flits_per_port_buffer, flit_width,
+                                     DSENTInterface::getSingleton());
+      _dsent_router_registry.insert(key, dsent_router);
+   }
+   return dsent_router;
 }
 
 void
@@ -38,8 +38,9 @@ private:
    UInt32 _num_input_ports;
    UInt32 _num_output_ports;
 
-   map<double, dsent_contrib::DSENTRouter*> _dsent_router_map;
-   dsent_contrib::DSENTRouter* _dsent_router;
+   // DSENT router models at each voltage, shared with the routers with the same parameters
+   map<double, const dsent_contrib::DSENTRouter*> _dsent_router_map;
+   const dsent_contrib::DSENTRouter* _dsent_router;
 
    // Energy counters
    double _total_dynamic_energy_buffer;
@@ -50,6 +51,10 @@ private:
    // Last energy compute time
    Time _last_energy_compute_time;
 
+   static const dsent_contrib::DSENTRouter* getDSENTRouter(double frequency, double voltage,
+                                                           UInt32 num_input_ports, UInt32 num_output_ports,
+                                                           UInt32 num_flits_per_port_buffer, UInt32 flit_width);
+
    void initializeEnergyCounters();
    double getStaticPower() const;
 
@@ -4,6 +4,7 @@
 #include <string>
 using namespace std;
 
+#include "lock.h"
 #include "queue_model.h"
 #include "network.h"
 #include "network_model.h"
@@ -65,7 +66,9 @@ private:
       STAR
    };
 
+   // Set once by the first tile to be built (tiles are built in parallel)
    static bool _initialized;
+   static Lock _initialized_lock;
    
    // ENet
    static SInt32 _enet_width;
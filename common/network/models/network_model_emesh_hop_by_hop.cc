@@ -7,8 +7,10 @@ using namespace std;
 #include "config.h"
 #include "utils.h"
 #include "packet_type.h"
+#include "packetize.h"
 
 bool NetworkModelEMeshHopByHop::_initialized = false;
+Lock NetworkModelEMeshHopByHop::_initialized_lock;
 SInt32 NetworkModelEMeshHopByHop::_mesh_width;
 SInt32 NetworkModelEMeshHopByHop::_mesh_height;
 bool NetworkModelEMeshHopByHop::_contention_model_enabled;
@@ -46,6 +48,7 @@ NetworkModelEMeshHopByHop::~NetworkModelEMeshHopByHop()
 void
 NetworkModelEMeshHopByHop::initializeEMeshTopologyParams()
 {
+   ScopedLock sl(_initialized_lock);
    if (_initialized)
       return;
    _initialized = true;
@@ -154,7 +157,7 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, queue<Hop> &next_ho
       UInt64 contention_delay = 0;
       _injection_router->processPacket(pkt, 0, zero_load_delay, contention_delay);
       
-      Hop hop(pkt, _tile_id, EMESH, Latency(0,_frequency), Latency(contention_delay,_frequency));
+      Hop hop(pkt, _tile_id, EMESH, Latency(0,_clock_domain), Latency(contention_delay,_clock_domain));
       next_hops.push(hop);
    }
 
@@ -215,7 +218,7 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, queue<Hop> &next_ho
          // Populate the next_hops queue
          for (list<NextDest>::iterator it = next_dest_list.begin(); it != next_dest_list.end(); it++)
          {
-            Hop hop(pkt, (*it)._tile_id, (*it)._node_type, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
+            Hop hop(pkt, (*it)._tile_id, (*it)._node_type, Latency(zero_load_delay,_clock_domain), Latency(contention_delay,_clock_domain));
             next_hops.push(hop);
          }
       }
@@ -250,7 +253,7 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, queue<Hop> &next_ho
          _mesh_link_list[next_dest._output_port]->processPacket(pkt, zero_load_delay);
 
          assert(next_dest._tile_id != INVALID_TILE_ID);
-         Hop hop(pkt, next_dest._tile_id, next_dest._node_type, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
+         Hop hop(pkt, next_dest._tile_id, next_dest._node_type, Latency(zero_load_delay,_clock_domain), Latency(contention_delay,_clock_domain));
          next_hops.push(hop);
       
       } // (pkt_receiver == NetPacket::BROADCAST)
@@ -263,6 +266,26 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, queue<Hop> &next_ho
    }
 }
 
+void
+NetworkModelEMeshHopByHop::checkpoint(UnstructuredBuffer& buffer)
+{
+   if (isSystemTile(_tile_id))
+      return;
+
+   _injection_router->checkpoint(buffer);
+   _mesh_router->checkpoint(buffer);
+}
+
+void
+NetworkModelEMeshHopByHop::restore(UnstructuredBuffer& buffer)
+{
+   if (isSystemTile(_tile_id))
+      return;
+
+   _injection_router->restore(buffer);
+   _mesh_router->restore(buffer);
+}
+
 void
 NetworkModelEMeshHopByHop::computePosition(tile_id_t tile_id, SInt32 &x, SInt32 &y)
 {
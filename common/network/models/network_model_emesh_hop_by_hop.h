@@ -9,6 +9,7 @@ using std::ostream;
 #include "network.h"
 #include "network_model.h"
 #include "fixed_types.h"
+#include "lock.h"
 #include "queue_model.h"
 #include "router_model.h"
 #include "electrical_link_model.h"
@@ -48,7 +49,9 @@ private:
    };
 
    // Fields
+   // Set once by the first tile to be built (tiles are built in parallel)
    static bool _initialized;
+   static Lock _initialized_lock;
    static SInt32 _mesh_width;
    static SInt32 _mesh_height;
 
@@ -65,6 +68,10 @@ private:
 
    // Routing Function
    void routePacket(const NetPacket &pkt, queue<Hop> &next_hops);
+
+   // Checkpoint of the contention models of the routers
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
   
    // DVFS 
    void setDVFS(double frequency, double voltage, const Time& curr_time);
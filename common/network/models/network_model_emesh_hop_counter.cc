@@ -148,7 +148,7 @@ NetworkModelEMeshHopCounter::routePacket(const NetPacket &pkt, queue<Hop> &next_
    computePosition(TILE_ID(pkt.receiver), dx, dy);
 
    UInt32 num_hops = computeDistance(sx, sy, dx, dy);
-   Latency latency = (isModelEnabled(pkt)) ? Latency(num_hops * _hop_latency,_frequency) : Latency(0,_frequency);
+   Latency latency = (isModelEnabled(pkt)) ? Latency(num_hops * _hop_latency,_clock_domain) : Latency(0,_clock_domain);
 
    updateDynamicEnergy(pkt, num_hops);
 
@@ -17,6 +17,6 @@ NetworkModelMagic::routePacket(const NetPacket &pkt, queue<Hop> &next_hops)
 {
    LOG_PRINT("Entering routePacket");
    // A latency of '1'
-   Hop hop(pkt, TILE_ID(pkt.receiver), RECEIVE_TILE, Latency(1,_frequency), Latency(0,_frequency));
+   Hop hop(pkt, TILE_ID(pkt.receiver), RECEIVE_TILE, Latency(1,_clock_domain), Latency(0,_clock_domain));
    next_hops.push(hop);
 }
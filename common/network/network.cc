@@ -1,5 +1,7 @@
 #include <cstring>
+#include <sstream>
 #include "transport.h"
+#include "packet_buffer.h"
 #include "tile.h"
 #include "core_model.h"
 #include "network.h"
@@ -9,6 +11,8 @@
 #include "network_model.h"
 #include "core_model.h"
 #include "statistics_manager.h"
+#include "statistics_registry.h"
+#include "packet_trace.h"
 #include "utils.h"
 #include "log.h"
 
@@ -20,6 +24,7 @@ ofstream* Network::_utilizationTraceFiles;
 
 Network::Network(Tile *tile)
       : _tile(tile)
+      , _netQueueSeqNum(0)
 {
    LOG_ASSERT_ERROR(sizeof(g_type_to_static_network_map) / sizeof(EStaticNetwork) == NUM_PACKET_TYPES,
                     "Static network type map has incorrect number of entries.");
@@ -48,11 +53,22 @@ Network::Network(Tile *tile)
                        "Cannot Enable Shared Memory Shortcut for (%i) processes", Config::getSingleton()->getProcessCount());
    }
 
+   // Packet trace for tools/network_replay
+   _packetTraceWriter = NULL;
+   if (Sim()->getCfg()->getBool("network/packet_trace", false))
+   {
+      ostringstream filename;
+      filename << "packet_trace_" << _tid << ".trc";
+      _packetTraceWriter = new PacketTraceWriter(Config::getSingleton()->formatOutputFileName(filename.str()), _tid);
+   }
+
    LOG_PRINT("Initialized Network.");
 }
 
 Network::~Network()
 {
+   delete _packetTraceWriter;
+
    for (SInt32 i = 0; i < NUM_STATIC_NETWORKS; i++)
       delete _models[i];
 
@@ -88,6 +104,36 @@ void Network::outputSummary(std::ostream &out, const Time& target_completion_tim
    }
 }
 
+void Network::registerStatistics(StatisticsRegistry* registry)
+{
+   for (UInt32 i = 0; i < NUM_STATIC_NETWORKS; i++)
+   {
+      if (i >= STATIC_NETWORK_SYSTEM)
+         break;
+      _models[i]->registerStatistics(registry);
+   }
+}
+
+void Network::checkpoint(UnstructuredBuffer& buffer)
+{
+   for (UInt32 i = 0; i < NUM_STATIC_NETWORKS; i++)
+   {
+      if (i >= STATIC_NETWORK_SYSTEM)
+         break;
+      _models[i]->__checkpoint(buffer);
+   }
+}
+
+void Network::restore(UnstructuredBuffer& buffer)
+{
+   for (UInt32 i = 0; i < NUM_STATIC_NETWORKS; i++)
+   {
+      if (i >= STATIC_NETWORK_SYSTEM)
+         break;
+      _models[i]->__restore(buffer);
+   }
+}
+
 // Polling function that performs background activities, such as
 // pulling from the physical transport layer and routing packets to
 // the appropriate queues.
@@ -98,7 +144,9 @@ void Network::netPullFromTransport()
    {
       LOG_PRINT("Entering netPullFromTransport");
 
-      NetPacket packet(_transport->recv());
+      // The packet payload points into the transport buffer (no copy)
+      Byte* buffer = _transport->recv();
+      NetPacket packet(buffer);
 
       LOG_PRINT("Pull packet : type %i, from (%i, %i), time %llu",
                 (SInt32)packet.type, packet.sender.tile_id, packet.sender.core_type, packet.time.toNanosec());
@@ -126,11 +174,8 @@ void Network::netPullFromTransport()
             assert(0 <= packet.sender.tile_id && packet.sender.tile_id < _numMod);
             assert(0 <= packet.type && packet.type < NUM_PACKET_TYPES);
 
+            // The payload is only valid for the duration of the callback
             callback(_callbackObjs[packet.type], packet);
-
-            // De-allocate packet payload
-            if (packet.length > 0)
-               delete [] (Byte*) packet.data;
          }
 
          // synchronous I/O support
@@ -141,12 +186,20 @@ void Network::netPullFromTransport()
                       packet.receiver.tile_id, packet.receiver.core_type,
                       _tile->getId(), packet.time.toNanosec());
 
+            // Callers of netRecv() own (and delete) the payload
+            if (packet.length > 0)
+            {
+               Byte* data_buffer = new Byte[packet.length];
+               memcpy(data_buffer, packet.data, packet.length);
+               packet.data = data_buffer;
+            }
+
             _netQueueLock.acquire();
-            _netQueue.push_back(packet);
+            enqueuePacket(packet);
             _netQueueLock.release();
-
-            _netQueueCond.broadcast();
          }
+
+         PacketBuffer::release(buffer);
       }
 
       else // Forward Packet
@@ -156,11 +209,9 @@ void Network::netPullFromTransport()
                    packet.receiver.tile_id, packet.receiver.core_type,
                    _tile->getId(), packet.time.toNanosec());
 
-         forwardPacket(packet);
-         
-         // De-allocate packet payload
-         if (packet.length > 0)
-            delete [] (Byte*) packet.data;
+         // Re-use the received buffer for the next hop
+         memcpy(buffer, &packet, sizeof(packet));
+         forwardBuffer(buffer);
       }
    }
    while (_transport->query());
@@ -181,7 +232,15 @@ SInt32 Network::netSend(NetPacket& packet)
              packet.type, packet.sender.tile_id, packet.sender.core_type,
              packet.receiver.tile_id, packet.receiver.core_type,
              _tile->getId(), packet.time.toNanosec());
-   
+
+   // Only the packets that update the user and memory network models are replayed
+   EStaticNetwork static_network = g_type_to_static_network_map[packet.type];
+   if ( _packetTraceWriter &&
+        ((static_network == STATIC_NETWORK_USER) || (static_network == STATIC_NETWORK_MEMORY)) &&
+        model->isModelEnabled(packet) )
+   {
+      _packetTraceWriter->write(packet, static_network, model->getModeledLength(packet));
+   }
 
    // Send packet as multiple packets if model has not broadcast capability and receiver is ALL
    if ( (TILE_ID(packet.receiver) == NetPacket::BROADCAST) && (!model->hasBroadcastCapability()) )
@@ -215,7 +274,13 @@ SInt32 Network::netSend(module_t module, NetPacket& packet)
 SInt32 Network::forwardPacket(const NetPacket& packet)
 {
    // Create a buffer suitable for forwarding
-   Byte* buffer = packet.makeBuffer();
+   forwardBuffer(packet.makeBuffer());
+
+   return packet.length;
+}
+
+void Network::forwardBuffer(Byte* buffer)
+{
    NetPacket* buf_pkt = (NetPacket*) buffer;
 
    LOG_ASSERT_ERROR((buf_pkt->type >= 0) && (buf_pkt->type < NUM_PACKET_TYPES),
@@ -252,127 +317,164 @@ SInt32 Network::forwardPacket(const NetPacket& packet)
                    hop._next_tile_id,
                    _tile->getId(), hop._time.toNanosec());
          
-         _transport->send(hop._next_tile_id, buffer, packet.bufferSize());
+         // Every hop carries its own header, so only the last hop can
+         // take the buffer itself; earlier hops (broadcast trees) get a copy
+         if (hop_queue.empty())
+         {
+            _transport->sendBuffer(hop._next_tile_id, buffer);
+            buffer = NULL;
+            buf_pkt = NULL;
+         }
+         else
+         {
+            _transport->sendBuffer(hop._next_tile_id, PacketBuffer::clone(buffer));
+         }
       }
    }
 
-   delete [] buffer;
+   PacketBuffer::release(buffer);
+}
 
-   return packet.length;
+// -- Receive queue
+
+bool NetQueueKey::operator<(const NetQueueKey& rhs) const
+{
+   if (receiver.tile_id != rhs.receiver.tile_id)
+      return receiver.tile_id < rhs.receiver.tile_id;
+   if (receiver.core_type != rhs.receiver.core_type)
+      return receiver.core_type < rhs.receiver.core_type;
+   if (type != rhs.type)
+      return type < rhs.type;
+   if (sender.tile_id != rhs.sender.tile_id)
+      return sender.tile_id < rhs.sender.tile_id;
+   return sender.core_type < rhs.sender.core_type;
 }
 
-// Stupid helper class to eliminate special cases for empty
-// sender/type vectors in a NetMatch
-class NetRecvIterator
+bool Network::isMatch(const NetMatch& match, core_id_t receiver, const NetPacket& packet)
 {
-   public:
-      NetRecvIterator(UInt32 i)
-            : _mode(INT)
-            , _max(i)
-            , _i(0)
-      {
-      }
-      NetRecvIterator(const std::vector<core_id_t> &v)
-            : _mode(SENDER_VECTOR)
-            , _senders(&v)
-            , _i(0)
-      {
-      }
-      NetRecvIterator(const std::vector<PacketType> &v)
-            : _mode(TYPE_VECTOR)
-            , _types(&v)
-            , _i(0)
-      {
-      }
+   // make sure that this core is the proper destination core for this tile
+   if (packet.receiver.tile_id != receiver.tile_id || packet.receiver.core_type != receiver.core_type)
+   {
+      if (packet.receiver.tile_id != NetPacket::BROADCAST)
+         return false;
+   }
 
-      inline UInt32 get()
+   bool sender_match = false;
+   if (match.senders.empty())
+   {
+      // Any tile, but only from its main core
+      sender_match = Tile::isMainCore(packet.sender);
+   }
+   else
+   {
+      for (UInt32 i = 0; i < match.senders.size() && !sender_match; i++)
       {
-         switch (_mode)
-         {
-         case INT:
-            return _i;
-         case TYPE_VECTOR:
-            return (UInt32)_types->at(_i);
-         default:
-            assert(false);
-            return (UInt32)-1;
-         };
+         sender_match = (packet.sender.tile_id == match.senders[i].tile_id) &&
+                        (packet.sender.core_type == match.senders[i].core_type);
       }
+   }
+   if (!sender_match)
+      return false;
 
-      inline core_id_t getId()
-      {
-         switch (_mode)
-         {
-         case INT:
-            return Tile::getMainCoreId(_i);
-         case SENDER_VECTOR:
-            return (core_id_t)_senders->at(_i);
-         default:
-            assert(false);
-            return INVALID_CORE_ID;
-         };
-      }
+   if (match.types.empty())
+      return true;
+   for (UInt32 i = 0; i < match.types.size(); i++)
+   {
+      if (packet.type == match.types[i])
+         return true;
+   }
+   return false;
+}
+
+void Network::enqueuePacket(const NetPacket& packet)
+{
+   NetQueueKey key(packet.receiver, packet.type, packet.sender);
+   if (packet.receiver.tile_id == NetPacket::BROADCAST)
+      key.receiver.core_type = 0;
+   _netQueue[key].push_back(NetQueueEntry(_netQueueSeqNum ++, packet));
+
+   // Only wake up the threads that are waiting for this packet
+   for (list<NetQueueWaiter*>::iterator it = _netQueueWaiters.begin(); it != _netQueueWaiters.end(); it++)
+   {
+      if (isMatch((*it)->match, (*it)->receiver, packet))
+         (*it)->cond.signal();
+   }
+}
+
+void Network::findOldestInBucket(const NetQueueKey& key, NetQueue::iterator& oldest)
+{
+   NetQueue::iterator it = _netQueue.find(key);
+   if (it == _netQueue.end())
+      return;
+   if ( (oldest == _netQueue.end()) ||
+        (it->second.front().seq_num < oldest->second.front().seq_num) )
+      oldest = it;
+}
 
-      inline Boolean done()
+void Network::findOldestForReceiver(const NetMatch& match, core_id_t receiver, NetQueue::iterator& oldest)
+{
+   // Buckets are never left empty, so only the bucket heads need to be compared
+   if (!match.senders.empty() && !match.types.empty())
+   {
+      for (UInt32 s = 0; s < match.senders.size(); s++)
+         for (UInt32 t = 0; t < match.types.size(); t++)
+            findOldestInBucket(NetQueueKey(receiver, match.types[t], match.senders[s]), oldest);
+   }
+   else if (!match.senders.empty())
+   {
+      for (UInt32 s = 0; s < match.senders.size(); s++)
+         for (SInt32 t = 0; t < NUM_PACKET_TYPES; t++)
+            findOldestInBucket(NetQueueKey(receiver, (PacketType) t, match.senders[s]), oldest);
+   }
+   else
+   {
+      // Any sender: walk the (receiver, type) ranges of non-empty buckets
+      SInt32 num_types = match.types.empty() ? 1 : match.types.size();
+      for (SInt32 t = 0; t < num_types; t++)
       {
-         switch (_mode)
+         PacketType first_type = match.types.empty() ? (PacketType) 0 : match.types[t];
+         NetQueue::iterator it = _netQueue.lower_bound(NetQueueKey(receiver, first_type, Tile::getMainCoreId(0)));
+         for ( ; it != _netQueue.end(); it++)
          {
-         case INT:
-            return _i >= _max;
-         case SENDER_VECTOR:
-            return _i >= _senders->size();
-         case TYPE_VECTOR:
-            return _i >= _types->size();
-         default:
-            assert(false);
-            return true;
-         };
+            const NetQueueKey& key = it->first;
+            if (key.receiver.tile_id != receiver.tile_id || key.receiver.core_type != receiver.core_type)
+               break;
+            if (!match.types.empty() && key.type != first_type)
+               break;
+
+            const NetPacket& packet = it->second.front().packet;
+            if (!isMatch(match, packet.receiver, packet))
+               continue;
+            if ( (oldest == _netQueue.end()) ||
+                 (it->second.front().seq_num < oldest->second.front().seq_num) )
+               oldest = it;
+         }
       }
+   }
+}
 
-      inline void next()
-      {
-         ++_i;
-      }
+bool Network::dequeuePacket(const NetMatch& match, core_id_t receiver, NetPacket& packet)
+{
+   NetQueue::iterator oldest = _netQueue.end();
 
-      inline void reset()
-      {
-         _i = 0;
-      }
+   findOldestForReceiver(match, receiver, oldest);
+   findOldestForReceiver(match, (core_id_t) {NetPacket::BROADCAST, 0}, oldest);
 
-   private:
-      enum
-      {
-         INT, SENDER_VECTOR, TYPE_VECTOR
-      } _mode;
+   if (oldest == _netQueue.end())
+      return false;
 
-      union
-      {
-         UInt32 _max;
-         const std::vector<core_id_t> *_senders;
-         const std::vector<PacketType> *_types;
-      };
+   packet = oldest->second.front().packet;
+   oldest->second.pop_front();
+   if (oldest->second.empty())
+      _netQueue.erase(oldest);
 
-      UInt32 _i;
-};
+   return true;
+}
 
 NetPacket Network::netRecv(const NetMatch &match)
 {
    LOG_PRINT("netRecv: Entering.");
 
-   // Track via iterator to minimize copying
-   NetQueue::iterator itr;
-   Boolean found;
-
-   found = false;
-
-   NetRecvIterator sender = match.senders.empty()
-                            ? NetRecvIterator(_numMod)
-                            : NetRecvIterator(match.senders);
-
-   NetRecvIterator type = match.types.empty()
-                          ? NetRecvIterator((UInt32)NUM_PACKET_TYPES)
-                          : NetRecvIterator(match.types);
-
    core_id_t receiver = match.receiver.tile_id == INVALID_TILE_ID 
                         ? _tile->getCore()->getId() 
                         : match.receiver;
@@ -382,63 +484,33 @@ NetPacket Network::netRecv(const NetMatch &match)
    Time start_time = _tile->getCore()->getModel()->getCurrTime();
    LOG_PRINT("netRecv: Start waiting at %llu", start_time.toNanosec());
 
+   NetPacket packet;
+   NetQueueWaiter waiter(match, receiver);
+
    _netQueueLock.acquire();
 
-   while (!found)
+   if (!dequeuePacket(match, receiver, packet))
    {
-      itr = _netQueue.end();
-
-      // check every entry in the queue
-      for (NetQueue::iterator i = _netQueue.begin();
-            (i != _netQueue.end()) && !found;
-            i++)
-      {
-         // make sure that this core is the proper destination core for this tile
-         if (i->receiver.tile_id != receiver.tile_id || i->receiver.core_type != receiver.core_type)
-         {
-            if (i->receiver.tile_id != NetPacket::BROADCAST)
-               continue;
-         }
-
-         // only find packets that match
-         for (sender.reset(); !sender.done() && !found; sender.next())
-         {
-            if (i->sender.tile_id != sender.getId().tile_id || i->sender.core_type != sender.getId().core_type)
-               continue;
-
-            for (type.reset(); !type.done() && !found; type.next())
-            {
-               if (i->type != (PacketType)type.get())
-                  continue;
-
-               found = true;
-               itr = i;
-            }
-         }
-      }
-
-      // go to sleep until a packet arrives if none have been found
-      if (!found)
+      // go to sleep until a matching packet arrives
+      list<NetQueueWaiter*>::iterator waiter_it = _netQueueWaiters.insert(_netQueueWaiters.end(), &waiter);
+      do
       {
          LOG_PRINT("netRecv: Packet match NOT found");
          LOG_PRINT("netRecv: Waiting on condition variable");
-         _netQueueCond.wait(_netQueueLock);
+         waiter.cond.wait(_netQueueLock);
          LOG_PRINT("netRecv: Woken up");
       }
+      while (!dequeuePacket(match, receiver, packet));
+      _netQueueWaiters.erase(waiter_it);
    }
 
-   LOG_PRINT("netRecv: Packet match found");
-
-   assert(found == true && itr != _netQueue.end());
-   assert(0 <= itr->sender.tile_id && itr->sender.tile_id < _numMod);
-   assert(0 <= itr->type && itr->type < NUM_PACKET_TYPES);
-   assert((itr->receiver.tile_id == _tile->getId()) || (itr->receiver.tile_id == NetPacket::BROADCAST));
+   _netQueueLock.release();
 
-   // Copy result
-   NetPacket packet = *itr;
-   _netQueue.erase(itr);
+   LOG_PRINT("netRecv: Packet match found");
 
-   _netQueueLock.release();
+   assert(0 <= packet.sender.tile_id && packet.sender.tile_id < _numMod);
+   assert(0 <= packet.type && packet.type < NUM_PACKET_TYPES);
+   assert((packet.receiver.tile_id == _tile->getId()) || (packet.receiver.tile_id == NetPacket::BROADCAST));
 
    LOG_PRINT("netRecv: Started waiting at %llu ns, Got packet at %llu ns", start_time.toNanosec(), packet.time.toNanosec());
 
@@ -684,19 +756,14 @@ NetPacket::NetPacket(Time t, PacketType ty, core_id_t s,
 {
 }
 
+// The payload is NOT copied; it stays valid only as long as the
+// buffer is held
 NetPacket::NetPacket(Byte *buffer)
 {
    memcpy(this, buffer, sizeof(*this));
 
    // LOG_ASSERT_ERROR(length > 0, "type(%u), sender(%i), receiver(%i), length(%u)", type, sender, receiver, length);
-   if (length > 0)
-   {
-      Byte* data_buffer = new Byte[length];
-      memcpy(data_buffer, buffer + sizeof(*this), length);
-      data = data_buffer;
-   }
-
-   delete [] buffer;
+   data = (length > 0) ? (buffer + sizeof(*this)) : NULL;
 }
 
 // This implementation is slightly wasteful because there is no need
@@ -712,7 +779,7 @@ Byte* NetPacket::makeBuffer() const
    UInt32 size = bufferSize();
    assert(size >= sizeof(NetPacket));
 
-   Byte *buffer = new Byte[size];
+   Byte *buffer = PacketBuffer::allocate(size);
 
    memcpy(buffer, this, sizeof(*this));
    memcpy(buffer + sizeof(*this), data, length);
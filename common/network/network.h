@@ -5,10 +5,14 @@
 #include <fstream>
 #include <vector>
 #include <list>
+#include <deque>
+#include <map>
 using std::ostream;
 using std::ofstream;
 using std::vector;
 using std::list;
+using std::deque;
+using std::map;
 
 #include "packet_type.h"
 #include "fixed_types.h"
@@ -21,6 +25,9 @@ using std::list;
 class Tile;
 class Network;
 class NetworkModel;
+class StatisticsRegistry;
+class UnstructuredBuffer;
+class PacketTraceWriter;
 
 // -- Network Packets -- //
 
@@ -49,13 +56,12 @@ public:
              SInt32 receiver, UInt32 length, const void *data);
 
    UInt32 bufferSize() const;
+   // Returns a PacketBuffer; release it with PacketBuffer::release()
    Byte *makeBuffer() const;
 
    static const SInt32 BROADCAST = 0xDEADBABE;
 };
 
-typedef list<NetPacket> NetQueue;
-
 // -- Network Matches -- //
 
 class NetMatch
@@ -67,6 +73,38 @@ public:
    core_id_t receiver;
 };
 
+// -- Network Receive Queue -- //
+
+// Packets waiting for netRecv() are kept in FIFO buckets indexed by
+// (receiver, type, sender), so a match only looks at the heads of the
+// buckets it can accept. The arrival sequence number picks the oldest
+// packet across buckets, as a single FIFO queue would.
+
+class NetQueueKey
+{
+public:
+   NetQueueKey(core_id_t receiver_, PacketType type_, core_id_t sender_)
+      : receiver(receiver_), type(type_), sender(sender_) {}
+
+   core_id_t receiver;
+   PacketType type;
+   core_id_t sender;
+
+   bool operator<(const NetQueueKey& rhs) const;
+};
+
+class NetQueueEntry
+{
+public:
+   NetQueueEntry(UInt64 seq_num_, const NetPacket& packet_)
+      : seq_num(seq_num_), packet(packet_) {}
+
+   UInt64 seq_num;
+   NetPacket packet;
+};
+
+typedef map<NetQueueKey, deque<NetQueueEntry> > NetQueue;
+
 // -- Network -- //
 
 // This is the managing class that interacts with the physical
@@ -91,6 +129,11 @@ public:
    void unregisterCallback(PacketType type);
 
    void outputSummary(ostream &out, const Time& target_completion_time) const;
+   void registerStatistics(StatisticsRegistry* registry);
+
+   // Checkpoint of the network models, for the checkpoint of the tile
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
 
    void netPullFromTransport();
 
@@ -132,9 +175,22 @@ private:
    SInt32 _tid;
    SInt32 _numMod;
 
+   // Threads blocked in netRecv(), woken only by packets they match
+   class NetQueueWaiter
+   {
+   public:
+      NetQueueWaiter(const NetMatch& match_, core_id_t receiver_)
+         : match(match_), receiver(receiver_) {}
+
+      const NetMatch& match;
+      core_id_t receiver;
+      ConditionVariable cond;
+   };
+
    NetQueue _netQueue;
+   UInt64 _netQueueSeqNum;
+   list<NetQueueWaiter*> _netQueueWaiters;
    Lock _netQueueLock;
-   ConditionVariable _netQueueCond;
    
    // -- Network Injection/Ejection Rate Trace -- //
    static bool* _utilizationTraceEnabled;
@@ -143,7 +199,18 @@ private:
    // Is shortCut available through shared memory
    bool _sharedMemoryShortcutEnabled;
 
+   // Headers of the packets sent by this tile ([network] packet_trace)
+   PacketTraceWriter* _packetTraceWriter;
+
    SInt32 forwardPacket(const NetPacket& packet);
+   void forwardBuffer(Byte* buffer);
+
+   // -- Receive queue (call with _netQueueLock held) -- //
+   void enqueuePacket(const NetPacket& packet);
+   bool dequeuePacket(const NetMatch& match, core_id_t receiver, NetPacket& packet);
+   void findOldestInBucket(const NetQueueKey& key, NetQueue::iterator& oldest);
+   void findOldestForReceiver(const NetMatch& match, core_id_t receiver, NetQueue::iterator& oldest);
+   static bool isMatch(const NetMatch& match, core_id_t receiver, const NetPacket& packet);
    
    // -- Network Injection/Ejection Rate Trace -- //
    static void computeTraceEnabledNetworks();
@@ -13,14 +13,17 @@ using namespace std;
 #include "config.h"
 #include "log.h"
 #include "dvfs_manager.h"
+#include "statistics_registry.h"
 
 NetworkModel::NetworkModel(Network *network, SInt32 network_id)
    : _frequency(0)
+   , _clock_domain(NULL)
    , _voltage(0)
    , _module(INVALID_MODULE)
    , _network(network)
    , _network_id(network_id)
    , _enabled(false)
+   , _replay(false)
 {
    assert(network_id >= 0 && network_id < NUM_STATIC_NETWORKS);
    _network_name = g_static_network_name_list[network_id];
@@ -139,14 +142,28 @@ NetworkModel::__processReceivedPacket(NetPacket& pkt)
    updateReceiveCounters(pkt);
 }
 
+void
+NetworkModel::__checkpoint(UnstructuredBuffer& buffer)
+{
+   ScopedLock sl(_lock);
+   checkpoint(buffer);
+}
+
+void
+NetworkModel::__restore(UnstructuredBuffer& buffer)
+{
+   ScopedLock sl(_lock);
+   restore(buffer);
+}
+
 void
 NetworkModel::processReceivedPacket(NetPacket& pkt)
 {
    // Add serialization latency due to finite link bandwidth
    UInt64 num_flits = computeNumFlits(getModeledLength(pkt));
 
-   pkt.time += Latency(num_flits,_frequency);
-   pkt.zero_load_delay += Latency(num_flits,_frequency);
+   pkt.time += Latency(num_flits,_clock_domain);
+   pkt.zero_load_delay += Latency(num_flits,_clock_domain);
 }
 
 void
@@ -172,7 +189,12 @@ bool
 NetworkModel::isModelEnabled(const NetPacket& pkt)
 {
    SInt32 network_id = getNetworkID();
-   if (network_id == STATIC_NETWORK_MEMORY)
+   if (_replay)
+   {
+      // Only modeled packets are replayed
+      return _enabled;
+   }
+   else if (network_id == STATIC_NETWORK_MEMORY)
    {
       return ( _enabled && (getNetwork()->getTile()->getMemoryManager()->isModeled(pkt.data)) );
    }
@@ -185,7 +207,11 @@ NetworkModel::isModelEnabled(const NetPacket& pkt)
 UInt32
 NetworkModel::getModeledLength(const NetPacket& pkt) // In bits
 {   
-   if (pkt.type == SHARED_MEM)
+   if (_replay)
+   {
+      return *((const UInt32*) pkt.data);
+   }
+   else if (pkt.type == SHARED_MEM)
    {
       // sender + receiver + size of shmem_msg
       // log2(core_id) for sender and receiver
@@ -315,6 +341,23 @@ NetworkModel::outputSummary(ostream& out, const Time& target_completion_time)
       DVFSManager::printAsynchronousMap(out, _module, _asynchronous_map);
 }
 
+void
+NetworkModel::registerStatistics(StatisticsRegistry* registry)
+{
+   string component = "network/" + _network_name;
+   registry->registerCounter(component, "packets_sent", &_total_packets_sent);
+   registry->registerCounter(component, "flits_sent", &_total_flits_sent);
+   registry->registerCounter(component, "bits_sent", &_total_bits_sent);
+   registry->registerCounter(component, "packets_broadcasted", &_total_packets_broadcasted);
+   registry->registerCounter(component, "flits_broadcasted", &_total_flits_broadcasted);
+   registry->registerCounter(component, "bits_broadcasted", &_total_bits_broadcasted);
+   registry->registerCounter(component, "packets_received", &_total_packets_received);
+   registry->registerCounter(component, "flits_received", &_total_flits_received);
+   registry->registerCounter(component, "bits_received", &_total_bits_received);
+   registry->registerCounter(component, "total_packet_latency", &_total_packet_latency);
+   registry->registerCounter(component, "total_contention_delay", &_total_contention_delay);
+}
+
 UInt32 
 NetworkModel::parseNetworkType(string str)
 {
@@ -485,6 +528,7 @@ void NetworkModel::initializeDVFS()
 
    int rc = DVFSManager::getInitialFrequencyAndVoltage(_module, _frequency, _voltage);
    LOG_ASSERT_ERROR(rc == 0, "Error setting initial voltage for frequency(%g)", _frequency);
+   _clock_domain = DVFSManager::getClockDomain(_frequency);
 
    // Asynchronous communication
    _synchronization_delay = Time(Latency(DVFSManager::getSynchronizationDelay(), _frequency));
@@ -519,6 +563,7 @@ NetworkModel::setDVFS(double frequency, voltage_option_t voltage_flag, const Tim
    if (rc==0)
    {
       _frequency = frequency;
+      _clock_domain = DVFSManager::getClockDomain(_frequency);
       setDVFS(_frequency, _voltage, curr_time);
       _synchronization_delay = Time(Latency(DVFSManager::getSynchronizationDelay(), _frequency));
    }
@@ -3,6 +3,8 @@
 
 class NetPacket;
 class Network;
+class StatisticsRegistry;
+class UnstructuredBuffer;
 
 #include <vector>
 #include <queue>
@@ -71,6 +73,7 @@ public:
    void __processReceivedPacket(NetPacket &pkt);
 
    virtual void outputSummary(std::ostream &out, const Time& target_completion_time);
+   virtual void registerStatistics(StatisticsRegistry* registry);
 
    // Energy
    virtual void computeEnergy(const Time& curr_time) { }
@@ -87,6 +90,14 @@ public:
    void enable()                 { _enabled = true;   }
    void disable()                { _enabled = false;  }
 
+   // Offline replay (tools/network_replay): the data of every packet is
+   // its modeled length (UInt32, in bits) instead of the message itself
+   void enableReplay()           { _replay = true;    }
+
+   // Checkpoint of the contention state of the model
+   void __checkpoint(UnstructuredBuffer& buffer);
+   void __restore(UnstructuredBuffer& buffer);
+
    static NetworkModel *createModel(Network* network, SInt32 network_id, UInt32 model_type);
    static UInt32 parseNetworkType(string str);
 
@@ -128,6 +139,7 @@ protected:
 
    // Frequency
    double _frequency;
+   const ClockDomain* _clock_domain;
    // Voltage
    double _voltage;
    // Flit Width
@@ -179,6 +191,7 @@ private:
    Time _total_contention_delay;
 
    bool _enabled;
+   bool _replay;
    
    // For getting a trace of network injection/ejection rate
    UInt64 _total_flits_sent_in_current_interval;
@@ -187,6 +200,10 @@ private:
 
    virtual void routePacket(const NetPacket &pkt, queue<Hop> &next_hops) = 0;
    virtual void processReceivedPacket(NetPacket &pkt);
+
+   // Checkpoint (nothing to save by default)
+   virtual void checkpoint(UnstructuredBuffer& buffer) {}
+   virtual void restore(UnstructuredBuffer& buffer) {}
  
    // DVFS 
    void initializeDVFS();
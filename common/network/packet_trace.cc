@@ -0,0 +1,70 @@
+#include "packet_trace.h"
+#include "network.h"
+#include "log.h"
+
+using namespace std;
+
+bool
+PacketTrace::read(const string& filename, vector<Record>& records)
+{
+   FILE* file = fopen(filename.c_str(), "rb");
+   if (!file)
+      return false;
+
+   Header header;
+   __attribute__((unused)) size_t num_read = fread(&header, sizeof(header), 1, file);
+   LOG_ASSERT_ERROR(num_read == 1 &&
+                    header.magic == MAGIC && header.version == VERSION,
+                    "%s is not a packet trace file (version %u)", filename.c_str(), VERSION);
+
+   Record record;
+   while (fread(&record, sizeof(record), 1, file) == 1)
+      records.push_back(record);
+
+   fclose(file);
+   return true;
+}
+
+PacketTraceWriter::PacketTraceWriter(const string& filename, tile_id_t tile_id)
+{
+   _file = fopen(filename.c_str(), "wb");
+   LOG_ASSERT_ERROR(_file, "Could not open packet trace file(%s)", filename.c_str());
+
+   PacketTrace::Header header = { PacketTrace::MAGIC, PacketTrace::VERSION, tile_id, 0 };
+   fwrite(&header, sizeof(header), 1, _file);
+
+   _buffer.reserve(BUFFER_SIZE);
+}
+
+PacketTraceWriter::~PacketTraceWriter()
+{
+   flush();
+   fclose(_file);
+}
+
+void
+PacketTraceWriter::write(const NetPacket& packet, UInt32 static_network, UInt32 modeled_length)
+{
+   PacketTrace::Record record;
+   record.time = packet.time.toPicosec();
+   record.sender = packet.sender;
+   record.receiver = packet.receiver;
+   record.type = packet.type;
+   record.static_network = static_network;
+   record.length = packet.length;
+   record.modeled_length = modeled_length;
+
+   ScopedLock sl(_lock);
+   _buffer.push_back(record);
+   if (_buffer.size() >= BUFFER_SIZE)
+      flush();
+}
+
+void
+PacketTraceWriter::flush()
+{
+   if (_buffer.empty())
+      return;
+   fwrite(&_buffer[0], sizeof(PacketTrace::Record), _buffer.size(), _file);
+   _buffer.clear();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "fixed_types.h"
+#include "lock.h"
+
+class NetPacket;
+
+// Headers of the packets a tile sends on the user and memory networks while
+// the models are enabled ([network] packet_trace = true), one file per tile.
+// tools/network_replay routes them through the network models alone.
+//
+// The file is a Header followed by fixed-size Records in the order the
+// packets were sent. Broadcasts are recorded once, before they are split for
+// the models that cannot broadcast. The modeled length is recorded as the
+// model computed it, so that memory packets can be replayed without the
+// messages of the memory manager.
+class PacketTrace
+{
+public:
+   static const UInt32 MAGIC = 0x50525447;   // "GTRP"
+   static const UInt32 VERSION = 1;
+
+   struct Header
+   {
+      UInt32 magic;
+      UInt32 version;
+      tile_id_t tile_id;
+      UInt32 reserved;
+   };
+
+   struct Record
+   {
+      UInt64 time;               // In picoseconds
+      core_id_t sender;
+      core_id_t receiver;
+      UInt32 type;               // PacketType
+      UInt32 static_network;     // EStaticNetwork
+      UInt32 length;             // Payload (in bytes)
+      UInt32 modeled_length;     // As given by NetworkModel::getModeledLength() (in bits)
+   };
+
+   // Appends the records of a trace file; returns false if there is none
+   static bool read(const std::string& filename, std::vector<Record>& records);
+};
+
+class PacketTraceWriter
+{
+public:
+   PacketTraceWriter(const std::string& filename, tile_id_t tile_id);
+   ~PacketTraceWriter();
+
+   void write(const NetPacket& packet, UInt32 static_network, UInt32 modeled_length);
+
+private:
+   static const UInt32 BUFFER_SIZE = 4096;   // In records
+
+   FILE* _file;
+   std::vector<PacketTrace::Record> _buffer;
+   Lock _lock;
+
+   void flush();
+};
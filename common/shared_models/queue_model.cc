@@ -4,6 +4,7 @@
 #include "queue_model_basic.h"
 #include "queue_model_history_list.h"
 #include "queue_model_history_tree.h"
+#include "packetize.h"
 #include "log.h"
 
 QueueModel::QueueModel(Type type)
@@ -60,3 +61,17 @@ QueueModel::getQueueUtilization()
    UInt64 total_cycles = _last_request_time;
    return (total_cycles > 0) ? (((float) _total_utilized_cycles) / total_cycles) : 0.0;
 }
+
+void
+QueueModel::checkpoint(UnstructuredBuffer& buffer)
+{
+   buffer << (SInt32) _type;
+}
+
+void
+QueueModel::restore(UnstructuredBuffer& buffer)
+{
+   SInt32 type;
+   buffer >> type;
+   LOG_ASSERT_ERROR(type == (SInt32) _type, "Queue model type(%i) in checkpoint, expected(%i)", type, _type);
+}
@@ -4,6 +4,8 @@
 
 #include "fixed_types.h"
 
+class UnstructuredBuffer;
+
 class QueueModel
 {
 public:
@@ -25,6 +27,11 @@ public:
 
    static QueueModel* create(std::string model_type, UInt64 min_processing_time);
 
+   // State of the queue (not the counters), for the checkpoint of the tile.
+   // Derived models add their own state after the type.
+   virtual void checkpoint(UnstructuredBuffer& buffer);
+   virtual void restore(UnstructuredBuffer& buffer);
+
 protected:
    void updateQueueUtilizationCounters(UInt64 request_time, UInt64 processing_time, UInt64 queue_delay);
 
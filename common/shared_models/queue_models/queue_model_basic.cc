@@ -2,6 +2,7 @@
 #include "config.h"
 #include "queue_model_basic.h"
 #include "utils.h"
+#include "packetize.h"
 #include "log.h"
 
 QueueModelBasic::QueueModelBasic()
@@ -59,3 +60,18 @@ QueueModelBasic::computeQueueDelay(UInt64 pkt_time, UInt64 processing_time, tile
 
    return queue_delay;
 }
+
+void
+QueueModelBasic::checkpoint(UnstructuredBuffer& buffer)
+{
+   // The moving average starts again from the first request
+   QueueModel::checkpoint(buffer);
+   buffer << _queue_time;
+}
+
+void
+QueueModelBasic::restore(UnstructuredBuffer& buffer)
+{
+   QueueModel::restore(buffer);
+   buffer >> _queue_time;
+}
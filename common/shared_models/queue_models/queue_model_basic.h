@@ -12,6 +12,9 @@ public:
 
    UInt64 computeQueueDelay(UInt64 pkt_time, UInt64 processing_time, tile_id_t requester = INVALID_TILE_ID);
 
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
+
 private:
    UInt64 _queue_time;
    MovingAverage<UInt64>* _moving_average;
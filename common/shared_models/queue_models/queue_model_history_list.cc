@@ -5,6 +5,7 @@
 #include "tile_manager.h"
 #include "config.h"
 #include "queue_model_history_list.h"
+#include "packetize.h"
 #include "log.h"
 
 QueueModelHistoryList::QueueModelHistoryList(UInt64 min_processing_time)
@@ -25,7 +26,8 @@ QueueModelHistoryList::QueueModelHistoryList(UInt64 min_processing_time)
       LOG_PRINT_ERROR("Could not read parameters from cfg");
    }
    
-   _free_interval_list.push_back(std::make_pair<UInt64,UInt64>(0, UINT64_MAX));
+   _free_interval_list = new FreeIntervalList(_max_free_interval_list_size);
+   _free_interval_list->insert(0, std::make_pair<UInt64,UInt64>(0, UINT64_MAX));
    _queue_model_m_g_1 = new QueueModelMG1();
 
    _total_requests_using_analytical_model = 0;
@@ -34,12 +36,13 @@ QueueModelHistoryList::QueueModelHistoryList(UInt64 min_processing_time)
 QueueModelHistoryList::~QueueModelHistoryList()
 {
    delete _queue_model_m_g_1;
+   delete _free_interval_list;
 }
 
 UInt64 
 QueueModelHistoryList::computeQueueDelay(UInt64 pkt_time, UInt64 processing_time, tile_id_t requester)
 {
-   LOG_ASSERT_ERROR(_free_interval_list.size() >= 1,
+   LOG_ASSERT_ERROR(_free_interval_list->size() >= 1,
          "Free Interval list size < 1");
  
    UInt64 queue_delay;
@@ -47,7 +50,7 @@ QueueModelHistoryList::computeQueueDelay(UInt64 pkt_time, UInt64 processing_time
    // Check if it is an old packet
    // If yes, use analytical model
    // If not, use the history list based queue model
-   std::pair<UInt64,UInt64> oldest_interval = _free_interval_list.front();
+   std::pair<UInt64,UInt64> oldest_interval = _free_interval_list->front();
    if (_analytical_model_enabled && ((pkt_time + processing_time) < oldest_interval.first))
    {
       // Increment the number of requests that use the analytical model
@@ -70,27 +73,33 @@ QueueModelHistoryList::computeQueueDelay(UInt64 pkt_time, UInt64 processing_time
 UInt64
 QueueModelHistoryList::computeUsingHistoryList(UInt64 pkt_time, UInt64 processing_time)
 {
-   LOG_ASSERT_ERROR(_free_interval_list.size() <= _max_free_interval_list_size,
-         "Free Interval list size(%u) > %u", _free_interval_list.size(), _max_free_interval_list_size);
+   LOG_ASSERT_ERROR(_free_interval_list->size() <= _max_free_interval_list_size,
+         "Free Interval list size(%u) > %u", _free_interval_list->size(), _max_free_interval_list_size);
    UInt64 queue_delay = 0;
- 
-   FreeIntervalList::iterator curr_it;
-   for (curr_it = _free_interval_list.begin(); curr_it != _free_interval_list.end(); curr_it ++)
+
+   // Skip the intervals that cannot be used by this packet. With
+   // interleaving, the packet may also use up the tails of intervals
+   // that are too short to hold it.
+   UInt32 index = _interleaving_enabled ?
+                  _free_interval_list->lowerBound(pkt_time) :
+                  _free_interval_list->findFirstFit(pkt_time, processing_time);
+
+   while (index < _free_interval_list->size())
    {
-      std::pair<UInt64,UInt64> interval = (*curr_it);
+      std::pair<UInt64,UInt64> interval = (*_free_interval_list)[index];
 
       if ((pkt_time >= interval.first) && ((pkt_time + processing_time) <= interval.second))
       {
          // No additional queue delay
          // Adjust the data structure accordingly
-         curr_it = _free_interval_list.erase(curr_it);
+         _free_interval_list->erase(index);
          if ((pkt_time - interval.first) >= _min_processing_time)
          {
-            _free_interval_list.insert(curr_it, std::make_pair<UInt64,UInt64>(interval.first, pkt_time));
+            _free_interval_list->insert(index++, std::make_pair<UInt64,UInt64>(interval.first, pkt_time));
          }
          if ((interval.second - (pkt_time + processing_time)) >= _min_processing_time)
          {
-            _free_interval_list.insert(curr_it, std::make_pair<UInt64,UInt64>(pkt_time + processing_time, interval.second));
+            _free_interval_list->insert(index, std::make_pair<UInt64,UInt64>(pkt_time + processing_time, interval.second));
          }
          break;
       }
@@ -99,10 +108,10 @@ QueueModelHistoryList::computeUsingHistoryList(UInt64 pkt_time, UInt64 processin
          // Add additional queue delay
          queue_delay += (interval.first - pkt_time);
          // Adjust the data structure accordingly
-         curr_it = _free_interval_list.erase(curr_it);
+         _free_interval_list->erase(index);
          if ((interval.second - (interval.first + processing_time)) >= _min_processing_time)
          {
-            _free_interval_list.insert(curr_it, std::make_pair<UInt64,UInt64>(interval.first + processing_time, interval.second));
+            _free_interval_list->insert(index, std::make_pair<UInt64,UInt64>(interval.first + processing_time, interval.second));
          }
          break;
       }
@@ -110,37 +119,54 @@ QueueModelHistoryList::computeUsingHistoryList(UInt64 pkt_time, UInt64 processin
       {
          if ((pkt_time >= interval.first) && (pkt_time < interval.second))
          {
-            curr_it = _free_interval_list.erase(curr_it);
+            _free_interval_list->erase(index);
             if ((pkt_time - interval.first) >= _min_processing_time)
             {
-               _free_interval_list.insert(curr_it, std::make_pair<UInt64,UInt64>(interval.first, pkt_time));
+               _free_interval_list->insert(index++, std::make_pair<UInt64,UInt64>(interval.first, pkt_time));
             }
-            curr_it --;
             
             // Adjust times
             pkt_time = interval.second;
             processing_time -= (interval.second - pkt_time);
+            continue;
          }
          else if (pkt_time < interval.first)
          {
-            curr_it = _free_interval_list.erase(curr_it);
-            curr_it --;
+            _free_interval_list->erase(index);
             // Add additional queue delay
             queue_delay += (interval.first - pkt_time);
             
             // Adjust times
             pkt_time = interval.second;
             processing_time -= (interval.second - interval.first);
+            continue;
          }
       }
+      index ++;
    }
 
-   if (_free_interval_list.size() > _max_free_interval_list_size)
+   if (_free_interval_list->size() > _max_free_interval_list_size)
    {
-      _free_interval_list.erase(_free_interval_list.begin());
+      _free_interval_list->erase(0);
    }
   
    LOG_PRINT("HistoryList: pkt_time(%llu), processing_time(%llu), queue_delay(%llu)", pkt_time, processing_time, queue_delay);
 
    return queue_delay;
 }
+
+void
+QueueModelHistoryList::checkpoint(UnstructuredBuffer& buffer)
+{
+   QueueModel::checkpoint(buffer);
+   _free_interval_list->checkpoint(buffer);
+   _queue_model_m_g_1->checkpoint(buffer);
+}
+
+void
+QueueModelHistoryList::restore(UnstructuredBuffer& buffer)
+{
+   QueueModel::restore(buffer);
+   _free_interval_list->restore(buffer);
+   _queue_model_m_g_1->restore(buffer);
+}
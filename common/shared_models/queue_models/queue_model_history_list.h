@@ -1,10 +1,9 @@
 #ifndef __QUEUE_MODEL_HISTORY_LIST_H__
 #define __QUEUE_MODEL_HISTORY_LIST_H__
 
-#include <list>
-
 #include "queue_model.h"
 #include "queue_model_m_g_1.h"
+#include "free_interval_list.h"
 #include "fixed_types.h"
 
 class QueueModelHistoryList : public QueueModel
@@ -16,11 +15,12 @@ public:
    UInt64 computeQueueDelay(UInt64 pkt_time, UInt64 processing_time, tile_id_t requester = INVALID_TILE_ID);
    UInt64 getTotalRequestsUsingAnalyticalModel() { return _total_requests_using_analytical_model; }
 
-private:
-   typedef std::list<std::pair<UInt64,UInt64> > FreeIntervalList;
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
 
+private:
    QueueModelMG1* _queue_model_m_g_1;
-   FreeIntervalList _free_interval_list;
+   FreeIntervalList* _free_interval_list;
    
    // Is analytical model used ?
    bool _analytical_model_enabled;
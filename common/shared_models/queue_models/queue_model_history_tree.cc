@@ -6,9 +6,10 @@
 #include "tile_manager.h"
 #include "config.h"
 #include "queue_model_history_tree.h"
+#include "packetize.h"
 #include "log.h"
 
-#define PAIR(x_,y_)  (make_pair<UInt64,UInt64>(x_,y_))
+#define PAIR(x_,y_)  (std::make_pair<UInt64,UInt64>(x_,y_))
 
 QueueModelHistoryTree::QueueModelHistoryTree(UInt64 min_processing_time)
    : QueueModel(HISTORY_TREE)
@@ -24,10 +25,8 @@ QueueModelHistoryTree::QueueModelHistoryTree(UInt64 min_processing_time)
       LOG_PRINT_ERROR("Could not read queue_model/history_tree parameters from the cfg file");
    }
   
-   allocateMemory();
-
-   IntervalTree::Node* start_node = allocateNode(PAIR(0,UINT64_MAX)); 
-   _interval_tree = new IntervalTree(start_node);
+   _free_interval_list = new FreeIntervalList(_max_free_interval_size);
+   _free_interval_list->insert(0, PAIR(0,UINT64_MAX));
    _queue_model_m_g_1 = new QueueModelMG1();
 
    _total_requests_using_analytical_model = 0;
@@ -36,8 +35,7 @@ QueueModelHistoryTree::QueueModelHistoryTree(UInt64 min_processing_time)
 QueueModelHistoryTree::~QueueModelHistoryTree()
 {
    delete _queue_model_m_g_1;
-   delete _interval_tree;
-   releaseMemory();
+   delete _free_interval_list;
 }
 
 UInt64
@@ -47,68 +45,64 @@ QueueModelHistoryTree::computeQueueDelay(UInt64 pkt_time, UInt64 processing_time
   
    UInt64 queue_delay = UINT64_MAX;
 
-   IntervalTree::Node* min_node = _interval_tree->search(PAIR(0,1));
-   // Prune the Tree when it grows too large
-   if (_interval_tree->size() >= ((UInt32) _max_free_interval_size))
+   // Prune the history when it grows too large
+   if (_free_interval_list->size() >= ((UInt32) _max_free_interval_size))
    {
-      // Remove the node with the minimum key
-      releaseNode(_interval_tree->remove(min_node));
+      // Remove the oldest interval
+      _free_interval_list->erase(0);
    }
   
-   // Check if we need to use Analytical Model - Get the min_node again 
-   min_node = _interval_tree->search(PAIR(0,1)); 
-   if ( _analytical_model_enabled && (min_node->interval.first > (pkt_time + processing_time)) )
+   // Check if we need to use Analytical Model
+   if ( _analytical_model_enabled && (_free_interval_list->front().first > (pkt_time + processing_time)) )
    {
       _total_requests_using_analytical_model ++;
       queue_delay = _queue_model_m_g_1->computeQueueDelay(pkt_time, processing_time, requester);
    }
    else
    {
-      IntervalTree::Node* node = _interval_tree->search(PAIR(pkt_time, pkt_time + processing_time));
-      if (!node)
+      UInt32 index = _free_interval_list->findFirstFit(pkt_time, processing_time);
+      if (index == _free_interval_list->size())
       {
-         _interval_tree->inOrderTraversal();
-         LOG_PRINT_ERROR("node = (NULL)");
+         _free_interval_list->print();
+         LOG_PRINT_ERROR("No free interval found");
       }
 
-      assert((pkt_time + processing_time) <= node->interval.second);
+      std::pair<UInt64,UInt64> interval = (*_free_interval_list)[index];
+      assert((pkt_time + processing_time) <= interval.second);
 
-      if (pkt_time >= node->interval.first)
+      if (pkt_time >= interval.first)
       {
          queue_delay = 0;
-         if ((pkt_time - node->interval.first) >= _min_processing_time)
+         if ((pkt_time - interval.first) >= _min_processing_time)
          {
-            if ((node->interval.second - (pkt_time + processing_time)) >= _min_processing_time)
+            if ((interval.second - (pkt_time + processing_time)) >= _min_processing_time)
             {
-               IntervalTree::Node* next_node = allocateNode(PAIR(pkt_time + processing_time, node->interval.second));
-               _interval_tree->insert(next_node);
+               _free_interval_list->insert(index + 1, PAIR(pkt_time + processing_time, interval.second));
             }
-            node->interval.second = pkt_time;
+            _free_interval_list->set(index, PAIR(interval.first, pkt_time));
          }
-         else // ((pkt_time - node->interval.first) < _min_processing_time)
+         else // ((pkt_time - interval.first) < _min_processing_time)
          {
-            if ((node->interval.second - (pkt_time + processing_time)) >= _min_processing_time)
+            if ((interval.second - (pkt_time + processing_time)) >= _min_processing_time)
             {
-               node->interval.first = pkt_time + processing_time;
-               node->key = node->interval.first;
+               _free_interval_list->set(index, PAIR(pkt_time + processing_time, interval.second));
             }
             else
             {
-               releaseNode(_interval_tree->remove(node));
+               _free_interval_list->erase(index);
             }
          }
       }
-      else // (pkt_time < node->interval.first)
+      else // (pkt_time < interval.first)
       {
-         queue_delay = node->interval.first - pkt_time;
-         if ((node->interval.second - (node->interval.first + processing_time)) >= _min_processing_time)
+         queue_delay = interval.first - pkt_time;
+         if ((interval.second - (interval.first + processing_time)) >= _min_processing_time)
          {
-            node->interval.first = node->interval.first + processing_time;
-            node->key = node->interval.first;
+            _free_interval_list->set(index, PAIR(interval.first + processing_time, interval.second));
          }
          else
          {
-            releaseNode(_interval_tree->remove(node));
+            _free_interval_list->erase(index);
          }
       }
    }
@@ -126,45 +120,17 @@ QueueModelHistoryTree::computeQueueDelay(UInt64 pkt_time, UInt64 processing_time
 }
 
 void
-QueueModelHistoryTree::allocateMemory()
+QueueModelHistoryTree::checkpoint(UnstructuredBuffer& buffer)
 {
-   _memory_blocks = new IntervalTree::Node[_max_free_interval_size];
-   _free_memory_block_list = new SInt32[_max_free_interval_size];
-   for (SInt32 i = 0; i < _max_free_interval_size; i++)
-      _free_memory_block_list[i] = i;
-   _free_memory_block_list_tail = _max_free_interval_size - 1;
+   QueueModel::checkpoint(buffer);
+   _free_interval_list->checkpoint(buffer);
+   _queue_model_m_g_1->checkpoint(buffer);
 }
 
 void
-QueueModelHistoryTree::releaseMemory()
-{
-   delete [] _free_memory_block_list;
-   delete [] _memory_blocks;
-}
-
-IntervalTree::Node*
-QueueModelHistoryTree::allocateNode(pair<UInt64,UInt64> interval)
+QueueModelHistoryTree::restore(UnstructuredBuffer& buffer)
 {
-   LOG_ASSERT_ERROR(_free_memory_block_list_tail >= 0,
-      "_free_memory_block_list_tail(%i)", _free_memory_block_list_tail);
-   
-   SInt32 free_index = _free_memory_block_list[_free_memory_block_list_tail];
-   IntervalTree::Node* node = &_memory_blocks[free_index];
-   node->initialize(PAIR(interval.first, interval.second));
-   _free_memory_block_list_tail --;
-
-   return node;
-}
-
-void
-QueueModelHistoryTree::releaseNode(IntervalTree::Node* node)
-{
-   SInt32 index = (SInt32) (node - _memory_blocks);
-   // LOG_PRINT_WARNING("index(%i)", index);
-   assert((index >= 0) && (index < _max_free_interval_size));
-
-   _free_memory_block_list_tail ++;
-   LOG_ASSERT_ERROR(_free_memory_block_list_tail < _max_free_interval_size, \
-         "_free_memory_block_list_tail(%i)", _free_memory_block_list_tail);
-   _free_memory_block_list[_free_memory_block_list_tail] = index;
+   QueueModel::restore(buffer);
+   _free_interval_list->restore(buffer);
+   _queue_model_m_g_1->restore(buffer);
 }
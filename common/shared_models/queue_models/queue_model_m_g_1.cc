@@ -2,6 +2,7 @@
 
 #include "queue_model_m_g_1.h"
 #include "utils.h"
+#include "packetize.h"
 #include "log.h"
 
 QueueModelMG1::QueueModelMG1():
@@ -54,3 +55,15 @@ QueueModelMG1::updateQueue(UInt64 pkt_time, UInt64 service_time, UInt64 waiting_
    _num_arrivals ++;
    _newest_arrival_time = getMax<UInt64>(_newest_arrival_time, pkt_time + waiting_time_queue + service_time);
 }
+
+void
+QueueModelMG1::checkpoint(UnstructuredBuffer& buffer)
+{
+   buffer << _sigma_service_time_square << _sigma_service_time << _num_arrivals << _newest_arrival_time;
+}
+
+void
+QueueModelMG1::restore(UnstructuredBuffer& buffer)
+{
+   buffer >> _sigma_service_time_square >> _sigma_service_time >> _num_arrivals >> _newest_arrival_time;
+}
@@ -2,6 +2,8 @@
 
 #include "fixed_types.h"
 
+class UnstructuredBuffer;
+
 class QueueModelMG1
 {
 public:
@@ -11,6 +13,9 @@ public:
    UInt64 computeQueueDelay(UInt64 pkt_time, UInt64 service_time, tile_id_t requester = INVALID_TILE_ID);
    void updateQueue(UInt64 pkt_time, UInt64 service_time, UInt64 waiting_time_queue);
 
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
+
 private:
    // Service Time distribution Parameters
    double _sigma_service_time_square;
@@ -0,0 +1,236 @@
+#include <sstream>
+
+#include "checkpoint.h"
+#include "simulator.h"
+#include "tile_manager.h"
+#include "tile.h"
+#include "mcp.h"
+#include "log.h"
+
+using namespace std;
+
+bool Checkpoint::m_initialized = false;
+bool Checkpoint::m_save = false;
+string Checkpoint::m_restore_directory;
+UInt32 Checkpoint::m_enable_count = 0;
+UInt32 Checkpoint::m_num_enables = 0;
+bool Checkpoint::m_models_enabled = false;
+bool Checkpoint::m_processed = false;
+
+void
+Checkpoint::initialize()
+{
+   if (m_initialized)
+      return;
+   m_initialized = true;
+
+   m_save = Sim()->getCfg()->getBool("checkpoint/save", false);
+   m_restore_directory = Sim()->getCfg()->getString("checkpoint/restore", "");
+   m_enable_count = Sim()->getCfg()->getInt("checkpoint/enable_count", 0);
+   if (!isEnabled())
+      return;
+
+   LOG_ASSERT_ERROR(!m_save || (m_restore_directory == ""), "[checkpoint] save and restore are exclusive");
+   // In full mode, the application's current values are in the simulated
+   // caches and DRAM, and restoring the saved data over them would corrupt it
+   LOG_ASSERT_ERROR(Config::getSingleton()->getSimulationMode() == Config::LITE,
+                    "[checkpoint] is only supported in lite mode (--general/mode=lite)");
+}
+
+bool
+Checkpoint::isEnabled()
+{
+   initialize();
+   return m_save || (m_restore_directory != "");
+}
+
+bool
+Checkpoint::processModelsEnabled()
+{
+   if (!isEnabled() || m_processed)
+      return true;
+
+   m_models_enabled = true;
+   m_num_enables++;
+   if (m_num_enables == m_enable_count)
+   {
+      saveOrRestore();
+      return true;
+   }
+   return m_save;
+}
+
+bool
+Checkpoint::processModelsDisabled()
+{
+   if (!isEnabled() || m_processed)
+      return true;
+
+   m_models_enabled = false;
+   return m_save;
+}
+
+void
+Checkpoint::processCheckpoint()
+{
+   if (!isEnabled())
+      return;
+   if (m_processed)
+   {
+      LOG_PRINT_WARNING("Only one checkpoint is taken per run: CarbonCheckpoint() ignored");
+      return;
+   }
+
+   saveOrRestore();
+   // The models were kept disabled up to here
+   if (!m_save && m_models_enabled)
+      Sim()->enableModels();
+}
+
+void
+Checkpoint::saveOrRestore()
+{
+   m_processed = true;
+
+   fprintf(stderr, "[[Graphite]] --> [ %s the checkpoint of the models ]\n", m_save ? "Saving" : "Restoring");
+
+   Config* config = Config::getSingleton();
+   for (UInt32 i = 0; i < config->getNumLocalTiles(); i++)
+   {
+      Tile* tile = Sim()->getTileManager()->getTileFromIndex(i);
+      ostringstream filename;
+      filename << "checkpoint_" << tile->getId() << ".ckpt";
+      if (m_save)
+      {
+         CheckpointWriter writer(config->formatOutputFileName(filename.str()), tile->getId());
+         tile->saveCheckpoint(writer);
+      }
+      else
+      {
+         CheckpointReader reader(m_restore_directory + "/" + filename.str(), tile->getId());
+         tile->restoreCheckpoint(reader);
+      }
+   }
+
+   // The MCP is in one process only
+   if (Sim()->getMCP())
+   {
+      string filename = "checkpoint_sync_server.ckpt";
+      if (m_save)
+      {
+         CheckpointWriter writer(config->formatOutputFileName(filename), config->getMCPTileNum());
+         Sim()->getMCP()->getSyncServer()->checkpoint(writer.startSection("sync_server"));
+      }
+      else
+      {
+         CheckpointReader reader(m_restore_directory + "/" + filename, config->getMCPTileNum());
+         Sim()->getMCP()->getSyncServer()->restore(reader.startSection("sync_server"));
+      }
+   }
+}
+
+CheckpointWriter::CheckpointWriter(const string& filename, tile_id_t tile_id)
+   : m_filename(filename)
+{
+   m_file = fopen(filename.c_str(), "wb");
+   LOG_ASSERT_ERROR(m_file, "Could not open checkpoint file(%s)", filename.c_str());
+
+   Checkpoint::Header header = { Checkpoint::MAGIC, Checkpoint::VERSION, tile_id, 0 };
+   fwrite(&header, sizeof(header), 1, m_file);
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+   endSection();
+   __attribute__((unused)) int ret = fclose(m_file);
+   LOG_ASSERT_ERROR(ret == 0, "Could not write checkpoint file(%s)", m_filename.c_str());
+}
+
+UnstructuredBuffer&
+CheckpointWriter::startSection(const string& name)
+{
+   endSection();
+   m_section_name = name;
+   return m_buffer;
+}
+
+void
+CheckpointWriter::endSection()
+{
+   if (m_section_name == "")
+      return;
+
+   UInt32 name_length = m_section_name.size();
+   UInt64 data_length = m_buffer.size();
+   fwrite(&name_length, sizeof(name_length), 1, m_file);
+   fwrite(m_section_name.c_str(), 1, name_length, m_file);
+   fwrite(&data_length, sizeof(data_length), 1, m_file);
+   fwrite(m_buffer.getBuffer(), 1, data_length, m_file);
+
+   m_section_name = "";
+   m_buffer.clear();
+}
+
+CheckpointReader::CheckpointReader(const string& filename, tile_id_t tile_id)
+   : m_filename(filename)
+{
+   m_file = fopen(filename.c_str(), "rb");
+   LOG_ASSERT_ERROR(m_file, "Could not open checkpoint file(%s)", filename.c_str());
+
+   Checkpoint::Header header;
+   __attribute__((unused)) size_t num_read = fread(&header, sizeof(header), 1, m_file);
+   LOG_ASSERT_ERROR(num_read == 1 &&
+                    header.magic == Checkpoint::MAGIC && header.version == Checkpoint::VERSION,
+                    "%s is not a checkpoint file (version %u)", filename.c_str(), Checkpoint::VERSION);
+   LOG_ASSERT_ERROR(header.tile_id == tile_id, "Checkpoint file(%s) is for tile(%i), not tile(%i)",
+                    filename.c_str(), header.tile_id, tile_id);
+}
+
+CheckpointReader::~CheckpointReader()
+{
+   endSection();
+   fclose(m_file);
+}
+
+UnstructuredBuffer&
+CheckpointReader::startSection(const string& name)
+{
+   endSection();
+
+   UInt32 name_length = 0;
+   UInt64 data_length = 0;
+   string section_name;
+   bool read = (fread(&name_length, sizeof(name_length), 1, m_file) == 1);
+   if (read)
+   {
+      section_name.resize(name_length);
+      read = (fread(&section_name[0], 1, name_length, m_file) == name_length) &&
+             (fread(&data_length, sizeof(data_length), 1, m_file) == 1);
+   }
+   LOG_ASSERT_ERROR(read && (section_name == name), "Checkpoint file(%s) has no section(%s) next",
+                    m_filename.c_str(), name.c_str());
+
+   // One more byte, so that an empty section has an address too
+   m_data.resize(data_length + 1);
+   __attribute__((unused)) size_t data_read = fread(&m_data[0], 1, data_length, m_file);
+   LOG_ASSERT_ERROR(data_read == data_length,
+                    "Truncated section(%s) in checkpoint file(%s)", name.c_str(), m_filename.c_str());
+
+   m_section_name = name;
+   m_buffer.wrap(&m_data[0], data_length);
+   return m_buffer;
+}
+
+void
+CheckpointReader::endSection()
+{
+   if (m_section_name == "")
+      return;
+
+   LOG_ASSERT_ERROR(m_buffer.size() == 0, "Section(%s) of checkpoint file(%s) has %i bytes left: "
+                    "the parameters of the component differ from when it was saved",
+                    m_section_name.c_str(), m_filename.c_str(), m_buffer.size());
+
+   m_section_name = "";
+   m_buffer.clear();
+}
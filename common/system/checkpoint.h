@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "packetize.h"
+#include "fixed_types.h"
+
+// Checkpoint of the state of the models ([checkpoint] in carbon_sim.cfg),
+// saved or restored at a point the application marks: when it enables the
+// models for the enable_count-th time (CarbonEnableModels(), or before main()
+// when [general] trigger_models_within_application = false), or when it
+// calls CarbonCheckpoint(), whichever comes first. Only one checkpoint is
+// taken per run.
+//
+// This is for lite mode, where the application's memory is native, and the
+// models only see the accesses made while they are enabled. The application
+// warms the models up with them enabled, up to the checkpoint. A restored
+// run keeps the models disabled up to the same point, so that the warm-up
+// runs natively, and the checkpoint then replaces the state of the caches,
+// directories, DRAM controllers, queue models and core clocks. So every run
+// restored from it starts the region of interest from the same warmed-up
+// state, without paying for the warm-up. In full mode, the application's
+// memory is the simulated caches and DRAM, so there is no checkpoint.
+//
+// The application itself is not in it. The state is only consistent if the
+// other threads are not accessing memory at that point (e.g., they wait in
+// a barrier or are not spawned yet): requests in flight are not saved.
+// Statistics are not saved either.
+//
+// There is a file per tile (checkpoint_<tile>.ckpt) and one for the sync
+// server (checkpoint_sync_server.ckpt). A file is a Header followed by
+// named sections. Each section holds what one component put in an
+// UnstructuredBuffer, and is got back by the same component, in the same
+// order. The parameters of the components that are restored (e.g., the
+// geometry of the caches) must be the same as when the checkpoint was
+// saved; the others (latencies, DVFS, ...) can differ. Only the
+// pr_l1_pr_l2_dram_directory protocols are supported.
+class Checkpoint
+{
+public:
+   static const UInt32 MAGIC = 0x504b4347;   // "GCKP"
+   static const UInt32 VERSION = 1;
+
+   struct Header
+   {
+      UInt32 magic;
+      UInt32 version;
+      tile_id_t tile_id;
+      UInt32 reserved;
+   };
+
+   // Is a checkpoint saved or restored in this run?
+   static bool isEnabled();
+
+   // Called whenever the application enables or disables the models in this
+   // process. Return whether to do so: a restored run keeps the models
+   // disabled up to the checkpoint.
+   static bool processModelsEnabled();
+   static bool processModelsDisabled();
+   // Called at CarbonCheckpoint() in this process
+   static void processCheckpoint();
+
+private:
+   static bool m_initialized;
+   static bool m_save;
+   static std::string m_restore_directory;
+   // The checkpoint is taken at this enable of the models (0 for none)
+   static UInt32 m_enable_count;
+   static UInt32 m_num_enables;
+   // Have the models been enabled by the application (when restoring, they
+   // are not before the checkpoint)?
+   static bool m_models_enabled;
+   static bool m_processed;
+
+   static void initialize();
+   static void saveOrRestore();
+};
+
+class CheckpointWriter
+{
+public:
+   CheckpointWriter(const std::string& filename, tile_id_t tile_id);
+   ~CheckpointWriter();
+
+   // Buffer for the data of section 'name', written out when the next
+   // section starts
+   UnstructuredBuffer& startSection(const std::string& name);
+
+private:
+   std::string m_filename;
+   FILE* m_file;
+   std::string m_section_name;
+   UnstructuredBuffer m_buffer;
+
+   void endSection();
+};
+
+class CheckpointReader
+{
+public:
+   CheckpointReader(const std::string& filename, tile_id_t tile_id);
+   ~CheckpointReader();
+
+   // Data of the next section, which must be 'name'. All of it must be
+   // got before the next section starts.
+   UnstructuredBuffer& startSection(const std::string& name);
+
+private:
+   std::string m_filename;
+   FILE* m_file;
+   std::string m_section_name;
+   std::vector<Byte> m_data;
+   UnstructuredBuffer m_buffer;
+
+   void endSection();
+};
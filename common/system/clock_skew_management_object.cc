@@ -6,6 +6,7 @@
 #include "clock_skew_management_object.h"
 #include "lax_barrier_sync_client.h"
 #include "lax_barrier_sync_server.h"
+#include "lax_barrier_tree_sync_client.h"
 #include "lax_p2p_sync_client.h"
 
 #include "log.h"
@@ -25,6 +26,8 @@ ClockSkewManagementObject::parseScheme(std::string scheme)
       return LAX;
    else if (scheme == "lax_barrier")
       return LAX_BARRIER;
+   else if (scheme == "lax_barrier_tree")
+      return LAX_BARRIER_TREE;
    else if (scheme == "lax_p2p")
       return LAX_P2P;
    else
@@ -47,6 +50,9 @@ ClockSkewManagementClient::create(std::string scheme_str, Core* core)
       case LAX_BARRIER:
          return new LaxBarrierSyncClient(core);
 
+      case LAX_BARRIER_TREE:
+         return new LaxBarrierTreeSyncClient(core);
+
       case LAX_P2P:
          return new LaxP2PSyncClient(core);
 
@@ -65,6 +71,7 @@ ClockSkewManagementManager::create(std::string scheme_str)
    {
       case LAX:
       case LAX_BARRIER:
+      case LAX_BARRIER_TREE:
       case LAX_P2P:
          return (ClockSkewManagementManager*) NULL;
 
@@ -87,6 +94,7 @@ ClockSkewManagementServer::create(std::string scheme_str, Network& network, Unst
       case LAX_BARRIER:
          return new LaxBarrierSyncServer(network, recv_buff);
 
+      case LAX_BARRIER_TREE:
       case LAX_P2P:
          return (ClockSkewManagementServer*) NULL;
 
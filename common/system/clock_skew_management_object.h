@@ -18,6 +18,7 @@ public:
    {
       LAX = 0,
       LAX_BARRIER,
+      LAX_BARRIER_TREE,
       LAX_P2P,
       NUM_SCHEMES
    };
@@ -33,13 +34,15 @@ protected:
    ClockSkewManagementClient() {}
 
 public:
-   ~ClockSkewManagementClient() {}
+   virtual ~ClockSkewManagementClient() {}
    static ClockSkewManagementClient* create(std::string scheme_str, Core* core);
 
    virtual void enable() = 0;
    virtual void disable() = 0;
    virtual void synchronize(Time curr_time = Time(0)) = 0;
    virtual void netProcessSyncMsg(const NetPacket& recv_pkt) = 0;
+   // Called whenever the state of the core (RUNNING, STALLED, ...) changes
+   virtual void coreStateChanged() {}
 };
 
 class ClockSkewManagementManager : public ClockSkewManagementObject
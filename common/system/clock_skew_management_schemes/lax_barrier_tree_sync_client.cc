@@ -0,0 +1,247 @@
+#include <algorithm>
+
+#include "lax_barrier_tree_sync_client.h"
+#include "simulator.h"
+#include "config.h"
+#include "packet_type.h"
+#include "packetize.h"
+#include "network.h"
+#include "tile.h"
+#include "core.h"
+#include "core_model.h"
+#include "statistics_thread.h"
+#include "log.h"
+
+LaxBarrierTreeSyncClient::LaxBarrierTreeSyncClient(Core* core):
+   _core(core),
+   _barrier_interval(0),
+   _next_barrier_time(0),
+   _parent(INVALID_TILE_ID),
+   _first_child(INVALID_TILE_ID),
+   _num_children(0),
+   _waiting(false),
+   _local_clock(0),
+   _arrival_sent(false),
+   _sent_min_clock(NO_WAITING_THREAD)
+{
+   UInt32 arity = 0;
+   try
+   {
+      _barrier_interval = (UInt64) Sim()->getCfg()->getInt("clock_skew_management/lax_barrier_tree/quantum");
+      arity = (UInt32) Sim()->getCfg()->getInt("clock_skew_management/lax_barrier_tree/arity");
+   }
+   catch(...)
+   {
+      LOG_PRINT_ERROR("Could not read clock_skew_management/lax_barrier_tree parameters from the config file");
+   }
+   LOG_ASSERT_ERROR(arity >= 2, "clock_skew_management/lax_barrier_tree/arity(%u) must be >= 2", arity);
+
+   _next_barrier_time = _barrier_interval;
+
+   // Only the main cores of the application tiles take part in the barrier
+   tile_id_t tile_id = _core->getTile()->getId();
+   UInt32 num_application_tiles = Config::getSingleton()->getApplicationTiles();
+   _participating = ((UInt32) tile_id < num_application_tiles) && (_core->getId().core_type == MAIN_CORE_TYPE);
+   if (!_participating)
+      return;
+
+   if (tile_id > 0)
+      _parent = (tile_id - 1) / arity;
+
+   UInt64 first_child = ((UInt64) tile_id) * arity + 1;
+   if (first_child < num_application_tiles)
+   {
+      _first_child = (tile_id_t) first_child;
+      _num_children = std::min((UInt64) arity, num_application_tiles - first_child);
+   }
+
+   // All the tiles but tile 0 start out idle, so the children are taken
+   // to have arrived at the first barrier
+   _child_arrived_list.resize(_num_children, true);
+   _child_min_clock_list.resize(_num_children, NO_WAITING_THREAD);
+
+   _core->getTile()->getNetwork()->registerCallback(CLOCK_SKEW_MANAGEMENT, ClockSkewManagementClientNetworkCallback, this);
+}
+
+LaxBarrierTreeSyncClient::~LaxBarrierTreeSyncClient()
+{
+   if (_participating)
+      _core->getTile()->getNetwork()->unregisterCallback(CLOCK_SKEW_MANAGEMENT);
+}
+
+// Called by user thread
+void
+LaxBarrierTreeSyncClient::synchronize(Time time)
+{
+   if (!_participating)
+      return;
+
+   UInt64 curr_time_ns = time.toNanosec();
+   if (curr_time_ns == 0)
+      curr_time_ns = _core->getModel()->getCurrTime().toNanosec();
+
+   // '_next_barrier_time' only grows, so a stale value read without the
+   // lock only sends us down the slow path
+   if (curr_time_ns < _next_barrier_time)
+      return;
+
+   ScopedLock sl(_lock);
+
+   if (curr_time_ns < _next_barrier_time)
+      return;
+
+   LOG_PRINT("Tile(%i) waiting at barrier(%llu), curr_time(%llu)",
+             _core->getTile()->getId(), _next_barrier_time, curr_time_ns);
+
+   _waiting = true;
+   _local_clock = curr_time_ns;
+   checkArrival();
+
+   while (_waiting)
+      _cond.wait(_lock);
+
+   LOG_PRINT("Tile(%i) released, next barrier(%llu)", _core->getTile()->getId(), _next_barrier_time);
+}
+
+// Called (by whichever thread changes it) when the state of the core changes
+void
+LaxBarrierTreeSyncClient::coreStateChanged()
+{
+   if (!_participating)
+      return;
+
+   // A core that stops running may complete the barrier of its subtree
+   ScopedLock sl(_lock);
+   checkArrival();
+}
+
+// Called by network thread
+void
+LaxBarrierTreeSyncClient::netProcessSyncMsg(const NetPacket& recv_pkt)
+{
+   UInt32 msg_type;
+   UInt64 barrier_time;
+   UInt64 time;
+
+   UnstructuredBuffer recv_buf(recv_pkt.data, recv_pkt.length);
+   recv_buf >> msg_type >> barrier_time >> time;
+
+   ScopedLock sl(_lock);
+
+   switch (msg_type)
+   {
+   case ARRIVE:
+      {
+         UInt32 child_index = recv_pkt.sender.tile_id - _first_child;
+         LOG_ASSERT_ERROR(_first_child != INVALID_TILE_ID && child_index < _num_children,
+                          "Tile(%i) received ARRIVE from Tile(%i), which is not a child",
+                          _core->getTile()->getId(), recv_pkt.sender.tile_id);
+         LOG_ASSERT_ERROR(barrier_time <= _next_barrier_time,
+                          "Tile(%i) received ARRIVE for barrier(%llu) ahead of barrier(%llu)",
+                          _core->getTile()->getId(), barrier_time, _next_barrier_time);
+
+         // The child sent this before it saw the last RELEASE; it will
+         // arrive again at the current barrier
+         if (barrier_time < _next_barrier_time)
+            break;
+
+         _child_arrived_list[child_index] = true;
+         _child_min_clock_list[child_index] = time;
+         checkArrival();
+      }
+      break;
+
+   case RELEASE:
+      LOG_ASSERT_ERROR(recv_pkt.sender.tile_id == _parent,
+                       "Tile(%i) received RELEASE from Tile(%i), parent is Tile(%i)",
+                       _core->getTile()->getId(), recv_pkt.sender.tile_id, _parent);
+      releaseBarrier(barrier_time);
+      break;
+
+   default:
+      LOG_PRINT_ERROR("Unrecognized Sync Msg, type(%u) from Tile(%i)", msg_type, recv_pkt.sender.tile_id);
+      break;
+   }
+}
+
+void
+LaxBarrierTreeSyncClient::checkArrival()
+{
+   // The thread on this tile must either wait at the barrier or not be running
+   Core::State core_state = _core->getState();
+   if (!_waiting && (core_state == Core::RUNNING || core_state == Core::WAKING_UP))
+      return;
+
+   UInt64 min_clock = _waiting ? _local_clock : NO_WAITING_THREAD;
+   for (UInt32 i = 0; i < _num_children; i++)
+   {
+      if (!_child_arrived_list[i])
+         return;
+      min_clock = std::min(min_clock, _child_min_clock_list[i]);
+   }
+
+   if (_parent != INVALID_TILE_ID)
+   {
+      // Report again if a thread arrived after the subtree did
+      if (!_arrival_sent || (min_clock != _sent_min_clock))
+      {
+         sendMsg(_parent, ARRIVE, _next_barrier_time, min_clock);
+         _arrival_sent = true;
+         _sent_min_clock = min_clock;
+      }
+      return;
+   }
+
+   // Root: at least one thread must be waiting. Advance the barrier till the
+   // earliest waiting thread can be resumed, so that there is forward progress
+   if (min_clock == NO_WAITING_THREAD)
+      return;
+
+   assert(min_clock >= _next_barrier_time);
+   UInt64 num_intervals = (min_clock - _next_barrier_time) / _barrier_interval + 1;
+   releaseBarrier(_next_barrier_time + num_intervals * _barrier_interval);
+}
+
+void
+LaxBarrierTreeSyncClient::releaseBarrier(UInt64 next_barrier_time)
+{
+   LOG_ASSERT_ERROR(next_barrier_time > _next_barrier_time,
+                    "Tile(%i): next barrier(%llu) must be after the current one(%llu)",
+                    _core->getTile()->getId(), next_barrier_time, _next_barrier_time);
+
+   LOG_PRINT("Tile(%i) releasing barrier(%llu), next barrier(%llu)",
+             _core->getTile()->getId(), _next_barrier_time, next_barrier_time);
+
+   _next_barrier_time = next_barrier_time;
+
+   for (UInt32 i = 0; i < _num_children; i++)
+   {
+      sendMsg(_first_child + i, RELEASE, _next_barrier_time, 0);
+      _child_arrived_list[i] = false;
+      _child_min_clock_list[i] = NO_WAITING_THREAD;
+   }
+   _arrival_sent = false;
+   _sent_min_clock = NO_WAITING_THREAD;
+
+   if (_waiting && (_local_clock < _next_barrier_time))
+   {
+      _waiting = false;
+      _cond.signal();
+   }
+
+   // Notify Statistics thread about the global time
+   if (_parent == INVALID_TILE_ID && Sim()->getStatisticsThread())
+      Sim()->getStatisticsThread()->notify(_next_barrier_time);
+
+   // Idle subtrees (and threads still ahead) arrive at the new barrier right away
+   checkArrival();
+}
+
+void
+LaxBarrierTreeSyncClient::sendMsg(tile_id_t receiver, MsgType type, UInt64 barrier_time, UInt64 time)
+{
+   UnstructuredBuffer send_buf;
+   send_buf << (UInt32) type << barrier_time << time;
+   _core->getTile()->getNetwork()->netSend(Tile::getMainCoreId(receiver), CLOCK_SKEW_MANAGEMENT,
+                                           send_buf.getBuffer(), send_buf.size());
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+
+#include "clock_skew_management_object.h"
+#include "lock.h"
+#include "cond.h"
+#include "fixed_types.h"
+#include "time_types.h"
+
+// Forward Decls
+class Core;
+
+// Lax-Barrier with the barrier distributed over a k-ary tree of the
+// application tiles (tile 0 is the root; tile t has children k*t+1 .. k*t+k)
+// instead of being centralized at the MCP.
+//
+// Every tile knows the current barrier time, so a thread that has not
+// reached it does not send any message. Each tile combines the arrivals of
+// its subtree and sends a single ARRIVE message (carrying the smallest
+// clock of its waiting threads) to its parent once every thread running
+// in the subtree is waiting. The root then advances the barrier time
+// (as LaxBarrierSyncServer does) and the RELEASE message fans back down
+// the tree.
+//
+// A tile participates in a barrier while its core is RUNNING (or
+// WAKING_UP). A core that stalls or goes idle is re-evaluated through
+// coreStateChanged(). As with the centralized barrier, a thread that
+// resumes after its subtree has arrived only catches up at the next
+// barrier.
+class LaxBarrierTreeSyncClient : public ClockSkewManagementClient
+{
+public:
+   LaxBarrierTreeSyncClient(Core* core);
+   ~LaxBarrierTreeSyncClient();
+
+   void enable() {}
+   void disable() {}
+
+   // Called by user thread
+   void synchronize(Time time);
+   void coreStateChanged();
+
+   // Called by network thread
+   void netProcessSyncMsg(const NetPacket& recv_pkt);
+
+private:
+   enum MsgType
+   {
+      ARRIVE = 0,
+      RELEASE,
+      NUM_MSG_TYPES
+   };
+
+   static const UInt64 NO_WAITING_THREAD = ~((UInt64) 0);
+
+   Core* _core;
+   bool _participating;
+
+   UInt64 _barrier_interval;
+   UInt64 _next_barrier_time;
+
+   // Tree position
+   tile_id_t _parent;
+   tile_id_t _first_child;
+   UInt32 _num_children;
+
+   // Thread on this tile
+   bool _waiting;
+   UInt64 _local_clock;
+
+   // Children subtrees, for the current barrier
+   std::vector<bool> _child_arrived_list;
+   std::vector<UInt64> _child_min_clock_list;
+
+   // Summary last sent to the parent for the current barrier
+   bool _arrival_sent;
+   UInt64 _sent_min_clock;
+
+   Lock _lock;
+   ConditionVariable _cond;
+
+   // Called with _lock held
+   void checkArrival();
+   void releaseBarrier(UInt64 next_barrier_time);
+   void sendMsg(tile_id_t receiver, MsgType type, UInt64 barrier_time, UInt64 time);
+};
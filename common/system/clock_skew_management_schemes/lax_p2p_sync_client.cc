@@ -65,8 +65,7 @@ LaxP2PSyncClient::netProcessSyncMsg(const NetPacket& recv_pkt)
    UInt32 msg_type;
    UInt64 time;
 
-   UnstructuredBuffer recv_buf;
-   recv_buf << make_pair(recv_pkt.data, recv_pkt.length);
+   UnstructuredBuffer recv_buf(recv_pkt.data, recv_pkt.length);
    
    recv_buf >> msg_type >> time;
    SyncMsg sync_msg(recv_pkt.sender, (SyncMsg::MsgType) msg_type, time);
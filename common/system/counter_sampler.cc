@@ -0,0 +1,189 @@
+#include <algorithm>
+
+#include "counter_sampler.h"
+#include "statistics_registry.h"
+#include "simulator.h"
+#include "tile_manager.h"
+#include "tile.h"
+#include "config.h"
+#include "varint.h"
+#include "log.h"
+
+using namespace std;
+
+CounterSampler::CounterSampler(UInt32 block_size, const vector<string>& components)
+   : _block_size(block_size)
+   , _components(components)
+   , _initialized(false)
+   , _fill_block(&_blocks[0])
+   , _drain_block(&_blocks[1])
+   , _drain_pending(false)
+   , _num_dropped_samples(0)
+   , _header_written(false)
+{
+   LOG_ASSERT_ERROR(_block_size > 0, "Counter sampler block size must be > 0");
+
+   string filename = Config::getSingleton()->formatOutputFileName("counter_samples.bin");
+   _file = fopen(filename.c_str(), "wb");
+   LOG_ASSERT_ERROR(_file, "Could not open counter samples file(%s)", filename.c_str());
+
+   for (UInt32 i = 0; i < 2; i++)
+      _blocks[i].num_samples = 0;
+}
+
+CounterSampler::~CounterSampler()
+{
+   // The statistics thread is gone: write out whatever is left
+   if (!_initialized)
+      initializeColumns();
+   drain();
+   if (_fill_block->num_samples > 0)
+      writeBlock(_fill_block);
+   if (!_header_written)
+      writeHeader();
+   fclose(_file);
+
+   LOG_ASSERT_WARNING(_num_dropped_samples == 0,
+                      "Dropped %llu counter samples: the sampling interval is too small", _num_dropped_samples);
+}
+
+void
+CounterSampler::initializeColumns()
+{
+   // Counters are only read, and the registries do not change once the
+   // simulation has started (the MCP registers its counters at startup)
+   for (UInt32 i = 0; i < Config::getSingleton()->getNumLocalTiles(); i++)
+   {
+      const StatisticsRegistry* registry = Sim()->getTileManager()->getTileFromIndex(i)->getStatisticsRegistry();
+      for (UInt32 j = 0; j < registry->getNumCounters(); j++)
+      {
+         if (!_components.empty() &&
+             find(_components.begin(), _components.end(), registry->getComponent(j)) == _components.end())
+            continue;
+
+         Column column;
+         column.registry = registry;
+         column.index = j;
+         _columns.push_back(column);
+      }
+   }
+
+   for (UInt32 i = 0; i < 2; i++)
+   {
+      _blocks[i].times.resize(_block_size);
+      _blocks[i].values.resize(_block_size * _columns.size());
+   }
+
+   _initialized = true;
+}
+
+void
+CounterSampler::sample(UInt64 time)
+{
+   if (!_initialized)
+      initializeColumns();
+
+   // The previous full block could not be handed over yet
+   if (_fill_block->num_samples == _block_size && !swapBlocks())
+   {
+      _num_dropped_samples ++;
+      return;
+   }
+
+   UInt32 num_columns = _columns.size();
+   UInt32 row = _fill_block->num_samples * num_columns;
+   for (UInt32 i = 0; i < num_columns; i++)
+      _fill_block->values[row + i] = _columns[i].registry->read(_columns[i].index);
+   _fill_block->times[_fill_block->num_samples ++] = time;
+
+   if (_fill_block->num_samples == _block_size)
+      swapBlocks();
+}
+
+bool
+CounterSampler::swapBlocks()
+{
+   ScopedLock sl(_lock);
+   if (_drain_pending)
+      return false;
+
+   swap(_fill_block, _drain_block);
+   _fill_block->num_samples = 0;
+   _drain_pending = true;
+   return true;
+}
+
+void
+CounterSampler::drain()
+{
+   {
+      ScopedLock sl(_lock);
+      if (!_drain_pending)
+         return;
+   }
+
+   // The barrier path does not touch the drain block until it is released
+   writeBlock(_drain_block);
+
+   ScopedLock sl(_lock);
+   _drain_pending = false;
+}
+
+void
+CounterSampler::writeHeader()
+{
+   UInt32 header[3] = { MAGIC, VERSION, (UInt32) _columns.size() };
+   fwrite(header, sizeof(header), 1, _file);
+
+   _encoded.clear();
+   for (vector<Column>::iterator it = _columns.begin(); it != _columns.end(); it++)
+   {
+      SInt32 tile_id = it->registry->getTileId();
+      UInt32 type = it->registry->getType(it->index);
+      _encoded.insert(_encoded.end(), (Byte*) &tile_id, (Byte*) &tile_id + sizeof(tile_id));
+      _encoded.insert(_encoded.end(), (Byte*) &type, (Byte*) &type + sizeof(type));
+      encodeString(it->registry->getComponent(it->index));
+      encodeString(it->registry->getName(it->index));
+   }
+   if (!_encoded.empty())
+      fwrite(&_encoded[0], 1, _encoded.size(), _file);
+
+   _header_written = true;
+}
+
+void
+CounterSampler::writeBlock(Block* block)
+{
+   if (!_header_written)
+      writeHeader();
+
+   UInt32 num_columns = _columns.size();
+
+   _encoded.clear();
+   for (UInt32 s = 0; s < block->num_samples; s++)
+      encode(block->times[s], (s == 0) ? 0 : block->times[s-1]);
+   for (UInt32 c = 0; c < num_columns; c++)
+   {
+      for (UInt32 s = 0; s < block->num_samples; s++)
+         encode(block->values[s * num_columns + c], (s == 0) ? 0 : block->values[(s-1) * num_columns + c]);
+   }
+
+   fwrite(&block->num_samples, sizeof(block->num_samples), 1, _file);
+   fwrite(&_encoded[0], 1, _encoded.size(), _file);
+   fflush(_file);
+}
+
+void
+CounterSampler::encode(UInt64 value, UInt64 prev_value)
+{
+   // Counters mostly grow by small amounts between samples
+   encodeSignedVarint(_encoded, (SInt64) (value - prev_value));
+}
+
+void
+CounterSampler::encodeString(const string& str)
+{
+   UInt32 length = str.length();
+   _encoded.insert(_encoded.end(), (Byte*) &length, (Byte*) &length + sizeof(length));
+   _encoded.insert(_encoded.end(), str.begin(), str.end());
+}
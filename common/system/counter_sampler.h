@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "fixed_types.h"
+#include "lock.h"
+
+class StatisticsRegistry;
+
+// Samples the registered counters of the local tiles (see StatisticsRegistry)
+// every sampling interval into a columnar binary file, counter_samples.bin,
+// that tools/read_counter_samples.py reads back.
+//
+// The barrier path only copies the counters into the fill block. Once the
+// fill block is full, it is swapped with the drain block, which the
+// statistics thread writes out. If the drain block has not been written out
+// yet when the fill block is full again, the new samples are dropped (and
+// counted) instead of stalling the barrier.
+//
+// File format (little endian):
+//   MAGIC, VERSION and the number of columns (UInt32 each)
+//   for each column: tile id (SInt32), counter type (UInt32), component and
+//     counter names (each a UInt32 length followed by the characters)
+//   blocks of samples: the number of samples (UInt32), followed by the
+//     sample times (in nanoseconds) and then each column in turn. Each value
+//     is the zig-zag LEB128 encoded difference from the previous value of its
+//     column in the block (the first one is relative to 0).
+class CounterSampler
+{
+public:
+   static const UInt32 MAGIC = 0x544e4347;   // "GCNT"
+   static const UInt32 VERSION = 1;
+
+   // An empty list of components samples all the registered counters
+   CounterSampler(UInt32 block_size, const std::vector<std::string>& components);
+   // Writes out the remaining samples
+   ~CounterSampler();
+
+   // Called on the barrier path
+   void sample(UInt64 time);
+   // Called by the statistics thread
+   void drain();
+
+private:
+   struct Column
+   {
+      const StatisticsRegistry* registry;
+      UInt32 index;
+   };
+
+   struct Block
+   {
+      std::vector<UInt64> times;
+      std::vector<UInt64> values;     // One row of columns per sample
+      UInt32 num_samples;
+   };
+
+   UInt32 _block_size;
+   std::vector<std::string> _components;
+   std::vector<Column> _columns;
+   bool _initialized;
+
+   Block _blocks[2];
+   Block* _fill_block;
+   Block* _drain_block;
+   bool _drain_pending;
+   Lock _lock;
+   UInt64 _num_dropped_samples;
+
+   FILE* _file;
+   bool _header_written;
+   std::vector<Byte> _encoded;
+
+   void initializeColumns();
+   bool swapBlocks();
+   void writeHeader();
+   void writeBlock(Block* block);
+   void encode(UInt64 value, UInt64 prev_value);
+   void encodeString(const std::string& str);
+};
@@ -17,6 +17,8 @@ DVFSManager::DVFSLevels DVFSManager::_dvfs_levels;
 double DVFSManager::_max_frequency;
 DVFSManager::DomainType DVFSManager::_dvfs_domain_map;
 UInt32 DVFSManager::_synchronization_delay_cycles;
+DVFSManager::ClockDomainMap DVFSManager::_clock_domain_map;
+Lock DVFSManager::_clock_domain_map_lock;
 
 DVFSManager::DVFSManager(UInt32 technology_node, Tile* tile):
    _tile(tile)
@@ -64,8 +66,7 @@ DVFSManager::getDVFS(tile_id_t tile_id, module_t module_mask, double* frequency,
    // receive reply
    core_id_t this_core_id = {_tile->getId(), MAIN_CORE_TYPE};
    NetPacket packet = _tile->getNetwork()->netRecv(remote_core_id, this_core_id, DVFS_GET_REPLY);
-   UnstructuredBuffer recv_buffer;
-   recv_buffer << std::make_pair(packet.data, packet.length);
+   UnstructuredBuffer recv_buffer(packet.data, packet.length);
 
    int rc;
    recv_buffer >> rc;
@@ -104,8 +105,7 @@ DVFSManager::setDVFS(tile_id_t tile_id, int module_mask, double frequency, volta
    // receive reply
    core_id_t this_core_id = {_tile->getId(), MAIN_CORE_TYPE};
    NetPacket packet = _tile->getNetwork()->netRecv(remote_core_id, this_core_id, DVFS_SET_REPLY);
-   UnstructuredBuffer recv_buffer;
-   recv_buffer << std::make_pair(packet.data, packet.length);
+   UnstructuredBuffer recv_buffer(packet.data, packet.length);
 
    int rc;
    recv_buffer >> rc;
@@ -208,8 +208,7 @@ DVFSManager::doSetDVFS(int module_mask, double frequency, voltage_option_t volta
 void
 getDVFSCallback(void* obj, NetPacket packet)
 {
-   UnstructuredBuffer recv_buffer;
-   recv_buffer << std::make_pair(packet.data, packet.length);
+   UnstructuredBuffer recv_buffer(packet.data, packet.length);
 
    module_t module_type;
    
@@ -222,8 +221,7 @@ getDVFSCallback(void* obj, NetPacket packet)
 void
 setDVFSCallback(void* obj, NetPacket packet)
 {
-   UnstructuredBuffer recv_buffer;
-   recv_buffer << std::make_pair(packet.data, packet.length);
+   UnstructuredBuffer recv_buffer(packet.data, packet.length);
 
    int module_mask;
    double frequency;
@@ -284,6 +282,9 @@ DVFSManager::initializeDVFSLevels()
       double voltage = convertFromString<double>(tokens[0]);
       double frequency_factor = convertFromString<double>(tokens[1]);
       _dvfs_levels.push_back(make_pair(voltage, frequency_factor * _max_frequency));
+
+      // Set up the clock domains of the DVFS levels ahead of time
+      getClockDomain(frequency_factor * _max_frequency);
    }
 }
 
@@ -397,6 +398,21 @@ UInt32 DVFSManager::getSynchronizationDelay()
    return _synchronization_delay_cycles;
 }
 
+const ClockDomain*
+DVFSManager::getClockDomain(double frequency)
+{
+   ScopedLock sl(_clock_domain_map_lock);
+
+   ClockDomainMap::iterator it = _clock_domain_map.find(frequency);
+   if (it != _clock_domain_map.end())
+      return it->second;
+
+   ClockDomain* clock_domain = new ClockDomain(frequency);
+   _clock_domain_map[frequency] = clock_domain;
+   LOG_PRINT("Clock domain: frequency(%g GHz), period(%llu ps)", frequency, clock_domain->getPeriod());
+   return clock_domain;
+}
+
 int
 DVFSManager::getVoltage(double &voltage, voltage_option_t voltage_flag, double frequency) 
 {
@@ -443,8 +459,7 @@ DVFSManager::getTileEnergy(tile_id_t tile_id, double *energy)
    // receive reply
    core_id_t this_core_id = {_tile->getId(), MAIN_CORE_TYPE};
    NetPacket packet = _tile->getNetwork()->netRecv(remote_core_id, this_core_id, GET_TILE_ENERGY_REPLY);
-   UnstructuredBuffer recv_buffer;
-   recv_buffer << std::make_pair(packet.data, packet.length);
+   UnstructuredBuffer recv_buffer(packet.data, packet.length);
 
    recv_buffer >> *energy;
 }
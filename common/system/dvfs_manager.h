@@ -7,6 +7,8 @@ using std::pair;
 using std::map;
 
 #include "fixed_types.h"
+#include "clock_domain.h"
+#include "lock.h"
 #include "dvfs.h"
 #include "network.h"
 #include "mem_component.h"
@@ -68,6 +70,10 @@ public:
    // Returns synchronization delay in cycles
    static UInt32 getSynchronizationDelay();
 
+   // Returns the clock domain of a frequency. Domains are shared, so modules
+   // running at the same frequency get the same one.
+   static const ClockDomain* getClockDomain(double frequency);
+
    // Converts from MemComponent to module_t
    static module_t convertToModule(MemComponent::Type component);
 
@@ -85,4 +91,8 @@ private:
    static double getMinVoltage(double frequency);
 
    static UInt32 _synchronization_delay_cycles;
+
+   typedef map<double, ClockDomain*> ClockDomainMap;
+   static ClockDomainMap _clock_domain_map;
+   static Lock _clock_domain_map_lock;
 };
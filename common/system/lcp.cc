@@ -6,6 +6,7 @@
 #include "tile_manager.h"
 #include "performance_counter_manager.h"
 #include "clock_skew_management_object.h"
+#include "packet_buffer.h"
 
 #include "log.h"
 
@@ -87,7 +88,7 @@ void LCP::processPacket()
       break;
    }
 
-   delete [] pkt;
+   PacketBuffer::release(pkt);
 }
 
 void LCP::finish()
@@ -128,6 +129,5 @@ void LCP::updateCommId(void *vp)
                  /*length*/ 0,
                  /*data*/ NULL);
    Byte *buffer = ack.makeBuffer();
-   m_transport->send(update->tile_id, buffer, ack.bufferSize());
-   delete [] buffer;
+   m_transport->sendBuffer(update->tile_id, buffer);
 }
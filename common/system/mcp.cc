@@ -25,6 +25,11 @@ MCP::MCP(Network & network)
    , m_clock_skew_management_server(NULL)
 {
    m_clock_skew_management_server = ClockSkewManagementServer::create(Sim()->getCfg()->getString("clock_skew_management/scheme"), m_network, m_recv_buff);
+
+   // The servers' counters are reported with the MCP tile
+   StatisticsRegistry* registry = m_network.getTile()->getStatisticsRegistry();
+   m_syscall_server.registerStatistics(registry);
+   m_sync_server.registerStatistics(registry);
 }
 
 MCP::~MCP()
@@ -46,7 +51,8 @@ void MCP::processPacket()
    match.types.push_back(MCP_SYSTEM_TYPE);
    recv_pkt = m_network.netRecv(match);
 
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   // 'recv_pkt.data' is deleted once the packet has been processed
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    int msg_type;
 
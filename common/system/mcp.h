@@ -24,6 +24,7 @@ class MCP : public Runnable
 
       VMManager* getVMManager() { return &m_vm_manager; }
       ClockSkewManagementServer* getClockSkewManagementServer() { return m_clock_skew_management_server; }
+      SyncServer* getSyncServer() { return &m_sync_server; }
 
    private:
       Boolean m_finished;
@@ -1,7 +1,9 @@
 #include "performance_counter_manager.h"
 #include "simulator.h"
+#include "checkpoint.h"
 #include "network.h"
 #include "transport.h"
+#include "packet_buffer.h"
 #include "log.h"
 
 PerformanceCounterManager::PerformanceCounterManager()
@@ -25,7 +27,7 @@ PerformanceCounterManager::togglePerformanceCounters(Byte* msg)
                        0 /* length */, NULL /* data */);
          Byte* buffer = ack.makeBuffer();
          Transport::Node* transport = Transport::getSingleton()->getGlobalNode();
-         transport->send(0, buffer, ack.bufferSize());
+         transport->sendBuffer(0, buffer);
       }
       break;
    
@@ -38,7 +40,20 @@ PerformanceCounterManager::togglePerformanceCounters(Byte* msg)
                        0 /* length */, NULL /* data */);
          Byte* buffer = ack.makeBuffer();
          Transport::Node* transport = Transport::getSingleton()->getGlobalNode();
-         transport->send(0, buffer, ack.bufferSize());
+         transport->sendBuffer(0, buffer);
+      }
+      break;
+
+   case CHECKPOINT:
+      {
+         Checkpoint::processCheckpoint();
+         // Send ACK back to tile 0
+         NetPacket ack(Time(0) /* time */, LCP_TOGGLE_PERFORMANCE_COUNTERS_ACK /* packet type */,
+                       0 /* sender - doesn't matter */, 0 /* receiver */,
+                       0 /* length */, NULL /* data */);
+         Byte* buffer = ack.makeBuffer();
+         Transport::Node* transport = Transport::getSingleton()->getGlobalNode();
+         transport->sendBuffer(0, buffer);
       }
       break;
    
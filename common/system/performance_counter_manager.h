@@ -8,7 +8,8 @@ public:
    enum MsgType
    {
       ENABLE = 0,
-      DISABLE
+      DISABLE,
+      CHECKPOINT
    };
 
    PerformanceCounterManager();
@@ -30,8 +30,7 @@ RemoteQueryHelper::~RemoteQueryHelper()
 void
 RemoteQueryHelper::handleQuery(const NetPacket& packet)
 {
-   UnstructuredBuffer recv_buf;
-   recv_buf << make_pair(packet.data, packet.length);
+   UnstructuredBuffer recv_buf(packet.data, packet.length);
    
    RemoteQueryType query_type;
    recv_buf >> query_type;
@@ -16,6 +16,14 @@ SimThread::~SimThread()
 }
 
 void SimThread::run()
+{
+   if (Sim()->getSimThreadManager()->isPoolEnabled())
+      runPool();
+   else
+      runTile();
+}
+
+void SimThread::runTile()
 {
    tile_id_t tile_id = Sim()->getTileManager()->registerSimThread();
 
@@ -40,6 +48,34 @@ void SimThread::run()
    LOG_PRINT("Sim thread exiting");
 }
 
+void SimThread::runPool()
+{
+   SimThreadManager *sim_thread_manager = Sim()->getSimThreadManager();
+   Sim()->getTileManager()->registerSimPoolThread();
+
+   LOG_PRINT("Pool sim thread starting...");
+
+   sim_thread_manager->simThreadStartCallback();
+
+   // The tile stays with this thread till tileProcessed(), so the
+   // messages of a tile are still handled one at a time and in order
+   UInt32 tile_index;
+   while (sim_thread_manager->getReadyTile(tile_index))
+   {
+      Tile *tile = Sim()->getTileManager()->setCurrentSimPoolTile(tile_index);
+      Network *net = tile->getNetwork();
+
+      if (!sim_thread_manager->isTileTerminated(tile_index) && net->getTransport()->query())
+         net->netPullFromTransport();
+
+      sim_thread_manager->tileProcessed(tile_index);
+   }
+
+   sim_thread_manager->simThreadExitCallback();
+
+   LOG_PRINT("Pool sim thread exiting");
+}
+
 void SimThread::spawn()
 {
    m_thread = Thread::create(this);
@@ -5,6 +5,9 @@
 #include "fixed_types.h"
 #include "network.h"
 
+// A SimThread either serves the network of a single tile (blocking in
+// the transport for its messages) or, when the sim threads are pooled,
+// serves whichever local tile SimThreadManager hands it next.
 class SimThread : public Runnable
 {
 public:
@@ -15,6 +18,8 @@ public:
 
 private:
    void run();
+   void runTile();
+   void runPool();
 
    static void terminateFunc(void *vp, NetPacket pkt);
 
@@ -9,22 +9,70 @@
 #include "mcp.h"
 
 SimThreadManager::SimThreadManager()
-   : m_active_threads(0)
+   : m_sim_threads(NULL)
+   , m_num_sim_threads(0)
+   , m_active_threads(0)
+   , m_pool_enabled(false)
+   , m_num_local_tiles(Config::getSingleton()->getNumLocalTiles())
+   , m_tile_scheduled(NULL)
+   , m_tile_terminated(NULL)
+   , m_num_terminated_tiles(0)
 {
+   m_num_sim_threads = m_num_local_tiles;
+
+   // 0 keeps one sim thread per local tile
+   UInt32 num_pool_threads = (UInt32) Sim()->getCfg()->getInt("general/num_sim_threads", 0);
+
+   if (num_pool_threads > 0 && num_pool_threads < m_num_local_tiles)
+   {
+      m_pool_enabled = true;
+      m_num_sim_threads = num_pool_threads;
+
+      m_tile_index_map.resize(Config::getSingleton()->getTotalTiles(), -1);
+      const Config::TileList &tile_list = Config::getSingleton()->getTileListForProcess(Config::getSingleton()->getCurrentProcessNum());
+      for (UInt32 i = 0; i < m_num_local_tiles; i++)
+         m_tile_index_map[tile_list[i]] = i;
+
+      m_tile_scheduled = new UInt32[m_num_local_tiles];
+      m_tile_terminated = new UInt32[m_num_local_tiles];
+      for (UInt32 i = 0; i < m_num_local_tiles; i++)
+      {
+         m_tile_scheduled[i] = 0;
+         m_tile_terminated[i] = 0;
+      }
+   }
 }
 
 SimThreadManager::~SimThreadManager()
 {
    LOG_ASSERT_WARNING(m_active_threads == 0,
                       "Threads still active when SimThreadManager exits.");
+
+   delete [] m_tile_scheduled;
+   delete [] m_tile_terminated;
 }
 
 void SimThreadManager::spawnSimThreads()
 {
-   UInt32 num_sim_threads = Config::getSingleton()->getNumLocalTiles();
+   UInt32 num_sim_threads = m_num_sim_threads;
 
    LOG_PRINT("Starting %d threads on proc: %d.", num_sim_threads, Config::getSingleton()->getCurrentProcessNum());
 
+   if (m_pool_enabled)
+   {
+      for (UInt32 i = 0; i < m_num_local_tiles; i++)
+      {
+         Network *net = Sim()->getTileManager()->getTileFromIndex(i)->getNetwork();
+         net->registerCallback(SIM_THREAD_TERMINATE_THREADS, terminateTileFunc, this);
+      }
+
+      // Messages that arrived before the callback was set are only seen
+      // by looking at every tile once
+      Transport::getSingleton()->setReadyCallback(tileReadyCallback, this);
+      for (UInt32 i = 0; i < m_num_local_tiles; i++)
+         scheduleTile(i);
+   }
+
    m_sim_threads = new SimThread [num_sim_threads];
 
    for (UInt32 i = 0; i < num_sim_threads; i++)
@@ -74,3 +122,75 @@ void SimThreadManager::simThreadExitCallback()
    --m_active_threads;
    m_active_threads_lock.release();
 }
+
+bool SimThreadManager::getReadyTile(UInt32 &tile_index)
+{
+   m_ready_tile_sem.wait();
+
+   ScopedLock sl(m_ready_tile_lock);
+   LOG_ASSERT_ERROR(!m_ready_tile_queue.empty(), "Ready tile list empty after waiting on semaphore.");
+   tile_index = m_ready_tile_queue.front();
+   m_ready_tile_queue.pop();
+
+   return (tile_index != QUIT_TILE_INDEX);
+}
+
+void SimThreadManager::tileProcessed(UInt32 tile_index)
+{
+   // Give the tile up first, then look for messages that came in while it
+   // was served: their senders could not schedule it
+   __sync_lock_release(&m_tile_scheduled[tile_index]);
+   __sync_synchronize();
+
+   if (!m_tile_terminated[tile_index] &&
+       Sim()->getTileManager()->getTileFromIndex(tile_index)->getNetwork()->getTransport()->query())
+   {
+      scheduleTile(tile_index);
+   }
+}
+
+void SimThreadManager::scheduleTile(UInt32 tile_index)
+{
+   if (__sync_bool_compare_and_swap(&m_tile_scheduled[tile_index], 0, 1))
+      pushReadyTile(tile_index);
+}
+
+void SimThreadManager::pushReadyTile(UInt32 tile_index)
+{
+   m_ready_tile_lock.acquire();
+   m_ready_tile_queue.push(tile_index);
+   m_ready_tile_lock.release();
+
+   m_ready_tile_sem.signal();
+}
+
+void SimThreadManager::tileReadyCallback(void *obj, tile_id_t tile_id)
+{
+   SimThreadManager *sim_thread_manager = (SimThreadManager*) obj;
+
+   LOG_ASSERT_ERROR(0 <= tile_id && tile_id < (tile_id_t) sim_thread_manager->m_tile_index_map.size(),
+                    "Unexpected tile id(%i)", tile_id);
+   SInt32 tile_index = sim_thread_manager->m_tile_index_map[tile_id];
+   LOG_ASSERT_ERROR(tile_index >= 0, "Tile(%i) does not live on this process", tile_id);
+
+   sim_thread_manager->scheduleTile(tile_index);
+}
+
+void SimThreadManager::terminateTileFunc(void *vp, NetPacket pkt)
+{
+   SimThreadManager *sim_thread_manager = (SimThreadManager*) vp;
+   UInt32 tile_index = sim_thread_manager->m_tile_index_map[pkt.receiver.tile_id];
+
+   sim_thread_manager->m_tile_terminated[tile_index] = 1;
+
+   ScopedLock sl(sim_thread_manager->m_ready_tile_lock);
+   if (++sim_thread_manager->m_num_terminated_tiles < sim_thread_manager->m_num_local_tiles)
+      return;
+
+   // All the local tiles are done, let every sim thread exit
+   for (UInt32 i = 0; i < sim_thread_manager->m_num_sim_threads; i++)
+   {
+      sim_thread_manager->m_ready_tile_queue.push(QUIT_TILE_INDEX);
+      sim_thread_manager->m_ready_tile_sem.signal();
+   }
+}
@@ -1,8 +1,18 @@
 #ifndef SIM_THREAD_MANAGER_H
 #define SIM_THREAD_MANAGER_H
 
+#include <queue>
+#include <vector>
+
 #include "sim_thread.h"
+#include "semaphore.h"
 
+// By default, every local tile gets its own sim thread. With
+// [general/num_sim_threads] smaller than the number of local tiles, that
+// many sim threads are shared by all the local tiles instead: the
+// transport reports the tiles that have messages, which are queued on a
+// ready list for the next free sim thread. A tile is on the ready list
+// (or being served) at most once, which keeps its messages in order.
 class SimThreadManager
 {
 public:
@@ -14,12 +24,44 @@ public:
 
    void simThreadStartCallback();
    void simThreadExitCallback();
+
+   // Pooled sim threads
+   bool isPoolEnabled() const { return m_pool_enabled; }
+   // Blocks till a tile has messages; returns false once all the local
+   // tiles have been terminated
+   bool getReadyTile(UInt32 &tile_index);
+   void tileProcessed(UInt32 tile_index);
+   bool isTileTerminated(UInt32 tile_index) const { return m_tile_terminated[tile_index]; }
    
 private:
    SimThread *m_sim_threads;
+   UInt32 m_num_sim_threads;
 
    Lock m_active_threads_lock;
    UInt32 m_active_threads;
+
+   bool m_pool_enabled;
+   UInt32 m_num_local_tiles;
+   // Tile ID -> local tile index (-1 for tiles of other processes)
+   std::vector<SInt32> m_tile_index_map;
+   // 1 while the tile is on the ready list or being served
+   volatile UInt32 *m_tile_scheduled;
+   // 1 once the tile is terminated (a word per tile: set and read by
+   // different pool threads)
+   volatile UInt32 *m_tile_terminated;
+   UInt32 m_num_terminated_tiles;
+
+   std::queue<UInt32> m_ready_tile_queue;
+   Lock m_ready_tile_lock;
+   Semaphore m_ready_tile_sem;
+
+   static const UInt32 QUIT_TILE_INDEX = ~((UInt32) 0);
+
+   void scheduleTile(UInt32 tile_index);
+   void pushReadyTile(UInt32 tile_index);
+
+   static void tileReadyCallback(void *obj, tile_id_t tile_id);
+   static void terminateTileFunc(void *vp, NetPacket pkt);
 };
 
 #endif // SIM_THREAD_MANAGER
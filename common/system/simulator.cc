@@ -18,8 +18,11 @@
 #include "clock_skew_management_object.h"
 #include "statistics_manager.h"
 #include "statistics_thread.h"
+#include "trace_recorder.h"
+#include "checkpoint.h"
 #include "contrib/dsent/dsent_contrib.h"
 #include "contrib/mcpat/cacti/io.h"
+#include "mcpat_cache_interface.h"
 
 Simulator *Simulator::m_singleton;
 config::Config *Simulator::m_config_file;
@@ -71,6 +74,7 @@ Simulator::Simulator()
    , m_clock_skew_management_manager(NULL)
    , m_statistics_manager(NULL)
    , m_statistics_thread(NULL)
+   , m_trace_recorder(NULL)
    , m_finished(false)
    , m_boot_time(getTime())
    , m_start_time(0)
@@ -101,6 +105,7 @@ void Simulator::start()
       // Initialize McPAT for core + cache power modeling
       string mcpat_path = m_graphite_home + "/contrib/mcpat";
       McPAT::initializeDatabase(mcpat_path);
+      McPATCacheInterface::initializeDatabase(mcpat_path);
    }
   
    m_transport = Transport::create();
@@ -108,6 +113,10 @@ void Simulator::start()
    // Initialize the DVFS
    DVFSManager::initializeDVFS();
 
+   // The cores look it up when they are constructed
+   if (m_config_file->getBool("trace/record", false))
+      m_trace_recorder = new TraceRecorder();
+
    m_tile_manager = new TileManager();
    m_thread_manager = new ThreadManager(m_tile_manager);
    m_thread_scheduler = ThreadScheduler::create(m_thread_manager, m_tile_manager);
@@ -193,6 +202,7 @@ Simulator::~Simulator()
    delete m_performance_counter_manager;
    delete m_thread_manager;
    delete m_thread_scheduler;
+   delete m_trace_recorder;
    delete m_tile_manager;
    m_tile_manager = NULL;
    delete m_transport;
@@ -302,10 +312,13 @@ void Simulator::disableModels()
 
 void Simulator::enablePerformanceModelsInCurrentProcess()
 {
-   Sim()->enableModels();
+   // The models may start from a checkpoint, or stay disabled up to it ([checkpoint])
+   if (Checkpoint::processModelsEnabled())
+      Sim()->enableModels();
 }
 
 void Simulator::disablePerformanceModelsInCurrentProcess()
 {
-   Sim()->disableModels();
+   if (Checkpoint::processModelsDisabled())
+      Sim()->disableModels();
 }
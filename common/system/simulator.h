@@ -17,6 +17,7 @@ class SimThreadManager;
 class ClockSkewManagementManager;
 class StatisticsManager;
 class StatisticsThread;
+class TraceRecorder;
 
 class Simulator
 {
@@ -41,6 +42,8 @@ public:
    ClockSkewManagementManager *getClockSkewManagementManager() { return m_clock_skew_management_manager; }
    StatisticsManager *getStatisticsManager() { return m_statistics_manager; } 
    StatisticsThread *getStatisticsThread() { return m_statistics_thread; } 
+   // NULL unless [trace] record = true
+   TraceRecorder *getTraceRecorder() { return m_trace_recorder; }
    Config *getConfig() { return &m_config; }
    config::Config *getCfg() { return m_config_file; }
 
@@ -86,6 +89,7 @@ private:
    ClockSkewManagementManager *m_clock_skew_management_manager;
    StatisticsManager *m_statistics_manager;
    StatisticsThread *m_statistics_thread;
+   TraceRecorder *m_trace_recorder;
 
    static Simulator *m_singleton;
 
@@ -3,11 +3,16 @@
 #include "config.h"
 #include "memory_manager.h"
 #include "network.h"
+#include "counter_sampler.h"
 #include "utils.h"
 #include "log.h"
 
 StatisticsManager::StatisticsManager()
+   : _counter_sampler(NULL)
 {
+   for (SInt32 i = 0; i < NUM_STATISTIC_TYPES; i++)
+      _statistic_enabled[i] = false;
+
    string enabled_statistics_line;
    try
    {
@@ -25,6 +30,7 @@ StatisticsManager::StatisticsManager()
    for (vector<string>::iterator it = enabled_statistics.begin(); it != enabled_statistics.end(); it ++)
    {
       StatisticType type = parseType(*it);
+      LOG_ASSERT_ERROR(type != NUM_STATISTIC_TYPES, "Unrecognized statistic(%s)", (*it).c_str());
       _statistic_enabled[type] = true;
    }
   
@@ -55,6 +61,16 @@ StatisticsManager::openTraceFiles()
             Network::openUtilizationTraceFiles();
             break;
 
+         case COUNTERS:
+            {
+               vector<string> components;
+               string components_line = Sim()->getCfg()->getString("statistics_trace/counters/components", "");
+               splitIntoTokens(components_line, components, ", ");
+               UInt32 block_size = Sim()->getCfg()->getInt("statistics_trace/counters/block_size", 64);
+               _counter_sampler = new CounterSampler(block_size, components);
+            }
+            break;
+
          default:
             LOG_PRINT_ERROR("Unrecognized Statistic Type(%i)", i);
             break;
@@ -80,6 +96,11 @@ StatisticsManager::closeTraceFiles()
             Network::closeUtilizationTraceFiles();
             break;
 
+         case COUNTERS:
+            delete _counter_sampler;
+            _counter_sampler = NULL;
+            break;
+
          default:
             LOG_PRINT_ERROR("Unrecognized Statistic Type(%i)", i);
             break;
@@ -105,6 +126,10 @@ StatisticsManager::outputPeriodicSummary()
             Network::outputUtilizationSummary();
             break;
 
+         case COUNTERS:
+            _counter_sampler->drain();
+            break;
+
          default:
             LOG_PRINT_ERROR("Unrecognized Statistic Type(%i)", i);
             break;
@@ -113,6 +138,13 @@ StatisticsManager::outputPeriodicSummary()
    }
 }
    
+void
+StatisticsManager::sampleCounters(UInt64 time)
+{
+   if (_counter_sampler)
+      _counter_sampler->sample(time);
+}
+
 StatisticsManager::StatisticType
 StatisticsManager::parseType(string type)
 {
@@ -120,6 +152,8 @@ StatisticsManager::parseType(string type)
       return CACHE_LINE_REPLICATION;
    else if (type == "network_utilization")
       return NETWORK_UTILIZATION;
+   else if (type == "counters")
+      return COUNTERS;
    else
       return NUM_STATISTIC_TYPES;
 }
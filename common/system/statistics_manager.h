@@ -4,6 +4,8 @@
 using std::string;
 #include "fixed_types.h"
 
+class CounterSampler;
+
 class StatisticsManager
 {
 public:
@@ -11,17 +13,21 @@ public:
    {
       CACHE_LINE_REPLICATION = 0,
       NETWORK_UTILIZATION,
+      COUNTERS,
       NUM_STATISTIC_TYPES
    };
 
    StatisticsManager();
    ~StatisticsManager();
    void outputPeriodicSummary();
+   // Called on the barrier path at every sampling interval
+   void sampleCounters(UInt64 time);
    UInt64 getSamplingInterval() { return _sampling_interval; }
 
 private:
    bool _statistic_enabled[NUM_STATISTIC_TYPES];
    UInt64 _sampling_interval;
+   CounterSampler* _counter_sampler;
 
    void openTraceFiles();
    void closeTraceFiles();
@@ -66,6 +66,10 @@ StatisticsThread::notify(UInt64 time)
 {
    if ((time % _statistics_manager->getSamplingInterval()) == 0)
    {
+      // Counters are copied out here, so the statistics thread only has to
+      // write them out
+      _statistics_manager->sampleCounters(time);
+
       LOG_ASSERT_WARNING(!_flag, "Sampling interval too small");
       _flag = true;
 
@@ -9,6 +9,7 @@
 #include "simulator.h"
 #include "thread_scheduler.h"
 #include "thread_manager.h"
+#include "trace_recorder.h"
 
 #include <iostream>
 
@@ -17,6 +18,7 @@ using namespace std;
 SyncClient::SyncClient(Core *core)
       : m_core(core)
       , m_network(core->getTile()->getNetwork())
+      , m_trace_recorder(Sim()->getTraceRecorder())
 {
 }
 
@@ -42,6 +44,9 @@ void SyncClient::mutexInit(carbon_mutex_t *mux)
 
    *mux = *((carbon_mutex_t*)recv_pkt.data);
 
+   if (m_trace_recorder)
+      m_trace_recorder->recordEvent(TraceFormat::MUTEX_INIT, *mux);
+
    delete [](Byte*) recv_pkt.data;
 }
 
@@ -53,6 +58,9 @@ void SyncClient::mutexLock(carbon_mutex_t *mux)
 
    int msg_type = MCP_MESSAGE_MUTEX_LOCK;
 
+   if (m_trace_recorder)
+      m_trace_recorder->recordEvent(TraceFormat::MUTEX_LOCK, *mux);
+
    UInt64 start_time = m_core->getModel()->getCurrTime().getTime();
 
    m_send_buff << msg_type << *mux << start_time;
@@ -98,6 +106,9 @@ void SyncClient::mutexUnlock(carbon_mutex_t *mux)
 
    int msg_type = MCP_MESSAGE_MUTEX_UNLOCK;
 
+   if (m_trace_recorder)
+      m_trace_recorder->recordEvent(TraceFormat::MUTEX_UNLOCK, *mux);
+
    UInt64 start_time = m_core->getModel()->getCurrTime().getTime();
 
    m_send_buff << msg_type << *mux << start_time;
@@ -137,6 +148,9 @@ void SyncClient::condInit(carbon_cond_t *cond)
 
    *cond = *((carbon_cond_t*)recv_pkt.data);
 
+   if (m_trace_recorder)
+      m_trace_recorder->recordEvent(TraceFormat::COND_INIT, *cond);
+
    delete [](Byte*) recv_pkt.data;
 }
 
@@ -148,6 +162,9 @@ void SyncClient::condWait(carbon_cond_t *cond, carbon_mutex_t *mux)
 
    int msg_type = MCP_MESSAGE_COND_WAIT;
 
+   if (m_trace_recorder)
+      m_trace_recorder->recordEvent(TraceFormat::COND_WAIT, *cond, *mux);
+
    UInt64 start_time = m_core->getModel()->getCurrTime().getTime();
 
    m_send_buff << msg_type << *cond << *mux << start_time;
@@ -193,6 +210,9 @@ void SyncClient::condSignal(carbon_cond_t *cond)
 
    int msg_type = MCP_MESSAGE_COND_SIGNAL;
 
+   if (m_trace_recorder)
+      m_trace_recorder->recordEvent(TraceFormat::COND_SIGNAL, *cond);
+
    UInt64 start_time = m_core->getModel()->getCurrTime().getTime();
 
    m_send_buff << msg_type << *cond << start_time;
@@ -220,6 +240,9 @@ void SyncClient::condBroadcast(carbon_cond_t *cond)
 
    int msg_type = MCP_MESSAGE_COND_BROADCAST;
 
+   if (m_trace_recorder)
+      m_trace_recorder->recordEvent(TraceFormat::COND_BROADCAST, *cond);
+
    UInt64 start_time = m_core->getModel()->getCurrTime().getTime();
 
    m_send_buff << msg_type << *cond << start_time;
@@ -259,6 +282,9 @@ void SyncClient::barrierInit(carbon_barrier_t *barrier, UInt32 count)
 
    *barrier = *((carbon_barrier_t*)recv_pkt.data);
 
+   if (m_trace_recorder)
+      m_trace_recorder->recordEvent(TraceFormat::BARRIER_INIT, *barrier, count);
+
    delete [](Byte*) recv_pkt.data;
 }
 
@@ -270,6 +296,9 @@ void SyncClient::barrierWait(carbon_barrier_t *barrier)
 
    int msg_type = MCP_MESSAGE_BARRIER_WAIT;
 
+   if (m_trace_recorder)
+      m_trace_recorder->recordEvent(TraceFormat::BARRIER_WAIT, *barrier);
+
    UInt64 start_time = m_core->getModel()->getCurrTime().getTime();
 
    m_send_buff << msg_type << *barrier << start_time;
@@ -6,6 +6,7 @@
 
 class Core;
 class Network;
+class TraceRecorder;
 
 class SyncClient
 {
@@ -45,6 +46,7 @@ class SyncClient
    private:
       Core *m_core;
       Network *m_network;
+      TraceRecorder *m_trace_recorder;
       UnstructuredBuffer m_send_buff;
       UnstructuredBuffer m_recv_buff;
 
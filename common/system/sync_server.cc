@@ -4,6 +4,7 @@
 #include "thread_manager.h"
 #include "tile_manager.h"
 #include "thread_scheduler.h"
+#include "statistics_registry.h"
 
 using namespace std;
 
@@ -168,7 +169,13 @@ void SimBarrier::wait(core_id_t core_id, UInt64 time, WakeupList &woken_list)
 
 SyncServer::SyncServer(Network &network, UnstructuredBuffer &recv_buffer)
       : m_network(network),
-      m_recv_buffer(recv_buffer)
+      m_recv_buffer(recv_buffer),
+      m_total_mutex_locks(0),
+      m_total_contended_mutex_locks(0),
+      m_total_cond_waits(0),
+      m_total_cond_signals(0),
+      m_total_cond_broadcasts(0),
+      m_total_barrier_waits(0)
 { }
 
 SyncServer::~SyncServer()
@@ -194,6 +201,7 @@ void SyncServer::mutexLock(core_id_t core_id)
 
    SimMutex *psimmux = &m_mutexes[mux];
 
+   m_total_mutex_locks ++;
    if (psimmux->lock(core_id))
    {
       // notify the owner
@@ -205,6 +213,7 @@ void SyncServer::mutexLock(core_id_t core_id)
    else
    {
       // nothing...thread goes to sleep
+      m_total_contended_mutex_locks ++;
    }
 }
 
@@ -262,6 +271,7 @@ void SyncServer::condWait(core_id_t core_id)
    assert((size_t)cond < m_conds.size());
 
    SimCond *psimcond = &m_conds[cond];
+   m_total_cond_waits ++;
 
    StableIterator<SimMutex> it(m_mutexes, mux);
    core_id_t new_mutex_owner = psimcond->wait(core_id, time, it);
@@ -290,6 +300,7 @@ void SyncServer::condSignal(core_id_t core_id)
 
    SimCond *psimcond = &m_conds[cond];
 
+   m_total_cond_signals ++;
    core_id_t woken = psimcond->signal(core_id, time);
 
    if (woken.tile_id != INVALID_TILE_ID)
@@ -323,6 +334,7 @@ void SyncServer::condBroadcast(core_id_t core_id)
 
    SimCond *psimcond = &m_conds[cond];
 
+   m_total_cond_broadcasts ++;
    SimCond::WakeupList woken_list;
    psimcond->broadcast(core_id, time, woken_list);
 
@@ -366,6 +378,7 @@ void SyncServer::barrierWait(core_id_t core_id)
 
    SimBarrier *psimbarrier = &m_barriers[barrier];
 
+   m_total_barrier_waits ++;
    SimBarrier::WakeupList woken_list;
    psimbarrier->wait(core_id, time, woken_list);
 
@@ -381,3 +394,37 @@ void SyncServer::barrierWait(core_id_t core_id)
       m_network.netSend(core_id, MCP_RESPONSE_TYPE, (char*)&r, sizeof(r));
    }
 }
+
+void SyncServer::registerStatistics(StatisticsRegistry* registry)
+{
+   registry->registerCounter("sync_server", "mutex_locks", &m_total_mutex_locks);
+   registry->registerCounter("sync_server", "contended_mutex_locks", &m_total_contended_mutex_locks);
+   registry->registerCounter("sync_server", "cond_waits", &m_total_cond_waits);
+   registry->registerCounter("sync_server", "cond_signals", &m_total_cond_signals);
+   registry->registerCounter("sync_server", "cond_broadcasts", &m_total_cond_broadcasts);
+   registry->registerCounter("sync_server", "barrier_waits", &m_total_barrier_waits);
+}
+
+void SyncServer::checkpoint(UnstructuredBuffer& buffer)
+{
+   buffer << (UInt32) m_mutexes.size() << (UInt32) m_conds.size() << (UInt32) m_barriers.size();
+   for (MutexVector::iterator it = m_mutexes.begin(); it != m_mutexes.end(); it++)
+      buffer << (Boolean) it->isLocked();
+}
+
+void SyncServer::restore(UnstructuredBuffer& buffer)
+{
+   UInt32 num_mutexes, num_conds, num_barriers;
+   buffer >> num_mutexes >> num_conds >> num_barriers;
+   LOG_ASSERT_ERROR(num_mutexes == m_mutexes.size() && num_conds == m_conds.size() && num_barriers == m_barriers.size(),
+                    "Checkpoint has %u mutexes, %u conds, %u barriers; application has %u, %u, %u",
+                    num_mutexes, num_conds, num_barriers,
+                    (UInt32) m_mutexes.size(), (UInt32) m_conds.size(), (UInt32) m_barriers.size());
+   for (UInt32 i = 0; i < num_mutexes; i++)
+   {
+      Boolean locked;
+      buffer >> locked;
+      LOG_ASSERT_ERROR(locked == m_mutexes[i].isLocked(), "Mutex(%u) is %slocked in the checkpoint, but not in the application",
+                       i, locked ? "" : "un");
+   }
+}
@@ -12,6 +12,8 @@
 #include "packetize.h"
 #include "stable_iterator.h"
 
+class StatisticsRegistry;
+
 class SimMutex
 {
    public:
@@ -27,6 +29,8 @@ class SimMutex
       // the server
       core_id_t unlock(core_id_t core_id);
 
+      bool isLocked() const { return (m_owner.tile_id != INVALID_TILE_ID); }
+
    private:
       typedef std::queue<core_id_t> ThreadQueue;
 
@@ -113,9 +117,24 @@ class SyncServer
       void barrierInit(core_id_t);
       void barrierWait(core_id_t);
 
+      void registerStatistics(StatisticsRegistry* registry);
+
+      // The synchronization objects belong to the application threads, so a
+      // checkpoint only records how many there are, and restore() checks
+      // that the application reached the same point
+      void checkpoint(UnstructuredBuffer& buffer);
+      void restore(UnstructuredBuffer& buffer);
+
    private:
       Network &m_network;
       UnstructuredBuffer &m_recv_buffer;
+
+      UInt64 m_total_mutex_locks;
+      UInt64 m_total_contended_mutex_locks;
+      UInt64 m_total_cond_waits;
+      UInt64 m_total_cond_signals;
+      UInt64 m_total_cond_broadcasts;
+      UInt64 m_total_barrier_waits;
 };
 
 #endif // SYNC_SERVER_H
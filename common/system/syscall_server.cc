@@ -18,6 +18,7 @@
 #include "mcp.h"
 #include "simulator.h"
 #include "thread_manager.h"
+#include "statistics_registry.h"
 
 #include "log.h"
 
@@ -32,6 +33,8 @@ SyscallServer::SyscallServer(Network & network,
    , m_recv_buff(recv_buff_)
    , m_SYSCALL_SERVER_MAX_BUFF(SERVER_MAX_BUFF)
    , m_scratch(scratch_)
+   , m_total_syscalls(0)
+   , m_total_futex_calls(0)
 {
 }
 
@@ -39,6 +42,12 @@ SyscallServer::~SyscallServer()
 {
 }
 
+void SyscallServer::registerStatistics(StatisticsRegistry* registry)
+{
+   registry->registerCounter("syscall_server", "syscalls", &m_total_syscalls);
+   registry->registerCounter("syscall_server", "futex_calls", &m_total_futex_calls);
+}
+
 
 void SyscallServer::handleSyscall(core_id_t core_id)
 {
@@ -47,6 +56,8 @@ void SyscallServer::handleSyscall(core_id_t core_id)
 
    LOG_PRINT("Syscall: %i from core(%i, %i)", syscall_number, core_id.tile_id, core_id.core_type);
 
+   m_total_syscalls ++;
+
    switch (syscall_number)
    {
    case SYS_open:
@@ -760,6 +771,8 @@ void SyscallServer::marshallSchedGetAffinityCall(core_id_t core_id)
 
 void SyscallServer::marshallFutexCall(core_id_t core_id)
 {
+   m_total_futex_calls ++;
+
    int *addr1;
    int op;
    int val1;
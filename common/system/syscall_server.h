@@ -22,6 +22,8 @@
 #include "fixed_types.h"
 #include "network.h"
 
+class StatisticsRegistry;
+
 // -- Special Class to Handle Futexes
 class SimFutex
 {
@@ -47,6 +49,8 @@ public:
 
    void handleSyscall(core_id_t core_id);
 
+   void registerStatistics(StatisticsRegistry* registry);
+
 private:
    void marshallOpenCall(core_id_t core_id);
    void marshallReadCall(core_id_t core_id);
@@ -94,6 +98,9 @@ private:
    // Handling Futexes
    typedef std::map<IntPtr, SimFutex> FutexMap;
    FutexMap m_futexes;
+
+   UInt64 m_total_syscalls;
+   UInt64 m_total_futex_calls;
 };
 
 #endif
@@ -16,6 +16,7 @@
 #include "core_model.h"
 #include "thread.h"
 #include "packetize.h"
+#include "trace_recorder.h"
 
 ThreadManager::ThreadManager(TileManager *tile_manager)
    : m_thread_spawn_sem(0)
@@ -172,6 +173,9 @@ void ThreadManager::onThreadExit()
 
    m_thread_scheduler->onThreadExit();
 
+   if (Sim()->getTraceRecorder())
+      Sim()->getTraceRecorder()->onThreadExit();
+
    // Set the CoreState to 'IDLE'
    core->setState(Core::IDLE);
 
@@ -269,6 +273,9 @@ SInt32 ThreadManager::spawnThread(tile_id_t dest_tile_id, thread_func_t func, vo
    thread_id_t dest_thread_id = *(thread_id_t*) ((Byte*) pkt.data + sizeof(core_id_t) + sizeof(thread_id_t));
    LOG_PRINT("Thread: %i spawned on core(%d, %d), idx(%i)", dest_thread_id, dest_tile_id, dest_core_id.core_type, dest_thread_index);
 
+   if (Sim()->getTraceRecorder())
+      Sim()->getTraceRecorder()->recordEvent(TraceFormat::THREAD_SPAWN, dest_thread_id, dest_tile_id);
+
    // Delete the data buffer
    delete [] (Byte*) pkt.data;
 
@@ -418,6 +425,9 @@ void ThreadManager::masterSpawnThreadReply(ThreadSpawnRequest *req)
 
 void ThreadManager::joinThread(thread_id_t join_thread_id)
 {
+   if (Sim()->getTraceRecorder())
+      Sim()->getTraceRecorder()->recordEvent(TraceFormat::THREAD_JOIN, join_thread_id);
+
    // Send the message to the master process; will get reply when thread is finished
    Core* core = m_tile_manager->getCurrentCore();
    thread_id_t thread_idx = m_tile_manager->getCurrentThreadIndex();
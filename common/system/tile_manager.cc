@@ -8,6 +8,8 @@
 #include <vector>
 
 #include "tile_manager.h"
+#include "simulator.h"
+#include "thread.h"
 #include "tile.h"
 #include "network.h"
 #include "cache.h"
@@ -26,20 +28,20 @@ TileManager::TileManager()
    , m_thread_index_tls(TLS::create())
    , m_thread_type_tls(TLS::create())
    , m_num_registered_sim_threads(0)
+   , m_num_constructed_tiles(0)
+   , m_num_claimed_tiles(0)
 {
    LOG_PRINT("Starting TileManager Constructor.");
 
    UInt32 num_local_tiles = Config::getSingleton()->getNumLocalTiles();
 
-   UInt32 proc_id = Config::getSingleton()->getCurrentProcessNum();
-   const Config::TileList &local_tiles = Config::getSingleton()->getTileListForProcess(proc_id);
-
    m_max_threads_per_core = Config::getSingleton()->getMaxThreadsPerCore();
    m_initialized_threads = new bool*[num_local_tiles];
 
+   constructTiles();
+
    for (UInt32 i = 0; i < num_local_tiles; i++)
    {
-      m_tiles.push_back(new Tile(local_tiles.at(i)));
       m_initialized_cores.push_back(false);
       m_num_initialized_threads.push_back(0);
 
@@ -53,6 +55,8 @@ TileManager::TileManager()
 
 TileManager::~TileManager()
 {
+   for (UInt32 i = 0; i < m_tile_construction_threads.size(); i++)
+      delete m_tile_construction_threads[i];
    for (std::vector<Tile *>::iterator i = m_tiles.begin(); i != m_tiles.end(); i++)
       delete *i;
    delete m_tile_tls;
@@ -67,6 +71,65 @@ TileManager::~TileManager()
    m_thread_type_tls = NULL;
 }
 
+void TileManager::constructTiles()
+{
+   UInt32 num_local_tiles = Config::getSingleton()->getNumLocalTiles();
+   m_tiles.resize(num_local_tiles, NULL);
+
+   // 0 uses one thread per host CPU
+   UInt32 num_threads = (UInt32) Sim()->getCfg()->getInt("general/num_startup_threads", 0);
+   if (num_threads == 0)
+      num_threads = std::max(sysconf(_SC_NPROCESSORS_ONLN), 1L);
+   num_threads = std::min(num_threads, num_local_tiles);
+
+   LOG_PRINT("Constructing %u tiles with %u threads", num_local_tiles, num_threads);
+
+   // Tiles are claimed by index and stored at their index, so the result does
+   // not depend on which thread builds which tile. The calling thread builds
+   // tiles too, and only waits for the ones claimed by the helper threads:
+   // under Pin, internal threads spawned before the application starts do not
+   // run yet, and the calling thread then builds every tile itself.
+   for (UInt32 i = 1; i < num_threads; i++)
+   {
+      Thread *thread = Thread::create(constructTilesFunc, this);
+      m_tile_construction_threads.push_back(thread);
+      thread->run();
+   }
+
+   constructTilesFunc(this);
+
+   ScopedLock sl(m_tile_construction_lock);
+   while (m_num_constructed_tiles < num_local_tiles)
+      m_tile_construction_cond.wait(m_tile_construction_lock);
+
+   LOG_PRINT("Constructed %u tiles", num_local_tiles);
+}
+
+void TileManager::constructTilesFunc(void *vp)
+{
+   TileManager *tile_manager = (TileManager*) vp;
+   UInt32 num_local_tiles = Config::getSingleton()->getNumLocalTiles();
+   const Config::TileList &local_tiles = Config::getSingleton()->getTileListForProcess(Config::getSingleton()->getCurrentProcessNum());
+
+   while (true)
+   {
+      UInt32 tile_index;
+      {
+         ScopedLock sl(tile_manager->m_tile_construction_lock);
+         if (tile_manager->m_num_claimed_tiles == num_local_tiles)
+            return;
+         tile_index = tile_manager->m_num_claimed_tiles++;
+      }
+
+      Tile *tile = new Tile(local_tiles.at(tile_index));
+
+      ScopedLock sl(tile_manager->m_tile_construction_lock);
+      tile_manager->m_tiles[tile_index] = tile;
+      if (++tile_manager->m_num_constructed_tiles == num_local_tiles)
+         tile_manager->m_tile_construction_cond.signal();
+   }
+}
+
 void TileManager::initializeCommId(SInt32 comm_id)
 {
    LOG_PRINT("initializeCommId - current tile (id) = %p (%d)", getCurrentTile(), getCurrentTileID());
@@ -344,6 +407,25 @@ tile_id_t TileManager::registerSimThread()
     return tile->getId();
 }
 
+void TileManager::registerSimPoolThread()
+{
+    LOG_ASSERT_ERROR(getCurrentTile() == NULL, "registerSimPoolThread - Initialized thread twice");
+
+    m_tile_tls->insert((Tile*) NULL);
+    m_tile_index_tls->insertInt(-1);
+    m_thread_type_tls->insertInt(SIM_THREAD);
+}
+
+Tile *TileManager::setCurrentSimPoolTile(UInt32 tile_index)
+{
+    Tile *tile = m_tiles.at(tile_index);
+
+    m_tile_tls->set(tile);
+    m_tile_index_tls->setInt(tile_index);
+
+    return tile;
+}
+
 bool TileManager::amiSimThread()
 {
     return m_thread_type_tls ? (m_thread_type_tls->getInt() == SIM_THREAD) : false;
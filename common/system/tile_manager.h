@@ -9,9 +9,11 @@
 #include "fixed_types.h"
 #include "tls.h"
 #include "lock.h"
+#include "cond.h"
 
 class Tile;
 class Core;
+class Thread;
 
 class TileManager
 {
@@ -23,6 +25,9 @@ public:
    void initializeThread(core_id_t core_id, SInt32 thread_index = 0, thread_id_t thread_id = 0);
    void terminateThread();
    tile_id_t registerSimThread();
+   // Sim threads of a pool serve any local tile (see SimThreadManager)
+   void registerSimPoolThread();
+   Tile *setCurrentSimPoolTile(UInt32 tile_index);
 
    core_id_t getCurrentCoreID(); // id of currently active core (or INVALID_CORE_ID)
    tile_id_t getCurrentTileID(); // id of currently active core (or INVALID_TILE_ID)
@@ -49,6 +54,10 @@ public:
 
 private:
 
+   // Tiles are built in parallel at startup (general/num_startup_threads)
+   void constructTiles();
+   static void constructTilesFunc(void *vp);
+
    void doInitializeThread(UInt32 tile_index, SInt32 thread_index, thread_id_t thread_id);
 
    TLS *m_tile_tls;
@@ -77,6 +86,12 @@ private:
 
    std::vector<Tile*> m_tiles;
    UInt32 m_max_threads_per_core;
+
+   std::vector<Thread*> m_tile_construction_threads;
+   UInt32 m_num_constructed_tiles;
+   UInt32 m_num_claimed_tiles;
+   Lock m_tile_construction_lock;
+   ConditionVariable m_tile_construction_cond;
 };
 
 #endif
@@ -1,13 +1,16 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <fstream>
 #include <algorithm>
 #include "log.h"
 #include "simulator.h"
 #include "config.h"
 #include "transport.h"
+#include "packet_buffer.h"
 #include "tile.h"
 #include "tile_manager.h"
+#include "statistics_registry.h"
 
 using namespace std;
 
@@ -16,8 +19,12 @@ using namespace std;
 // Collect output summaries for all the tiles and send them to process
 // zero. This process then formats the output to look pretty. Only
 // process zero writes to the output stream passed in.
+//
+// The registered counters of all the tiles (including the system tiles)
+// follow the summaries, and process zero writes them out as stats.json
+// and stats.csv next to the output file.
 
-static void gatherSummaries(vector<string> &summaries)
+static void gatherSummaries(vector<string> &summaries, vector<StatisticsRegistry::ValueList> &statistics)
 {
    Config *cfg = Config::getSingleton();
    Transport::Node *global_node = Transport::getSingleton()->getGlobalNode();
@@ -41,11 +48,27 @@ static void gatherSummaries(vector<string> &summaries)
 
          buf = global_node->recv();
          assert(*((tile_id_t*)buf) == tl[t]);
-         delete [] buf;
+         PacketBuffer::release(buf);
 
          buf = global_node->recv();
          summaries[tl[t]] = string((char*)buf);
-         delete [] buf;
+         PacketBuffer::release(buf);
+      }
+
+      // receive statistics
+      const Config::TileList &all_tl = cfg->getTileListForProcess(p);
+
+      for (UInt32 t = 0; t < all_tl.size(); t++)
+      {
+         Byte *buf;
+
+         buf = global_node->recv();
+         assert(*((tile_id_t*)buf) == all_tl[t]);
+         PacketBuffer::release(buf);
+
+         buf = global_node->recv();
+         StatisticsRegistry::deserialize(string((char*)buf), statistics[all_tl[t]]);
+         PacketBuffer::release(buf);
       }
    }
 
@@ -214,7 +237,7 @@ void TileManager::outputSummary(ostream &os)
    {
       Byte *buf = global_node->recv();
       assert(*((UInt32*)buf) == cfg->getCurrentProcessNum());
-      delete [] buf;
+      PacketBuffer::release(buf);
    }
 
    // send each summary
@@ -229,17 +252,37 @@ void TileManager::outputSummary(ostream &os)
       global_node->globalSend(0, ss.str().c_str(), ss.str().length()+1);
    }
 
+   // send the statistics of each tile
+   const Config::TileList &all_tl = cfg->getTileListForProcess(cfg->getCurrentProcessNum());
+
+   for (UInt32 i = 0; i < all_tl.size(); i++)
+   {
+      stringstream ss;
+      m_tiles[i]->getStatisticsRegistry()->serialize(ss);
+      global_node->globalSend(0, &all_tl[i], sizeof(all_tl[i]));
+      global_node->globalSend(0, ss.str().c_str(), ss.str().length()+1);
+   }
+
    // format (only done on proc 0)
    if (cfg->getCurrentProcessNum() != 0)
       return;
 
    vector<string> summaries(cfg->getApplicationTiles());
+   vector<StatisticsRegistry::ValueList> statistics(cfg->getTotalTiles());
    string formatted;
 
-   gatherSummaries(summaries);
+   gatherSummaries(summaries, statistics);
    formatted = formatSummaries(summaries);
 
    os << formatted;                   
 
+   ofstream json_os(cfg->formatOutputFileName("stats.json").c_str());
+   StatisticsRegistry::outputJSON(json_os, statistics);
+   json_os.close();
+
+   ofstream csv_os(cfg->formatOutputFileName("stats.csv").c_str());
+   StatisticsRegistry::outputCSV(csv_os, statistics);
+   csv_os.close();
+
    LOG_PRINT("Finished outputSummary");
 }
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "fixed_types.h"
+
+// Per-thread traces of the calls a frontend makes into the core, memory and
+// synchronization models, as written by TraceRecorder ([trace] record = true)
+// and replayed by tools/carbon_replay.
+//
+// Each thread of the application has its own file, trace_<thread id>.trc,
+// in the output directory (little endian):
+//   MAGIC, VERSION (UInt32 each), thread id and tile id (SInt32 each)
+//   records: a type byte, followed by its fields
+//
+// All the fields are LEB128 encoded, and the signed ones are zig-zag encoded
+// first. Addresses are written as the difference from the previous address
+// of the same kind, so most records take a few bytes:
+//   INSTRUCTION_DEFINE    first execution of a static instruction. It gets
+//                         the next instruction id (from 0) of the trace:
+//                         type, opcode, address (from the previous
+//                         instruction), size, atomic, read registers (count,
+//                         registers), write registers (count, registers),
+//                         number of read and write memory operands,
+//                         immediates (count, immediates), then whether it has
+//                         McPAT information and if so, its micro-ops (count,
+//                         micro-ops), register file accesses (4 counters) and
+//                         execution units (count, units)
+//   INSTRUCTION_NEXT      execution of the instruction following the previous
+//                         one in id order
+//   INSTRUCTION           execution of another instruction: id (signed, from
+//                         the id following the previous one)
+//   BRANCH_TAKEN,
+//   BRANCH_NOT_TAKEN      outcome of the previous instruction: target (signed,
+//                         from the previous instruction address)
+//   MEMORY_ACCESS + 3 * mem_op + lock_signal
+//                         data memory access: size, address (signed, from the
+//                         previous memory access)
+//   MUTEX_INIT, MUTEX_LOCK, MUTEX_UNLOCK, COND_INIT, COND_SIGNAL,
+//   COND_BROADCAST, BARRIER_WAIT
+//                         object id
+//   COND_WAIT             condition variable id, mutex id
+//   BARRIER_INIT          barrier id, count
+//   THREAD_SPAWN          thread id, tile id
+//   THREAD_JOIN           thread id
+//   ENABLE_MODELS,
+//   DISABLE_MODELS        CarbonEnableModels() / CarbonDisableModels()
+//
+// Object and thread ids are the ones the simulation gave out when recording.
+class TraceFormat
+{
+public:
+   static const UInt32 MAGIC = 0x43525447;   // "GTRC"
+   static const UInt32 VERSION = 1;
+
+   enum RecordType
+   {
+      INSTRUCTION_DEFINE = 0,
+      INSTRUCTION_NEXT,
+      INSTRUCTION,
+      BRANCH_TAKEN,
+      BRANCH_NOT_TAKEN,
+      MUTEX_INIT,
+      MUTEX_LOCK,
+      MUTEX_UNLOCK,
+      COND_INIT,
+      COND_WAIT,
+      COND_SIGNAL,
+      COND_BROADCAST,
+      BARRIER_INIT,
+      BARRIER_WAIT,
+      THREAD_SPAWN,
+      THREAD_JOIN,
+      ENABLE_MODELS,
+      DISABLE_MODELS,
+      MEMORY_ACCESS,
+      NUM_RECORD_TYPES = MEMORY_ACCESS + 9
+   };
+
+   struct Header
+   {
+      UInt32 magic;
+      UInt32 version;
+      SInt32 thread_id;
+      SInt32 tile_id;
+   };
+};
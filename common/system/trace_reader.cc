@@ -0,0 +1,174 @@
+#include "trace_reader.h"
+#include "instruction.h"
+#include "varint.h"
+#include "log.h"
+
+using namespace std;
+
+TraceReader::TraceReader(const string& filename)
+   : m_filename(filename)
+   , m_curr(NULL)
+   , m_end(NULL)
+   , m_thread_id(INVALID_THREAD_ID)
+   , m_tile_id(INVALID_TILE_ID)
+   , m_last_instruction_id(0)
+   , m_last_instruction_address(0)
+   , m_last_memory_address(0)
+{
+   if (!m_file.open(filename, sizeof(TraceFormat::Header)))
+   {
+      LOG_PRINT("No trace file(%s)", filename.c_str());
+      return;
+   }
+
+   const TraceFormat::Header* header = (const TraceFormat::Header*) m_file.getData();
+   LOG_ASSERT_ERROR(header->magic == TraceFormat::MAGIC && header->version == TraceFormat::VERSION,
+                    "%s is not a trace file (version %u)", filename.c_str(), TraceFormat::VERSION);
+   m_thread_id = header->thread_id;
+   m_tile_id = header->tile_id;
+
+   m_curr = m_file.getData() + sizeof(TraceFormat::Header);
+   m_end = m_file.getData() + m_file.getLength();
+}
+
+TraceReader::~TraceReader()
+{
+   for (vector<Instruction*>::iterator it = m_instructions.begin(); it != m_instructions.end(); it++)
+   {
+      delete (*it)->getMcPATInstruction();
+      delete *it;
+   }
+}
+
+bool
+TraceReader::next(Record& record)
+{
+   if (m_curr == m_end)
+      return false;
+
+   UInt32 type = *m_curr++;
+   LOG_ASSERT_ERROR(type < TraceFormat::NUM_RECORD_TYPES, "Corrupt trace file(%s): record type(%u)",
+                    m_filename.c_str(), type);
+
+   record.type = (TraceFormat::RecordType) type;
+   switch (type)
+   {
+   case TraceFormat::INSTRUCTION_DEFINE:
+   case TraceFormat::INSTRUCTION_NEXT:
+   case TraceFormat::INSTRUCTION:
+      if (type == TraceFormat::INSTRUCTION_DEFINE)
+         defineInstruction();
+      else if (type == TraceFormat::INSTRUCTION_NEXT)
+         m_last_instruction_id ++;
+      else
+         m_last_instruction_id += 1 + decodeSigned();
+
+      LOG_ASSERT_ERROR(m_last_instruction_id < m_instructions.size(), "Corrupt trace file(%s): instruction(%u)",
+                       m_filename.c_str(), m_last_instruction_id);
+      record.type = TraceFormat::INSTRUCTION;
+      record.instruction = m_instructions[m_last_instruction_id];
+      m_last_instruction_address = record.instruction->getAddress();
+      break;
+
+   case TraceFormat::BRANCH_TAKEN:
+   case TraceFormat::BRANCH_NOT_TAKEN:
+      record.address = m_last_instruction_address + decodeSigned();
+      break;
+
+   case TraceFormat::COND_WAIT:
+   case TraceFormat::BARRIER_INIT:
+   case TraceFormat::THREAD_SPAWN:
+      record.arg0 = decodeSigned();
+      record.arg1 = decodeSigned();
+      break;
+
+   case TraceFormat::ENABLE_MODELS:
+   case TraceFormat::DISABLE_MODELS:
+      break;
+
+   default:
+      if (type >= TraceFormat::MEMORY_ACCESS)
+      {
+         record.type = TraceFormat::MEMORY_ACCESS;
+         record.mem_op = (type - TraceFormat::MEMORY_ACCESS) / 3;
+         record.lock_signal = (type - TraceFormat::MEMORY_ACCESS) % 3;
+         record.size = decode();
+         record.address = m_last_memory_address + decodeSigned();
+         m_last_memory_address = record.address;
+      }
+      else
+      {
+         record.arg0 = decodeSigned();
+      }
+      break;
+   }
+
+   return true;
+}
+
+void
+TraceReader::defineInstruction()
+{
+   InstructionType type = (InstructionType) decode();
+   UInt64 opcode = decode();
+   IntPtr address = m_last_instruction_address + decodeSigned();
+   UInt32 size = decode();
+   bool atomic = decode();
+
+   RegisterOperandList read_registers(decode());
+   for (UInt32 i = 0; i < read_registers.size(); i++)
+      read_registers[i] = decode();
+   RegisterOperandList write_registers(decode());
+   for (UInt32 i = 0; i < write_registers.size(); i++)
+      write_registers[i] = decode();
+   UInt32 num_read_memory_operands = decode();
+   UInt32 num_write_memory_operands = decode();
+   ImmediateOperandList immediates(decode());
+   for (UInt32 i = 0; i < immediates.size(); i++)
+      immediates[i] = decode();
+   OperandList operands(read_registers, write_registers, num_read_memory_operands, num_write_memory_operands, immediates);
+
+   McPATInstruction* mcpat_instruction = NULL;
+   if (decode())
+   {
+      McPATInstruction::MicroOpList micro_ops(decode());
+      for (UInt32 i = 0; i < micro_ops.size(); i++)
+         micro_ops[i] = (McPATInstruction::MicroOpType) decode();
+      McPATInstruction::RegisterFile register_file;
+      register_file._num_integer_reads = decode();
+      register_file._num_integer_writes = decode();
+      register_file._num_floating_point_reads = decode();
+      register_file._num_floating_point_writes = decode();
+      McPATInstruction::ExecutionUnitList execution_units(decode());
+      for (UInt32 i = 0; i < execution_units.size(); i++)
+         execution_units[i] = (McPATInstruction::ExecutionUnitType) decode();
+      mcpat_instruction = new McPATInstruction(micro_ops, register_file, execution_units);
+   }
+
+   LOG_ASSERT_ERROR(type < MAX_INSTRUCTION_COUNT, "Corrupt trace file(%s): instruction type(%u)",
+                    m_filename.c_str(), type);
+   if (type == INST_BRANCH)
+      m_instructions.push_back(new BranchInstruction(opcode, address, size, atomic, operands, mcpat_instruction));
+   else
+      m_instructions.push_back(new Instruction(type, opcode, address, size, atomic, operands, mcpat_instruction));
+
+   m_last_instruction_id = m_instructions.size() - 1;
+}
+
+UInt64
+TraceReader::decode()
+{
+   UInt64 value;
+   __attribute__((unused)) bool ok = decodeVarint(m_curr, m_end, value);
+   LOG_ASSERT_ERROR(ok, "Corrupt trace file(%s): truncated record", m_filename.c_str());
+   return value;
+}
+
+SInt64
+TraceReader::decodeSigned()
+{
+   SInt64 value;
+   __attribute__((unused)) bool ok = decodeSignedVarint(m_curr, m_end, value);
+   LOG_ASSERT_ERROR(ok, "Corrupt trace file(%s): truncated record", m_filename.c_str());
+   return value;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "trace_format.h"
+#include "mapped_file.h"
+#include "fixed_types.h"
+
+class Instruction;
+
+// Reads back the trace of one thread (see TraceFormat). The file is mapped
+// into memory and decoded one record at a time.
+class TraceReader
+{
+public:
+   struct Record
+   {
+      // INSTRUCTION_DEFINE and INSTRUCTION_NEXT are returned as INSTRUCTION,
+      // and all the memory accesses as MEMORY_ACCESS
+      TraceFormat::RecordType type;
+      Instruction* instruction;
+      IntPtr address;            // Branch target or memory address
+      UInt32 size;
+      UInt32 lock_signal;
+      UInt32 mem_op;
+      SInt32 arg0;
+      SInt32 arg1;
+   };
+
+   // A missing file reads as an empty trace: threads that never called into
+   // the models have none
+   TraceReader(const std::string& filename);
+   // Frees the instructions: the core models must not use them anymore
+   ~TraceReader();
+
+   thread_id_t getThreadId() const { return m_thread_id; }
+   tile_id_t getTileId() const { return m_tile_id; }
+
+   // Returns false at the end of the trace
+   bool next(Record& record);
+
+private:
+   std::string m_filename;
+   MappedFile m_file;
+   const Byte* m_curr;
+   const Byte* m_end;
+
+   thread_id_t m_thread_id;
+   tile_id_t m_tile_id;
+
+   std::vector<Instruction*> m_instructions;
+   UInt32 m_last_instruction_id;
+   IntPtr m_last_instruction_address;
+   IntPtr m_last_memory_address;
+
+   void defineInstruction();
+   UInt64 decode();
+   SInt64 decodeSigned();
+};
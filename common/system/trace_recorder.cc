@@ -0,0 +1,96 @@
+#include <sstream>
+#include <algorithm>
+
+#include "trace_recorder.h"
+#include "trace_writer.h"
+#include "simulator.h"
+#include "tile_manager.h"
+#include "config.h"
+#include "tls.h"
+#include "log.h"
+
+using namespace std;
+
+TraceRecorder::TraceRecorder()
+   : m_writer_tls(TLS::create())
+{}
+
+TraceRecorder::~TraceRecorder()
+{
+   for (vector<TraceWriter*>::iterator it = m_writers.begin(); it != m_writers.end(); it++)
+      delete *it;
+   delete m_writer_tls;
+}
+
+TraceWriter*
+TraceRecorder::getWriter()
+{
+   TraceWriter* writer = m_writer_tls->get<TraceWriter>();
+   if (writer)
+      return writer;
+
+   // The trace of a thread is opened when it first calls into the models
+   thread_id_t thread_id = Sim()->getTileManager()->getCurrentThreadID();
+   tile_id_t tile_id = Sim()->getTileManager()->getCurrentTileID();
+   LOG_ASSERT_ERROR(thread_id != INVALID_THREAD_ID, "Recording a trace from a thread that is not an application thread");
+
+   ostringstream filename;
+   filename << "trace_" << thread_id << ".trc";
+   writer = new TraceWriter(Config::getSingleton()->formatOutputFileName(filename.str()), thread_id, tile_id);
+   m_writer_tls->set(writer);
+
+   ScopedLock sl(m_writers_lock);
+   m_writers.push_back(writer);
+   return writer;
+}
+
+void
+TraceRecorder::recordInstruction(const Instruction* instruction)
+{
+   getWriter()->writeInstruction(instruction);
+}
+
+void
+TraceRecorder::recordBranch(bool taken, IntPtr target)
+{
+   getWriter()->writeBranch(taken, target);
+}
+
+void
+TraceRecorder::recordMemoryAccess(UInt32 lock_signal, UInt32 mem_op, IntPtr address, UInt32 size)
+{
+   getWriter()->writeMemoryAccess(lock_signal, mem_op, address, size);
+}
+
+void
+TraceRecorder::recordEvent(TraceFormat::RecordType type)
+{
+   getWriter()->writeEvent(type);
+}
+
+void
+TraceRecorder::recordEvent(TraceFormat::RecordType type, SInt32 arg)
+{
+   getWriter()->writeEvent(type, arg);
+}
+
+void
+TraceRecorder::recordEvent(TraceFormat::RecordType type, SInt32 arg0, SInt32 arg1)
+{
+   getWriter()->writeEvent(type, arg0, arg1);
+}
+
+void
+TraceRecorder::onThreadExit()
+{
+   TraceWriter* writer = m_writer_tls->get<TraceWriter>();
+   if (!writer)
+      return;
+
+   {
+      ScopedLock sl(m_writers_lock);
+      m_writers.erase(find(m_writers.begin(), m_writers.end(), writer));
+   }
+   m_writer_tls->set(NULL);
+   delete writer;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+#include "trace_format.h"
+#include "fixed_types.h"
+#include "lock.h"
+
+class Instruction;
+class TraceWriter;
+class TLS;
+
+// Records the calls the frontend (the Pin tool, in full or lite mode) makes
+// into the core, memory and synchronization models of each application
+// thread into a per-thread trace ([trace] record = true). tools/carbon_replay
+// replays the traces through the same models without Pin.
+//
+// Instructions are only recorded while the core models are enabled, as they
+// are dropped otherwise. Data memory accesses, synchronization and thread
+// events are always recorded.
+class TraceRecorder
+{
+public:
+   TraceRecorder();
+   // Closes the traces of the threads that are still running
+   ~TraceRecorder();
+
+   void recordInstruction(const Instruction* instruction);
+   void recordBranch(bool taken, IntPtr target);
+   void recordMemoryAccess(UInt32 lock_signal, UInt32 mem_op, IntPtr address, UInt32 size);
+   void recordEvent(TraceFormat::RecordType type);
+   void recordEvent(TraceFormat::RecordType type, SInt32 arg);
+   void recordEvent(TraceFormat::RecordType type, SInt32 arg0, SInt32 arg1);
+
+   // Closes the trace of the current thread
+   void onThreadExit();
+
+private:
+   TLS* m_writer_tls;
+   std::vector<TraceWriter*> m_writers;
+   Lock m_writers_lock;
+
+   TraceWriter* getWriter();
+};
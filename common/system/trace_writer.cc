@@ -0,0 +1,175 @@
+#include "trace_writer.h"
+#include "instruction.h"
+#include "varint.h"
+#include "log.h"
+
+using namespace std;
+
+TraceWriter::TraceWriter(const string& filename, thread_id_t thread_id, tile_id_t tile_id)
+   : m_last_instruction_id(0)
+   , m_last_instruction_address(0)
+   , m_last_memory_address(0)
+{
+   m_file = fopen(filename.c_str(), "wb");
+   LOG_ASSERT_ERROR(m_file, "Could not open trace file(%s)", filename.c_str());
+
+   TraceFormat::Header header = { TraceFormat::MAGIC, TraceFormat::VERSION, thread_id, tile_id };
+   fwrite(&header, sizeof(header), 1, m_file);
+
+   m_buffer.reserve(BUFFER_SIZE);
+}
+
+TraceWriter::~TraceWriter()
+{
+   flush();
+   fclose(m_file);
+}
+
+void
+TraceWriter::writeInstruction(const Instruction* instruction)
+{
+   map<const Instruction*, UInt32>::iterator it = m_instruction_ids.find(instruction);
+   if (it == m_instruction_ids.end())
+   {
+      defineInstruction(instruction);
+      return;
+   }
+
+   UInt32 id = it->second;
+   if (id == m_last_instruction_id + 1)
+   {
+      m_buffer.push_back(TraceFormat::INSTRUCTION_NEXT);
+   }
+   else
+   {
+      m_buffer.push_back(TraceFormat::INSTRUCTION);
+      encodeSigned((SInt64) id - (SInt64) (m_last_instruction_id + 1));
+   }
+   m_last_instruction_id = id;
+   m_last_instruction_address = instruction->getAddress();
+
+   if (m_buffer.size() >= BUFFER_SIZE)
+      flush();
+}
+
+void
+TraceWriter::defineInstruction(const Instruction* instruction)
+{
+   UInt32 id = m_instruction_ids.size();
+   m_instruction_ids.insert(make_pair(instruction, id));
+
+   m_buffer.push_back(TraceFormat::INSTRUCTION_DEFINE);
+   encode(instruction->getType());
+   encode(instruction->getOpcode());
+   encodeSigned((SInt64) (instruction->getAddress() - m_last_instruction_address));
+   encode(instruction->getSize());
+   encode(instruction->isAtomic());
+
+   const RegisterOperandList& read_registers = instruction->getReadRegisterOperands();
+   encode(read_registers.size());
+   for (UInt32 i = 0; i < read_registers.size(); i++)
+      encode(read_registers[i]);
+   const RegisterOperandList& write_registers = instruction->getWriteRegisterOperands();
+   encode(write_registers.size());
+   for (UInt32 i = 0; i < write_registers.size(); i++)
+      encode(write_registers[i]);
+   encode(instruction->getNumReadMemoryOperands());
+   encode(instruction->getNumWriteMemoryOperands());
+   const ImmediateOperandList& immediates = instruction->getImmediateOperands();
+   encode(immediates.size());
+   for (UInt32 i = 0; i < immediates.size(); i++)
+      encode(immediates[i]);
+
+   const McPATInstruction* mcpat_instruction = instruction->getMcPATInstruction();
+   encode(mcpat_instruction != NULL);
+   if (mcpat_instruction)
+   {
+      const McPATInstruction::MicroOpList& micro_ops = mcpat_instruction->getMicroOpList();
+      encode(micro_ops.size());
+      for (UInt32 i = 0; i < micro_ops.size(); i++)
+         encode(micro_ops[i]);
+      const McPATInstruction::RegisterFile& register_file = mcpat_instruction->getRegisterFile();
+      encode(register_file._num_integer_reads);
+      encode(register_file._num_integer_writes);
+      encode(register_file._num_floating_point_reads);
+      encode(register_file._num_floating_point_writes);
+      const McPATInstruction::ExecutionUnitList& execution_units = mcpat_instruction->getExecutionUnitList();
+      encode(execution_units.size());
+      for (UInt32 i = 0; i < execution_units.size(); i++)
+         encode(execution_units[i]);
+   }
+
+   m_last_instruction_id = id;
+   m_last_instruction_address = instruction->getAddress();
+
+   if (m_buffer.size() >= BUFFER_SIZE)
+      flush();
+}
+
+void
+TraceWriter::writeBranch(bool taken, IntPtr target)
+{
+   m_buffer.push_back(taken ? TraceFormat::BRANCH_TAKEN : TraceFormat::BRANCH_NOT_TAKEN);
+   encodeSigned((SInt64) (target - m_last_instruction_address));
+
+   if (m_buffer.size() >= BUFFER_SIZE)
+      flush();
+}
+
+void
+TraceWriter::writeMemoryAccess(UInt32 lock_signal, UInt32 mem_op, IntPtr address, UInt32 size)
+{
+   LOG_ASSERT_ERROR(lock_signal < 3 && mem_op < 3, "Unexpected memory access (lock_signal(%u), mem_op(%u))",
+                    lock_signal, mem_op);
+
+   m_buffer.push_back(TraceFormat::MEMORY_ACCESS + 3 * mem_op + lock_signal);
+   encode(size);
+   encodeSigned((SInt64) (address - m_last_memory_address));
+   m_last_memory_address = address;
+
+   if (m_buffer.size() >= BUFFER_SIZE)
+      flush();
+}
+
+void
+TraceWriter::writeEvent(TraceFormat::RecordType type)
+{
+   m_buffer.push_back(type);
+}
+
+void
+TraceWriter::writeEvent(TraceFormat::RecordType type, SInt32 arg)
+{
+   m_buffer.push_back(type);
+   encodeSigned(arg);
+}
+
+void
+TraceWriter::writeEvent(TraceFormat::RecordType type, SInt32 arg0, SInt32 arg1)
+{
+   m_buffer.push_back(type);
+   encodeSigned(arg0);
+   encodeSigned(arg1);
+}
+
+void
+TraceWriter::encode(UInt64 value)
+{
+   encodeVarint(m_buffer, value);
+}
+
+void
+TraceWriter::encodeSigned(SInt64 value)
+{
+   encodeSignedVarint(m_buffer, value);
+}
+
+void
+TraceWriter::flush()
+{
+   if (m_buffer.empty())
+      return;
+
+   fwrite(&m_buffer[0], 1, m_buffer.size(), m_file);
+   m_buffer.clear();
+}
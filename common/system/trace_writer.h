@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "trace_format.h"
+#include "fixed_types.h"
+
+class Instruction;
+
+// Writes the trace of one thread (see TraceFormat). Only the thread itself
+// writes to it.
+class TraceWriter
+{
+public:
+   TraceWriter(const std::string& filename, thread_id_t thread_id, tile_id_t tile_id);
+   // Writes out the buffered records
+   ~TraceWriter();
+
+   void writeInstruction(const Instruction* instruction);
+   void writeBranch(bool taken, IntPtr target);
+   void writeMemoryAccess(UInt32 lock_signal, UInt32 mem_op, IntPtr address, UInt32 size);
+   void writeEvent(TraceFormat::RecordType type);
+   void writeEvent(TraceFormat::RecordType type, SInt32 arg);
+   void writeEvent(TraceFormat::RecordType type, SInt32 arg0, SInt32 arg1);
+
+private:
+   // Records are written out in chunks of this size
+   static const UInt32 BUFFER_SIZE = 1 << 16;
+
+   FILE* m_file;
+   std::vector<Byte> m_buffer;
+
+   // Static instructions are written out once, and referred to by id after
+   std::map<const Instruction*, UInt32> m_instruction_ids;
+   UInt32 m_last_instruction_id;
+   IntPtr m_last_instruction_address;
+   IntPtr m_last_memory_address;
+
+   void defineInstruction(const Instruction* instruction);
+   void encode(UInt64 value);
+   void encodeSigned(SInt64 value);
+   void flush();
+};
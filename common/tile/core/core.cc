@@ -13,6 +13,7 @@
 #include "config.h"
 #include "log.h"
 #include "dvfs_manager.h"
+#include "trace_recorder.h"
 
 Core::Core(Tile *tile, core_type_t core_type)
    : _tile(tile)
@@ -20,12 +21,14 @@ Core::Core(Tile *tile, core_type_t core_type)
    , _state(IDLE)
    , _pin_memory_manager(NULL)
    , _enabled(false)
+   , _trace_recorder(Sim()->getTraceRecorder())
    , _module(CORE)
 {
 
    //initialize frequency and voltage
    int rc = DVFSManager::getInitialFrequencyAndVoltage(CORE, _frequency, _voltage);
    LOG_ASSERT_ERROR(rc == 0, "Error setting initial voltage for frequency(%g)", _frequency);
+   _clock_domain = DVFSManager::getClockDomain(_frequency);
 
    _id = (core_id_t) {_tile->getId(), core_type};
    if (Config::getSingleton()->getEnableCoreModeling())
@@ -63,6 +66,14 @@ Core::~Core()
    delete _core_model;
 }
 
+void
+Core::setState(State state)
+{
+   _state = state;
+   if (_clock_skew_management_client)
+      _clock_skew_management_client->coreStateChanged();
+}
+
 int
 Core::coreSendW(int sender, int receiver, char* buffer, int size, carbon_network_t net_type)
 {
@@ -143,6 +154,11 @@ Core::initiateMemoryAccess(MemComponent::Type mem_component, lock_signal_t lock_
 {
    LOG_ASSERT_ERROR(Config::getSingleton()->isSimulatingSharedMemory(), "Shared Memory Disabled");
 
+   // Only the accesses of the application are recorded: instruction fetches
+   // are replayed along with the instructions
+   if (_trace_recorder && push_info && mem_component == MemComponent::L1_DCACHE)
+      _trace_recorder->recordMemoryAccess(lock_signal, mem_op_type, address, data_size);
+
    if (data_size == 0)
    {
       if (push_info)
@@ -209,7 +225,7 @@ Core::initiateMemoryAccess(MemComponent::Type mem_component, lock_signal_t lock_
             // Instruction buffer hit, so NO need to access ICACHE
             _instruction_buffer_hits ++;
             // 1 cycle to access instruction buffer
-            curr_time += Latency(1, _frequency);
+            curr_time += Latency(1, _clock_domain);
             continue;
          }
          else
@@ -309,6 +325,13 @@ Core::outputSummary(ostream& os, const Time& target_completion_time)
       << endl;
 }
 
+void
+Core::registerStatistics(StatisticsRegistry* registry)
+{
+   if (_core_model)
+      _core_model->registerStatistics(registry);
+}
+
 void
 Core::enableModels()
 {
@@ -384,6 +407,7 @@ Core::setDVFS(double frequency, voltage_option_t voltage_flag, const Time& curr_
    {
       _core_model->setDVFS(_frequency, _voltage, frequency, curr_time);
       _frequency = frequency;
+      _clock_domain = DVFSManager::getClockDomain(_frequency);
       _synchronization_delay = Time(Latency(DVFSManager::getSynchronizationDelay(), _frequency));
    }
    return rc;
@@ -12,6 +12,8 @@ class SyscallMdl;
 class SyncClient;
 class ClockSkewManagementClient;
 class PinMemoryManager;
+class StatisticsRegistry;
+class TraceRecorder;
 
 #include "mem_component.h"
 #include "fixed_types.h"
@@ -74,14 +76,16 @@ public:
    PinMemoryManager *getPinMemoryManager()   { return _pin_memory_manager; }
 
    State getState()                          { return _state; }
-   void setState(State state)                { _state = state; }
+   void setState(State state);
   
    void outputSummary(ostream& os, const Time& target_completion_time);
+   void registerStatistics(StatisticsRegistry* registry);
 
    void enableModels();
    void disableModels();
 
    double getFrequency() const               { return _frequency; }
+   const ClockDomain* getClockDomain() const { return _clock_domain; }
    double getVoltage() const                 { return _voltage; }
 
    int getDVFS(double &frequency, double &voltage);
@@ -97,6 +101,8 @@ private:
    State _state;
    PinMemoryManager *_pin_memory_manager;
    bool _enabled;
+   // Records the data memory accesses ([trace] record = true)
+   TraceRecorder *_trace_recorder;
 
    // Instruction Buffer
    IntPtr _instruction_buffer_address;
@@ -114,6 +120,7 @@ private:
    PacketType getPacketTypeFromUserNetType(carbon_network_t net_type);
 
    double _frequency;
+   const ClockDomain* _clock_domain;
    double _voltage;
    module_t _module;
    Time _synchronization_delay;
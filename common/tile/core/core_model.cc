@@ -11,6 +11,9 @@
 #include "time_types.h"
 #include "mcpat_core_interface.h"
 #include "remote_query_helper.h"
+#include "statistics_registry.h"
+#include "trace_recorder.h"
+#include "packetize.h"
 
 CoreModel* CoreModel::create(Core* core)
 {
@@ -41,6 +44,7 @@ CoreModel::CoreModel(Core *core)
    , _dynamic_memory_info_queue(3) // Max 3 dynamic memory info objects
    , _dynamic_branch_info_queue(1) // Max 1 dynamic branch info object
    , _enabled(false)
+   , _trace_recorder(Sim()->getTraceRecorder())
 {
    // Create Branch Predictor
    _bp = BranchPredictor::create();
@@ -114,6 +118,34 @@ void CoreModel::outputSummary(ostream& os, const Time& target_completion_time)
    os << "      Implicit MFENCE: " << _total_implicit_mfence_instructions << endl; 
 }
 
+void CoreModel::registerStatistics(StatisticsRegistry* registry)
+{
+   registry->registerCounter("core", "instructions", &_instruction_count);
+   registry->registerCounter("core", "completion_time", &_curr_time);
+   registry->registerCounter("core", "sync_instructions", &_total_sync_instructions);
+   registry->registerCounter("core", "recv_instructions", &_total_recv_instructions);
+   registry->registerCounter("core", "memory_stall_time", &_total_memory_stall_time);
+   registry->registerCounter("core", "execution_unit_stall_time", &_total_execution_unit_stall_time);
+   registry->registerCounter("core", "sync_stall_time", &_total_sync_instruction_stall_time);
+   registry->registerCounter("core", "recv_stall_time", &_total_recv_instruction_stall_time);
+   registry->registerCounter("core", "lfence_instructions", &_total_lfence_instructions);
+   registry->registerCounter("core", "sfence_instructions", &_total_sfence_instructions);
+   registry->registerCounter("core", "explicit_mfence_instructions", &_total_explicit_mfence_instructions);
+   registry->registerCounter("core", "implicit_mfence_instructions", &_total_implicit_mfence_instructions);
+}
+
+void CoreModel::checkpoint(UnstructuredBuffer& buffer)
+{
+   buffer << _curr_time.getTime();
+}
+
+void CoreModel::restore(UnstructuredBuffer& buffer)
+{
+   UInt64 curr_time;
+   buffer >> curr_time;
+   setCurrTime(Time(curr_time));
+}
+
 void CoreModel::initializeMcPATInterface(UInt32 num_load_buffer_entries, UInt32 num_store_buffer_entries)
 {
    // For Power/Area Modeling
@@ -129,7 +161,7 @@ void CoreModel::updateMcPATCounters(Instruction* instruction)
 
    // Update Event Counters
    _mcpat_core_interface->updateEventCounters(instruction->getMcPATInstruction(),
-                                              _curr_time.toCycles(_core->getFrequency()),
+                                              _curr_time.toCycles(_core->getClockDomain()),
                                               total_branch_misprediction_count);
 }
 
@@ -285,6 +317,8 @@ void CoreModel::queueInstruction(Instruction* instruction)
       return;
    assert(!_instruction_queue.full());
    _instruction_queue.push_back(instruction);
+   if (_trace_recorder && !instruction->isDynamic())
+      _trace_recorder->recordInstruction(instruction);
 }
 
 void CoreModel::iterate()
@@ -323,6 +357,8 @@ void CoreModel::pushDynamicBranchInfo(const DynamicBranchInfo& info)
       return;
    assert(!_dynamic_branch_info_queue.full());
    _dynamic_branch_info_queue.push_back(info);
+   if (_trace_recorder)
+      _trace_recorder->recordBranch(info._taken, info._target);
 }
 
 void CoreModel::popDynamicBranchInfo()
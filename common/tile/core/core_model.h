@@ -10,6 +10,9 @@ using std::vector;
 class Core;
 class BranchPredictor;
 class McPATCoreInterface;
+class StatisticsRegistry;
+class TraceRecorder;
+class UnstructuredBuffer;
 
 #include "instruction.h"
 #include "basic_block.h"
@@ -49,6 +52,11 @@ public:
    bool isEnabled() const { return _enabled; }
 
    virtual void outputSummary(std::ostream &os, const Time& target_completion_time) = 0;
+   void registerStatistics(StatisticsRegistry* registry);
+
+   // Clock of the core, for the checkpoint of the tile
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
 
    void computeEnergy(const Time& curr_time);
    double getDynamicEnergy();
@@ -109,6 +117,9 @@ private:
 
    bool _enabled;
 
+   // Records the instructions and branch outcomes ([trace] record = true)
+   TraceRecorder* _trace_recorder;
+
    // Instruction costs
    typedef vector<Time> InstructionCosts;
    typedef vector<UInt32> StaticInstructionCosts;
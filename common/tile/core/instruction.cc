@@ -47,7 +47,7 @@ BranchInstruction::BranchInstruction(UInt64 opcode, IntPtr address, UInt32 size,
 Time
 BranchInstruction::getCost(CoreModel* perf)
 {
-   double frequency = perf->getCore()->getFrequency();
+   const ClockDomain* clock_domain = perf->getCore()->getClockDomain();
    BranchPredictor *bp = perf->getBranchPredictor();
 
    const DynamicBranchInfo& info = perf->getDynamicBranchInfo();
@@ -56,14 +56,14 @@ BranchInstruction::getCost(CoreModel* perf)
    if (bp == NULL)
    {
       perf->popDynamicBranchInfo();
-      return Time(Latency(1,frequency));
+      return Time(Latency(1,clock_domain));
    }
 
    bool prediction = bp->predict(getAddress(), info._target);
    bool correct = (prediction == info._taken);
 
    bp->update(prediction, info._taken, getAddress(), info._target);
-   Latency cost = correct ? Latency(1,frequency) : Latency(bp->getMispredictPenalty(),frequency);
+   Latency cost = correct ? Latency(1,clock_domain) : Latency(bp->getMispredictPenalty(),clock_domain);
       
    perf->popDynamicBranchInfo();
    return Time(cost);
@@ -4,10 +4,13 @@
 #include "cache_line_info.h"
 #include "cache_replacement_policy.h"
 #include "cache_hash_fn.h"
+#include "reuse_distance_profiler.h"
 #include "mcpat_cache_interface.h"
 #include "utils.h"
 #include "log.h"
 #include "memory_manager.h"
+#include "statistics_registry.h"
+#include "packetize.h"
 
 // Cache class
 // constructors/destructors
@@ -45,10 +48,19 @@ Cache::Cache(string name,
    _log_line_size = floorLog2(_line_size);
   
    // Instantiate cache sets 
+   _tags = new IntPtr[_num_sets * _associativity];
    _sets = new CacheSet*[_num_sets];
    for (UInt32 i = 0; i < _num_sets; i++)
    {
-      _sets[i] = new CacheSet(i, caching_protocol_type, cache_level, _replacement_policy, _associativity, _line_size);
+      _sets[i] = new CacheSet(i, caching_protocol_type, cache_level, _replacement_policy, _associativity, _line_size,
+                              &_tags[i * _associativity]);
+   }
+
+   for (UInt32 i = 0; i < HIT_FILTER_SIZE; i++)
+   {
+      _hit_filter[i]._set = NULL;
+      _hit_filter[i]._line_index = 0;
+      _hit_filter[i]._cache_line_info = NULL;
    }
 
    // Initialize DVFS variables
@@ -72,6 +84,9 @@ Cache::Cache(string name,
    initializeTagAndDataArrayCounters();
    // Cache line state counters
    initializeCacheLineStateCounters();
+
+   // Reuse distance profiling
+   _reuse_distance_profiler = ReuseDistanceProfiler::create(_name, _cache_size, _line_size);
 }
 
 Cache::~Cache()
@@ -79,6 +94,8 @@ Cache::~Cache()
    for (SInt32 i = 0; i < (SInt32) _num_sets; i++)
       delete _sets[i];
    delete [] _sets;
+   delete [] _tags;
+   delete _reuse_distance_profiler;
 }
 
 void
@@ -111,6 +128,46 @@ Cache::accessCacheLine(IntPtr address, AccessType access_type, Byte* buf, UInt32
              address, (access_type == 0) ? "LOAD": "STORE", num_bytes);
 }
 
+bool
+Cache::readCacheLineIfReadable(IntPtr address, Byte* buf, UInt32 num_bytes, bool tag_write_on_hit)
+{
+   assert((buf == NULL) == (num_bytes == 0));
+
+   IntPtr tag = getTag(address);
+   HitFilterEntry& entry = _hit_filter[tag & (HIT_FILTER_SIZE - 1)];
+   if (!entry._cache_line_info || (entry._cache_line_info->getTag() != tag))
+   {
+      CacheSet* set = getSet(address);
+      UInt32 line_index = -1;
+      CacheLineInfo* cache_line_info = set->find(tag, &line_index);
+      if (!cache_line_info)
+         return false;
+
+      entry._set = set;
+      entry._line_index = line_index;
+      entry._cache_line_info = cache_line_info;
+   }
+
+   if (!CacheState(entry._cache_line_info->getCState()).readable())
+      return false;
+
+   entry._set->read_line(entry._line_index, getLineOffset(address), buf, num_bytes);
+
+   // Same counters as getCacheLineInfo(), updateMissCounters() and
+   // accessCacheLine(), plus setCacheLineInfo() (with the unchanged state)
+   // for protocols that write the line info back on a hit
+   if (_enabled)
+   {
+      _event_counters[TAG_ARRAY_READ] ++;
+      if (tag_write_on_hit)
+         _event_counters[TAG_ARRAY_WRITE] ++;
+      _event_counters[DATA_ARRAY_READ] ++;
+   }
+   updateMissCounters(address, Core::READ, false);
+
+   return true;
+}
+
 void
 Cache::insertCacheLine(IntPtr inserted_address, CacheLineInfo* inserted_cache_line_info, Byte* fill_buf,
                        bool* eviction, IntPtr* evicted_address, CacheLineInfo* evicted_cache_line_info, Byte* writeback_buf)
@@ -219,7 +276,9 @@ void
 Cache::setCacheLineInfo(IntPtr address, CacheLineInfo* updated_cache_line_info)
 {
    LOG_PRINT("setCacheLineInfo: Address(%#lx) start", address);
-   CacheLineInfo* cache_line_info = getCacheLineInfo(address);
+   CacheSet* set = getSet(address);
+   UInt32 line_index = -1;
+   CacheLineInfo* cache_line_info = set->find(getTag(address), &line_index);
    LOG_ASSERT_ERROR(cache_line_info, "Address(%#lx)", address);
 
    // Update exclusive/shared counters
@@ -230,7 +289,7 @@ Cache::setCacheLineInfo(IntPtr address, CacheLineInfo* updated_cache_line_info)
       _invalidated_address_set.insert(address);
 
    // Update the cache line info   
-   cache_line_info->assign(updated_cache_line_info);
+   set->update(line_index, updated_cache_line_info);
    
    if (_enabled)
    {
@@ -315,6 +374,7 @@ Cache::initializeDVFS()
    // Initialize frequency and voltage
    int rc = DVFSManager::getInitialFrequencyAndVoltage(_module, _frequency, _voltage);
    LOG_ASSERT_ERROR(rc == 0, "Error setting initial voltage for frequency(%g)", _frequency);
+   _clock_domain = DVFSManager::getClockDomain(_frequency);
 }
 
 
@@ -322,6 +382,10 @@ Cache::MissType
 Cache::updateMissCounters(IntPtr address, Core::mem_op_t mem_op_type, bool cache_miss)
 {
    MissType miss_type = INVALID_MISS_TYPE;
+
+   // Also sees the accesses while the models are disabled, to warm up
+   if (_reuse_distance_profiler)
+      _reuse_distance_profiler->access(getTag(address), _enabled);
    
    if (_enabled)
    {
@@ -465,6 +529,9 @@ Cache::outputSummary(ostream& out, const Time& target_completion_time)
       out << "      Sharing Misses: " << _total_sharing_misses << endl;
    }
 
+   if (_reuse_distance_profiler)
+      _reuse_distance_profiler->outputSummary(out);
+
    // Cache Access Counters Summary
    out << "    Event Counters:" << endl;
    out << "      Tag Array Reads: " << _event_counters[TAG_ARRAY_READ] << endl;
@@ -476,6 +543,93 @@ Cache::outputSummary(ostream& out, const Time& target_completion_time)
    DVFSManager::printAsynchronousMap(out, _module, _asynchronous_map);
 }
 
+void
+Cache::registerStatistics(StatisticsRegistry* registry)
+{
+   registry->registerCounter(_name, "accesses", &_total_cache_accesses);
+   registry->registerCounter(_name, "misses", &_total_cache_misses);
+   if (_cache_category != INSTRUCTION_CACHE)
+   {
+      registry->registerCounter(_name, "read_accesses", &_total_read_accesses);
+      registry->registerCounter(_name, "read_misses", &_total_read_misses);
+      registry->registerCounter(_name, "write_accesses", &_total_write_accesses);
+      registry->registerCounter(_name, "write_misses", &_total_write_misses);
+   }
+   registry->registerCounter(_name, "evictions", &_total_evictions);
+   if (_write_policy == WRITE_BACK)
+      registry->registerCounter(_name, "dirty_evictions", &_total_dirty_evictions);
+   if (_track_miss_types)
+   {
+      registry->registerCounter(_name, "cold_misses", &_total_cold_misses);
+      registry->registerCounter(_name, "capacity_misses", &_total_capacity_misses);
+      registry->registerCounter(_name, "sharing_misses", &_total_sharing_misses);
+   }
+   if (_reuse_distance_profiler)
+      _reuse_distance_profiler->registerStatistics(registry, _name);
+   registry->registerCounter(_name, "tag_array_reads", &_event_counters[TAG_ARRAY_READ]);
+   registry->registerCounter(_name, "tag_array_writes", &_event_counters[TAG_ARRAY_WRITE]);
+   registry->registerCounter(_name, "data_array_reads", &_event_counters[DATA_ARRAY_READ]);
+   registry->registerCounter(_name, "data_array_writes", &_event_counters[DATA_ARRAY_WRITE]);
+}
+
+void
+Cache::checkpoint(UnstructuredBuffer& buffer)
+{
+   buffer << _num_sets << _associativity << _line_size;
+   for (UInt32 i = 0; i < _num_sets; i++)
+      _sets[i]->checkpoint(buffer);
+   _replacement_policy->checkpoint(buffer);
+
+   for (UInt32 i = 0; i < _cache_line_state_counters.size(); i++)
+      buffer << _cache_line_state_counters[i];
+
+   checkpointAddressSet(buffer, _fetched_address_set);
+   checkpointAddressSet(buffer, _evicted_address_set);
+   checkpointAddressSet(buffer, _invalidated_address_set);
+}
+
+void
+Cache::restore(UnstructuredBuffer& buffer)
+{
+   UInt32 num_sets, associativity, line_size;
+   buffer >> num_sets >> associativity >> line_size;
+   LOG_ASSERT_ERROR(num_sets == _num_sets && associativity == _associativity && line_size == _line_size,
+                    "Cache(%s): checkpoint has %u sets, %u ways, %u-byte lines; expected %u, %u, %u",
+                    _name.c_str(), num_sets, associativity, line_size, _num_sets, _associativity, _line_size);
+   for (UInt32 i = 0; i < _num_sets; i++)
+      _sets[i]->restore(buffer);
+   _replacement_policy->restore(buffer);
+
+   for (UInt32 i = 0; i < _cache_line_state_counters.size(); i++)
+      buffer >> _cache_line_state_counters[i];
+
+   restoreAddressSet(buffer, _fetched_address_set);
+   restoreAddressSet(buffer, _evicted_address_set);
+   restoreAddressSet(buffer, _invalidated_address_set);
+}
+
+void
+Cache::checkpointAddressSet(UnstructuredBuffer& buffer, const set<IntPtr>& address_set)
+{
+   buffer << (UInt64) address_set.size();
+   for (set<IntPtr>::const_iterator it = address_set.begin(); it != address_set.end(); it++)
+      buffer << *it;
+}
+
+void
+Cache::restoreAddressSet(UnstructuredBuffer& buffer, set<IntPtr>& address_set)
+{
+   UInt64 size;
+   buffer >> size;
+   address_set.clear();
+   for (UInt64 i = 0; i < size; i++)
+   {
+      IntPtr address;
+      buffer >> address;
+      address_set.insert(address_set.end(), address);
+   }
+}
+
 void Cache::computeEnergy(const Time& curr_time)
 {
    _mcpat_cache_interface->computeEnergy(curr_time, _frequency);
@@ -551,6 +705,7 @@ Cache::setDVFS(double frequency, voltage_option_t voltage_flag, const Time& curr
       if (Config::getSingleton()->getEnablePowerModeling())
          _mcpat_cache_interface->setDVFS(_frequency, _voltage, frequency, curr_time);
       _frequency = frequency;
+      _clock_domain = DVFSManager::getClockDomain(_frequency);
    }
    return rc;
 }
@@ -22,6 +22,9 @@ class CacheLineInfo;
 class CacheReplacementPolicy;
 class CacheHashFn;
 class McPATCacheInterface;
+class StatisticsRegistry;
+class ReuseDistanceProfiler;
+class UnstructuredBuffer;
 
 class Cache
 {
@@ -90,6 +93,12 @@ public:
                         bool* eviction, IntPtr* evicted_address, CacheLineInfo* evicted_cache_line_info, Byte* writeback_buf);
    void getCacheLineInfo(IntPtr address, CacheLineInfo* cache_line_info);
    void setCacheLineInfo(IntPtr address, CacheLineInfo* updated_cache_line_info);
+   // Read hit fast path for accesses from the core (see MemoryManager).
+   // If the line is present in a readable state, reads it and updates the
+   // counters and the replacement state as a READ hit through the L1 cache
+   // controller does, and returns true. Otherwise, leaves the cache untouched
+   // and returns false.
+   bool readCacheLineIfReadable(IntPtr address, Byte* buf, UInt32 num_bytes, bool tag_write_on_hit);
 
    // Get the tag associated with an address
    IntPtr getTag(IntPtr address) const;
@@ -105,6 +114,9 @@ public:
    // Get cache line state counters
    void getCacheLineStateCounters(vector<UInt64>& cache_line_state_counters) const;
 
+   const string& getName() const
+   { return _name; }
+
    // Get performance model
    CachePerfModel* getPerfModel() const
    { return _perf_model; }
@@ -116,6 +128,12 @@ public:
    void disable()    { _enabled = false; }
    
    void outputSummary(ostream& out, const Time& target_completion_time);
+   void registerStatistics(StatisticsRegistry* registry);
+
+   // Lines, replacement state and miss type tracking state, for the
+   // checkpoint of the tile. The geometry must be the same on restore.
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
 
    void computeEnergy(const Time& curr_time);
 
@@ -126,6 +144,7 @@ public:
    friend class McPATCacheInterface;
 
    double getFrequency() const {return _frequency;};
+   const ClockDomain* getClockDomain() const {return _clock_domain;};
    int getDVFS(double &frequency, double &voltage);
    int setDVFS(double frequency, voltage_option_t voltage_flag, const Time& curr_time);
 
@@ -141,6 +160,8 @@ private:
    CacheCategory _cache_category;
    WritePolicy _write_policy;
    CacheSet** _sets;
+   // Tags of all the lines, set by set (see CacheSet)
+   IntPtr* _tags;
 
    // Cache params
    UInt32 _cache_size;
@@ -150,9 +171,23 @@ private:
    UInt32 _num_banks;
    UInt32 _log_line_size;
    double _frequency;
+   const ClockDomain* _clock_domain;
    double _voltage;
    module_t _module;
 
+   // Hit filter for readCacheLineIfReadable(): the way of a few recently
+   // read lines, indexed by the low bits of the tag. An entry is checked
+   // against the live line info, so lines that are evicted or invalidated
+   // since need not be removed from it.
+   struct HitFilterEntry
+   {
+      CacheSet* _set;
+      UInt32 _line_index;
+      CacheLineInfo* _cache_line_info;
+   };
+   static const UInt32 HIT_FILTER_SIZE = 16;
+   HitFilterEntry _hit_filter[HIT_FILTER_SIZE];
+
    // Computing replacement policy and hash function
    CacheReplacementPolicy* _replacement_policy;
    CacheHashFn* _hash_fn;
@@ -186,6 +221,9 @@ private:
 
    // Track miss types ?
    bool _track_miss_types;
+
+   // Miss ratio curve of the accesses from the core (NULL if not profiled)
+   ReuseDistanceProfiler* _reuse_distance_profiler;
  
    // Performance model
    CachePerfModel* _perf_model;
@@ -223,6 +261,9 @@ private:
    // Update counters that record the state of cache lines
    void updateCacheLineStateCounters(CacheState::Type old_cstate, CacheState::Type new_cstate);
 
+   static void checkpointAddressSet(UnstructuredBuffer& buffer, const set<IntPtr>& address_set);
+   static void restoreAddressSet(UnstructuredBuffer& buffer, set<IntPtr>& address_set);
+
    // Asynchronous communication
    DVFSManager::AsynchronousMap _asynchronous_map;
    ShmemPerfModel* _shmem_perf_model;
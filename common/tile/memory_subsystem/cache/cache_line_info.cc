@@ -3,6 +3,7 @@
 #include "pr_l1_pr_l2_dram_directory_mosi/cache_line_info.h"
 #include "pr_l1_sh_l2_msi/cache_line_info.h"
 #include "pr_l1_sh_l2_mesi/cache_line_info.h"
+#include "packetize.h"
 #include "log.h"
 
 CacheLineInfo::CacheLineInfo(IntPtr tag, CacheState::Type cstate)
@@ -49,3 +50,17 @@ CacheLineInfo::assign(CacheLineInfo* cache_line_info)
    _tag = cache_line_info->getTag();
    _cstate = cache_line_info->getCState();
 }
+
+void
+CacheLineInfo::checkpoint(UnstructuredBuffer& buffer)
+{
+   buffer << _tag << (SInt32) _cstate;
+}
+
+void
+CacheLineInfo::restore(UnstructuredBuffer& buffer)
+{
+   SInt32 cstate;
+   buffer >> _tag >> cstate;
+   _cstate = (CacheState::Type) cstate;
+}
@@ -5,6 +5,8 @@
 #include "cache_utils.h"
 #include "caching_protocol_type.h"
 
+class UnstructuredBuffer;
+
 class CacheLineInfo
 {
 // This can be extended to include other information
@@ -18,6 +20,10 @@ public:
    virtual void invalidate();
    virtual void assign(CacheLineInfo* cache_line_info);
 
+   // Derived line infos add their own state after the tag and state
+   virtual void checkpoint(UnstructuredBuffer& buffer);
+   virtual void restore(UnstructuredBuffer& buffer);
+
    bool isValid() const                        
    { return (_tag != ((IntPtr) ~0)); }
    IntPtr getTag() const                        
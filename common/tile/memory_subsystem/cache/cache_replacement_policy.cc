@@ -1,6 +1,7 @@
 #include "cache_replacement_policy.h"
 #include "round_robin_replacement_policy.h"
 #include "lru_replacement_policy.h"
+#include "packed_replacement_policy.h"
 #include "cache_line_info.h"
 #include "log.h"
 
@@ -24,6 +25,14 @@ CacheReplacementPolicy::create(string policy_str, UInt32 cache_size, UInt32 asso
       return new RoundRobinReplacementPolicy(cache_size, associativity, cache_line_size);
    case LRU:
       return new LRUReplacementPolicy(cache_size, associativity, cache_line_size);
+   case PLRU:
+      return new PLRUReplacementPolicy(cache_size, associativity, cache_line_size);
+   case NRU:
+      return new NRUReplacementPolicy(cache_size, associativity, cache_line_size);
+   case SRRIP:
+      return new SRRIPReplacementPolicy(cache_size, associativity, cache_line_size);
+   case BRRIP:
+      return new BRRIPReplacementPolicy(cache_size, associativity, cache_line_size);
    default:
       LOG_PRINT_ERROR("Unrecognized Replacement Policy(%u)", policy);
       return (CacheReplacementPolicy*) NULL;
@@ -37,6 +46,14 @@ CacheReplacementPolicy::parse(string policy_str)
       return ROUND_ROBIN;
    if (policy_str == "lru")
       return LRU;
+   if (policy_str == "plru")
+      return PLRU;
+   if (policy_str == "nru")
+      return NRU;
+   if (policy_str == "srrip")
+      return SRRIP;
+   if (policy_str == "brrip")
+      return BRRIP;
    else
    {
       LOG_PRINT_ERROR("Unrecognized Cache Replacement Policy(%s)", policy_str.c_str());
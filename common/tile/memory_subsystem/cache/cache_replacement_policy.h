@@ -7,6 +7,7 @@ using std::string;
 #include "caching_protocol_type.h"
 
 class CacheLineInfo;
+class UnstructuredBuffer;
 
 class CacheReplacementPolicy
 {
@@ -15,6 +16,10 @@ public:
    {
       ROUND_ROBIN = 0,
       LRU,
+      PLRU,
+      NRU,
+      SRRIP,
+      BRRIP,
       NUM_TYPES
    };
 
@@ -26,6 +31,15 @@ public:
    
    virtual UInt32 getReplacementWay(CacheLineInfo** cache_line_info_array, UInt32 set_num) = 0;
    virtual void update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way) = 0;
+   // Called when a line is filled into 'inserted_way'; policies that do not
+   // tell fills from hits treat it as an access
+   virtual void insert(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 inserted_way)
+   { update(cache_line_info_array, set_num, inserted_way); }
+
+   // State of the policy, for the checkpoint of the cache. Policies that
+   // keep it in the line infos have nothing more to save.
+   virtual void checkpoint(UnstructuredBuffer& buffer) {}
+   virtual void restore(UnstructuredBuffer& buffer) {}
 
 protected:
    UInt32 _num_sets;
@@ -1,11 +1,19 @@
 #include <cstring>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__x86_64__)
+#include <emmintrin.h>
+#endif
 #include "cache_set.h"
 #include "cache.h"
+#include "packetize.h"
 #include "log.h"
 
 CacheSet::CacheSet(UInt32 set_num, CachingProtocolType caching_protocol_type, SInt32 cache_level,
-                   CacheReplacementPolicy* replacement_policy, UInt32 associativity, UInt32 line_size)
-   : _set_num(set_num)
+                   CacheReplacementPolicy* replacement_policy, UInt32 associativity, UInt32 line_size,
+                   IntPtr* tags)
+   : _tags(tags)
+   , _set_num(set_num)
    , _replacement_policy(replacement_policy)
    , _associativity(associativity)
    , _line_size(line_size)
@@ -14,6 +22,7 @@ CacheSet::CacheSet(UInt32 set_num, CachingProtocolType caching_protocol_type, SI
    for (UInt32 i = 0; i < _associativity; i++)
    {
       _cache_line_info_array[i] = CacheLineInfo::create(caching_protocol_type, cache_level);
+      _tags[i] = _cache_line_info_array[i]->getTag();
    }
    _lines = new char[_associativity * _line_size];
    
@@ -54,19 +63,74 @@ CacheSet::write_line(UInt32 line_index, UInt32 offset, Byte *in_buf, UInt32 byte
    _replacement_policy->update(_cache_line_info_array, _set_num, line_index);
 }
 
-CacheLineInfo* 
-CacheSet::find(IntPtr tag, UInt32* line_index)
+// Returns the highest way holding 'tag', or -1. Ways are compared a
+// vector at a time, starting from the top.
+static SInt32
+matchTag(const IntPtr* tags, UInt32 associativity, IntPtr tag)
 {
-   for (SInt32 index = _associativity-1; index >= 0; index--)
+   SInt32 index = associativity;
+
+#if defined(__AVX2__)
+   const SInt32 TAGS_PER_VECTOR = 4;
+#elif defined(__x86_64__)
+   const SInt32 TAGS_PER_VECTOR = 2;
+#else
+   const SInt32 TAGS_PER_VECTOR = 1;
+#endif
+
+   // Ways that do not fill a whole vector
+   while (index % TAGS_PER_VECTOR != 0)
    {
-      if (_cache_line_info_array[index]->getTag() == tag)
-      {
-         if (line_index != NULL)
-            *line_index = index;
-         return (_cache_line_info_array[index]);
-      }
+      index --;
+      if (tags[index] == tag)
+         return index;
    }
-   return NULL;
+
+#if defined(__AVX2__)
+   const __m256i key = _mm256_set1_epi64x(tag);
+   while (index > 0)
+   {
+      index -= TAGS_PER_VECTOR;
+      __m256i ways = _mm256_loadu_si256((const __m256i*) &tags[index]);
+      SInt32 mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(ways, key)));
+      if (mask)
+         return index + 31 - __builtin_clz(mask);
+   }
+#elif defined(__x86_64__)
+   // SSE2 has no 64-bit compare: both 32-bit halves must match
+   const __m128i key = _mm_set1_epi64x(tag);
+   while (index > 0)
+   {
+      index -= TAGS_PER_VECTOR;
+      __m128i ways = _mm_loadu_si128((const __m128i*) &tags[index]);
+      __m128i equal = _mm_cmpeq_epi32(ways, key);
+      equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2,3,0,1)));
+      SInt32 mask = _mm_movemask_pd(_mm_castsi128_pd(equal));
+      if (mask)
+         return index + 31 - __builtin_clz(mask);
+   }
+#endif
+
+   return -1;
+}
+
+CacheLineInfo* 
+CacheSet::find(IntPtr tag, UInt32* line_index)
+{
+   SInt32 index = matchTag(_tags, _associativity, tag);
+   if (index < 0)
+      return NULL;
+
+   if (line_index != NULL)
+      *line_index = index;
+   return (_cache_line_info_array[index]);
+}
+
+void
+CacheSet::update(UInt32 line_index, CacheLineInfo* updated_cache_line_info)
+{
+   _cache_line_info_array[line_index]->assign(updated_cache_line_info);
+   _tags[line_index] = _cache_line_info_array[line_index]->getTag();
 }
 
 void 
@@ -95,9 +159,30 @@ CacheSet::insert(CacheLineInfo* inserted_cache_line_info, Byte* fill_buf,
    }
 
    _cache_line_info_array[index]->assign(inserted_cache_line_info);
+   _tags[index] = _cache_line_info_array[index]->getTag();
    if (fill_buf != NULL)
       memcpy(&_lines[index * _line_size], (void*) fill_buf, _line_size);
 
    // Update replacement policy
-   _replacement_policy->update(_cache_line_info_array, _set_num, index);
+   _replacement_policy->insert(_cache_line_info_array, _set_num, index);
+}
+
+void
+CacheSet::checkpoint(UnstructuredBuffer& buffer)
+{
+   for (UInt32 i = 0; i < _associativity; i++)
+      _cache_line_info_array[i]->checkpoint(buffer);
+   buffer << std::make_pair(_lines, _associativity * _line_size);
+}
+
+void
+CacheSet::restore(UnstructuredBuffer& buffer)
+{
+   for (UInt32 i = 0; i < _associativity; i++)
+   {
+      _cache_line_info_array[i]->restore(buffer);
+      _tags[i] = _cache_line_info_array[i]->getTag();
+   }
+   // Only in lite mode, where the application never reads the data back (see DramCntlr::restore())
+   buffer >> std::make_pair(_lines, _associativity * _line_size);
 }
@@ -4,21 +4,33 @@
 #include "cache_line_info.h"
 #include "cache_replacement_policy.h"
 
+class UnstructuredBuffer;
+
 // Everything related to cache sets
 class CacheSet
 {
 public:
    CacheSet(UInt32 set_num, CachingProtocolType caching_protocol_type, SInt32 cache_level,
-            CacheReplacementPolicy* replacement_policy, UInt32 associativity, UInt32 line_size);
+            CacheReplacementPolicy* replacement_policy, UInt32 associativity, UInt32 line_size,
+            IntPtr* tags);
    ~CacheSet();
 
    void read_line(UInt32 line_index, UInt32 offset, Byte *out_buf, UInt32 bytes);
    void write_line(UInt32 line_index, UInt32 offset, Byte *in_buf, UInt32 bytes);
    CacheLineInfo* find(IntPtr tag, UInt32* line_index = NULL);
+   void update(UInt32 line_index, CacheLineInfo* updated_cache_line_info);
    void insert(CacheLineInfo* inserted_cache_line_info, Byte* fill_buf,
                bool* eviction, CacheLineInfo* evicted_cache_line_info, Byte* writeback_buf);
 
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
+
 private:
+   // Tags of the ways, kept in a contiguous per-cache array (owned by
+   // Cache) so that lookups do not touch the line info objects. They
+   // mirror the tags in _cache_line_info_array, which holds the
+   // protocol-specific state.
+   IntPtr* _tags;
    CacheLineInfo** _cache_line_info_array;
    char* _lines;
    UInt32 _set_num;
@@ -6,6 +6,8 @@
 #include "log.h"
 #include "mcpat_cache_interface.h"
 #include "utils.h"
+#include "statistics_registry.h"
+#include "packetize.h"
 
 DirectoryCache::DirectoryCache(Tile* tile,
                                CachingProtocolType caching_protocol_type,
@@ -52,11 +54,12 @@ DirectoryCache::DirectoryCache(Tile* tile,
    //initialize frequency and voltage
    int rc = DVFSManager::getInitialFrequencyAndVoltage(DIRECTORY, _frequency, _voltage);
    LOG_ASSERT_ERROR(rc == 0, "Error setting initial voltage for frequency(%g)", _frequency);
+   _clock_domain = DVFSManager::getClockDomain(_frequency);
 
 
    // Calculate access time based on size of directory entry and total number of entries (or) user specified
    _directory_access_cycles = computeDirectoryAccessCycles();
-   _directory_access_latency = Time(Latency(_directory_access_cycles, _frequency));
+   _directory_access_latency = Time(Latency(_directory_access_cycles, _clock_domain));
 
    // asynchronous communication
    _synchronization_delay = Time(Latency(DVFSManager::getSynchronizationDelay(), _frequency));
@@ -124,7 +127,7 @@ DirectoryCache::getDirectoryEntry(IntPtr address)
       if (directory_entry->getAddress() == address)
       {
          if (getShmemPerfModel())
-            getShmemPerfModel()->incrCurrTime(Latency(directory_entry->getLatency(),_frequency));
+            getShmemPerfModel()->incrCurrTime(Latency(directory_entry->getLatency(),_clock_domain));
          // Simple check for now. Make sophisticated later
          return directory_entry;
       }
@@ -367,6 +370,28 @@ DirectoryCache::outputSummary(ostream& out)
    DVFSManager::printAsynchronousMap(out, _module, _asynchronous_map);
 }
 
+void
+DirectoryCache::registerStatistics(StatisticsRegistry* registry)
+{
+   registry->registerCounter("directory", "accesses", &_total_directory_accesses);
+   registry->registerCounter("directory", "evictions", &_total_evictions);
+   registry->registerCounter("directory", "back_invalidations", &_total_back_invalidations);
+}
+
+void
+DirectoryCache::checkpoint(UnstructuredBuffer& buffer)
+{
+   LOG_ASSERT_ERROR(_replaced_directory_entry_list.empty(),
+                    "Directory entries are being replaced: memory requests are in flight");
+   _directory->checkpoint(buffer);
+}
+
+void
+DirectoryCache::restore(UnstructuredBuffer& buffer)
+{
+   _directory->restore(buffer);
+}
+
 void
 DirectoryCache::dummyOutputSummary(ostream& out, tile_id_t tile_id)
 {
@@ -435,7 +460,8 @@ DirectoryCache::setDVFS(double frequency, voltage_option_t voltage_flag, const T
    if (rc==0)
    {
       _frequency = frequency;
-      _directory_access_latency = Time(Latency(_directory_access_cycles, _frequency));
+      _clock_domain = DVFSManager::getClockDomain(_frequency);
+      _directory_access_latency = Time(Latency(_directory_access_cycles, _clock_domain));
       _synchronization_delay = Time(Latency(DVFSManager::getSynchronizationDelay(), _frequency));
    }
 
@@ -16,6 +16,8 @@ using std::ostream;
 #include "dvfs_manager.h"
 
 class McPATCacheInterface;
+class StatisticsRegistry;
+class UnstructuredBuffer;
 
 class DirectoryCache
 {
@@ -40,8 +42,13 @@ public:
    void getReplacementCandidates(IntPtr address, vector<DirectoryEntry*>& replacement_candidate_list);
 
    void outputSummary(ostream& os);
+   void registerStatistics(StatisticsRegistry* registry);
    static void dummyOutputSummary(ostream& os, tile_id_t tile_id);
 
+   // Entries of the directory, for the checkpoint of the tile
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
+
    void enable() { _enabled = true; }
    void disable() { _enabled = false; }
 
@@ -113,6 +120,7 @@ private:
    ShmemPerfModel* getShmemPerfModel();
 
    double _frequency;
+   const ClockDomain* _clock_domain;
    double _voltage;
    module_t _module;
    DVFSManager::AsynchronousMap _asynchronous_map;
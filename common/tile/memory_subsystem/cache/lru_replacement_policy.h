@@ -13,7 +13,11 @@ public:
 
    UInt32 getReplacementWay(CacheLineInfo** cache_line_info_array, UInt32 set_num);
    void update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way);
+
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
   
 private: 
-   vector<vector<UInt8> > _lru_bits_vec;
+   // LRU positions of all the ways, set by set (0 is the MRU way)
+   vector<UInt8> _lru_bits_vec;
 };
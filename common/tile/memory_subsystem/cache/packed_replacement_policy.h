@@ -0,0 +1,245 @@
+#pragma once
+
+#include <vector>
+using std::vector;
+
+#include "cache_replacement_policy.h"
+#include "cache_line_info.h"
+#include "packetize.h"
+#include "log.h"
+
+// Replacement policy whose per-set state is a single packed 64-bit
+// word. The 'Engine' implements the policy on that word; it is a
+// template parameter so all of its per-way work is inlined into the
+// (one) virtual call made by CacheSet.
+//
+// An Engine provides:
+//    Engine(UInt32 associativity);
+//    UInt64 initialState() const;
+//    UInt32 getVictim(UInt64& state);
+//    void touch(UInt64& state, UInt32 way);      // hit
+//    void insert(UInt64& state, UInt32 way);     // fill
+//    void checkpoint(UnstructuredBuffer& buffer); // state beyond the sets
+//    void restore(UnstructuredBuffer& buffer);
+//
+// Invalid ways are always filled first, as with LRU.
+
+template <class Engine>
+class PackedReplacementPolicy : public CacheReplacementPolicy
+{
+public:
+   PackedReplacementPolicy(UInt32 cache_size, UInt32 associativity, UInt32 cache_line_size)
+      : CacheReplacementPolicy(cache_size, associativity, cache_line_size)
+      , _engine(associativity)
+   {
+      _set_state_vec.resize(_num_sets, _engine.initialState());
+   }
+   ~PackedReplacementPolicy() {}
+
+   UInt32 getReplacementWay(CacheLineInfo** cache_line_info_array, UInt32 set_num)
+   {
+      for (UInt32 i = 0; i < _associativity; i++)
+      {
+         if (!cache_line_info_array[i]->isValid())
+            return i;
+      }
+      return _engine.getVictim(_set_state_vec[set_num]);
+   }
+
+   void update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way)
+   { _engine.touch(_set_state_vec[set_num], accessed_way); }
+
+   void insert(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 inserted_way)
+   { _engine.insert(_set_state_vec[set_num], inserted_way); }
+
+   void checkpoint(UnstructuredBuffer& buffer)
+   {
+      buffer << std::make_pair(&_set_state_vec[0], _set_state_vec.size() * sizeof(UInt64));
+      _engine.checkpoint(buffer);
+   }
+
+   void restore(UnstructuredBuffer& buffer)
+   {
+      buffer >> std::make_pair(&_set_state_vec[0], _set_state_vec.size() * sizeof(UInt64));
+      _engine.restore(buffer);
+   }
+
+private:
+   Engine _engine;
+   vector<UInt64> _set_state_vec;
+};
+
+// Tree pseudo-LRU: associativity-1 node bits, heap-ordered (node n has
+// children 2n+1, 2n+2). A node bit of 0 points to the left half as the
+// one to replace, 1 to the right half.
+class TreePLRUEngine
+{
+public:
+   TreePLRUEngine(UInt32 associativity)
+      : _associativity(associativity)
+   {
+      LOG_ASSERT_ERROR(associativity <= 64 && (associativity & (associativity - 1)) == 0,
+                       "PLRU needs a power-of-two associativity <= 64, got %u", associativity);
+   }
+
+   UInt64 initialState() const { return 0; }
+
+   UInt32 getVictim(UInt64& state)
+   {
+      UInt32 node = 0;
+      for (UInt32 width = _associativity; width > 1; width >>= 1)
+         node = 2 * node + 1 + ((state >> node) & 1);
+      return node - (_associativity - 1);
+   }
+
+   void touch(UInt64& state, UInt32 way)
+   {
+      // Walk up from the leaf, pointing every node away from 'way'
+      UInt32 node = way + (_associativity - 1);
+      while (node > 0)
+      {
+         UInt32 parent = (node - 1) / 2;
+         bool is_left = (node == 2 * parent + 1);
+         if (is_left)
+            state |= (1ULL << parent);
+         else
+            state &= ~(1ULL << parent);
+         node = parent;
+      }
+   }
+
+   void insert(UInt64& state, UInt32 way)
+   { touch(state, way); }
+
+   void checkpoint(UnstructuredBuffer& buffer) {}
+   void restore(UnstructuredBuffer& buffer) {}
+
+private:
+   UInt32 _associativity;
+};
+
+// Not-recently-used: one reference bit per way. When the last clear bit
+// gets set, all the others are cleared.
+class NRUEngine
+{
+public:
+   NRUEngine(UInt32 associativity)
+      : _all_ways((associativity == 64) ? ~0ULL : ((1ULL << associativity) - 1))
+   {
+      LOG_ASSERT_ERROR(associativity <= 64, "NRU supports an associativity of at most 64, got %u", associativity);
+   }
+
+   UInt64 initialState() const { return 0; }
+
+   UInt32 getVictim(UInt64& state)
+   {
+      UInt64 not_used = ~state & _all_ways;
+      LOG_ASSERT_ERROR(not_used != 0, "NRU state(%#llx) has no candidate", state);
+      return __builtin_ctzll(not_used);
+   }
+
+   void touch(UInt64& state, UInt32 way)
+   {
+      state |= (1ULL << way);
+      if (state == _all_ways)
+         state = (1ULL << way);
+   }
+
+   void insert(UInt64& state, UInt32 way)
+   { touch(state, way); }
+
+   void checkpoint(UnstructuredBuffer& buffer) {}
+   void restore(UnstructuredBuffer& buffer) {}
+
+private:
+   UInt64 _all_ways;
+};
+
+// Re-reference interval prediction (Jaleel et al., ISCA 2010) with 2-bit
+// re-reference prediction values (RRPVs) per way. Hits predict a
+// near-immediate re-reference (0); the victim is the first way predicted
+// distant (3), aging all the ways until there is one. SRRIP fills with a
+// long (2) prediction; BRRIP fills with a distant one, except for one fill
+// in every BRRIP_LONG_INTERVAL.
+template <bool BIMODAL>
+class RRIPEngine
+{
+public:
+   RRIPEngine(UInt32 associativity)
+      : _associativity(associativity)
+      , _fill_count(0)
+   {
+      LOG_ASSERT_ERROR(associativity <= 32, "RRIP supports an associativity of at most 32, got %u", associativity);
+   }
+
+   // Every way starts out distant
+   UInt64 initialState() const
+   {
+      UInt64 state = 0;
+      for (UInt32 way = 0; way < _associativity; way++)
+         setRRPV(state, way, DISTANT);
+      return state;
+   }
+
+   UInt32 getVictim(UInt64& state)
+   {
+      while (true)
+      {
+         for (UInt32 way = 0; way < _associativity; way++)
+         {
+            if (getRRPV(state, way) == DISTANT)
+               return way;
+         }
+         // No RRPV is saturated, so adding 1 to each field cannot carry
+         for (UInt32 way = 0; way < _associativity; way++)
+            state += (1ULL << (RRPV_BITS * way));
+      }
+   }
+
+   void touch(UInt64& state, UInt32 way)
+   { setRRPV(state, way, IMMEDIATE); }
+
+   void insert(UInt64& state, UInt32 way)
+   {
+      if (!BIMODAL)
+      {
+         setRRPV(state, way, LONG);
+      }
+      else
+      {
+         setRRPV(state, way, (_fill_count == 0) ? LONG : DISTANT);
+         _fill_count = (_fill_count + 1) % BRRIP_LONG_INTERVAL;
+      }
+   }
+
+   void checkpoint(UnstructuredBuffer& buffer)
+   { buffer << _fill_count; }
+   void restore(UnstructuredBuffer& buffer)
+   { buffer >> _fill_count; }
+
+private:
+   enum RRPV
+   {
+      IMMEDIATE = 0,
+      LONG = 2,
+      DISTANT = 3
+   };
+
+   static const UInt32 RRPV_BITS = 2;
+   static const UInt64 RRPV_MASK = 3;
+   static const UInt32 BRRIP_LONG_INTERVAL = 32;
+
+   UInt32 _associativity;
+   // Deterministic stand-in for BRRIP's random choice, so runs repeat
+   UInt32 _fill_count;
+
+   static UInt32 getRRPV(UInt64 state, UInt32 way)
+   { return (state >> (RRPV_BITS * way)) & RRPV_MASK; }
+   static void setRRPV(UInt64& state, UInt32 way, RRPV rrpv)
+   { state = (state & ~(RRPV_MASK << (RRPV_BITS * way))) | (((UInt64) rrpv) << (RRPV_BITS * way)); }
+};
+
+typedef PackedReplacementPolicy<TreePLRUEngine> PLRUReplacementPolicy;
+typedef PackedReplacementPolicy<NRUEngine> NRUReplacementPolicy;
+typedef PackedReplacementPolicy<RRIPEngine<false> > SRRIPReplacementPolicy;
+typedef PackedReplacementPolicy<RRIPEngine<true> > BRRIPReplacementPolicy;
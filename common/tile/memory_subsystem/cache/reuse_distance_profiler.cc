@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <sstream>
+
+#include "reuse_distance_profiler.h"
+#include "simulator.h"
+#include "config.h"
+#include "statistics_registry.h"
+#include "utils.h"
+#include "constants.h"
+#include "log.h"
+
+using std::endl;
+
+ReuseDistanceProfiler*
+ReuseDistanceProfiler::create(const string& cache_name, UInt32 cache_size, UInt32 line_size)
+{
+   vector<string> cache_names;
+   string cache_names_line = Sim()->getCfg()->getString("caching_protocol/reuse_distance/caches", "");
+   splitIntoTokens(cache_names_line, cache_names, ", ");
+   if (std::find(cache_names.begin(), cache_names.end(), cache_name) == cache_names.end())
+      return NULL;
+
+   double sampling_rate = Sim()->getCfg()->getFloat("caching_protocol/reuse_distance/sampling_rate", 0.01);
+   UInt32 max_samples = Sim()->getCfg()->getInt("caching_protocol/reuse_distance/max_samples", 8192);
+   UInt32 range = Sim()->getCfg()->getInt("caching_protocol/reuse_distance/size_range", 16);
+   LOG_ASSERT_ERROR(sampling_rate > 0 && sampling_rate <= 1, "Invalid reuse distance sampling rate(%g)", sampling_rate);
+   LOG_ASSERT_ERROR(range >= 1 && isPower2(range), "Invalid reuse distance size range(%u)", range);
+
+   // Power-of-two sizes from 1/range to range times the size of the cache
+   vector<UInt64> cache_sizes;
+   for (UInt64 size = std::max<UInt64>(cache_size / range, line_size); size <= (UInt64) cache_size * range; size *= 2)
+      cache_sizes.push_back(size);
+
+   return new ReuseDistanceProfiler(cache_sizes, line_size, sampling_rate, max_samples);
+}
+
+ReuseDistanceProfiler::ReuseDistanceProfiler(const vector<UInt64>& cache_sizes, UInt32 line_size,
+                                             double sampling_rate, UInt32 max_samples)
+   : _cache_sizes(cache_sizes)
+   , _max_samples(max_samples)
+   , _threshold((UInt32) (sampling_rate * (1 << HASH_BITS)))
+   , _timestamps(MIN_TIMESTAMPS + 1, 0)
+   , _next_timestamp(0)
+   , _total_accesses(0)
+   , _total_misses(cache_sizes.size(), 0)
+{
+   _threshold = std::max<UInt32>(_threshold, 1);
+   for (UInt32 i = 0; i < _cache_sizes.size(); i++)
+      _cache_sizes_in_lines.push_back(_cache_sizes[i] / line_size);
+}
+
+ReuseDistanceProfiler::~ReuseDistanceProfiler()
+{}
+
+void
+ReuseDistanceProfiler::access(IntPtr tag, bool enabled)
+{
+   UInt32 hash = computeHash(tag);
+   if (hash >= _threshold)
+      return;
+
+   // Every sampled access stands for this many accesses
+   double weight = (double) (1 << HASH_BITS) / _threshold;
+
+   map<IntPtr, Sample>::iterator it = _samples.find(tag);
+   bool cold = (it == _samples.end());
+   double distance = 0;
+   if (!cold)
+   {
+      distance = weight * (_samples.size() - countTimestamps(it->second.timestamp));
+      removeSample(it);
+   }
+
+   if (enabled)
+   {
+      _total_accesses += weight;
+      for (UInt32 i = 0; i < _cache_sizes_in_lines.size(); i++)
+      {
+         if (cold || (distance >= _cache_sizes_in_lines[i]))
+            _total_misses[i] += weight;
+      }
+   }
+
+   Sample sample;
+   sample.timestamp = allocateTimestamp();
+   sample.hash = hash;
+   addTimestamp(sample.timestamp, 1);
+   _samples.insert(std::make_pair(tag, sample));
+   _samples_by_hash.insert(std::make_pair(hash, tag));
+
+   // Lower the threshold to the largest hash until the samples fit
+   while ( (_max_samples > 0) && (_samples.size() > _max_samples) )
+   {
+      UInt32 largest_hash = _samples_by_hash.rbegin()->first;
+      while (!_samples_by_hash.empty() && (_samples_by_hash.rbegin()->first == largest_hash))
+         removeSample(_samples.find(_samples_by_hash.rbegin()->second));
+      _threshold = largest_hash;
+   }
+}
+
+void
+ReuseDistanceProfiler::removeSample(map<IntPtr, Sample>::iterator it)
+{
+   addTimestamp(it->second.timestamp, -1);
+   _samples_by_hash.erase(std::make_pair(it->second.hash, it->first));
+   _samples.erase(it);
+}
+
+UInt32
+ReuseDistanceProfiler::computeHash(IntPtr tag)
+{
+   // MurmurHash3 finalizer
+   UInt64 h = (UInt64) tag;
+   h ^= h >> 33;
+   h *= 0xff51afd7ed558ccdULL;
+   h ^= h >> 33;
+   h *= 0xc4ceb9fe1a85ec53ULL;
+   h ^= h >> 33;
+   return (UInt32) (h & ((1 << HASH_BITS) - 1));
+}
+
+void
+ReuseDistanceProfiler::addTimestamp(UInt32 timestamp, SInt32 delta)
+{
+   for (UInt32 i = timestamp + 1; i < _timestamps.size(); i += i & (-i))
+      _timestamps[i] += delta;
+}
+
+UInt32
+ReuseDistanceProfiler::countTimestamps(UInt32 timestamp) const
+{
+   UInt32 count = 0;
+   for (UInt32 i = timestamp + 1; i > 0; i -= i & (-i))
+      count += _timestamps[i];
+   return count;
+}
+
+UInt32
+ReuseDistanceProfiler::allocateTimestamp()
+{
+   if (_next_timestamp == _timestamps.size() - 1)
+      renumberTimestamps();
+   return _next_timestamp ++;
+}
+
+void
+ReuseDistanceProfiler::renumberTimestamps()
+{
+   // Keep the order of the last accesses, without the gaps
+   vector<pair<UInt32, IntPtr> > last_accesses;
+   for (map<IntPtr, Sample>::iterator it = _samples.begin(); it != _samples.end(); it++)
+      last_accesses.push_back(std::make_pair(it->second.timestamp, it->first));
+   std::sort(last_accesses.begin(), last_accesses.end());
+
+   UInt32 num_timestamps = std::max<UInt32>(2 * last_accesses.size(), MIN_TIMESTAMPS);
+   _timestamps.assign(num_timestamps + 1, 0);
+   for (UInt32 i = 0; i < last_accesses.size(); i++)
+   {
+      _samples[last_accesses[i].second].timestamp = i;
+      addTimestamp(i, 1);
+   }
+   _next_timestamp = last_accesses.size();
+}
+
+void
+ReuseDistanceProfiler::outputSummary(ostream& out) const
+{
+   out << "    Miss Ratio Curve (Sampled Reuse Distance):" << endl;
+   for (UInt32 i = 0; i < _cache_sizes.size(); i++)
+   {
+      out << "      " << _cache_sizes[i] / k_KILO << " KB Miss Rate (%): ";
+      if (_total_accesses > 0)
+         out << 100.0 * _total_misses[i] / _total_accesses;
+      out << endl;
+   }
+}
+
+void
+ReuseDistanceProfiler::registerStatistics(StatisticsRegistry* registry, const string& component)
+{
+   registry->registerCounter(component, "mrc_accesses", &_total_accesses);
+   for (UInt32 i = 0; i < _cache_sizes.size(); i++)
+   {
+      std::ostringstream name;
+      name << "mrc_misses_" << _cache_sizes[i] / k_KILO << "KB";
+      registry->registerCounter(component, name.str(), &_total_misses[i]);
+   }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <iostream>
+using std::string;
+using std::vector;
+using std::map;
+using std::set;
+using std::pair;
+using std::ostream;
+
+#include "fixed_types.h"
+
+class StatisticsRegistry;
+
+// Miss ratio curve of a cache from the reuse distances of the accesses from
+// the core, estimated in a single pass with spatial sampling (SHARDS).
+//
+// A line is sampled if a hash of its address falls below a threshold, so a
+// sampled line has all of its accesses sampled. The reuse distance of an
+// access to a sampled line is the number of distinct sampled lines accessed
+// since its previous access, scaled by the inverse of the sampling rate. The
+// last access of every sampled line is kept in a Fenwick tree indexed by
+// access number, which gives the distance in O(log n). When more than
+// max_samples lines are sampled, the lines with the largest hashes are
+// dropped and the threshold is lowered to their hash, which bounds the
+// memory and time spent per cache.
+//
+// The curve is for a fully associative LRU cache of the same line size, at
+// power-of-two sizes around the size of the cache. Invalidations from the
+// coherence protocol are not modeled.
+class ReuseDistanceProfiler
+{
+public:
+   // Returns a profiler if the cache is listed in [caching_protocol/reuse_distance],
+   // NULL otherwise. 'cache_size' is in bytes.
+   static ReuseDistanceProfiler* create(const string& cache_name, UInt32 cache_size, UInt32 line_size);
+
+   ReuseDistanceProfiler(const vector<UInt64>& cache_sizes, UInt32 line_size, double sampling_rate, UInt32 max_samples);
+   ~ReuseDistanceProfiler();
+
+   // Access to the line with the given tag (address / line size).
+   // Only accesses while the models are enabled go into the curve.
+   void access(IntPtr tag, bool enabled);
+
+   void outputSummary(ostream& out) const;
+   void registerStatistics(StatisticsRegistry* registry, const string& component);
+
+private:
+   static const UInt32 HASH_BITS = 24;
+   static const UInt32 MIN_TIMESTAMPS = 1024;
+
+   struct Sample
+   {
+      UInt32 timestamp;
+      UInt32 hash;
+   };
+
+   // Sizes of the curve, in bytes and in lines
+   vector<UInt64> _cache_sizes;
+   vector<UInt64> _cache_sizes_in_lines;
+   UInt32 _max_samples;
+   // Lines whose hash is below the threshold are sampled
+   UInt32 _threshold;
+
+   // Last access of the sampled lines
+   map<IntPtr, Sample> _samples;
+   // Sampled lines by hash, to drop the largest ones
+   set<pair<UInt32, IntPtr> > _samples_by_hash;
+
+   // Fenwick tree with a 1 at the timestamp of the last access of every
+   // sampled line. Timestamps are renumbered when they run out.
+   vector<UInt32> _timestamps;
+   UInt32 _next_timestamp;
+
+   // Estimated accesses and misses at each size (scaled by the sampling rate)
+   double _total_accesses;
+   vector<double> _total_misses;
+
+   static UInt32 computeHash(IntPtr tag);
+
+   void addTimestamp(UInt32 timestamp, SInt32 delta);
+   // Number of sampled lines last accessed at or before 'timestamp'
+   UInt32 countTimestamps(UInt32 timestamp) const;
+   UInt32 allocateTimestamp();
+   void renumberTimestamps();
+
+   void removeSample(map<IntPtr, Sample>::iterator it);
+};
@@ -1,5 +1,6 @@
 #include "round_robin_replacement_policy.h"
 #include "cache_line_info.h"
+#include "packetize.h"
 
 RoundRobinReplacementPolicy::RoundRobinReplacementPolicy(UInt32 cache_size, UInt32 associativity, UInt32 cache_line_size)
    : CacheReplacementPolicy(cache_size, associativity, cache_line_size)
@@ -25,3 +26,15 @@ RoundRobinReplacementPolicy::update(CacheLineInfo** cache_line_info_array, UInt3
 {
    return;
 }
+
+void
+RoundRobinReplacementPolicy::checkpoint(UnstructuredBuffer& buffer)
+{
+   buffer << std::make_pair(&_replacement_index_vec[0], _replacement_index_vec.size() * sizeof(UInt32));
+}
+
+void
+RoundRobinReplacementPolicy::restore(UnstructuredBuffer& buffer)
+{
+   buffer >> std::make_pair(&_replacement_index_vec[0], _replacement_index_vec.size() * sizeof(UInt32));
+}
@@ -1,12 +1,16 @@
 #include "simulator.h"
 #include "directory.h"
 #include "directory_entry.h"
+#include "packetize.h"
 #include "log.h"
 
 Directory::Directory(CachingProtocolType caching_protocol_type, DirectoryType directory_type,
                      SInt32 total_entries, SInt32 max_hw_sharers, SInt32 max_num_sharers)
    : _total_entries(total_entries)
+   , _caching_protocol_type(caching_protocol_type)
    , _directory_type(directory_type)
+   , _max_hw_sharers(max_hw_sharers)
+   , _max_num_sharers(max_num_sharers)
 {
    // Look at the type of directory and create 
    _directory_entry_list.resize(_total_entries);
@@ -78,3 +82,38 @@ Directory::getSharerStats(vector<UInt64>& sharer_count_vec)
    LOG_ASSERT_ERROR(_directory_type == FULL_MAP, "Directory type should be FULL_MAP, now (%i)", _directory_type);
    sharer_count_vec = _sharer_count_vec;
 }
+
+void
+Directory::checkpoint(UnstructuredBuffer& buffer)
+{
+   buffer << _total_entries << (SInt32) _directory_type;
+   for (SInt32 i = 0; i < _total_entries; i++)
+      _directory_entry_list[i]->checkpoint(buffer);
+
+   for (UInt32 i = 0; i < _sharer_count_vec.size(); i++)
+      buffer << _sharer_count_vec[i];
+}
+
+void
+Directory::restore(UnstructuredBuffer& buffer)
+{
+   SInt32 total_entries;
+   SInt32 directory_type;
+   buffer >> total_entries >> directory_type;
+   LOG_ASSERT_ERROR(total_entries == _total_entries && directory_type == (SInt32) _directory_type,
+                    "Directory: checkpoint has %i entries of type(%i), expected %i of type(%i)",
+                    total_entries, directory_type, _total_entries, _directory_type);
+
+   // Sharers are only added to an entry, so start from new ones
+   for (SInt32 i = 0; i < _total_entries; i++)
+   {
+      DirectoryEntry* directory_entry = DirectoryEntry::create(_caching_protocol_type, _directory_type,
+                                                               _max_hw_sharers, _max_num_sharers);
+      directory_entry->restore(buffer);
+      delete _directory_entry_list[i];
+      _directory_entry_list[i] = directory_entry;
+   }
+
+   for (UInt32 i = 0; i < _sharer_count_vec.size(); i++)
+      buffer >> _sharer_count_vec[i];
+}
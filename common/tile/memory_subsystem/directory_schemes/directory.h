@@ -7,6 +7,7 @@ using std::vector;
 
 // Forward Decls
 class DirectoryEntry;
+class UnstructuredBuffer;
 
 #include "fixed_types.h"
 #include "directory_type.h"
@@ -26,9 +27,16 @@ public:
    void updateSharerStats(SInt32 old_sharer_count, SInt32 new_sharer_count);
    void getSharerStats(vector<UInt64>& sharer_count_vec);
 
+   // Entries and sharer stats, for the checkpoint of the directory cache
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
+
 private:
    SInt32 _total_entries;
+   CachingProtocolType _caching_protocol_type;
    DirectoryType _directory_type;
+   SInt32 _max_hw_sharers;
+   SInt32 _max_num_sharers;
 
    vector<DirectoryEntry*> _directory_entry_list;
    vector<UInt64> _sharer_count_vec;
@@ -6,6 +6,8 @@
 #include "directory_entry_ackwise.h"
 #include "directory_entry_limitless.h"
 #include "utils.h"
+#include "bit_vector.h"
+#include "packetize.h"
 #include "log.h"
 
 DirectoryEntry::DirectoryEntry(SInt32 max_hw_sharers)
@@ -109,3 +111,42 @@ DirectoryEntry::setOwner(tile_id_t owner_id)
       LOG_ASSERT_ERROR(hasSharer(owner_id), "Owner Id(%i) not a sharer", owner_id);
    _owner_id = owner_id;
 }
+
+void
+DirectoryEntry::checkpoint(UnstructuredBuffer& buffer)
+{
+   buffer << _address << (SInt32) _directory_block_info->getDState() << _owner_id;
+}
+
+void
+DirectoryEntry::restore(UnstructuredBuffer& buffer)
+{
+   SInt32 dstate;
+   buffer >> _address >> dstate >> _owner_id;
+   _directory_block_info->setDState((DirectoryState::Type) dstate);
+}
+
+void
+DirectoryEntry::checkpointSharers(UnstructuredBuffer& buffer, BitVector* sharers)
+{
+   buffer << sharers->size();
+   for (UInt32 i = 0; i < sharers->capacity(); i++)
+   {
+      if (sharers->at(i))
+         buffer << i;
+   }
+}
+
+void
+DirectoryEntry::restoreSharers(UnstructuredBuffer& buffer, BitVector* sharers)
+{
+   UInt32 num_sharers;
+   buffer >> num_sharers;
+   for (UInt32 i = 0; i < num_sharers; i++)
+   {
+      UInt32 sharer_id;
+      buffer >> sharer_id;
+      LOG_ASSERT_ERROR(sharer_id < sharers->capacity(), "Sharer(%u) out of range(%u)", sharer_id, sharers->capacity());
+      sharers->set(sharer_id);
+   }
+}
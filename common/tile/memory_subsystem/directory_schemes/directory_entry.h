@@ -10,6 +10,9 @@ using std::string;
 #include "directory_type.h"
 #include "caching_protocol_type.h"
 
+class UnstructuredBuffer;
+class BitVector;
+
 class DirectoryEntry
 {
 public:
@@ -40,12 +43,19 @@ public:
 
    virtual UInt32 getLatency() = 0;
 
+   // Derived entries add their sharers after the address, state and owner
+   virtual void checkpoint(UnstructuredBuffer& buffer);
+   virtual void restore(UnstructuredBuffer& buffer);
+
 protected:
    IntPtr _address;
    DirectoryBlockInfo* _directory_block_info;
    tile_id_t _owner_id;
    SInt32 _max_hw_sharers;
 
+   static void checkpointSharers(UnstructuredBuffer& buffer, BitVector* sharers);
+   static void restoreSharers(UnstructuredBuffer& buffer, BitVector* sharers);
+
 private:
    static DirectoryEntry* create(DirectoryType directory_type, SInt32 max_hw_sharers, SInt32 max_num_sharers);
 };
@@ -1,4 +1,5 @@
 #include "directory_entry_ackwise.h"
+#include "packetize.h"
 #include "log.h"
 
 DirectoryEntryAckwise::DirectoryEntryAckwise(SInt32 max_hw_sharers)
@@ -90,3 +91,17 @@ DirectoryEntryAckwise::getLatency()
 {
    return 0;
 }
+
+void
+DirectoryEntryAckwise::checkpoint(UnstructuredBuffer& buffer)
+{
+   DirectoryEntryLimited::checkpoint(buffer);
+   buffer << _global_enabled << _num_untracked_sharers;
+}
+
+void
+DirectoryEntryAckwise::restore(UnstructuredBuffer& buffer)
+{
+   DirectoryEntryLimited::restore(buffer);
+   buffer >> _global_enabled >> _num_untracked_sharers;
+}
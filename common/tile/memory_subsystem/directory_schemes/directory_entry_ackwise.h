@@ -17,6 +17,9 @@ public:
 
    UInt32 getLatency();
 
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
+
 private:
    bool _global_enabled;
    SInt32 _num_untracked_sharers;
@@ -1,4 +1,5 @@
 #include "directory_entry_full_map.h"
+#include "packetize.h"
 #include "log.h"
 
 using namespace std;
@@ -84,3 +85,17 @@ DirectoryEntryFullMap::getLatency()
 {
    return 0;
 }
+
+void
+DirectoryEntryFullMap::checkpoint(UnstructuredBuffer& buffer)
+{
+   DirectoryEntry::checkpoint(buffer);
+   checkpointSharers(buffer, _sharers);
+}
+
+void
+DirectoryEntryFullMap::restore(UnstructuredBuffer& buffer)
+{
+   DirectoryEntry::restore(buffer);
+   restoreSharers(buffer, _sharers);
+}
@@ -23,6 +23,9 @@ public:
 
    UInt32 getLatency();
 
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
+
 private:
    BitVector* _sharers;
    Random<int> _rand_num;
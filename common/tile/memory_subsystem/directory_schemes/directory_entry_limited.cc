@@ -1,4 +1,5 @@
 #include "directory_entry_limited.h"
+#include "packetize.h"
 #include "log.h"
 
 using namespace std;
@@ -103,3 +104,17 @@ DirectoryEntryLimited::getNumSharers()
 {
    return _num_tracked_sharers;
 }
+
+void
+DirectoryEntryLimited::checkpoint(UnstructuredBuffer& buffer)
+{
+   DirectoryEntry::checkpoint(buffer);
+   buffer << std::make_pair(&_sharers[0], _sharers.size() * sizeof(SInt16)) << _num_tracked_sharers;
+}
+
+void
+DirectoryEntryLimited::restore(UnstructuredBuffer& buffer)
+{
+   DirectoryEntry::restore(buffer);
+   buffer >> std::make_pair(&_sharers[0], _sharers.size() * sizeof(SInt16)) >> _num_tracked_sharers;
+}
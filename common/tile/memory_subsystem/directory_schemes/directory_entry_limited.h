@@ -17,6 +17,9 @@ public:
    tile_id_t getOneSharer();
    SInt32 getNumSharers();
 
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
+
 protected:
    vector<SInt16> _sharers;
    SInt32 _num_tracked_sharers;
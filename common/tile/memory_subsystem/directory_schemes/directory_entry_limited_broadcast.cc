@@ -1,5 +1,6 @@
 #include "directory_entry_limited_broadcast.h"
 #include "config.h"
+#include "packetize.h"
 #include "log.h"
 
 using namespace std;
@@ -88,3 +89,16 @@ DirectoryEntryLimitedBroadcast::getLatency()
    return 0;
 }
 
+void
+DirectoryEntryLimitedBroadcast::checkpoint(UnstructuredBuffer& buffer)
+{
+   DirectoryEntryLimited::checkpoint(buffer);
+   buffer << _global_enabled << _num_sharers;
+}
+
+void
+DirectoryEntryLimitedBroadcast::restore(UnstructuredBuffer& buffer)
+{
+   DirectoryEntryLimited::restore(buffer);
+   buffer >> _global_enabled >> _num_sharers;
+}
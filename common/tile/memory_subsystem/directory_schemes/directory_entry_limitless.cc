@@ -1,10 +1,12 @@
 #include "directory_entry_limitless.h"
 #include "simulator.h"
 #include "config.h"
+#include "packetize.h"
 #include "log.h"
 
-bool DirectoryEntryLimitless::_software_trap_penalty_initialized = false;
+volatile bool DirectoryEntryLimitless::_software_trap_penalty_initialized = false;
 UInt32 DirectoryEntryLimitless::_software_trap_penalty;
+Lock DirectoryEntryLimitless::_software_trap_penalty_lock;
 
 DirectoryEntryLimitless::DirectoryEntryLimitless(SInt32 max_hw_sharers, SInt32 max_num_sharers)
    : DirectoryEntryLimited(max_hw_sharers)
@@ -12,10 +14,17 @@ DirectoryEntryLimitless::DirectoryEntryLimitless(SInt32 max_hw_sharers, SInt32 m
    , _max_num_sharers(max_num_sharers)
    , _software_trap_enabled(false)
 {
+   // Tiles are built in parallel, so the first entries may be constructed concurrently
    if (!_software_trap_penalty_initialized)
    {
-      _software_trap_penalty = Sim()->getCfg()->getInt("dram_directory/limitless/software_trap_penalty",0);
-      _software_trap_penalty_initialized = true;
+      ScopedLock sl(_software_trap_penalty_lock);
+      if (!_software_trap_penalty_initialized)
+      {
+         _software_trap_penalty = Sim()->getCfg()->getInt("dram_directory/limitless/software_trap_penalty",0);
+         // Unlocked readers look at the penalty only once they see the flag
+         __sync_synchronize();
+         _software_trap_penalty_initialized = true;
+      }
    }
 }
 
@@ -135,3 +144,25 @@ DirectoryEntryLimitless::getLatency()
 {
    return (_software_trap_enabled) ? _software_trap_penalty : 0;
 }
+
+void
+DirectoryEntryLimitless::checkpoint(UnstructuredBuffer& buffer)
+{
+   DirectoryEntryLimited::checkpoint(buffer);
+   buffer << _software_trap_enabled;
+   if (_software_trap_enabled)
+      checkpointSharers(buffer, _software_sharers);
+}
+
+void
+DirectoryEntryLimitless::restore(UnstructuredBuffer& buffer)
+{
+   DirectoryEntryLimited::restore(buffer);
+   buffer >> _software_trap_enabled;
+   if (_software_trap_enabled)
+   {
+      if (!_software_sharers)
+         _software_sharers = new BitVector(_max_num_sharers);
+      restoreSharers(buffer, _software_sharers);
+   }
+}
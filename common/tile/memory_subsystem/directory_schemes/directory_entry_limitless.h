@@ -2,6 +2,7 @@
 
 #include "directory_entry_limited.h"
 #include "bit_vector.h"
+#include "lock.h"
 
 class DirectoryEntryLimitless : public DirectoryEntryLimited
 {
@@ -18,6 +19,9 @@ public:
 
    UInt32 getLatency();
 
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
+
 private:
    // Software Sharers
    BitVector* _software_sharers;
@@ -28,5 +32,6 @@ private:
    // Software Trap Variables
    bool _software_trap_enabled;
    static UInt32 _software_trap_penalty;
-   static bool _software_trap_penalty_initialized;
+   static volatile bool _software_trap_penalty_initialized;
+   static Lock _software_trap_penalty_lock;
 };
@@ -4,8 +4,11 @@
 #include "core_model.h"
 #include "tile.h"
 #include "memory_manager.h"
+#include "simulator.h"
+#include "config.h"
 #include "log.h"
 #include "constants.h"
+#include "packetize.h"
 
 DramCntlr::DramCntlr(Tile* tile,
       float dram_access_cost,
@@ -22,13 +25,24 @@ DramCntlr::DramCntlr(Tile* tile,
                                         dram_queue_model_type,
                                         cache_line_size);
 
-   _dram_access_count = new AccessCountMap[NUM_ACCESS_TYPES];
+   UInt32 chunk_size = 0;
+   bool use_mmap = false;
+   try
+   {
+      chunk_size = k_KILO * Sim()->getCfg()->getInt("dram/data_store/chunk_size", 4);
+      use_mmap = Sim()->getCfg()->getBool("dram/data_store/use_mmap", false);
+   }
+   catch (...)
+   {
+      LOG_PRINT_ERROR("Error reading dram/data_store parameters from the config file");
+   }
+   _data_store = new SparseMemoryStore(chunk_size, cache_line_size, NUM_ACCESS_TYPES, use_mmap);
 }
 
 DramCntlr::~DramCntlr()
 {
    printDramAccessCount();
-   delete [] _dram_access_count;
+   delete _data_store;
 
    delete _dram_perf_model;
 }
@@ -36,12 +50,9 @@ DramCntlr::~DramCntlr()
 void
 DramCntlr::getDataFromDram(IntPtr address, Byte* data_buf, bool modeled)
 {
-   if (_data_map[address] == NULL)
-   {
-      _data_map[address] = new Byte[_cache_line_size];
-      memset((void*) _data_map[address], 0x00, _cache_line_size);
-   }
-   memcpy((void*) data_buf, (void*) _data_map[address], _cache_line_size);
+   // Lines that were never written read as zero
+   Byte* line = _data_store->getLine(address);
+   memcpy((void*) data_buf, (void*) line, _cache_line_size);
 
    Latency dram_access_latency = modeled ? runDramPerfModel() : Latency(0,DRAM_FREQUENCY);
    LOG_PRINT("Dram Access Latency(%llu)", dram_access_latency.getCycles());
@@ -53,9 +64,10 @@ DramCntlr::getDataFromDram(IntPtr address, Byte* data_buf, bool modeled)
 void
 DramCntlr::putDataToDram(IntPtr address, Byte* data_buf, bool modeled)
 {
-   LOG_ASSERT_ERROR(_data_map[address] != NULL, "Data Buffer does not exist");
+   Byte* line = _data_store->findLine(address);
+   LOG_ASSERT_ERROR(line != NULL, "Data Buffer does not exist");
    
-   memcpy((void*) _data_map[address], (void*) data_buf, _cache_line_size);
+   memcpy((void*) line, (void*) data_buf, _cache_line_size);
 
    __attribute__((unused)) Latency dram_access_latency = modeled ? runDramPerfModel() : Latency(0,DRAM_FREQUENCY);
    
@@ -76,24 +88,118 @@ DramCntlr::runDramPerfModel()
 void
 DramCntlr::addToDramAccessCount(IntPtr address, AccessType access_type)
 {
-   _dram_access_count[access_type][address] = _dram_access_count[access_type][address] + 1;
+   _data_store->getCounter(address, access_type) ++;
 }
 
-void
-DramCntlr::printDramAccessCount()
+// Logs the heavily accessed lines and builds a histogram of the access
+// counts (bucket i holds the lines accessed [2^i, 2^(i+1)) times)
+class DramAccessCountPrinter
 {
-   for (UInt32 k = 0; k < NUM_ACCESS_TYPES; k++)
+public:
+   static const UInt32 NUM_BUCKETS = 33;
+
+   DramAccessCountPrinter(tile_id_t tile_id)
+      : _tile_id(tile_id)
    {
-      for (AccessCountMap::iterator i = _dram_access_count[k].begin(); i != _dram_access_count[k].end(); i++)
+      memset(_histogram, 0, sizeof(_histogram));
+   }
+
+   void operator()(IntPtr address, const UInt32* access_counts)
+   {
+      for (UInt32 k = 0; k < DramCntlr::NUM_ACCESS_TYPES; k++)
       {
-         if ((*i).second > 100)
+         UInt32 count = access_counts[k];
+         if (count > 100)
          {
             LOG_PRINT("Dram Cntlr(%i), Address(0x%x), Access Count(%llu), Access Type(%s)", 
-                  _tile->getId(), (*i).first, (*i).second,
-                  (k == READ)? "READ" : "WRITE");
+                  _tile_id, address, (UInt64) count,
+                  (k == DramCntlr::READ)? "READ" : "WRITE");
+         }
+         if (count > 0)
+            _histogram[k][floorLog2(count) + 1] ++;
+         else
+            _histogram[k][0] ++;
+      }
+   }
+
+   void print()
+   {
+      for (UInt32 k = 0; k < DramCntlr::NUM_ACCESS_TYPES; k++)
+      {
+         for (UInt32 i = 0; i < NUM_BUCKETS; i++)
+         {
+            if (_histogram[k][i] == 0)
+               continue;
+            UInt64 min_count = (i == 0) ? 0 : (1ULL << (i-1));
+            UInt64 max_count = (i == 0) ? 0 : ((1ULL << i) - 1);
+            LOG_PRINT("Dram Cntlr(%i), Access Type(%s), Access Count[%llu-%llu]: %llu lines",
+                  _tile_id, (k == DramCntlr::READ)? "READ" : "WRITE",
+                  min_count, max_count, _histogram[k][i]);
          }
       }
    }
+
+private:
+   tile_id_t _tile_id;
+   // Bucket 0 counts the lines that were never accessed this way
+   UInt64 _histogram[DramCntlr::NUM_ACCESS_TYPES][NUM_BUCKETS];
+};
+
+void
+DramCntlr::printDramAccessCount()
+{
+   DramAccessCountPrinter printer(_tile->getId());
+   _data_store->visitLines(printer);
+   printer.print();
+}
+
+// Puts the address and data of every line that has been touched
+class DramLineCheckpointer
+{
+public:
+   DramLineCheckpointer(SparseMemoryStore* data_store, UInt32 line_size, UnstructuredBuffer& buffer)
+      : _data_store(data_store)
+      , _line_size(line_size)
+      , _buffer(buffer)
+   {}
+
+   void operator()(IntPtr address, const UInt32* access_counts)
+   {
+      _buffer << address << std::make_pair(_data_store->findLine(address), _line_size);
+   }
+
+private:
+   SparseMemoryStore* _data_store;
+   UInt32 _line_size;
+   UnstructuredBuffer& _buffer;
+};
+
+void
+DramCntlr::checkpoint(UnstructuredBuffer& buffer)
+{
+   // The access counts are statistics, and start again from zero
+   DramLineCheckpointer checkpointer(_data_store, _cache_line_size, buffer);
+   _data_store->visitLines(checkpointer);
+   buffer << INVALID_ADDRESS;
+
+   _dram_perf_model->checkpoint(buffer);
+}
+
+void
+DramCntlr::restore(UnstructuredBuffer& buffer)
+{
+   // Checkpoints are only restored in lite mode, where the application's
+   // memory is native: the data here is never read back by it
+   while (true)
+   {
+      IntPtr address;
+      buffer >> address;
+      if (address == INVALID_ADDRESS)
+         break;
+      buffer >> std::make_pair(_data_store->getLine(address), _cache_line_size);
+   }
+
+   _dram_perf_model->restore(buffer);
 }
 
 ShmemPerfModel*
@@ -5,10 +5,13 @@ using std::map;
 
 #include "tile.h"
 #include "dram_perf_model.h"
+#include "sparse_memory_store.h"
 #include "shmem_perf_model.h"
 #include "fixed_types.h"
 #include "time_types.h"
 
+class UnstructuredBuffer;
+
 class DramCntlr
 {
 public:
@@ -31,15 +34,17 @@ public:
 
    void getDataFromDram(IntPtr address, Byte* data_buf, bool modeled);
    void putDataToDram(IntPtr address, Byte* data_buf, bool modeled);
+
+   // Data of the lines and the queue model, for the checkpoint of the tile
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
    
 private:
    Tile* _tile;
-   map<IntPtr, Byte*> _data_map;
+   // Functional data, along with a read and a write counter per line
+   SparseMemoryStore* _data_store;
    DramPerfModel* _dram_perf_model;
 
-   typedef std::map<IntPtr,UInt64> AccessCountMap;
-   AccessCountMap* _dram_access_count;
-
    ShmemPerfModel* getShmemPerfModel();
    Latency runDramPerfModel();
 
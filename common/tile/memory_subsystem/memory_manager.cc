@@ -1,3 +1,4 @@
+#include <sstream>
 #include "simulator.h"
 #include "config.h"
 #include "memory_manager.h"
@@ -6,6 +7,9 @@
 #include "pr_l1_sh_l2_msi/memory_manager.h"
 #include "pr_l1_sh_l2_mesi/memory_manager.h"
 #include "network_model.h"
+#include "memory_trace.h"
+#include "dram_cntlr.h"
+#include "checkpoint.h"
 #include "log.h"
 
 // Static Members
@@ -14,9 +18,22 @@ CachingProtocolType MemoryManager::_caching_protocol_type;
 MemoryManager::MemoryManager(Tile* tile)
    : _tile(tile)
    , _enabled(false)
+   , _app_thread_in_fast_path(false)
+   , _sim_thread_handling_msg(false)
+   , _memory_trace_writer(NULL)
 {
    _network = _tile->getNetwork();
    _shmem_perf_model = new ShmemPerfModel();
+
+   _l1_fast_path_enabled = Sim()->getCfg()->getBool("caching_protocol/l1_read_hit_fast_path", true);
+
+   // Memory trace for tools/cache_replay
+   if (Sim()->getCfg()->getBool("caching_protocol/memory_trace", false))
+   {
+      ostringstream filename;
+      filename << "memory_trace_" << _tile->getId() << ".trc";
+      _memory_trace_writer = new MemoryTraceWriter(Config::getSingleton()->formatOutputFileName(filename.str()), _tile->getId());
+   }
    
    // Register call-backs
    _network->registerCallback(SHARED_MEM, MemoryManagerNetworkCallback, this);
@@ -24,6 +41,7 @@ MemoryManager::MemoryManager(Tile* tile)
 
 MemoryManager::~MemoryManager()
 {
+   delete _memory_trace_writer;
    _network->unregisterCallback(SHARED_MEM);
 }
 
@@ -82,6 +100,25 @@ MemoryManager::__coreInitiateMemoryAccess(MemComponent::Type mem_component,
                                           Byte* data_buf, UInt32 data_length,
                                           Time& curr_time, bool modeled)
 {
+   if (_memory_trace_writer)
+      _memory_trace_writer->write(mem_component, mem_op_type, address + offset, data_length, curr_time, _enabled);
+
+   if (_l1_fast_path_enabled && (lock_signal == Core::NONE) && (mem_op_type == Core::READ))
+   {
+      // Dekker-style handshake with __handleMsgFromNetwork()
+      _app_thread_in_fast_path = true;
+      __sync_synchronize();
+
+      bool hit = (!_sim_thread_handling_msg) &&
+                 coreReadL1HitFastPath(mem_component, address, offset, data_buf, data_length, curr_time);
+
+      __sync_synchronize();
+      _app_thread_in_fast_path = false;
+
+      if (hit)
+         return true;
+   }
+
    if (lock_signal != Core::UNLOCK)
       _lock.acquire();
    
@@ -101,7 +138,7 @@ MemoryManager::__coreInitiateMemoryAccess(MemComponent::Type mem_component,
 void
 MemoryManager::__handleMsgFromNetwork(NetPacket& packet)
 {
-   _lock.acquire();
+   acquireLockForSimThread();
 
    _shmem_perf_model->setCurrTime(packet.time);
 
@@ -116,9 +153,119 @@ MemoryManager::__handleMsgFromNetwork(NetPacket& packet)
       break;
    }
 
+   releaseLockForSimThread();
+}
+
+void
+MemoryManager::acquireLockForSimThread()
+{
+   _lock.acquire();
+
+   // Wait for the app thread to leave the L1 fast path
+   _sim_thread_handling_msg = true;
+   __sync_synchronize();
+   while (_app_thread_in_fast_path)
+      __asm__ __volatile__("pause" ::: "memory");
+}
+
+void
+MemoryManager::releaseLockForSimThread()
+{
+   __sync_synchronize();
+   _sim_thread_handling_msg = false;
+
    _lock.release();
 }
 
+void
+MemoryManager::saveCheckpoint(CheckpointWriter& writer)
+{
+   vector<Cache*> caches;
+   DirectoryCache* directory_cache = NULL;
+   DramCntlr* dram_cntlr = NULL;
+   getCheckpointedState(caches, directory_cache, dram_cntlr);
+
+   acquireLockForSimThread();
+
+   for (UInt32 i = 0; i < caches.size(); i++)
+      caches[i]->checkpoint(writer.startSection(caches[i]->getName()));
+
+   UnstructuredBuffer& directory_buffer = writer.startSection("directory");
+   directory_buffer << (directory_cache != NULL);
+   if (directory_cache)
+      directory_cache->checkpoint(directory_buffer);
+
+   UnstructuredBuffer& dram_buffer = writer.startSection("dram");
+   dram_buffer << (dram_cntlr != NULL);
+   if (dram_cntlr)
+      dram_cntlr->checkpoint(dram_buffer);
+
+   releaseLockForSimThread();
+}
+
+void
+MemoryManager::restoreCheckpoint(CheckpointReader& reader)
+{
+   vector<Cache*> caches;
+   DirectoryCache* directory_cache = NULL;
+   DramCntlr* dram_cntlr = NULL;
+   getCheckpointedState(caches, directory_cache, dram_cntlr);
+
+   acquireLockForSimThread();
+
+   for (UInt32 i = 0; i < caches.size(); i++)
+      caches[i]->restore(reader.startSection(caches[i]->getName()));
+
+   UnstructuredBuffer& directory_buffer = reader.startSection("directory");
+   bool directory_cache_present;
+   directory_buffer >> directory_cache_present;
+   LOG_ASSERT_ERROR(directory_cache_present == (directory_cache != NULL),
+                    "Tile(%i): directory %s in checkpoint", getTile()->getId(), directory_cache_present ? "present" : "absent");
+   if (directory_cache)
+      directory_cache->restore(directory_buffer);
+
+   UnstructuredBuffer& dram_buffer = reader.startSection("dram");
+   bool dram_cntlr_present;
+   dram_buffer >> dram_cntlr_present;
+   LOG_ASSERT_ERROR(dram_cntlr_present == (dram_cntlr != NULL),
+                    "Tile(%i): DRAM controller %s in checkpoint", getTile()->getId(), dram_cntlr_present ? "present" : "absent");
+   if (dram_cntlr)
+      dram_cntlr->restore(dram_buffer);
+
+   releaseLockForSimThread();
+}
+
+void
+MemoryManager::getCheckpointedState(vector<Cache*>& caches, DirectoryCache*& directory_cache, DramCntlr*& dram_cntlr)
+{
+   LOG_PRINT_ERROR("Checkpoints are not supported with caching protocol(%s)",
+                   Sim()->getCfg()->getString("caching_protocol/type").c_str());
+}
+
+// Called by the app thread, in the L1 fast path
+bool
+MemoryManager::coreReadL1HitFastPath(MemComponent::Type mem_component,
+                                     IntPtr address, UInt32 offset, Byte* data_buf, UInt32 data_length,
+                                     Time& curr_time)
+{
+   if ((mem_component != MemComponent::L1_ICACHE) && (mem_component != MemComponent::L1_DCACHE))
+      return false;
+
+   Cache* l1_cache = getL1Cache(mem_component);
+   if (!l1_cache->readCacheLineIfReadable(address + offset, data_buf, data_length, isTagWrittenOnL1ReadHit()))
+      return false;
+
+   // Same time as a hit in L1CacheCntlr::processMemOpFromCore(), without
+   // going through the shmem perf model, which the sim thread also uses
+   Time sync_delay = l1_cache->getSynchronizationDelay(CORE);
+   if (_enabled)
+   {
+      curr_time += sync_delay;
+      curr_time += l1_cache->getPerfModel()->getLatency(CachePerfModel::ACCESS_DATA_AND_TAGS);
+   }
+   return true;
+}
+
 void
 MemoryManager::enableModels()
 {
@@ -138,6 +285,11 @@ MemoryManager::outputSummary(ostream& out, const Time& target_completion_time)
 {
 }
 
+void
+MemoryManager::registerStatistics(StatisticsRegistry* registry)
+{
+}
+
 void
 MemoryManager::waitForAppThread()
 {
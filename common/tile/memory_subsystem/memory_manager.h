@@ -12,6 +12,11 @@ using namespace std;
 #include "shmem_perf_model.h"
 #include "dvfs.h"
 
+class MemoryTraceWriter;
+class DramCntlr;
+class CheckpointWriter;
+class CheckpointReader;
+
 void MemoryManagerNetworkCallback(void* obj, NetPacket packet);
 
 class MemoryManager
@@ -28,6 +33,7 @@ public:
    void __handleMsgFromNetwork(NetPacket& packet);
 
    virtual void outputSummary(std::ostream& os, const Time& target_completion_time);
+   virtual void registerStatistics(StatisticsRegistry* registry);
 
    Tile* getTile()                        { return _tile; }
    ShmemPerfModel* getShmemPerfModel()    { return _shmem_perf_model; }
@@ -36,6 +42,11 @@ public:
    virtual void enableModels();
    virtual void disableModels();
    bool isEnabled()                       { return _enabled;  }
+
+   // Checkpoint of the caches, directory and DRAM controller of the tile.
+   // No memory request may be in flight.
+   void saveCheckpoint(CheckpointWriter& writer);
+   void restoreCheckpoint(CheckpointReader& reader);
   
    // APP + SIM thread synchronization 
    void waitForAppThread();
@@ -86,6 +97,33 @@ private:
    // Enabled
    bool _enabled;
 
+   // L1 read hit fast path: READ hits in the L1 are served by the app thread
+   // without '_lock'. The app thread only takes it while the sim thread is
+   // not handling a message, and the sim thread waits for it to finish
+   // before changing the caches.
+   bool _l1_fast_path_enabled;
+   volatile bool _app_thread_in_fast_path;
+   volatile bool _sim_thread_handling_msg;
+
+   // Memory accesses of the cores ([caching_protocol] memory_trace)
+   MemoryTraceWriter* _memory_trace_writer;
+
+   // Takes '_lock' for the sim thread, once the app thread has left the
+   // L1 fast path, so that the caches can be changed
+   void acquireLockForSimThread();
+   void releaseLockForSimThread();
+
+   // Components in the checkpoint (the directory cache and DRAM
+   // controller are NULL on tiles without a memory controller)
+   virtual void getCheckpointedState(vector<Cache*>& caches, DirectoryCache*& directory_cache, DramCntlr*& dram_cntlr);
+
+   bool coreReadL1HitFastPath(MemComponent::Type mem_component,
+                              IntPtr address, UInt32 offset, Byte* data_buf, UInt32 data_length,
+                              Time& curr_time);
+   virtual Cache* getL1Cache(MemComponent::Type mem_component) = 0;
+   // Does the protocol also write the tags of the line on a read hit?
+   virtual bool isTagWrittenOnL1ReadHit() { return false; }
+
    virtual bool coreInitiateMemoryAccess(MemComponent::Type mem_component,
                                          Core::lock_signal_t lock_signal, Core::mem_op_t mem_op_type,
                                          IntPtr address, UInt32 offset, Byte* data_buf, UInt32 data_length,
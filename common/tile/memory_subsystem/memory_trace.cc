@@ -0,0 +1,137 @@
+#include "memory_trace.h"
+#include "varint.h"
+#include "log.h"
+
+using namespace std;
+
+MemoryTraceWriter::MemoryTraceWriter(const string& filename, tile_id_t tile_id)
+   : _last_time(0)
+   , _last_address(0)
+{
+   _file = fopen(filename.c_str(), "wb");
+   LOG_ASSERT_ERROR(_file, "Could not open memory trace file(%s)", filename.c_str());
+
+   MemoryTrace::Header header = { MemoryTrace::MAGIC, MemoryTrace::VERSION, tile_id, 0 };
+   fwrite(&header, sizeof(header), 1, _file);
+
+   _buffer.reserve(BUFFER_SIZE);
+}
+
+MemoryTraceWriter::~MemoryTraceWriter()
+{
+   flush();
+   fclose(_file);
+}
+
+void
+MemoryTraceWriter::write(MemComponent::Type mem_component, Core::mem_op_t mem_op, IntPtr address, UInt32 size,
+                         const Time& time, bool enabled)
+{
+   ScopedLock sl(_lock);
+
+   Byte first = (Byte) mem_op & MemoryTrace::OP_MASK;
+   if (mem_component == MemComponent::L1_ICACHE)
+      first |= MemoryTrace::ICACHE;
+   if (enabled)
+      first |= MemoryTrace::ENABLED;
+   bool inline_size = (size > 0) && (size < (1 << (8 - MemoryTrace::SIZE_SHIFT)));
+   if (inline_size)
+      first |= size << MemoryTrace::SIZE_SHIFT;
+   _buffer.push_back(first);
+
+   if (!inline_size)
+      encode(size);
+   encodeSigned((SInt64) (time.toPicosec() - _last_time));
+   encodeSigned((SInt64) (address - _last_address));
+   _last_time = time.toPicosec();
+   _last_address = address;
+
+   if (_buffer.size() >= BUFFER_SIZE)
+      flush();
+}
+
+void
+MemoryTraceWriter::flush()
+{
+   if (_buffer.empty())
+      return;
+   fwrite(&_buffer[0], 1, _buffer.size(), _file);
+   _buffer.clear();
+}
+
+void
+MemoryTraceWriter::encode(UInt64 value)
+{
+   encodeVarint(_buffer, value);
+}
+
+void
+MemoryTraceWriter::encodeSigned(SInt64 value)
+{
+   encodeSignedVarint(_buffer, value);
+}
+
+MemoryTraceReader::MemoryTraceReader(const string& filename)
+   : _filename(filename)
+   , _curr(NULL)
+   , _end(NULL)
+   , _tile_id(INVALID_TILE_ID)
+   , _last_time(0)
+   , _last_address(0)
+{
+   if (!_file.open(filename, sizeof(MemoryTrace::Header)))
+   {
+      LOG_PRINT("No memory trace file(%s)", filename.c_str());
+      return;
+   }
+
+   const MemoryTrace::Header* header = (const MemoryTrace::Header*) _file.getData();
+   LOG_ASSERT_ERROR(header->magic == MemoryTrace::MAGIC && header->version == MemoryTrace::VERSION,
+                    "%s is not a memory trace file (version %u)", filename.c_str(), MemoryTrace::VERSION);
+   _tile_id = header->tile_id;
+
+   _curr = _file.getData() + sizeof(MemoryTrace::Header);
+   _end = _file.getData() + _file.getLength();
+}
+
+MemoryTraceReader::~MemoryTraceReader()
+{}
+
+bool
+MemoryTraceReader::next(MemoryTrace::Record& record)
+{
+   if (_curr == _end)
+      return false;
+
+   Byte first = *_curr++;
+   record.mem_op = (Core::mem_op_t) (first & MemoryTrace::OP_MASK);
+   record.mem_component = (first & MemoryTrace::ICACHE) ? MemComponent::L1_ICACHE : MemComponent::L1_DCACHE;
+   record.enabled = (first & MemoryTrace::ENABLED);
+   record.size = first >> MemoryTrace::SIZE_SHIFT;
+   if (record.size == 0)
+      record.size = decode();
+
+   _last_time += decodeSigned();
+   _last_address += decodeSigned();
+   record.time = _last_time;
+   record.address = _last_address;
+   return true;
+}
+
+UInt64
+MemoryTraceReader::decode()
+{
+   UInt64 value;
+   __attribute__((unused)) bool ok = decodeVarint(_curr, _end, value);
+   LOG_ASSERT_ERROR(ok, "Corrupt memory trace file(%s): truncated record", _filename.c_str());
+   return value;
+}
+
+SInt64
+MemoryTraceReader::decodeSigned()
+{
+   SInt64 value;
+   __attribute__((unused)) bool ok = decodeSignedVarint(_curr, _end, value);
+   LOG_ASSERT_ERROR(ok, "Corrupt memory trace file(%s): truncated record", _filename.c_str());
+   return value;
+}
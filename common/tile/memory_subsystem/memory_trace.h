@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "mem_component.h"
+#include "core.h"
+#include "fixed_types.h"
+#include "lock.h"
+#include "mapped_file.h"
+
+// Memory accesses of the cores of a tile, as they enter the memory manager
+// ([caching_protocol] memory_trace = true), one file per tile
+// (memory_trace_<tile>.trc). tools/cache_replay replays them through many
+// cache configurations at once.
+//
+// The file is a Header followed by variable-length records. A record starts
+// with a byte holding the memory operation (bits 0-1), whether it is an
+// instruction fetch (bit 2), whether the models were enabled (bit 3) and the
+// size when it is from 1 to 15 bytes (bits 4-7). Then come the size (if not
+// in the first byte), and the time and the address as differences with the
+// previous record, all as LEB128 (signed ones zigzag encoded).
+class MemoryTrace
+{
+public:
+   static const UInt32 MAGIC = 0x4d525447;   // "GTRM"
+   static const UInt32 VERSION = 1;
+
+   struct Header
+   {
+      UInt32 magic;
+      UInt32 version;
+      tile_id_t tile_id;
+      UInt32 reserved;
+   };
+
+   struct Record
+   {
+      UInt64 time;               // In picoseconds
+      IntPtr address;
+      UInt32 size;
+      MemComponent::Type mem_component;
+      Core::mem_op_t mem_op;
+      bool enabled;              // Were the models enabled?
+   };
+
+   static const Byte OP_MASK = 0x3;
+   static const Byte ICACHE = 0x4;
+   static const Byte ENABLED = 0x8;
+   static const UInt32 SIZE_SHIFT = 4;
+};
+
+class MemoryTraceWriter
+{
+public:
+   MemoryTraceWriter(const std::string& filename, tile_id_t tile_id);
+   ~MemoryTraceWriter();
+
+   void write(MemComponent::Type mem_component, Core::mem_op_t mem_op, IntPtr address, UInt32 size,
+              const Time& time, bool enabled);
+
+private:
+   static const UInt32 BUFFER_SIZE = 1 << 16;
+
+   FILE* _file;
+   std::vector<Byte> _buffer;
+   UInt64 _last_time;
+   IntPtr _last_address;
+   Lock _lock;
+
+   void flush();
+   void encode(UInt64 value);
+   void encodeSigned(SInt64 value);
+};
+
+// The file is mapped into memory and decoded one record at a time
+class MemoryTraceReader
+{
+public:
+   // A missing file reads as an empty trace
+   MemoryTraceReader(const std::string& filename);
+   ~MemoryTraceReader();
+
+   tile_id_t getTileId() const { return _tile_id; }
+
+   // Returns false at the end of the trace
+   bool next(MemoryTrace::Record& record);
+
+private:
+   std::string _filename;
+   MappedFile _file;
+   const Byte* _curr;
+   const Byte* _end;
+
+   tile_id_t _tile_id;
+   UInt64 _last_time;
+   IntPtr _last_address;
+
+   UInt64 decode();
+   SInt64 decodeSigned();
+};
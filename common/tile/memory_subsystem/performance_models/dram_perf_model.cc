@@ -7,6 +7,10 @@ using namespace std;
 #include "queue_model_history_list.h"
 #include "queue_model_history_tree.h"
 #include "constants.h"
+#include "dvfs_manager.h"
+#include "statistics_registry.h"
+#include "packetize.h"
+#include "log.h"
 
 // Note: Each Dram Controller owns a single DramModel object
 // Hence, m_dram_bandwidth is the bandwidth for a single DRAM controller
@@ -27,6 +31,7 @@ DramPerfModel::DramPerfModel(float dram_access_cost,
    m_dram_access_cost(UInt64(dram_access_cost)),
    m_dram_bandwidth(dram_bandwidth),
    m_cache_block_size(cache_block_size),
+   m_clock_domain(DVFSManager::getClockDomain(DRAM_FREQUENCY)),
    m_queue_model_type(queue_model_type),
    m_queue_model_enabled(queue_model_enabled),
    m_enabled(false)
@@ -86,7 +91,7 @@ DramPerfModel::getAccessLatency(Time pkt_time, UInt64 pkt_size)
    if (!m_enabled) 
    {
       LOG_PRINT("Not enabled. Return 0");
-      return Latency(0,DRAM_FREQUENCY);
+      return Latency(0,m_clock_domain);
    }
 
    UInt64 processing_time = (UInt64) ((float) pkt_size/m_dram_bandwidth) + 1;
@@ -112,7 +117,7 @@ DramPerfModel::getAccessLatency(Time pkt_time, UInt64 pkt_size)
    m_total_access_latency += (double) access_latency;
    m_total_queueing_delay += (double) queue_delay;
 
-   return Latency(access_latency,DRAM_FREQUENCY);
+   return Latency(access_latency,m_clock_domain);
 }
 
 void
@@ -164,6 +169,34 @@ DramPerfModel::outputSummary(ostream& out)
    }
 }
 
+void
+DramPerfModel::registerStatistics(StatisticsRegistry* registry)
+{
+   // Latencies are in DRAM clock cycles
+   registry->registerCounter("dram", "accesses", &m_num_accesses);
+   registry->registerCounter("dram", "total_access_latency", &m_total_access_latency);
+   registry->registerCounter("dram", "total_queueing_delay", &m_total_queueing_delay);
+}
+
+void
+DramPerfModel::checkpoint(UnstructuredBuffer& buffer)
+{
+   buffer << m_queue_model_enabled;
+   if (m_queue_model_enabled)
+      m_queue_model->checkpoint(buffer);
+}
+
+void
+DramPerfModel::restore(UnstructuredBuffer& buffer)
+{
+   bool queue_model_enabled;
+   buffer >> queue_model_enabled;
+   LOG_ASSERT_ERROR(queue_model_enabled == m_queue_model_enabled, "DRAM queue model %s in checkpoint",
+                    queue_model_enabled ? "enabled" : "disabled");
+   if (m_queue_model_enabled)
+      m_queue_model->restore(buffer);
+}
+
 void
 DramPerfModel::dummyOutputSummary(ostream& out)
 {
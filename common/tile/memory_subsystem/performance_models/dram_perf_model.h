@@ -5,6 +5,9 @@
 #include "moving_average.h"
 #include "time_types.h"
 
+class StatisticsRegistry;
+class UnstructuredBuffer;
+
 // Note: Each Dram Controller owns a single DramModel object
 // Hence, m_dram_bandwidth is the bandwidth for a single DRAM controller
 // Total Bandwidth = m_dram_bandwidth * Number of DRAM controllers
@@ -24,6 +27,7 @@ class DramPerfModel
       float m_dram_bandwidth;
 
       UInt32 m_cache_block_size;
+      const ClockDomain* m_clock_domain;
 
 
       // Queue Model
@@ -57,6 +61,11 @@ class DramPerfModel
 
       UInt64 getTotalAccesses() { return m_num_accesses; }
       void outputSummary(ostream& out);
+      void registerStatistics(StatisticsRegistry* registry);
+
+      // Queue model, for the checkpoint of the DRAM controller
+      void checkpoint(UnstructuredBuffer& buffer);
+      void restore(UnstructuredBuffer& buffer);
 
       static void dummyOutputSummary(ostream& out);
 };
@@ -1,5 +1,6 @@
 #include "cache_line_info.h"
 #include "cache_utils.h"
+#include "packetize.h"
 #include "log.h"
 
 namespace PrL1PrL2DramDirectoryMOSI
@@ -74,4 +75,20 @@ PrL2CacheLineInfo::assign(CacheLineInfo* cache_line_info)
    _cached_loc = L2_cache_line_info->getCachedLoc();
 }
 
+void
+PrL2CacheLineInfo::checkpoint(UnstructuredBuffer& buffer)
+{
+   CacheLineInfo::checkpoint(buffer);
+   buffer << (SInt32) _cached_loc;
+}
+
+void
+PrL2CacheLineInfo::restore(UnstructuredBuffer& buffer)
+{
+   CacheLineInfo::restore(buffer);
+   SInt32 cached_loc;
+   buffer >> cached_loc;
+   _cached_loc = (MemComponent::Type) cached_loc;
+}
+
 }
@@ -28,6 +28,9 @@ public:
    void invalidate();
    void assign(CacheLineInfo* cache_line_info);
 
+   void checkpoint(UnstructuredBuffer& buffer);
+   void restore(UnstructuredBuffer& buffer);
+
 private:
    MemComponent::Type _cached_loc;
 };
@@ -52,6 +52,7 @@ namespace PrL1PrL2DramDirectoryMOSI
       { return ((ShmemMsg*) pkt_data)->getRequester(); }
 
       void outputSummary(std::ostream &os, const Time& target_completion_time);
+      void registerStatistics(StatisticsRegistry* registry);
 
       // Energy monitoring
       void computeEnergy(const Time& curr_time);
@@ -92,6 +93,11 @@ namespace PrL1PrL2DramDirectoryMOSI
 
       void handleMsgFromNetwork(NetPacket& packet);
 
+      Cache* getL1Cache(MemComponent::Type mem_component)
+      { return (mem_component == MemComponent::L1_ICACHE) ? getL1ICache() : getL1DCache(); }
+
+      void getCheckpointedState(vector<Cache*>& caches, DirectoryCache*& directory_cache, DramCntlr*& dram_cntlr);
+
       // Check dram directory type
       static void checkDramDirectoryType();
    };
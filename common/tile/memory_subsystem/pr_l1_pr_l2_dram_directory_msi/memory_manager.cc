@@ -435,6 +435,34 @@ MemoryManager::outputSummary(std::ostream &os, const Time& target_completion_tim
    }
 }
 
+void
+MemoryManager::registerStatistics(StatisticsRegistry* registry)
+{
+   _L1_cache_cntlr->getL1ICache()->registerStatistics(registry);
+   _L1_cache_cntlr->getL1DCache()->registerStatistics(registry);
+   _L2_cache_cntlr->getL2Cache()->registerStatistics(registry);
+
+   if (_dram_cntlr_present)
+   {
+      _dram_directory_cntlr->getDramDirectoryCache()->registerStatistics(registry);
+      _dram_cntlr->getDramPerfModel()->registerStatistics(registry);
+   }
+}
+
+void
+MemoryManager::getCheckpointedState(vector<Cache*>& caches, DirectoryCache*& directory_cache, DramCntlr*& dram_cntlr)
+{
+   caches.push_back(_L1_cache_cntlr->getL1ICache());
+   caches.push_back(_L1_cache_cntlr->getL1DCache());
+   caches.push_back(_L2_cache_cntlr->getL2Cache());
+
+   if (_dram_cntlr_present)
+   {
+      directory_cache = _dram_directory_cntlr->getDramDirectoryCache();
+      dram_cntlr = _dram_cntlr;
+   }
+}
+
 void
 MemoryManager::computeEnergy(const Time& curr_time)
 {
@@ -48,6 +48,7 @@ namespace PrL1PrL2DramDirectoryMSI
       { return ((ShmemMsg*) pkt_data)->isModeled(); }
 
       void outputSummary(std::ostream &os, const Time& target_completion_time);
+      void registerStatistics(StatisticsRegistry* registry);
 
       // Energy monitoring
       void computeEnergy(const Time& curr_time);
@@ -78,5 +79,10 @@ namespace PrL1PrL2DramDirectoryMSI
                                     bool modeled);
 
       void handleMsgFromNetwork(NetPacket& packet);
+
+      Cache* getL1Cache(MemComponent::Type mem_component)
+      { return (mem_component == MemComponent::L1_ICACHE) ? getL1ICache() : getL1DCache(); }
+
+      void getCheckpointedState(vector<Cache*>& caches, DirectoryCache*& directory_cache, DramCntlr*& dram_cntlr);
    };
 }
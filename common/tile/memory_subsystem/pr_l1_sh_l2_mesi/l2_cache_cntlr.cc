@@ -311,7 +311,7 @@ L2CacheCntlr::processNextReqFromL1Cache(IntPtr address)
    LOG_PRINT("Start processNextReqFromL1Cache(%#lx)", address);
    
    // Add 1 cycle to denote that we are moving to the next request
-   getShmemPerfModel()->incrCurrTime(Latency(1,_L2_cache->getFrequency()));
+   getShmemPerfModel()->incrCurrTime(Latency(1,_L2_cache->getClockDomain()));
 
    assert(_L2_cache_req_queue.count(address) >= 1);
    
@@ -877,7 +877,7 @@ void
 L2CacheCntlr::restartShmemReq(ShmemReq* shmem_req, ShL2CacheLineInfo* L2_cache_line_info, Byte* data_buf)
 {
    // Add 1 cycle to denote that we are restarting the request
-   getShmemPerfModel()->incrCurrTime(Latency(1, _L2_cache->getFrequency()));
+   getShmemPerfModel()->incrCurrTime(Latency(1, _L2_cache->getClockDomain()));
 
    // Update ShmemReq & ShmemPerfModel internal time
    shmem_req->updateTime(getShmemPerfModel()->getCurrTime());
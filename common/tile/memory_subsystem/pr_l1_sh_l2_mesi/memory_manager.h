@@ -48,6 +48,7 @@ namespace PrL1ShL2MESI
       { return ((ShmemMsg*) pkt_data)->getRequester(); }
 
       void outputSummary(std::ostream &os, const Time& target_completion_time);
+      void registerStatistics(StatisticsRegistry* registry);
 
       // Energy monitoring
       void computeEnergy(const Time& curr_time);
@@ -79,5 +80,10 @@ namespace PrL1ShL2MESI
                                     bool modeled);
 
       void handleMsgFromNetwork(NetPacket& packet);
+
+      Cache* getL1Cache(MemComponent::Type mem_component)
+      { return (mem_component == MemComponent::L1_ICACHE) ? getL1ICache() : getL1DCache(); }
+      // operationPermissibleinL1Cache() writes the line info back on a hit
+      bool isTagWrittenOnL1ReadHit() { return true; }
    };
 }
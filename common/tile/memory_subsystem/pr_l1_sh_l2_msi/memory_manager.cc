@@ -428,6 +428,19 @@ MemoryManager::outputSummary(std::ostream &os, const Time& target_completion_tim
    }
 }
 
+void
+MemoryManager::registerStatistics(StatisticsRegistry* registry)
+{
+   _L1_cache_cntlr->getL1ICache()->registerStatistics(registry);
+   _L1_cache_cntlr->getL1DCache()->registerStatistics(registry);
+   _L2_cache_cntlr->getL2Cache()->registerStatistics(registry);
+
+   if (_dram_cntlr_present)
+   {
+      _dram_cntlr->getDramPerfModel()->registerStatistics(registry);
+   }
+}
+
 void
 MemoryManager::computeEnergy(const Time& curr_time)
 {
@@ -48,6 +48,7 @@ namespace PrL1ShL2MSI
       { return ((ShmemMsg*) pkt_data)->getRequester(); }
 
       void outputSummary(std::ostream &os, const Time& target_completion_time);
+      void registerStatistics(StatisticsRegistry* registry);
 
       // Energy monitoring
       void computeEnergy(const Time& curr_time);
@@ -79,5 +80,8 @@ namespace PrL1ShL2MSI
                                     bool modeled);
 
       void handleMsgFromNetwork(NetPacket& packet);
+
+      Cache* getL1Cache(MemComponent::Type mem_component)
+      { return (mem_component == MemComponent::L1_ICACHE) ? getL1ICache() : getL1DCache(); }
    };
 }
@@ -0,0 +1,152 @@
+#include <cstring>
+#include <sys/mman.h>
+
+#include "sparse_memory_store.h"
+#include "utils.h"
+#include "log.h"
+
+SparseMemoryStore::SparseMemoryStore(UInt32 chunk_size, UInt32 line_size, UInt32 num_counters_per_line, bool use_mmap)
+   : _chunk_size(chunk_size)
+   , _line_size(line_size)
+   , _num_counters_per_line(num_counters_per_line)
+   , _use_mmap(use_mmap)
+   , _num_chunks(0)
+{
+   LOG_ASSERT_ERROR(isPower2(_chunk_size) && isPower2(_line_size) && (_line_size <= _chunk_size),
+                    "Chunk size(%u) and line size(%u) must be powers of two, with line size <= chunk size",
+                    _chunk_size, _line_size);
+
+   _log_chunk_size = floorLog2(_chunk_size);
+   _log_line_size = floorLog2(_line_size);
+   _lines_per_chunk = _chunk_size / _line_size;
+
+   UInt32 index_bits = ADDRESS_BITS - _log_chunk_size;
+   _num_levels = (index_bits + RADIX_BITS - 1) / RADIX_BITS;
+
+   _root = new RadixNode();
+}
+
+SparseMemoryStore::~SparseMemoryStore()
+{
+   freeNode(_root, 0);
+}
+
+Byte*
+SparseMemoryStore::getLine(IntPtr address)
+{
+   Chunk* chunk = lookupChunk(address, true);
+   UInt32 line_num = getLineNum(address);
+   chunk->_present_bits[line_num >> 6] |= (1ULL << (line_num & 63));
+   return &chunk->_data[((UInt64) line_num) << _log_line_size];
+}
+
+Byte*
+SparseMemoryStore::findLine(IntPtr address) const
+{
+   Chunk* chunk = lookupChunk(address, false);
+   if (chunk == NULL)
+      return NULL;
+
+   UInt32 line_num = getLineNum(address);
+   if (!isPresent(chunk, line_num))
+      return NULL;
+   return &chunk->_data[((UInt64) line_num) << _log_line_size];
+}
+
+UInt32&
+SparseMemoryStore::getCounter(IntPtr address, UInt32 counter_num)
+{
+   assert(counter_num < _num_counters_per_line);
+
+   Chunk* chunk = lookupChunk(address, false);
+   LOG_ASSERT_ERROR(chunk, "Address(%#lx) has never been touched", address);
+
+   UInt32 line_num = getLineNum(address);
+   return chunk->_counters[line_num * _num_counters_per_line + counter_num];
+}
+
+SparseMemoryStore::Chunk*
+SparseMemoryStore::lookupChunk(IntPtr address, bool allocate) const
+{
+   LOG_ASSERT_ERROR((address >> ADDRESS_BITS) == 0, "Address(%#lx) out of range", address);
+
+   IntPtr chunk_num = address >> _log_chunk_size;
+   void** slot = NULL;
+   void* node = _root;
+
+   for (UInt32 level = 0; level < _num_levels; level++)
+   {
+      UInt32 shift = (_num_levels - 1 - level) * RADIX_BITS;
+      slot = &((RadixNode*) node)->_children[(chunk_num >> shift) & (RADIX_FAN_OUT - 1)];
+
+      if (*slot == NULL)
+      {
+         if (!allocate)
+            return NULL;
+
+         if (level == _num_levels - 1)
+            *slot = const_cast<SparseMemoryStore*>(this)->allocateChunk();
+         else
+            *slot = new RadixNode();
+      }
+      node = *slot;
+   }
+
+   return (Chunk*) node;
+}
+
+SparseMemoryStore::Chunk*
+SparseMemoryStore::allocateChunk()
+{
+   Chunk* chunk = new Chunk;
+
+   if (_use_mmap)
+   {
+      // Anonymous mappings come zero-filled and are only backed once touched
+      void* data = mmap(NULL, _chunk_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      LOG_ASSERT_ERROR(data != MAP_FAILED, "Could not map a memory chunk of %u bytes", _chunk_size);
+      chunk->_data = (Byte*) data;
+   }
+   else
+   {
+      chunk->_data = new Byte[_chunk_size];
+      memset(chunk->_data, 0x00, _chunk_size);
+   }
+
+   chunk->_counters = new UInt32[_lines_per_chunk * _num_counters_per_line]();
+   chunk->_present_bits = new UInt64[(_lines_per_chunk + 63) / 64]();
+
+   _num_chunks ++;
+   return chunk;
+}
+
+void
+SparseMemoryStore::freeChunk(Chunk* chunk)
+{
+   if (_use_mmap)
+      munmap(chunk->_data, _chunk_size);
+   else
+      delete [] chunk->_data;
+
+   delete [] chunk->_counters;
+   delete [] chunk->_present_bits;
+   delete chunk;
+}
+
+void
+SparseMemoryStore::freeNode(void* node, UInt32 level)
+{
+   if (node == NULL)
+      return;
+
+   if (level == _num_levels)
+   {
+      freeChunk((Chunk*) node);
+      return;
+   }
+
+   RadixNode* radix_node = (RadixNode*) node;
+   for (UInt32 i = 0; i < RADIX_FAN_OUT; i++)
+      freeNode(radix_node->_children[i], level + 1);
+   delete radix_node;
+}
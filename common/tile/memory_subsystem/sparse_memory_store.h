@@ -0,0 +1,111 @@
+#pragma once
+
+#include "fixed_types.h"
+
+// Functional backing store for simulated memory. Memory is allocated in
+// chunks (e.g., 4 KB or 2 MB) that are found through a page-table-like
+// radix tree, so the store only costs a little more than the footprint
+// the application actually touches. Chunks are zero-filled and may be
+// mmap'ed so that untouched parts of large chunks stay unbacked.
+//
+// Each line also carries a few 32-bit counters (e.g., access counts)
+// that live in a flat array next to the chunk data.
+
+class SparseMemoryStore
+{
+public:
+   SparseMemoryStore(UInt32 chunk_size, UInt32 line_size, UInt32 num_counters_per_line, bool use_mmap);
+   ~SparseMemoryStore();
+
+   // Returns the line holding 'address', allocating (and zero-filling)
+   // it if it has never been touched
+   Byte* getLine(IntPtr address);
+   // Returns NULL if the line holding 'address' has never been touched
+   Byte* findLine(IntPtr address) const;
+
+   // Counter 'counter_num' of the line holding 'address', which must
+   // exist
+   UInt32& getCounter(IntPtr address, UInt32 counter_num);
+
+   // Calls visitor(address, counters) for every line that has been
+   // touched, in address order
+   template <class Visitor> void visitLines(Visitor& visitor) const;
+
+   UInt64 getNumChunks() const { return _num_chunks; }
+
+private:
+   struct Chunk
+   {
+      Byte* _data;
+      UInt32* _counters;
+      // One bit per line that has been handed out by getLine()
+      UInt64* _present_bits;
+   };
+
+   // Simulated addresses are user-space virtual addresses
+   static const UInt32 ADDRESS_BITS = 48;
+   // Same fan-out as the x86-64 page tables
+   static const UInt32 RADIX_BITS = 9;
+   static const UInt32 RADIX_FAN_OUT = 1 << RADIX_BITS;
+
+   struct RadixNode
+   {
+      void* _children[RADIX_FAN_OUT];
+   };
+
+   UInt32 _chunk_size;
+   UInt32 _log_chunk_size;
+   UInt32 _line_size;
+   UInt32 _log_line_size;
+   UInt32 _lines_per_chunk;
+   UInt32 _num_counters_per_line;
+   bool _use_mmap;
+
+   UInt32 _num_levels;
+   RadixNode* _root;
+   UInt64 _num_chunks;
+
+   Chunk* lookupChunk(IntPtr address, bool allocate) const;
+   Chunk* allocateChunk();
+   void freeChunk(Chunk* chunk);
+   void freeNode(void* node, UInt32 level);
+   template <class Visitor> void visitNode(Visitor& visitor, const void* node, UInt32 level, IntPtr chunk_num) const;
+
+   UInt32 getLineNum(IntPtr address) const
+   { return (address & (_chunk_size - 1)) >> _log_line_size; }
+   static bool isPresent(const Chunk* chunk, UInt32 line_num)
+   { return (chunk->_present_bits[line_num >> 6] >> (line_num & 63)) & 1; }
+};
+
+template <class Visitor>
+void
+SparseMemoryStore::visitLines(Visitor& visitor) const
+{
+   visitNode(visitor, _root, 0, 0);
+}
+
+template <class Visitor>
+void
+SparseMemoryStore::visitNode(Visitor& visitor, const void* node, UInt32 level, IntPtr chunk_num) const
+{
+   if (node == NULL)
+      return;
+
+   if (level == _num_levels)
+   {
+      const Chunk* chunk = (const Chunk*) node;
+      for (UInt32 line_num = 0; line_num < _lines_per_chunk; line_num++)
+      {
+         if (isPresent(chunk, line_num))
+         {
+            IntPtr address = (chunk_num << _log_chunk_size) + (((IntPtr) line_num) << _log_line_size);
+            visitor(address, &chunk->_counters[line_num * _num_counters_per_line]);
+         }
+      }
+      return;
+   }
+
+   const RadixNode* radix_node = (const RadixNode*) node;
+   for (UInt32 i = 0; i < RADIX_FAN_OUT; i++)
+      visitNode(visitor, radix_node->_children[i], level + 1, (chunk_num << RADIX_BITS) | i);
+}
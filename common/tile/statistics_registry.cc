@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sstream>
+#include <map>
+
+#include "statistics_registry.h"
+#include "log.h"
+
+using namespace std;
+
+static const char* counter_type_names[StatisticsRegistry::NUM_COUNTER_TYPES] = { "uint64", "double", "time_ps" };
+
+StatisticsRegistry::StatisticsRegistry(tile_id_t tile_id)
+   : _tile_id(tile_id)
+{}
+
+StatisticsRegistry::~StatisticsRegistry()
+{}
+
+void
+StatisticsRegistry::registerCounter(const string& component, const string& name, const UInt64* counter)
+{
+   addCounter(component, name, UINT64, counter);
+}
+
+void
+StatisticsRegistry::registerCounter(const string& component, const string& name, const double* counter)
+{
+   addCounter(component, name, DOUBLE, counter);
+}
+
+void
+StatisticsRegistry::registerCounter(const string& component, const string& name, const Time* counter)
+{
+   addCounter(component, name, TIME, counter);
+}
+
+void
+StatisticsRegistry::addCounter(const string& component, const string& name, CounterType type, const void* counter)
+{
+   LOG_ASSERT_ERROR(component.find_first_of("\t\n\"\\") == string::npos && name.find_first_of("\t\n\"\\") == string::npos,
+                    "Invalid statistics counter name (%s, %s)", component.c_str(), name.c_str());
+
+   Counter c;
+   c.component = component;
+   c.name = name;
+   c.type = type;
+   c.counter = counter;
+   _counters.push_back(c);
+}
+
+UInt64
+StatisticsRegistry::read(UInt32 index) const
+{
+   const Counter& c = _counters[index];
+   switch (c.type)
+   {
+   case UINT64:
+      return *((const UInt64*) c.counter);
+
+   case DOUBLE:
+      {
+         UInt64 bits;
+         memcpy(&bits, c.counter, sizeof(bits));
+         return bits;
+      }
+
+   case TIME:
+      return ((const Time*) c.counter)->toPicosec();
+
+   default:
+      LOG_PRINT_ERROR("Unrecognized counter type(%u)", c.type);
+      return 0;
+   }
+}
+
+void
+StatisticsRegistry::serialize(ostream& os) const
+{
+   for (vector<Counter>::const_iterator it = _counters.begin(); it != _counters.end(); it++)
+   {
+      char value[32];
+      switch (it->type)
+      {
+      case UINT64:
+         snprintf(value, sizeof(value), "%llu", (unsigned long long) *((const UInt64*) it->counter));
+         break;
+
+      case DOUBLE:
+         {
+            double d = *((const double*) it->counter);
+            // NaN and infinities are not numbers in JSON: leave them out
+            if (d != d || (d - d) != 0)
+               value[0] = '\0';
+            else
+               snprintf(value, sizeof(value), "%.17g", d);
+         }
+         break;
+
+      case TIME:
+         snprintf(value, sizeof(value), "%llu", (unsigned long long) ((const Time*) it->counter)->toPicosec());
+         break;
+
+      default:
+         LOG_PRINT_ERROR("Unrecognized counter type(%u)", it->type);
+         break;
+      }
+
+      os << it->component << '\t' << it->name << '\t' << it->type << '\t' << value << '\n';
+   }
+}
+
+void
+StatisticsRegistry::deserialize(const string& serialized, ValueList& values)
+{
+   istringstream is(serialized);
+   string line;
+   while (getline(is, line))
+   {
+      string::size_type name_pos = line.find('\t') + 1;
+      string::size_type type_pos = line.find('\t', name_pos) + 1;
+      string::size_type value_pos = line.find('\t', type_pos) + 1;
+      LOG_ASSERT_ERROR(name_pos != 0 && type_pos != 0 && value_pos != 0, "Malformed statistics line(%s)", line.c_str());
+
+      Value value;
+      value.component = line.substr(0, name_pos - 1);
+      value.name = line.substr(name_pos, type_pos - name_pos - 1);
+      value.type = (CounterType) atoi(line.substr(type_pos, value_pos - type_pos - 1).c_str());
+      value.value = line.substr(value_pos);
+      values.push_back(value);
+   }
+}
+
+void
+StatisticsRegistry::outputJSON(ostream& os, const vector<ValueList>& tile_values)
+{
+   os << "{" << endl;
+   os << "  \"tiles\": [";
+   for (UInt32 t = 0; t < tile_values.size(); t++)
+   {
+      os << (t == 0 ? "" : ",") << endl;
+      os << "    {" << endl;
+      os << "      \"tile_id\": " << t;
+
+      // Components are grouped in the order they were first registered
+      vector<string> components;
+      map<string, vector<const Value*> > component_values;
+      for (ValueList::const_iterator it = tile_values[t].begin(); it != tile_values[t].end(); it++)
+      {
+         if (component_values.find(it->component) == component_values.end())
+            components.push_back(it->component);
+         component_values[it->component].push_back(&(*it));
+      }
+
+      for (vector<string>::iterator c = components.begin(); c != components.end(); c++)
+      {
+         os << "," << endl;
+         os << "      \"" << *c << "\": {";
+         const vector<const Value*>& values = component_values[*c];
+         for (UInt32 i = 0; i < values.size(); i++)
+         {
+            os << (i == 0 ? "" : ",") << endl;
+            os << "        \"" << values[i]->name << "\": "
+               << (values[i]->value.empty() ? "null" : values[i]->value);
+         }
+         os << endl << "      }";
+      }
+      os << endl << "    }";
+   }
+   os << endl << "  ]" << endl;
+   os << "}" << endl;
+}
+
+void
+StatisticsRegistry::outputCSV(ostream& os, const vector<ValueList>& tile_values)
+{
+   os << "tile_id,component,counter,type,value" << endl;
+   for (UInt32 t = 0; t < tile_values.size(); t++)
+   {
+      for (ValueList::const_iterator it = tile_values[t].begin(); it != tile_values[t].end(); it++)
+      {
+         os << t << ",\"" << it->component << "\",\"" << it->name << "\","
+            << counter_type_names[it->type] << "," << it->value << endl;
+      }
+   }
+}
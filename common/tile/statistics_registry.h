@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "fixed_types.h"
+#include "time_types.h"
+
+// Typed registry of the counters of a tile, written out as structured
+// statistics (stats.json and stats.csv, next to sim.out) at shutdown.
+//
+// Components register their existing counter members once, after they are
+// constructed, under their component name (e.g. "L1-D" or "network/memory")
+// and keep updating them as before. The registry only reads them when the
+// statistics are written out, so registration adds nothing to the models.
+class StatisticsRegistry
+{
+public:
+   enum CounterType
+   {
+      UINT64 = 0,
+      DOUBLE,
+      TIME,          // Written out in picoseconds
+      NUM_COUNTER_TYPES
+   };
+
+   StatisticsRegistry(tile_id_t tile_id);
+   ~StatisticsRegistry();
+
+   tile_id_t getTileId() const { return _tile_id; }
+
+   void registerCounter(const std::string& component, const std::string& name, const UInt64* counter);
+   void registerCounter(const std::string& component, const std::string& name, const double* counter);
+   void registerCounter(const std::string& component, const std::string& name, const Time* counter);
+
+   UInt32 getNumCounters() const { return _counters.size(); }
+   const std::string& getComponent(UInt32 index) const { return _counters[index].component; }
+   const std::string& getName(UInt32 index) const { return _counters[index].name; }
+   CounterType getType(UInt32 index) const { return _counters[index].type; }
+   // Current value of the counter as 64 bits: the value itself for UINT64
+   // and TIME (in picoseconds) counters, and its bits for DOUBLE counters
+   UInt64 read(UInt32 index) const;
+
+   // One "component\tname\ttype\tvalue" line per counter, in registration
+   // order. This is what gets sent to process 0.
+   void serialize(std::ostream& os) const;
+
+   // Counter values of one tile, as read back by process 0
+   struct Value
+   {
+      std::string component;
+      std::string name;
+      CounterType type;
+      std::string value;
+   };
+   typedef std::vector<Value> ValueList;
+
+   static void deserialize(const std::string& serialized, ValueList& values);
+   // 'tile_values' is indexed by tile id
+   static void outputJSON(std::ostream& os, const std::vector<ValueList>& tile_values);
+   static void outputCSV(std::ostream& os, const std::vector<ValueList>& tile_values);
+
+private:
+   struct Counter
+   {
+      std::string component;
+      std::string name;
+      CounterType type;
+      const void* counter;
+   };
+
+   tile_id_t _tile_id;
+   std::vector<Counter> _counters;
+
+   void addCounter(const std::string& component, const std::string& name, CounterType type, const void* counter);
+};
@@ -11,6 +11,8 @@
 #include "simulator.h"
 #include "log.h"
 #include "tile_energy_monitor.h"
+#include "statistics_registry.h"
+#include "checkpoint.h"
 
 Tile::Tile(tile_id_t id)
    : _id(id)
@@ -34,6 +36,13 @@ Tile::Tile(tile_id_t id)
 
    // Create Remote Query helper
    _remote_query_helper = new RemoteQueryHelper(this);   
+
+   // Register the counters for the structured statistics output
+   _statistics_registry = new StatisticsRegistry(_id);
+   _network->registerStatistics(_statistics_registry);
+   _core->registerStatistics(_statistics_registry);
+   if (_memory_manager)
+      _memory_manager->registerStatistics(_statistics_registry);
 }
 
 Tile::~Tile()
@@ -46,6 +55,7 @@ Tile::~Tile()
    delete _network;
    if (_tile_energy_monitor)
       delete _tile_energy_monitor;
+   delete _statistics_registry;
 }
 
 void
@@ -90,6 +100,39 @@ Tile::disableModels()
    LOG_PRINT("disableModels(%i) end", _id);
 }
 
+void
+Tile::saveCheckpoint(CheckpointWriter& writer)
+{
+   LOG_PRINT("saveCheckpoint(%i)", _id);
+   UnstructuredBuffer& core_buffer = writer.startSection("core");
+   core_buffer << (Boolean) (_core->getModel() != NULL);
+   if (_core->getModel())
+      _core->getModel()->checkpoint(core_buffer);
+
+   _network->checkpoint(writer.startSection("network"));
+
+   if (_memory_manager)
+      _memory_manager->saveCheckpoint(writer);
+}
+
+void
+Tile::restoreCheckpoint(CheckpointReader& reader)
+{
+   LOG_PRINT("restoreCheckpoint(%i)", _id);
+   UnstructuredBuffer& core_buffer = reader.startSection("core");
+   Boolean has_core_model;
+   core_buffer >> has_core_model;
+   LOG_ASSERT_ERROR(has_core_model == (_core->getModel() != NULL),
+                    "Core model of tile(%i) enabled in checkpoint(%s)", _id, has_core_model ? "yes" : "no");
+   if (_core->getModel())
+      _core->getModel()->restore(core_buffer);
+
+   _network->restore(reader.startSection("network"));
+
+   if (_memory_manager)
+      _memory_manager->restoreCheckpoint(reader);
+}
+
 Time
 Tile::getTargetCompletionTime()
 {
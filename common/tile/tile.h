@@ -11,6 +11,9 @@ class MemoryManager;
 class TileEnergyMonitor;
 class RemoteQueryHelper;
 class DVFSManager;
+class StatisticsRegistry;
+class CheckpointWriter;
+class CheckpointReader;
 
 #include "fixed_types.h"
 #include "network.h"
@@ -30,6 +33,7 @@ public:
    DVFSManager* getDVFSManager()       { return _dvfs_manager; }
    TileEnergyMonitor* getTileEnergyMonitor()       { return _tile_energy_monitor; }
    RemoteQueryHelper* getRemoteQueryHelper()       { return _remote_query_helper; }
+   StatisticsRegistry* getStatisticsRegistry()     { return _statistics_registry; }
 
    Time getCoreTime(tile_id_t tile_id) const;
 
@@ -39,6 +43,10 @@ public:
    void enableModels();
    void disableModels();
 
+   // Checkpoint of the core clock, network models and memory subsystem
+   void saveCheckpoint(CheckpointWriter& writer);
+   void restoreCheckpoint(CheckpointReader& reader);
+
 private:
    tile_id_t _id;
    Network* _network;
@@ -47,6 +55,7 @@ private:
    DVFSManager* _dvfs_manager;
    TileEnergyMonitor* _tile_energy_monitor;
    RemoteQueryHelper* _remote_query_helper;
+   StatisticsRegistry* _statistics_registry;
 
    Time getTargetCompletionTime();
 };
@@ -0,0 +1,97 @@
+#include <string.h>
+
+#include "packet_buffer.h"
+#include "log.h"
+
+PacketBuffer::Pool PacketBuffer::_pools[PacketBuffer::NUM_SIZE_CLASSES];
+
+SInt32 PacketBuffer::getSizeClass(UInt32 length)
+{
+   UInt32 total_size = length + sizeof(Header);
+   for (UInt32 size_class = 0; size_class < NUM_SIZE_CLASSES; size_class++)
+   {
+      if (total_size <= (1U << (MIN_SIZE_CLASS_LOG + size_class)))
+         return size_class;
+   }
+   return -1;
+}
+
+Byte* PacketBuffer::allocate(UInt32 length)
+{
+   Header* header = NULL;
+   SInt32 size_class = getSizeClass(length);
+
+   if (size_class >= 0)
+   {
+      Pool& pool = _pools[size_class];
+      pool._lock.acquire();
+      header = pool._free_list;
+      if (header)
+      {
+         pool._free_list = (Header*) header->_link._next;
+         pool._num_free --;
+      }
+      pool._lock.release();
+
+      if (!header)
+         header = (Header*) new Byte[1U << (MIN_SIZE_CLASS_LOG + size_class)];
+   }
+   else
+   {
+      header = (Header*) new Byte[length + sizeof(Header)];
+   }
+
+   header->_link._next = NULL;
+   header->_ref_count = 1;
+   header->_length = length;
+
+   return (Byte*) (header + 1);
+}
+
+Byte* PacketBuffer::clone(const Byte* buffer)
+{
+   UInt32 length = getLength(buffer);
+   Byte* copy = allocate(length);
+   memcpy(copy, buffer, length);
+   return copy;
+}
+
+void PacketBuffer::addReference(Byte* buffer)
+{
+   __sync_fetch_and_add(&getHeader(buffer)->_ref_count, 1);
+}
+
+void PacketBuffer::release(Byte* buffer)
+{
+   if (buffer == NULL)
+      return;
+
+   Header* header = getHeader(buffer);
+   SInt32 ref_count = __sync_sub_and_fetch(&header->_ref_count, 1);
+   LOG_ASSERT_ERROR(ref_count >= 0, "Packet buffer(%p) released too many times", buffer);
+   if (ref_count > 0)
+      return;
+
+   SInt32 size_class = getSizeClass(header->_length);
+   if (size_class >= 0)
+   {
+      Pool& pool = _pools[size_class];
+      pool._lock.acquire();
+      if (pool._num_free < MAX_FREE_BUFFERS_PER_POOL)
+      {
+         header->_link._next = (MPSCQueue::Node*) pool._free_list;
+         pool._free_list = header;
+         pool._num_free ++;
+         header = NULL;
+      }
+      pool._lock.release();
+   }
+
+   if (header)
+      delete [] (Byte*) header;
+}
+
+UInt32 PacketBuffer::getLength(const Byte* buffer)
+{
+   return getHeader(buffer)->_length;
+}
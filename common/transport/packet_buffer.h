@@ -0,0 +1,69 @@
+#ifndef PACKET_BUFFER_H
+#define PACKET_BUFFER_H
+
+#include "fixed_types.h"
+#include "lock.h"
+#include "mpsc_queue.h"
+
+// Pooled, reference-counted buffers for messages passed through the
+// transport layer. A buffer is handed around as a plain Byte* that
+// points just past a small hidden header holding the reference count
+// and the length, so the Transport::Node interface does not change.
+//
+// Buffers returned by Transport::Node::recv() are always PacketBuffers
+// and must be given back with PacketBuffer::release() (NOT delete []).
+
+class PacketBuffer
+{
+public:
+   // Returns a buffer of 'length' bytes with a reference count of 1
+   static Byte* allocate(UInt32 length);
+   // Returns a new buffer (reference count 1) holding a copy of 'buffer'
+   static Byte* clone(const Byte* buffer);
+
+   static void addReference(Byte* buffer);
+   // Drops a reference; the buffer goes back to its pool at zero
+   static void release(Byte* buffer);
+
+   static UInt32 getLength(const Byte* buffer);
+
+   // Intrusive link, so a buffer can sit in a transport queue without
+   // any extra allocation
+   static MPSCQueue::Node* getLink(Byte* buffer)
+   { return &getHeader(buffer)->_link; }
+   static Byte* getBuffer(MPSCQueue::Node* link)
+   { return (Byte*) (((Header*) link) + 1); }
+
+private:
+   struct Header
+   {
+      MPSCQueue::Node _link;        // free list or transport queue
+      volatile SInt32 _ref_count;
+      UInt32 _length;
+   } __attribute__((aligned(16)));
+
+   struct Pool
+   {
+      Pool() : _free_list(NULL), _num_free(0) {}
+      Lock _lock;
+      Header* _free_list;
+      UInt32 _num_free;
+   };
+
+   // Size classes are powers of two from 2^MIN_SIZE_CLASS_LOG to
+   // 2^MAX_SIZE_CLASS_LOG bytes (header included). Larger buffers
+   // (e.g., syscall payloads) are not pooled.
+   static const UInt32 MIN_SIZE_CLASS_LOG = 7;
+   static const UInt32 MAX_SIZE_CLASS_LOG = 13;
+   static const UInt32 NUM_SIZE_CLASSES = MAX_SIZE_CLASS_LOG - MIN_SIZE_CLASS_LOG + 1;
+   // Upper bound on the number of idle buffers kept per size class
+   static const UInt32 MAX_FREE_BUFFERS_PER_POOL = 8192;
+
+   static Pool _pools[NUM_SIZE_CLASSES];
+
+   static SInt32 getSizeClass(UInt32 length);
+   static Header* getHeader(const Byte* buffer)
+   { return ((Header*) buffer) - 1; }
+};
+
+#endif // PACKET_BUFFER_H
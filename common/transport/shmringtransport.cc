@@ -0,0 +1,588 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "log.h"
+#include "config.h"
+#include "simulator.h" //interface to config file singleton
+#include "shmringtransport.h"
+#include "packet_buffer.h"
+
+using std::string;
+
+// The segment is shared between processes, so these are deliberately
+// NOT the FUTEX_PRIVATE_FLAG variants
+static void futexWait(volatile SInt32 *addr, SInt32 val)
+{
+   syscall(SYS_futex, (void*) addr, FUTEX_WAIT, val, NULL, NULL, 0);
+}
+
+static void futexWake(volatile SInt32 *addr, SInt32 count)
+{
+   syscall(SYS_futex, (void*) addr, FUTEX_WAKE, count, NULL, NULL, 0);
+}
+
+ShmRingTransport::ShmRingTransport()
+   : m_barrier_sense(0)
+   , m_update_thread_state(RUNNING)
+{
+   m_base_port = Sim()->getCfg()->getInt("transport/base_port", DEFAULT_BASE_PORT);
+   m_ring_size = Sim()->getCfg()->getInt("transport/shm_ring/ring_size", DEFAULT_RING_SIZE);
+   LOG_ASSERT_ERROR(m_ring_size >= sizeof(MessageHeader) && (m_ring_size & (m_ring_size - 1)) == 0,
+                    "transport/shm_ring/ring_size(%u) must be a power of two", m_ring_size);
+
+   getProcInfo();
+   initSegment();
+   initBufferLists();
+
+   m_update_thread = Thread::create(updateThreadFunc, this);
+   m_update_thread->run();
+
+   m_global_node = new ShmRingNode(GLOBAL_TAG, this);
+}
+
+void ShmRingTransport::getProcInfo()
+{
+   m_num_procs = (SInt32)Config::getSingleton()->getProcessCount();
+
+   const char *proc_index_str = getenv("CARBON_PROCESS_INDEX");
+   LOG_ASSERT_ERROR(proc_index_str != NULL || m_num_procs == 1,
+                    "Process index undefined with multiple processes.");
+
+   if (proc_index_str)
+      m_proc_index = atoi(proc_index_str);
+   else
+      m_proc_index = 0;
+
+   LOG_ASSERT_ERROR(0 <= m_proc_index && m_proc_index < m_num_procs,
+                    "Invalid process index: %d with num_procs: %d", m_proc_index, m_num_procs);
+
+   Config::getSingleton()->setProcessNum(m_proc_index);
+   LOG_PRINT("Process number set to %i", Config::getSingleton()->getCurrentProcessNum());
+}
+
+// The name has to be the same in all the processes of a simulation and
+// different for simulations running side by side, so it is derived
+// from the base port and the (per-run) output directory
+string ShmRingTransport::getSegmentName()
+{
+   string output_dir = Sim()->getCfg()->getString("general/output_dir", ".");
+
+   // FNV-1a
+   UInt32 hash = 2166136261U;
+   for (UInt32 i = 0; i < output_dir.size(); i++)
+   {
+      hash ^= (UInt8) output_dir[i];
+      hash *= 16777619U;
+   }
+
+   char name[64];
+   snprintf(name, sizeof(name), "/carbon_shm_ring_%d_%08x", m_base_port, hash);
+   return string(name);
+}
+
+UInt64 ShmRingTransport::getSegmentSize()
+{
+   return sizeof(ControlBlock)
+      + m_num_procs * sizeof(Doorbell)
+      + ((UInt64) m_num_procs) * m_num_procs * (sizeof(RingHeader) + m_ring_size);
+}
+
+ShmRingTransport::RingHeader* ShmRingTransport::getRing(SInt32 src_proc, SInt32 dest_proc)
+{
+   Byte *rings = m_segment + sizeof(ControlBlock) + m_num_procs * sizeof(Doorbell);
+   return (RingHeader*) (rings + (((UInt64) src_proc) * m_num_procs + dest_proc) * (sizeof(RingHeader) + m_ring_size));
+}
+
+void ShmRingTransport::initSegment()
+{
+   LOG_PRINT("initSegment()");
+
+   m_segment_name = getSegmentName();
+   m_segment_size = getSegmentSize();
+
+   SInt32 fd;
+
+   if (m_proc_index == 0)
+   {
+      // Process 0 owns the segment; throw away whatever a crashed run
+      // may have left behind
+      shm_unlink(m_segment_name.c_str());
+
+      fd = shm_open(m_segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+      LOG_ASSERT_ERROR(fd >= 0, "Failed to create shared memory segment %s: errno(%d)", m_segment_name.c_str(), errno);
+
+      __attribute__((unused)) SInt32 err = ftruncate(fd, m_segment_size);
+      LOG_ASSERT_ERROR(err == 0, "Failed to size shared memory segment %s: errno(%d)", m_segment_name.c_str(), errno);
+
+      m_segment = (Byte*) mmap(NULL, m_segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      LOG_ASSERT_ERROR(m_segment != MAP_FAILED, "Failed to map shared memory segment %s: errno(%d)", m_segment_name.c_str(), errno);
+      ::close(fd);
+
+      // ftruncate() zero-fills, so the rings, doorbells and barrier are
+      // already in their initial state
+      m_control = (ControlBlock*) m_segment;
+      m_control->creator_pid = getpid();
+      __sync_synchronize();
+      m_control->magic = SEGMENT_MAGIC;
+   }
+   else
+   {
+      while (true)
+      {
+         fd = shm_open(m_segment_name.c_str(), O_RDWR, 0);
+         if (fd < 0)
+         {
+            usleep(1000);
+            continue;
+         }
+
+         // Wait for process 0 to size the segment
+         struct stat st;
+         if (fstat(fd, &st) != 0 || (UInt64) st.st_size != m_segment_size)
+         {
+            ::close(fd);
+            usleep(1000);
+            continue;
+         }
+
+         m_segment = (Byte*) mmap(NULL, m_segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+         LOG_ASSERT_ERROR(m_segment != MAP_FAILED, "Failed to map shared memory segment %s: errno(%d)", m_segment_name.c_str(), errno);
+         ::close(fd);
+
+         m_control = (ControlBlock*) m_segment;
+         while (m_control->magic != SEGMENT_MAGIC)
+            usleep(1000);
+
+         // A segment left over from a crashed run has a dead creator;
+         // wait for process 0 to replace it
+         if (kill(m_control->creator_pid, 0) == 0 || errno == EPERM)
+            break;
+
+         munmap(m_segment, m_segment_size);
+         usleep(1000);
+      }
+   }
+
+   m_doorbells = (Doorbell*) (m_segment + sizeof(ControlBlock));
+
+   m_send_locks = new Lock[m_num_procs];
+   m_recv_states = new RecvState[m_num_procs];
+
+   // Once everybody has it mapped, the name is no longer needed and the
+   // segment goes away with the last process
+   __sync_fetch_and_add(&m_control->num_attached, 1);
+   if (m_proc_index == 0)
+   {
+      while (m_control->num_attached < m_num_procs)
+         usleep(1000);
+      shm_unlink(m_segment_name.c_str());
+   }
+
+   LOG_PRINT("Mapped shared memory segment %s (%llu bytes)", m_segment_name.c_str(), m_segment_size);
+}
+
+void ShmRingTransport::initBufferLists()
+{
+   m_num_lists
+      = Config::getSingleton()->getTotalTiles() // for tiles
+      + 1; // for global node
+
+   m_buffer_lists = new buffer_list[m_num_lists];
+   m_buffer_list_locks = new Lock[m_num_lists];
+   m_buffer_list_sems = new Semaphore[m_num_lists];
+}
+
+ShmRingTransport::~ShmRingTransport()
+{
+   LOG_PRINT("dtor");
+
+   delete m_global_node;
+
+   terminateUpdateThread();
+   delete m_update_thread;
+
+   delete [] m_buffer_list_sems;
+   delete [] m_buffer_list_locks;
+   delete [] m_buffer_lists;
+
+   for (SInt32 i = 0; i < m_num_procs; i++)
+      PacketBuffer::release(m_recv_states[i].buffer);
+   delete [] m_recv_states;
+   delete [] m_send_locks;
+
+   munmap(m_segment, m_segment_size);
+}
+
+Transport::Node* ShmRingTransport::createNode(tile_id_t tile_id)
+{
+   return new ShmRingNode(tile_id, this);
+}
+
+Transport::Node* ShmRingTransport::getGlobalNode()
+{
+   return m_global_node;
+}
+
+void ShmRingTransport::barrier()
+{
+   // Sense-reversing barrier in the shared segment: the last process to
+   // arrive resets the count and flips the global sense, which releases
+   // everybody waiting for it
+
+   LOG_PRINT("Entering transport barrier");
+
+   BarrierState &barrier = m_control->barrier;
+   m_barrier_sense = 1 - m_barrier_sense;
+
+   if (__sync_add_and_fetch(&barrier.count, 1) == m_num_procs)
+   {
+      barrier.count = 0;
+      __sync_synchronize();
+      barrier.sense = m_barrier_sense;
+      futexWake(&barrier.sense, INT_MAX);
+   }
+   else
+   {
+      for (UInt32 i = 0; i < BARRIER_SPIN_COUNT && barrier.sense != m_barrier_sense; i++)
+         __asm__ __volatile__("pause" ::: "memory");
+
+      while (barrier.sense != m_barrier_sense)
+         futexWait(&barrier.sense, 1 - m_barrier_sense);
+   }
+
+   LOG_PRINT("Exiting transport barrier");
+}
+
+void ShmRingTransport::insertInBufferList(SInt32 tag, Byte *buffer)
+{
+   if (tag == GLOBAL_TAG)
+      tag = m_num_lists - 1;
+
+   LOG_ASSERT_ERROR(0 <= tag && tag < m_num_lists, "Unexpected tag value: %d", tag);
+   m_buffer_list_locks[tag].acquire();
+   m_buffer_lists[tag].push_back(buffer);
+   m_buffer_list_locks[tag].release();
+
+   m_buffer_list_sems[tag].signal();
+
+   // Not the global node
+   if (tag != m_num_lists - 1)
+      notifyReady(tag);
+}
+
+// -- producer side
+
+void ShmRingTransport::writeMessage(SInt32 dest_proc, SInt32 tag, const Byte *buffer, UInt32 length)
+{
+   RingHeader *ring = getRing(m_proc_index, dest_proc);
+
+   MessageHeader header;
+   header.length = length;
+   header.tag = tag;
+
+   ScopedLock sl(m_send_locks[dest_proc]);
+
+   UInt64 head = ring->head;
+   head = writeToRing(dest_proc, ring, head, (const Byte*) &header, sizeof(header));
+   head = writeToRing(dest_proc, ring, head, buffer, length);
+   publish(dest_proc, ring, head);
+}
+
+// Copies 'data' in at 'head' and returns the new (unpublished) head.
+// When the ring fills up, what has been written so far is published so
+// the receiver can make room.
+UInt64 ShmRingTransport::writeToRing(SInt32 dest_proc, RingHeader *ring, UInt64 head, const Byte *data, UInt32 length)
+{
+   Byte *ring_data = getRingData(ring);
+
+   while (length > 0)
+   {
+      UInt64 space = m_ring_size - (head - ring->tail);
+      if (space == 0)
+      {
+         publish(dest_proc, ring, head);
+         while (head - ring->tail == m_ring_size)
+            sched_yield();
+         continue;
+      }
+
+      UInt32 offset = head & (m_ring_size - 1);
+      UInt32 chunk = length;
+      if (chunk > space)
+         chunk = space;
+      if (chunk > m_ring_size - offset)
+         chunk = m_ring_size - offset;
+
+      memcpy(ring_data + offset, data, chunk);
+      head += chunk;
+      data += chunk;
+      length -= chunk;
+   }
+
+   return head;
+}
+
+void ShmRingTransport::publish(SInt32 dest_proc, RingHeader *ring, UInt64 head)
+{
+   // The data must be visible before the new head
+   __sync_synchronize();
+   ring->head = head;
+
+   ringDoorbell(dest_proc);
+}
+
+void ShmRingTransport::ringDoorbell(SInt32 proc)
+{
+   volatile SInt32 *futex = &m_doorbells[proc].futex;
+
+   // Only pay for the syscall if the update thread announced that it is
+   // going to sleep
+   __sync_synchronize();
+   if (*futex == 1 && __sync_bool_compare_and_swap(futex, 1, 0))
+      futexWake(futex, 1);
+}
+
+// -- consumer side
+
+void ShmRingTransport::updateThreadFunc(void *vp)
+{
+   LOG_PRINT("Starting updateThreadFunc");
+
+   ShmRingTransport *st = (ShmRingTransport*)vp;
+
+   while (st->m_update_thread_state == RUNNING)
+   {
+      st->updateBufferLists();
+   }
+
+   st->m_update_thread_state = EXITED;
+
+   LOG_PRINT("Leaving updateThreadFunc");
+}
+
+void ShmRingTransport::updateBufferLists()
+{
+   for (UInt32 i = 0; i < UPDATE_THREAD_SPIN_COUNT; i++)
+   {
+      if (drainRings())
+         return;
+      __asm__ __volatile__("pause" ::: "memory");
+   }
+
+   // Announce that we are going to sleep, then re-check so that a
+   // sender racing with us cannot be missed
+   volatile SInt32 *futex = &m_doorbells[m_proc_index].futex;
+   __sync_lock_test_and_set(futex, 1);
+
+   if (drainRings() || m_update_thread_state != RUNNING)
+   {
+      *futex = 0;
+      return;
+   }
+
+   futexWait(futex, 1);
+   *futex = 0;
+}
+
+bool ShmRingTransport::drainRings()
+{
+   bool progress = false;
+   for (SInt32 proc = 0; proc < m_num_procs; proc++)
+   {
+      if (proc != m_proc_index)
+         progress |= drainRing(proc);
+   }
+   return progress;
+}
+
+// Moves everything published in the ring from 'src_proc' into the
+// buffer lists. Returns true if any data was consumed.
+bool ShmRingTransport::drainRing(SInt32 src_proc)
+{
+   RingHeader *ring = getRing(src_proc, m_proc_index);
+   RecvState &state = m_recv_states[src_proc];
+
+   UInt64 tail = ring->tail;
+   UInt64 head = ring->head;
+   if (tail == head)
+      return false;
+
+   // Read the data only after the head
+   __sync_synchronize();
+
+   while (true)
+   {
+      if (state.buffer == NULL)
+      {
+         if (head - tail < sizeof(MessageHeader))
+            break;
+
+         MessageHeader header;
+         readFromRing(ring, tail, (Byte*) &header, sizeof(header));
+         tail += sizeof(header);
+
+         state.buffer = PacketBuffer::allocate(header.length);
+         state.tag = header.tag;
+         state.length = header.length;
+         state.received = 0;
+      }
+
+      UInt32 chunk = state.length - state.received;
+      if (chunk > head - tail)
+         chunk = head - tail;
+      readFromRing(ring, tail, state.buffer + state.received, chunk);
+      tail += chunk;
+      state.received += chunk;
+
+      if (state.received < state.length)
+         break;
+
+      insertInBufferList(state.tag, state.buffer);
+      state.buffer = NULL;
+   }
+
+   // We are done reading before the sender may overwrite the space
+   __sync_synchronize();
+   ring->tail = tail;
+
+   return true;
+}
+
+void ShmRingTransport::readFromRing(RingHeader *ring, UInt64 tail, Byte *data, UInt32 length)
+{
+   Byte *ring_data = getRingData(ring);
+   UInt32 offset = tail & (m_ring_size - 1);
+   UInt32 first = (length < m_ring_size - offset) ? length : (m_ring_size - offset);
+
+   memcpy(data, ring_data + offset, first);
+   memcpy(data + first, ring_data, length - first);
+}
+
+void ShmRingTransport::terminateUpdateThread()
+{
+   LOG_PRINT("Stopping update thread.");
+
+   m_update_thread_state = EXITING;
+   __sync_synchronize();
+   ringDoorbell(m_proc_index);
+
+   while (m_update_thread_state != EXITED)
+      sched_yield();
+
+   LOG_PRINT("Quit.");
+}
+
+// -- ShmRingTransport::ShmRingNode
+
+ShmRingTransport::ShmRingNode::ShmRingNode(tile_id_t tile_id, ShmRingTransport *trans)
+   : Node(tile_id)
+   , m_transport(trans)
+{
+}
+
+ShmRingTransport::ShmRingNode::~ShmRingNode()
+{
+}
+
+void ShmRingTransport::ShmRingNode::globalSend(SInt32 dest_proc,
+                                               const void *buffer,
+                                               UInt32 length)
+{
+   send(dest_proc, GLOBAL_TAG, buffer, length);
+}
+
+void ShmRingTransport::ShmRingNode::send(tile_id_t dest_tile,
+                                         const void *buffer,
+                                         UInt32 length)
+{
+   int dest_proc = Config::getSingleton()->getProcessNumForTile(dest_tile);
+   send(dest_proc, dest_tile, buffer, length);
+}
+
+void ShmRingTransport::ShmRingNode::sendBuffer(tile_id_t dest_tile,
+                                               Byte *buffer)
+{
+   int dest_proc = Config::getSingleton()->getProcessNumForTile(dest_tile);
+
+   if (dest_proc == m_transport->m_proc_index)
+   {
+      // Local destination: queue the buffer itself, the receiver
+      // drops our reference
+      m_transport->insertInBufferList(dest_tile, buffer);
+   }
+   else
+   {
+      m_transport->writeMessage(dest_proc, dest_tile, buffer, PacketBuffer::getLength(buffer));
+      PacketBuffer::release(buffer);
+   }
+
+   LOG_PRINT("Message sent.");
+}
+
+void ShmRingTransport::ShmRingNode::send(SInt32 dest_proc,
+                                         SInt32 tag,
+                                         const void *buffer,
+                                         UInt32 length)
+{
+   if (dest_proc == m_transport->m_proc_index)
+   {
+      Byte *buff_cpy = PacketBuffer::allocate(length);
+      memcpy(buff_cpy, buffer, length);
+      m_transport->insertInBufferList(tag, buff_cpy);
+   }
+   else
+   {
+      m_transport->writeMessage(dest_proc, tag, (const Byte*) buffer, length);
+   }
+
+   LOG_PRINT("Message sent.");
+}
+
+Byte* ShmRingTransport::ShmRingNode::recv()
+{
+   LOG_PRINT("Entering recv");
+
+   tile_id_t tag = getTileId();
+   tag = (tag == GLOBAL_TAG) ? m_transport->m_num_lists - 1 : tag;
+
+   m_transport->m_buffer_list_sems[tag].wait();
+
+   Lock &lock = m_transport->m_buffer_list_locks[tag];
+   lock.acquire();
+
+   buffer_list &list = m_transport->m_buffer_lists[tag];
+   LOG_ASSERT_ERROR(!list.empty(), "Buffer list empty after waiting on semaphore.");
+   Byte* buffer = list.front();
+   list.pop_front();
+
+   lock.release();
+
+   LOG_PRINT("Message recv'd");
+
+   return buffer;
+}
+
+bool ShmRingTransport::ShmRingNode::query()
+{
+   tile_id_t tag = getTileId();
+   tag = (tag == GLOBAL_TAG) ? m_transport->m_num_lists - 1 : tag;
+
+   buffer_list &list = m_transport->m_buffer_lists[tag];
+   Lock &lock = m_transport->m_buffer_list_locks[tag];
+
+   lock.acquire();
+   bool result = !list.empty();
+   lock.release();
+   return result;
+}
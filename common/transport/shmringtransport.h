@@ -0,0 +1,175 @@
+#ifndef SHM_RING_TRANSPORT_H
+#define SHM_RING_TRANSPORT_H
+
+#include "transport.h"
+#include "thread.h"
+#include "semaphore.h"
+#include "lock.h"
+
+#include <list>
+#include <string>
+
+// Transport for multi-process simulations where all the processes run
+// on the same host. The processes map a common POSIX shared-memory
+// segment holding one single-producer/single-consumer byte ring for
+// every (sender, receiver) pair of processes, so messages are copied
+// straight into the receiver's address space without going through
+// the kernel.
+//
+// Within a process, the sending threads take turns on each outgoing
+// ring and a single update thread drains the incoming rings into the
+// per-tile buffer lists, just like SockTransport. The update thread
+// spins for a while and then sleeps on a (process-shared) futex that
+// the senders ring when they publish data.
+
+class ShmRingTransport : public Transport
+{
+public:
+   ShmRingTransport();
+   ~ShmRingTransport();
+
+   class ShmRingNode : public Node
+   {
+   public:
+      ShmRingNode(tile_id_t tile_id, ShmRingTransport *trans);
+      ~ShmRingNode();
+
+      void globalSend(SInt32 dest_proc, const void *buffer, UInt32 length);
+      void send(tile_id_t dest_tile, const void *buffer, UInt32 length);
+      void sendBuffer(tile_id_t dest_tile, Byte *buffer);
+      Byte* recv();
+      bool query();
+
+   private:
+      void send(SInt32 dest_proc, SInt32 tag, const void *buffer, UInt32 length);
+
+      ShmRingTransport *m_transport;
+   };
+
+   Node *createNode(tile_id_t tile_id);
+
+   void barrier();
+   Node *getGlobalNode();
+
+private:
+   static const UInt32 CACHE_LINE_SIZE = 64;
+
+   // Message format in a ring: Length, Tag, Data
+   struct MessageHeader
+   {
+      UInt32 length;
+      SInt32 tag;
+   };
+
+   // -- Layout of the shared segment:
+   //    ControlBlock, Doorbell[num_procs], (RingHeader, data)[num_procs * num_procs]
+
+   // Sense-reversing barrier shared by all the processes
+   struct BarrierState
+   {
+      volatile SInt32 count __attribute__((aligned(CACHE_LINE_SIZE)));
+      volatile SInt32 sense __attribute__((aligned(CACHE_LINE_SIZE)));
+   };
+
+   struct ControlBlock
+   {
+      volatile UInt32 magic;
+      volatile SInt32 creator_pid;
+      volatile SInt32 num_attached;
+      BarrierState barrier;
+   };
+
+   // Futex word of a process: 1 while its update thread is (about to
+   // be) asleep
+   struct Doorbell
+   {
+      volatile SInt32 futex __attribute__((aligned(CACHE_LINE_SIZE)));
+   };
+
+   // 'head' and 'tail' count the bytes ever written and read; the
+   // producer only writes 'head' and the consumer only writes 'tail'
+   struct RingHeader
+   {
+      volatile UInt64 head __attribute__((aligned(CACHE_LINE_SIZE)));
+      volatile UInt64 tail __attribute__((aligned(CACHE_LINE_SIZE)));
+   };
+
+   // Message being copied out of an incoming ring; messages larger
+   // than the ring arrive over several passes
+   struct RecvState
+   {
+      RecvState() : buffer(NULL), tag(0), length(0), received(0) {}
+
+      Byte *buffer;
+      SInt32 tag;
+      UInt32 length;
+      UInt32 received;
+   };
+
+   enum UpdateThreadState
+   {
+      RUNNING,
+      EXITING,
+      EXITED
+   };
+
+   static const UInt32 SEGMENT_MAGIC = 0x43524e47;  // "CRNG"
+   static const SInt32 DEFAULT_BASE_PORT = 2000;
+   static const UInt32 DEFAULT_RING_SIZE = 1 << 20;
+   static const UInt32 UPDATE_THREAD_SPIN_COUNT = 4096;
+   static const UInt32 BARRIER_SPIN_COUNT = 4096;
+   static const SInt32 GLOBAL_TAG = -1;
+
+   void getProcInfo();
+   void initSegment();
+   void initBufferLists();
+   std::string getSegmentName();
+   UInt64 getSegmentSize();
+   RingHeader* getRing(SInt32 src_proc, SInt32 dest_proc);
+   Byte* getRingData(RingHeader *ring) { return (Byte*) (ring + 1); }
+
+   void insertInBufferList(SInt32 tag, Byte *buffer);
+
+   // -- producer side
+   void writeMessage(SInt32 dest_proc, SInt32 tag, const Byte *buffer, UInt32 length);
+   UInt64 writeToRing(SInt32 dest_proc, RingHeader *ring, UInt64 head, const Byte *data, UInt32 length);
+   void publish(SInt32 dest_proc, RingHeader *ring, UInt64 head);
+   void ringDoorbell(SInt32 proc);
+
+   // -- consumer side
+   static void updateThreadFunc(void *vp);
+   void updateBufferLists();
+   bool drainRings();
+   bool drainRing(SInt32 src_proc);
+   void readFromRing(RingHeader *ring, UInt64 tail, Byte *data, UInt32 length);
+   void terminateUpdateThread();
+
+   Node *m_global_node;
+
+   SInt32 m_base_port;
+   SInt32 m_num_procs;
+   SInt32 m_proc_index;
+   UInt32 m_ring_size;
+
+   std::string m_segment_name;
+   UInt64 m_segment_size;
+   Byte *m_segment;
+   ControlBlock *m_control;
+   Doorbell *m_doorbells;
+
+   // Serializes the threads of this process on each outgoing ring
+   Lock *m_send_locks;
+   RecvState *m_recv_states;
+   SInt32 m_barrier_sense;
+
+   Thread *m_update_thread;
+   volatile UpdateThreadState m_update_thread_state;
+
+   typedef std::list<Byte*> buffer_list;
+   SInt32 m_num_lists;
+   buffer_list *m_buffer_lists;
+   Lock *m_buffer_list_locks;
+   Semaphore *m_buffer_list_sems;
+};
+
+#endif // SHM_RING_TRANSPORT_H
@@ -1,7 +1,9 @@
 #include <string.h>
 
 #include "smtransport.h"
+#include "packet_buffer.h"
 #include "config.h"
+#include "simulator.h"
 #include "log.h"
 
 // -- SmTransport -- //
@@ -12,6 +14,8 @@ SmTransport::SmTransport()
 
    Config::getSingleton()->setProcessNum(0);
 
+   m_queue_type = parseQueueType(Sim()->getCfg()->getString("transport/shared_memory/queue_type", "lock_free"));
+
    m_global_node = new SmNode(-1, this);
    m_tile_nodes = new SmNode* [ Config::getSingleton()->getNumLocalTiles() ];
    for (UInt32 i = 0; i < Config::getSingleton()->getNumLocalTiles(); i++)
@@ -29,6 +33,19 @@ SmTransport::~SmTransport()
    delete m_global_node;
 }
 
+SmTransport::QueueType SmTransport::parseQueueType(std::string queue_type)
+{
+   if (queue_type == "locked")
+      return LOCKED;
+   else if (queue_type == "lock_free")
+      return LOCK_FREE;
+   else
+   {
+      LOG_PRINT_ERROR("Unrecognized shared memory transport queue type(%s)", queue_type.c_str());
+      return NUM_QUEUE_TYPES;
+   }
+}
+
 Transport::Node* SmTransport::createNode(tile_id_t tile_id)
 {
    LOG_ASSERT_ERROR((UInt32)tile_id < Config::getSingleton()->getNumLocalTiles(),
@@ -78,7 +95,7 @@ SmTransport::SmNode::SmNode(tile_id_t tile_id, SmTransport *smt)
 
 SmTransport::SmNode::~SmNode()
 {
-   LOG_ASSERT_WARNING(m_queue.empty(), "Unread messages in queue for tile: %d", getTileId());
+   LOG_ASSERT_WARNING(m_queue.empty() && m_lock_free_queue.empty(), "Unread messages in queue for tile: %d", getTileId());
    m_smt->clearNodeForId(getTileId());
 }
 
@@ -95,23 +112,54 @@ void SmTransport::SmNode::send(SInt32 dest_id, const void* buffer, UInt32 length
    send(dest_node, buffer, length);
 }
 
+void SmTransport::SmNode::sendBuffer(SInt32 dest_id, Byte* buffer)
+{
+   SmNode *dest_node = m_smt->getNodeFromId(dest_id);
+   LOG_ASSERT_ERROR(dest_node != NULL, "Attempt to send to non-existent node: %d", dest_id);
+   // The buffer is queued as-is, the receiver drops our reference
+   enqueue(dest_node, buffer);
+}
+
 void SmTransport::SmNode::send(SmNode *dest_node, const void *buffer, UInt32 length)
 {
-   Byte *data = new Byte[length];
+   Byte *data = PacketBuffer::allocate(length);
    memcpy(data, buffer, length);
+   enqueue(dest_node, data);
+}
 
-   LOG_PRINT("sending msg -- size: %i, data: %p, dest: %p", length, data, dest_node);
+void SmTransport::SmNode::enqueue(SmNode *dest_node, Byte *data)
+{
+   LOG_PRINT("sending msg -- size: %u, data: %p, dest: %p", PacketBuffer::getLength(data), data, dest_node);
+
+   if (m_smt->m_queue_type == LOCK_FREE)
+   {
+      dest_node->m_lock_free_queue.push(PacketBuffer::getLink(data));
+   }
+   else
+   {
+      dest_node->m_lock.acquire();
+      dest_node->m_queue.push(data);
+      dest_node->m_lock.release();
+      dest_node->m_cond.broadcast();
+   }
 
-   dest_node->m_lock.acquire();
-   dest_node->m_queue.push(data);
-   dest_node->m_lock.release();
-   dest_node->m_cond.broadcast();
+   if (dest_node != m_smt->m_global_node)
+      m_smt->notifyReady(dest_node->getTileId());
 }
 
 Byte* SmTransport::SmNode::recv()
 {
    LOG_PRINT("attempting recv -- this: %p", this);
 
+   if (m_smt->m_queue_type == LOCK_FREE)
+   {
+      Byte *data = PacketBuffer::getBuffer(m_lock_free_queue.waitPop());
+
+      LOG_PRINT("msg recv'd -- data: %p, this: %p", data, this);
+
+      return data;
+   }
+
    m_lock.acquire();
 
    while (true)
@@ -135,6 +183,9 @@ Byte* SmTransport::SmNode::recv()
 
 bool SmTransport::SmNode::query()
 {
+   if (m_smt->m_queue_type == LOCK_FREE)
+      return !m_lock_free_queue.empty();
+
    bool result = false;
 
    m_lock.acquire();
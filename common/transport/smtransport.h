@@ -2,9 +2,11 @@
 #define SMTRANSPORT_H
 
 #include <queue>
+#include <string>
 
 #include "transport.h"
 #include "cond.h"
+#include "mpsc_queue.h"
 
 class SmTransport : public Transport
 {
@@ -12,6 +14,16 @@ public:
    SmTransport();
    ~SmTransport();
 
+   // Per-node message queues. Each node has a single consumer (its sim
+   // thread, or the LCP for the global node), so the lock-free queue
+   // can be multi-producer / single-consumer.
+   enum QueueType
+   {
+      LOCKED = 0,
+      LOCK_FREE,
+      NUM_QUEUE_TYPES
+   };
+
    class SmNode : public Node
    {
    public:
@@ -20,15 +32,21 @@ public:
 
       void globalSend(SInt32, const void*, UInt32);
       void send(tile_id_t, const void*, UInt32);
+      void sendBuffer(tile_id_t, Byte*);
       Byte* recv();
       bool query();
 
    private:
       void send(SmNode *dest, const void *buffer, UInt32 length);
+      void enqueue(SmNode *dest, Byte *buffer);
 
+      // QueueType::LOCKED
       std::queue<Byte*> m_queue;
       Lock m_lock;
       ConditionVariable m_cond;
+      // QueueType::LOCK_FREE
+      MPSCQueue m_lock_free_queue;
+
       SmTransport *m_smt;
    };
 
@@ -38,9 +56,12 @@ public:
    Node* getGlobalNode();
 
 private:
+   QueueType m_queue_type;
    Node *m_global_node;
    SmNode **m_tile_nodes;
 
+   static QueueType parseQueueType(std::string queue_type);
+
    SmNode *getNodeFromId(tile_id_t tile_id);
    void clearNodeForId(tile_id_t tile_id);
 };
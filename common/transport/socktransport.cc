@@ -9,11 +9,14 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <sched.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
 
 #include "log.h"
 #include "config.h"
 #include "simulator.h" //interface to config file singleton
 #include "socktransport.h"
+#include "packet_buffer.h"
 
 // #define __CHECKSUM_ENABLED__     1
 
@@ -70,7 +73,7 @@ void SockTransport::initSockets()
 
    // -- client side
    m_send_sockets = new Socket[m_num_procs];
-   m_send_locks = new Lock[m_num_procs];
+   m_send_queues = new SendQueue[m_num_procs];
 
    for (SInt32 proc = 0; proc < m_num_procs; proc++)
    {
@@ -96,7 +99,7 @@ void SockTransport::initSockets()
 
    // -- accept connections
    m_recv_sockets = new Socket[m_num_procs];
-   m_recv_locks = new Lock[m_num_procs];
+   m_recv_buffers = new RecvBuffer[m_num_procs];
 
    for (SInt32 proc = 0; proc < m_num_procs; proc++)
    {
@@ -111,6 +114,22 @@ void SockTransport::initSockets()
 
       m_recv_sockets[proc_index] = sock;
    }
+
+   // -- the update thread sleeps in epoll until any process has data
+   m_epoll_fd = epoll_create(m_num_procs);
+   LOG_ASSERT_ERROR(m_epoll_fd >= 0, "Failed to create epoll instance.");
+
+   for (SInt32 proc = 0; proc < m_num_procs; proc++)
+   {
+      m_recv_buffers[proc].data = new Byte[RECV_BUFFER_SIZE];
+
+      struct epoll_event event;
+      memset(&event, 0, sizeof(event));
+      event.events = EPOLLIN;
+      event.data.u32 = proc;
+      __attribute__((unused)) SInt32 err = epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_recv_sockets[proc].getDescriptor(), &event);
+      LOG_ASSERT_ERROR(err >= 0, "Failed to add socket of process %d to epoll set.", proc);
+   }
 }
 
 void SockTransport::initBufferLists()
@@ -138,7 +157,6 @@ void SockTransport::updateThreadFunc(void *vp)
    while (st->m_update_thread_state == RUNNING)
    {
       st->updateBufferLists();
-      sched_yield();
    }
 
    st->m_update_thread_state = EXITED;
@@ -148,71 +166,154 @@ void SockTransport::updateThreadFunc(void *vp)
 
 void SockTransport::updateBufferLists()
 {
-   for (SInt32 i = 0; i < m_num_procs; i++)
+   struct epoll_event events[MAX_EPOLL_EVENTS];
+
+   SInt32 num_events = epoll_wait(m_epoll_fd, events, MAX_EPOLL_EVENTS, -1);
+   if (num_events < 0)
+   {
+      LOG_ASSERT_ERROR(errno == EINTR, "epoll_wait failed: errno(%d)", errno);
+      return;
+   }
+
+   for (SInt32 i = 0; i < num_events; i++)
+   {
+      if (!drainSocket(events[i].data.u32))
+         return;
+   }
+}
+
+// Reads everything that is currently available from the socket of
+// 'proc' and parses the complete messages. Returns false once the
+// terminate message has been received.
+bool SockTransport::drainSocket(SInt32 proc)
+{
+   RecvBuffer &recv_buffer = m_recv_buffers[proc];
+
+   while (true)
    {
-      while (true)
+      SInt32 recvd = m_recv_sockets[proc].recvAvailable(recv_buffer.data + recv_buffer.end,
+                                                        RECV_BUFFER_SIZE - recv_buffer.end);
+      if (recvd == 0)
+         return true;
+
+      if (recvd < 0)
       {
-         UInt32 length;
+         // Connection closed during shutdown, stop watching it
+         epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, m_recv_sockets[proc].getDescriptor(), NULL);
+         return true;
+      }
 
-         m_recv_locks[i].acquire();
+      recv_buffer.end += recvd;
 
-         // first get packet length, abort if none available
-         if (!m_recv_sockets[i].recv(&length, sizeof(length), false))
-         {
-            m_recv_locks[i].release();
-            break;
-         }
+      if (!parseMessages(proc))
+         return false;
+   }
+}
 
-         // now receive tag
-         SInt32 tag;
-         m_recv_sockets[i].recv(&tag, sizeof(tag), true);
+bool SockTransport::parseMessages(SInt32 proc)
+{
+   RecvBuffer &recv_buffer = m_recv_buffers[proc];
 
-         // now receive packet
-         Byte *buffer = new Byte[length];
-         m_recv_sockets[i].recv(buffer, length, true);
+   while (recv_buffer.end - recv_buffer.start >= sizeof(MessageHeader))
+   {
+      // Parse the header in place
+      MessageHeader *header = (MessageHeader*) (recv_buffer.data + recv_buffer.start);
+      UInt32 length = header->length;
+      SInt32 tag = header->tag;
+      Byte *payload = (Byte*) (header + 1);
 
+      UInt32 trailer_length = 0;
 #ifdef __CHECKSUM_ENABLED__
-         // now receive checksum
-         UInt64 checksum = 0;
-         if ((tag != TERMINATE_TAG) && (tag != BARRIER_TAG))
-         {
-            m_recv_sockets[i].recv(&checksum, sizeof(checksum), true);
-         }
+      if ((tag != TERMINATE_TAG) && (tag != BARRIER_TAG))
+         trailer_length = sizeof(UInt64);
 #endif // __CHECKSUM_ENABLED__
 
-         m_recv_locks[i].release();
+      UInt32 message_length = sizeof(MessageHeader) + length + trailer_length;
+      UInt32 available = recv_buffer.end - recv_buffer.start;
+      UInt64 checksum = 0;
+      Byte *buffer;
 
-         switch (tag)
-         {
-         case TERMINATE_TAG:
-            LOG_PRINT("Quit message received.");
-            LOG_ASSERT_ERROR(m_update_thread_state == RUNNING, "Terminate received in unexpected state: %d", m_update_thread_state);
-            LOG_ASSERT_ERROR(i == m_proc_index, "Terminate received from unexpected process: %d != %d", i, m_proc_index);
-            m_update_thread_state = EXITING;
-
-            delete [] buffer;
-            return;
-
-         case BARRIER_TAG:
-            m_barrier_sem.signal();
-            LOG_ASSERT_ERROR(i == (m_proc_index + m_num_procs - 1) % m_num_procs,
-                             "Barrier update from unexpected process: %d", i);
-            delete [] buffer;
-            break;
-
-         case GLOBAL_TAG:
-         default:
+      if (message_length <= available)
+      {
+         buffer = PacketBuffer::allocate(length);
+         memcpy(buffer, payload, length);
+         memcpy(&checksum, payload + length, trailer_length);
+         recv_buffer.start += message_length;
+      }
+      else if (message_length > RECV_BUFFER_SIZE)
+      {
+         // Does not fit in the receive buffer: take what we have and
+         // block for the remainder
+         UInt32 payload_available = available - sizeof(MessageHeader);
+         UInt32 payload_recvd = (payload_available < length) ? payload_available : length;
+         UInt32 trailer_recvd = payload_available - payload_recvd;
+
+         buffer = PacketBuffer::allocate(length);
+         memcpy(buffer, payload, payload_recvd);
+         memcpy(&checksum, payload + length, trailer_recvd);
+         if (payload_recvd < length)
+            m_recv_sockets[proc].recv(buffer + payload_recvd, length - payload_recvd, true);
+         if (trailer_recvd < trailer_length)
+            m_recv_sockets[proc].recv(((Byte*) &checksum) + trailer_recvd, trailer_length - trailer_recvd, true);
+
+         recv_buffer.start = recv_buffer.end;
+      }
+      else
+      {
+         // Incomplete message, wait for more data
+         break;
+      }
+
+      if (!handleMessage(proc, tag, buffer, checksum))
+         return false;
+   }
+
+   // Move the incomplete tail to the front of the buffer
+   if (recv_buffer.start == recv_buffer.end)
+   {
+      recv_buffer.start = recv_buffer.end = 0;
+   }
+   else if (recv_buffer.start > 0)
+   {
+      memmove(recv_buffer.data, recv_buffer.data + recv_buffer.start, recv_buffer.end - recv_buffer.start);
+      recv_buffer.end -= recv_buffer.start;
+      recv_buffer.start = 0;
+   }
+
+   return true;
+}
+
+bool SockTransport::handleMessage(SInt32 proc, SInt32 tag, Byte *buffer, __attribute__((unused)) UInt64 checksum)
+{
+   switch (tag)
+   {
+   case TERMINATE_TAG:
+      LOG_PRINT("Quit message received.");
+      LOG_ASSERT_ERROR(m_update_thread_state == RUNNING, "Terminate received in unexpected state: %d", m_update_thread_state);
+      LOG_ASSERT_ERROR(proc == m_proc_index, "Terminate received from unexpected process: %d != %d", proc, m_proc_index);
+      m_update_thread_state = EXITING;
+
+      PacketBuffer::release(buffer);
+      return false;
+
+   case BARRIER_TAG:
+      m_barrier_sem.signal();
+      LOG_ASSERT_ERROR(proc == (m_proc_index + m_num_procs - 1) % m_num_procs,
+                       "Barrier update from unexpected process: %d", proc);
+      PacketBuffer::release(buffer);
+      return true;
+
+   case GLOBAL_TAG:
+   default:
 #ifdef __CHECKSUM_ENABLED__
-            Header* header = new Header(length, checksum);
-            insertInBufferList(tag, buffer, header);
+      Header* header = new Header(PacketBuffer::getLength(buffer), checksum);
+      insertInBufferList(tag, buffer, header);
 #else
-            insertInBufferList(tag, buffer);
+      insertInBufferList(tag, buffer);
 #endif // __CHECKSUM_ENABLED__
-            // do NOT delete buffer
-            break;
-         };
-      }
-   }
+      // do NOT release buffer
+      return true;
+   };
 }
 
 void SockTransport::insertInBufferList(SInt32 tag, Byte *buffer, Header* header)
@@ -231,6 +332,95 @@ void SockTransport::insertInBufferList(SInt32 tag, Byte *buffer, Header* header)
    m_buffer_list_locks[tag].release();
    
    m_buffer_list_sems[tag].signal();
+
+   // Not the global node
+   if (tag != m_num_lists - 1)
+      notifyReady(tag);
+}
+
+void SockTransport::queueMessage(SInt32 dest_proc, SInt32 tag, Byte *buffer)
+{
+   OutgoingMessage message;
+   message.header.length = PacketBuffer::getLength(buffer);
+   message.header.tag = tag;
+   message.buffer = buffer;
+#ifdef __CHECKSUM_ENABLED__
+   message.checksum = computeCheckSum(buffer, message.header.length);
+#else
+   message.checksum = 0;
+#endif // __CHECKSUM_ENABLED__
+
+   SendQueue &queue = m_send_queues[dest_proc];
+
+   queue.lock.acquire();
+   queue.pending.push_back(message);
+
+   // Somebody else is writing to this process and will pick it up
+   if (queue.flushing)
+   {
+      queue.lock.release();
+      return;
+   }
+
+   queue.flushing = true;
+   flushSendQueue(dest_proc, queue);
+}
+
+// Called with queue.lock held; returns with it released. Writes out
+// everything that gets queued for 'dest_proc' in the meantime, so
+// messages are never left behind.
+void SockTransport::flushSendQueue(SInt32 dest_proc, SendQueue &queue)
+{
+   std::vector<OutgoingMessage> batch;
+   std::vector<struct iovec> iovecs;
+
+   while (!queue.pending.empty())
+   {
+      batch.swap(queue.pending);
+      queue.lock.release();
+
+      iovecs.clear();
+      for (UInt32 i = 0; i < batch.size(); i++)
+      {
+         OutgoingMessage &message = batch[i];
+
+         struct iovec iov;
+         iov.iov_base = &message.header;
+         iov.iov_len = sizeof(message.header);
+         iovecs.push_back(iov);
+
+         if (message.header.length > 0)
+         {
+            iov.iov_base = message.buffer;
+            iov.iov_len = message.header.length;
+            iovecs.push_back(iov);
+         }
+
+#ifdef __CHECKSUM_ENABLED__
+         if ((message.header.tag != TERMINATE_TAG) && (message.header.tag != BARRIER_TAG))
+         {
+            iov.iov_base = &message.checksum;
+            iov.iov_len = sizeof(message.checksum);
+            iovecs.push_back(iov);
+         }
+#endif // __CHECKSUM_ENABLED__
+      }
+
+      for (UInt32 i = 0; i < iovecs.size(); i += MAX_IOVECS_PER_WRITE)
+      {
+         UInt32 count = (iovecs.size() - i < MAX_IOVECS_PER_WRITE) ? (iovecs.size() - i) : MAX_IOVECS_PER_WRITE;
+         m_send_sockets[dest_proc].sendv(&iovecs[i], count);
+      }
+
+      for (UInt32 i = 0; i < batch.size(); i++)
+         PacketBuffer::release(batch[i].buffer);
+      batch.clear();
+
+      queue.lock.acquire();
+   }
+
+   queue.flushing = false;
+   queue.lock.release();
 }
 
 void SockTransport::terminateUpdateThread()
@@ -239,8 +429,9 @@ void SockTransport::terminateUpdateThread()
 
    // include m_proc_index as a dummy message body just to avoid extra
    // code paths in updateBufferLists
-   SInt32 quit_message[] = { sizeof(m_proc_index), TERMINATE_TAG, m_proc_index };
-   m_send_sockets[m_proc_index].send(quit_message, sizeof(quit_message));
+   Byte *quit_message = PacketBuffer::allocate(sizeof(m_proc_index));
+   memcpy(quit_message, &m_proc_index, sizeof(m_proc_index));
+   queueMessage(m_proc_index, TERMINATE_TAG, quit_message);
 
    while (m_update_thread_state != EXITED)
       sched_yield();
@@ -266,16 +457,19 @@ SockTransport::~SockTransport()
 
    delete [] m_buffer_lists;
 
+   ::close(m_epoll_fd);
+
    for (SInt32 i = 0; i < m_num_procs; i++)
    {
       m_recv_sockets[i].close();
       m_send_sockets[i].close();
+      delete [] m_recv_buffers[i].data;
    }
    m_server_socket.close();
    
-   delete [] m_recv_locks;
+   delete [] m_recv_buffers;
    delete [] m_recv_sockets;
-   delete [] m_send_locks;
+   delete [] m_send_queues;
    delete [] m_send_sockets;
 }
 
@@ -300,18 +494,24 @@ void SockTransport::barrier()
 
    LOG_PRINT("Entering transport barrier");
 
-   Socket &sock = m_send_sockets[(m_proc_index+1) % m_num_procs];
-   SInt32 message[] = { sizeof(SInt32), BARRIER_TAG, 0 };
+   SInt32 next_proc = (m_proc_index+1) % m_num_procs;
+   SInt32 message = 0;
 
    if (m_proc_index != 0)
       m_barrier_sem.wait();
 
-   sock.send(message, sizeof(message));
+   Byte *buffer = PacketBuffer::allocate(sizeof(message));
+   memcpy(buffer, &message, sizeof(message));
+   queueMessage(next_proc, BARRIER_TAG, buffer);
 
    m_barrier_sem.wait();
 
    if (m_proc_index != m_num_procs - 1)
-      sock.send(message, sizeof(message));
+   {
+      buffer = PacketBuffer::allocate(sizeof(message));
+      memcpy(buffer, &message, sizeof(message));
+      queueMessage(next_proc, BARRIER_TAG, buffer);
+   }
 
    LOG_PRINT("Exiting transport barrier");
 }
@@ -348,6 +548,31 @@ void SockTransport::SockNode::send(tile_id_t dest_tile,
    send(dest_proc, dest_tile, buffer, length);
 }
 
+void SockTransport::SockNode::sendBuffer(tile_id_t dest_tile,
+                                         Byte *buffer)
+{
+   int dest_proc = Config::getSingleton()->getProcessNumForTile(dest_tile);
+
+   if (dest_proc == m_transport->m_proc_index)
+   {
+      // Local destination: queue the buffer itself, the receiver
+      // drops our reference
+#ifdef __CHECKSUM_ENABLED__
+      UInt32 length = PacketBuffer::getLength(buffer);
+      Header* header = new Header(length, computeCheckSum(buffer, length));
+      m_transport->insertInBufferList(dest_tile, buffer, header);
+#else
+      m_transport->insertInBufferList(dest_tile, buffer);
+#endif // __CHECKSUM_ENABLED__
+
+      LOG_PRINT("Message sent.");
+   }
+   else
+   {
+      m_transport->queueMessage(dest_proc, dest_tile, buffer);
+   }
+}
+
 Byte* SockTransport::SockNode::recv()
 {
    LOG_PRINT("Entering recv");
@@ -413,7 +638,7 @@ void SockTransport::SockNode::send(SInt32 dest_proc,
 
    if (dest_proc == m_transport->m_proc_index)
    {
-      Byte *buff_cpy = new Byte[length];
+      Byte *buff_cpy = PacketBuffer::allocate(length);
       memcpy(buff_cpy, buffer, length);
 
 #ifdef __CHECKSUM_ENABLED__
@@ -425,30 +650,9 @@ void SockTransport::SockNode::send(SInt32 dest_proc,
    }
    else
    {
-#ifdef __CHECKSUM_ENABLED__
-      SInt32 pkt_len = sizeof(length) + sizeof(tag) + length + sizeof(checksum);
-#else
-      SInt32 pkt_len = sizeof(length) + sizeof(tag) + length;
-#endif // __CHECKSUM_ENABLED__
-
-      Byte *pkt_buff = new Byte[pkt_len];
-
-      // Length, Tag, Data, (Checksum)
-      Packet *p = (Packet*)pkt_buff;
-      
-      p->length = length;
-      p->tag = tag;
-      memcpy(&p->data, buffer, length);
-
-#ifdef __CHECKSUM_ENABLED__
-      memcpy(&p->data + length, &checksum, sizeof(checksum));
-#endif // __CHECKSUM_ENABLED__
-
-      m_transport->m_send_locks[dest_proc].acquire();
-      m_transport->m_send_sockets[dest_proc].send(pkt_buff, pkt_len);
-      m_transport->m_send_locks[dest_proc].release();
-
-      delete [] pkt_buff;
+      Byte *buff_cpy = PacketBuffer::allocate(length);
+      memcpy(buff_cpy, buffer, length);
+      m_transport->queueMessage(dest_proc, tag, buff_cpy);
    }
 
    LOG_PRINT("Message sent.");
@@ -571,6 +775,47 @@ void SockTransport::Socket::send(const void* buffer, UInt32 length)
    LOG_ASSERT_ERROR(sent == SInt32(length), "Failure sending packet on socket %d -- %d != %d", m_socket, sent, length);
 }
 
+void SockTransport::Socket::sendv(struct iovec *iov, UInt32 iov_count)
+{
+   // writev() may stop anywhere, so resume from the first unsent byte
+   while (iov_count > 0)
+   {
+      ssize_t sent = ::writev(m_socket, iov, iov_count);
+      if (sent < 0)
+      {
+         LOG_ASSERT_ERROR(errno == EINTR, "Failure sending packets on socket %d -- errno(%d)", m_socket, errno);
+         continue;
+      }
+
+      while (iov_count > 0 && (size_t) sent >= iov->iov_len)
+      {
+         sent -= iov->iov_len;
+         iov ++;
+         iov_count --;
+      }
+      if (iov_count > 0)
+      {
+         iov->iov_base = (Byte*) iov->iov_base + sent;
+         iov->iov_len -= sent;
+      }
+   }
+}
+
+SInt32 SockTransport::Socket::recvAvailable(void *buffer, UInt32 length)
+{
+   if (length == 0)
+      return 0;
+
+   SInt32 recvd = ::recv(m_socket, buffer, length, MSG_DONTWAIT);
+   if (recvd < 0)
+   {
+      LOG_ASSERT_ERROR(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR,
+                       "Error on socket(%i): errno(%d)", m_socket, errno);
+      return 0;
+   }
+   return (recvd == 0) ? -1 : recvd;
+}
+
 bool SockTransport::Socket::recv(void *buffer, UInt32 length, bool block)
 {
    SInt32 recvd;
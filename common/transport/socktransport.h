@@ -6,6 +6,8 @@
 #include "semaphore.h"
 
 #include <list>
+#include <vector>
+#include <sys/uio.h>
 
 class SockTransport : public Transport
 {
@@ -21,6 +23,7 @@ public:
 
       void globalSend(SInt32 dest_proc, const void *buffer, UInt32 length);
       void send(tile_id_t dest_tile, const void *buffer, UInt32 length);
+      void sendBuffer(tile_id_t dest_tile, Byte *buffer);
       Byte* recv();
       bool query();
 
@@ -30,19 +33,13 @@ public:
       SockTransport *m_transport;
    };
 
+
    Node *createNode(tile_id_t tile_id);
 
    void barrier();
    Node *getGlobalNode();
 
 private:
-   struct Packet
-   {
-      UInt32 length;
-      SInt32 tag;
-      Byte data;
-   } __attribute__((packed));
-
    struct Header
    {
       Header(UInt32 length, UInt64 checksum):
@@ -51,14 +48,56 @@ private:
       UInt32 m_length;
       UInt64 m_checksum;
    };
-   
+
+   // Wire format of a message: Length, Tag, Data, (Checksum)
+   struct MessageHeader
+   {
+      UInt32 length;
+      SInt32 tag;
+   } __attribute__((packed));
+
+   // A message waiting to be written out; 'buffer' is a PacketBuffer
+   struct OutgoingMessage
+   {
+      MessageHeader header;
+      Byte *buffer;
+      UInt64 checksum;
+   };
+
+   // Messages to a process are queued and written out in batches with
+   // writev() by whichever sender finds the queue idle
+   struct SendQueue
+   {
+      SendQueue() : flushing(false) {}
+
+      Lock lock;
+      std::vector<OutgoingMessage> pending;
+      bool flushing;
+   };
+
+   // Bytes read from a process socket that have not been parsed yet
+   struct RecvBuffer
+   {
+      RecvBuffer() : data(NULL), start(0), end(0) {}
+
+      Byte *data;
+      UInt32 start;
+      UInt32 end;
+   };
+
    void getProcInfo();
    void initSockets();
    void initBufferLists();
    void insertInBufferList(SInt32 tag, Byte *buffer, Header* header = NULL);
 
+   void queueMessage(SInt32 dest_proc, SInt32 tag, Byte *buffer);
+   void flushSendQueue(SInt32 dest_proc, SendQueue &queue);
+
    static void updateThreadFunc(void *vp);
    void updateBufferLists();
+   bool drainSocket(SInt32 proc);
+   bool parseMessages(SInt32 proc);
+   bool handleMessage(SInt32 proc, SInt32 tag, Byte *buffer, UInt64 checksum);
    void terminateUpdateThread();
 
    class Socket
@@ -75,7 +114,13 @@ private:
       void connect(const char *addr, SInt32 port);
 
       void send(const void* buffer, UInt32 length);
+      void sendv(struct iovec *iov, UInt32 iov_count);
       bool recv(void *buffer, UInt32 length, bool block);
+      // Reads whatever is available (up to length) without blocking;
+      // returns -1 once the peer has closed the connection
+      SInt32 recvAvailable(void *buffer, UInt32 length);
+
+      SInt32 getDescriptor() const { return m_socket; }
 
       void close();
 
@@ -93,6 +138,9 @@ private:
    };
 
    static const SInt32 DEFAULT_BASE_PORT = 2000;
+   static const UInt32 RECV_BUFFER_SIZE = 1 << 20;
+   static const UInt32 MAX_IOVECS_PER_WRITE = 512;
+   static const SInt32 MAX_EPOLL_EVENTS = 64;
    static const SInt32 GLOBAL_TAG = -1;
    static const SInt32 BARRIER_TAG = -2;
    static const SInt32 TERMINATE_TAG = -3;
@@ -106,11 +154,12 @@ private:
    Semaphore m_barrier_sem;
 
    Socket m_server_socket;
-   Lock *m_recv_locks;
    Socket *m_recv_sockets;
-   Lock *m_send_locks;
+   RecvBuffer *m_recv_buffers;
    Socket *m_send_sockets;
+   SendQueue *m_send_queues;
 
+   SInt32 m_epoll_fd;
    Thread *m_update_thread;
    UpdateThreadState m_update_thread_state;
 
@@ -6,15 +6,22 @@
 #include "smtransport.h"
 //#include "mpitransport.h"
 #include "socktransport.h"
+#include "shmringtransport.h"
+#include "packet_buffer.h"
 
 #include "config.h"
+#include "simulator.h"
 #include "log.h"
 
+using std::string;
+
 // -- Transport -- //
 
 Transport *Transport::m_singleton;
 
 Transport::Transport()
+   : m_ready_callback(NULL)
+   , m_ready_callback_obj(NULL)
 {
 }
 
@@ -22,20 +29,28 @@ Transport* Transport::create()
 {
    // dynamically choose the transport based on number of processes
    // this is required since MPICH seems to break in single-process mode
+   // The shared memory transport only works within a single process,
+   // so multi-process simulations fall back to sockets. Processes that
+   // all run on one host can use the shared memory rings instead.
 
    assert(m_singleton == NULL);
 
-   if (true)
+   string transport_type = Sim()->getCfg()->getString("transport/type", "socket");
+
+   if (Config::getSingleton()->getProcessCount() == 1 && transport_type == "shared_memory")
+      m_singleton = new SmTransport();
+
+   else if (transport_type == "shm_ring")
+      m_singleton = new ShmRingTransport();
+
+   else if (transport_type == "socket" || transport_type == "shared_memory")
       m_singleton = new SockTransport();
    
-   // else if (Config::getSingleton()->getProcessCount() == 1)
-   //    m_singleton = new SmTransport();
-
    // else if (Config::getSingleton()->getProcessCount() > 1)
    //    m_singleton = new MpiTransport();
    
    else
-      LOG_PRINT_ERROR("Negative no. processes ?!");
+      LOG_PRINT_ERROR("Unrecognized transport type(%s)", transport_type.c_str());
 
    return m_singleton;
 }
@@ -45,6 +60,14 @@ Transport* Transport::getSingleton()
    return m_singleton;
 }
 
+void Transport::setReadyCallback(ReadyCallback callback, void *obj)
+{
+   // Publish the object before the callback that uses it
+   m_ready_callback_obj = obj;
+   __sync_synchronize();
+   m_ready_callback = callback;
+}
+
 // -- Node -- //
 
 Transport::Node::Node(tile_id_t tile_id)
@@ -56,3 +79,9 @@ tile_id_t Transport::Node::getTileId()
 {
    return m_tile_id;
 }
+
+void Transport::Node::sendBuffer(tile_id_t dest, Byte *buffer)
+{
+   send(dest, buffer, PacketBuffer::getLength(buffer));
+   PacketBuffer::release(buffer);
+}
@@ -15,6 +15,10 @@ public:
 
       virtual void globalSend(SInt32 dest_proc, const void *buffer, UInt32 length) = 0;
       virtual void send(tile_id_t dest, const void *buffer, UInt32 length) = 0;
+      // Hands one reference to a PacketBuffer over to the transport,
+      // which may queue the buffer itself instead of copying it
+      virtual void sendBuffer(tile_id_t dest, Byte *buffer);
+      // Returns a PacketBuffer; release it with PacketBuffer::release()
       virtual Byte* recv() = 0;
       virtual bool query() = 0;
 
@@ -34,11 +38,26 @@ public:
    virtual void barrier() = 0;
    virtual Node* getGlobalNode() = 0; // for communication not linked to a tile
 
+   // Called (from any thread) after a buffer is queued for the node of a
+   // tile, so that a pool of sim threads can serve many nodes without
+   // blocking in recv() on each of them
+   typedef void (*ReadyCallback)(void *obj, tile_id_t tile_id);
+   void setReadyCallback(ReadyCallback callback, void *obj);
+
 protected:
    Transport();
 
+   void notifyReady(tile_id_t tile_id)
+   {
+      if (m_ready_callback)
+         m_ready_callback(m_ready_callback_obj, tile_id);
+   }
+
 private:
    static Transport *m_singleton;
+
+   ReadyCallback volatile m_ready_callback;
+   void *m_ready_callback_obj;
 };
 
 #endif // TRANSPORT_H
@@ -8,6 +8,8 @@
 #include "transport.h"
 #include "packetize.h"
 #include "message_types.h"
+#include "trace_recorder.h"
+#include "checkpoint.h"
 #include "log.h"
 
 void CarbonEnableModels()
@@ -15,6 +17,9 @@ void CarbonEnableModels()
    if (Sim()->getCfg()->getBool("general/trigger_models_within_application", false))
    {
       fprintf(stderr, "[[Graphite]] --> [ Enabling Performance and Power Models ]\n");
+
+      if (Sim()->getTraceRecorder())
+         Sim()->getTraceRecorder()->recordEvent(TraceFormat::ENABLE_MODELS);
       
       __attribute__((unused)) SInt32 curr_proc_num = Config::getSingleton()->getCurrentProcessNum();
       Core* core = Sim()->getTileManager()->getCurrentCore();
@@ -48,6 +53,9 @@ void CarbonDisableModels()
    if (Sim()->getCfg()->getBool("general/trigger_models_within_application", false))
    {
       fprintf(stderr, "[[Graphite]] --> [ Disabling Performance and Power Models ]\n");
+
+      if (Sim()->getTraceRecorder())
+         Sim()->getTraceRecorder()->recordEvent(TraceFormat::DISABLE_MODELS);
       
       __attribute__((unused)) SInt32 curr_proc_num = Config::getSingleton()->getCurrentProcessNum();
       Core* core = Sim()->getTileManager()->getCurrentCore();
@@ -74,4 +82,35 @@ void CarbonDisableModels()
          network->netRecvType(LCP_TOGGLE_PERFORMANCE_COUNTERS_ACK, core->getId());
       }
    }
-} 
+}
+
+void CarbonCheckpoint()
+{
+   if (Checkpoint::isEnabled())
+   {
+      __attribute__((unused)) SInt32 curr_proc_num = Config::getSingleton()->getCurrentProcessNum();
+      Core* core = Sim()->getTileManager()->getCurrentCore();
+      __attribute__((unused)) tile_id_t curr_tile_id = core->getTile()->getId();
+      
+      LOG_ASSERT_ERROR(curr_proc_num == 0 && curr_tile_id == 0, "Curr Process Num(%i), Curr Tile ID(%i)",
+                       curr_proc_num, curr_tile_id);
+
+      Network* network = core->getTile()->getNetwork();
+      Transport::Node *transport = Transport::getSingleton()->getGlobalNode();
+
+      UnstructuredBuffer send_buff;
+      send_buff << (SInt32) LCP_MESSAGE_TOGGLE_PERFORMACE_COUNTERS << (SInt32) PerformanceCounterManager::CHECKPOINT;
+      
+      // Send message to all processes to save or restore their checkpoint
+      for (SInt32 i = 0; i < (SInt32) Config::getSingleton()->getProcessCount(); i++)
+      {
+         transport->globalSend(i, send_buff.getBuffer(), send_buff.size());
+      }
+      
+      // Collect ACKs from all processes after the checkpoint is done
+      for (SInt32 i = 0; i < (SInt32) Config::getSingleton()->getProcessCount(); i++)
+      {
+         network->netRecvType(LCP_TOGGLE_PERFORMANCE_COUNTERS_ACK, core->getId());
+      }
+   }
+}
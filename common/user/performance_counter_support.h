@@ -7,6 +7,8 @@ extern "C" {
 
 void CarbonEnableModels(void);
 void CarbonDisableModels(void);
+// Saves or restores the checkpoint of the models here ([checkpoint])
+void CarbonCheckpoint(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,42 @@
+#ifndef CORE_MAP_H
+#define CORE_MAP_H
+
+#include <pin.H>
+
+#include "log.h"
+
+class Core;
+
+// Core of each application thread, indexed by the Pin thread id. A thread
+// sets its own entry in threadStartCallback() before it runs any
+// instrumented code and only ever looks up its own entry from the analysis
+// routines, so lookups are a plain array read, without a lock or a search.
+class CoreMap
+{
+public:
+   CoreMap()
+   {
+      for (UInt32 i = 0; i < PIN_MAX_THREADS; i++)
+         _cores[i] = NULL;
+   }
+
+   Core* get(THREADID thread_id) const
+   { return _cores[thread_id]; }
+
+   void insert(THREADID thread_id, Core* core)
+   {
+      LOG_ASSERT_ERROR(thread_id < PIN_MAX_THREADS, "Thread id(%u) out of range", thread_id);
+      _cores[thread_id] = core;
+   }
+
+   void erase(THREADID thread_id)
+   {
+      LOG_ASSERT_ERROR(thread_id < PIN_MAX_THREADS, "Thread id(%u) out of range", thread_id);
+      _cores[thread_id] = NULL;
+   }
+
+private:
+   Core* _cores[PIN_MAX_THREADS];
+};
+
+#endif
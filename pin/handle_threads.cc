@@ -3,9 +3,9 @@
 #include "tile_manager.h"
 #include "tile.h"
 #include "thread_scheduler.h"
-#include "hash_map.h"
+#include "core_map.h"
 
-extern HashMap core_map;
+extern CoreMap core_map;
 
 static bool enabled()
 {
@@ -19,7 +19,7 @@ void handleYield(THREADID thread_id)
    if (!Sim()->isEnabled())
       return;
 
-   Core* core = core_map.get<Core>(thread_id);
+   Core* core = core_map.get(thread_id);
    assert(core);
    if (core->getTile()->getId() >= (tile_id_t) Sim()->getConfig()->getApplicationTiles())
    {
@@ -5,17 +5,17 @@
 #include "tile.h"
 #include "core.h"
 #include "core_model.h"
-#include "hash_map.h"
+#include "core_map.h"
 #include "mcpat_core_helper.h"
 
-extern HashMap core_map;
+extern CoreMap core_map;
 
 void handleInstruction(THREADID thread_id, Instruction* instruction)
 {
    if (!Sim()->isEnabled())
       return;
 
-   CoreModel *core_model = core_map.get<Core>(thread_id)->getModel();
+   CoreModel *core_model = core_map.get(thread_id)->getModel();
    core_model->queueInstruction(instruction);
    core_model->iterate();
 }
@@ -25,7 +25,7 @@ void handleBranch(THREADID thread_id, BOOL taken, ADDRINT target)
    if (!Sim()->isEnabled())
       return;
 
-   CoreModel *core_model = core_map.get<Core>(thread_id)->getModel();
+   CoreModel *core_model = core_map.get(thread_id)->getModel();
    DynamicBranchInfo info(taken, target);
    core_model->pushDynamicBranchInfo(info);
 }
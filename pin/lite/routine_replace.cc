@@ -54,6 +54,22 @@ void routineCallback(RTN rtn, void* v)
       PROTO_Free(proto);
    }
 
+   // Checkpoint
+   if (rtn_name == "CarbonCheckpoint")
+   {
+      PROTO proto = PROTO_Allocate(PIN_PARG(void),
+            CALLINGSTD_DEFAULT,
+            "CarbonCheckpoint",
+            PIN_PARG_END());
+
+      RTN_ReplaceSignature(rtn,
+            AFUNPTR(CarbonCheckpoint),
+            IARG_PROTOTYPE, proto,
+            IARG_END);
+
+      PROTO_Free(proto);
+   }
+
    // _start
    if (rtn_name == "_start")
    {
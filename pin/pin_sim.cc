@@ -47,7 +47,7 @@
 #include "runtime_energy_monitoring.h"
 #include "redirect_memory.h"
 #include "handle_syscalls.h"
-#include "hash_map.h"
+#include "core_map.h"
 #include <typeinfo>
 
 // lite directories
@@ -71,7 +71,7 @@ extern PIN_LOCK clone_memory_update_lock;
 map <ADDRINT, string> rtn_map;
 PIN_LOCK rtn_map_lock;
 
-HashMap core_map;
+CoreMap core_map;
 // ---------------------------------------------------------------
 
 void printRtn (ADDRINT rtn_addr, bool enter)
@@ -108,8 +108,7 @@ void routineCallback(RTN rtn, void *v)
 
    // ---------------------------------------------------------------
 
-   std::string module = Log::getSingleton()->getModule(__FILE__);
-   if (Log::getSingleton()->isEnabled(module.c_str()) &&
+   if (Log::getSingleton()->isEnabled(Log::getModuleId(__FILE__)) &&
        Sim()->getCfg()->getBool("log/stack_trace",false))
    {
       RTN_Open (rtn);
@@ -4,15 +4,15 @@
 #include "core.h"
 #include "pin_memory_manager.h"
 #include "core_model.h"
-#include "hash_map.h"
+#include "core_map.h"
 
-extern HashMap core_map;
+extern CoreMap core_map;
 
 void memOp(THREADID thread_id, Core::lock_signal_t lock_signal, Core::mem_op_t mem_op_type, IntPtr d_addr, char *data_buffer, UInt32 data_size, BOOL push_info)
 {   
    assert (lock_signal == Core::NONE);
    assert(thread_id != INVALID_THREADID);
-   Core *core = core_map.get<Core>(thread_id);
+   Core *core = core_map.get(thread_id);
    assert(core);
    core->accessMemory(lock_signal, mem_op_type, d_addr, data_buffer, data_size, push_info);
 }
@@ -374,7 +374,7 @@ ADDRINT redirectPushf(THREADID thread_id, ADDRINT tgt_esp, ADDRINT size)
 {
    assert (size == sizeof (ADDRINT));
 
-   Core *core = core_map.get<Core>(thread_id);
+   Core *core = core_map.get(thread_id);
    assert(core); 
    return core->getPinMemoryManager()->redirectPushf(tgt_esp, size);
 }
@@ -383,7 +383,7 @@ ADDRINT completePushf(THREADID thread_id, ADDRINT esp, ADDRINT size)
 {
    assert (size == sizeof(ADDRINT));
    
-   Core *core = core_map.get<Core>(thread_id);
+   Core *core = core_map.get(thread_id);
    assert(core);
    return core->getPinMemoryManager()->completePushf(esp, size);
 }
@@ -392,7 +392,7 @@ ADDRINT redirectPopf(THREADID thread_id, ADDRINT tgt_esp, ADDRINT size)
 {
    assert (size == sizeof (ADDRINT));
 
-   Core *core = core_map.get<Core>(thread_id);
+   Core *core = core_map.get(thread_id);
    assert(core);
    return core->getPinMemoryManager()->redirectPopf(tgt_esp, size);
 }
@@ -401,14 +401,14 @@ ADDRINT completePopf(THREADID thread_id, ADDRINT esp, ADDRINT size)
 {
    assert (size == sizeof (ADDRINT));
    
-   Core *core = core_map.get<Core>(thread_id);
+   Core *core = core_map.get(thread_id);
    assert(core);
    return core->getPinMemoryManager()->completePopf(esp, size);
 }
 
 ADDRINT redirectMemOp(THREADID thread_id, bool has_lock_prefix, ADDRINT tgt_ea, ADDRINT size, UInt32 op_num, bool is_read)
 {
-   Core *core = core_map.get<Core>(thread_id);
+   Core *core = core_map.get(thread_id);
    assert(core);
    PinMemoryManager *mem_manager = core->getPinMemoryManager();
    return (ADDRINT) mem_manager->redirectMemOp(has_lock_prefix, (IntPtr) tgt_ea, (IntPtr) size, op_num, is_read);
@@ -421,7 +421,7 @@ ADDRINT redirectMemOpSaveEa(ADDRINT ea)
 
 VOID completeMemWrite(THREADID thread_id, bool has_lock_prefix, ADDRINT tgt_ea, ADDRINT size, UInt32 op_num)
 {
-   Core *core = core_map.get<Core>(thread_id);
+   Core *core = core_map.get(thread_id);
    assert(core);
    core->getPinMemoryManager()->completeMemWrite (has_lock_prefix, (IntPtr) tgt_ea, (IntPtr) size, op_num);
 }
@@ -82,6 +82,7 @@ bool replaceUserAPIFunction(RTN& rtn, string& name)
    // Enable/Disable/Reset Models
    else if (name == "CarbonEnableModels") msg_ptr = AFUNPTR(replacementEnableModels);
    else if (name == "CarbonDisableModels") msg_ptr = AFUNPTR(replacementDisableModels);
+   else if (name == "CarbonCheckpoint") msg_ptr = AFUNPTR(replacementCheckpoint);
 
    // pthread wrappers
    else if (name.find("pthread_create") != std::string::npos) msg_ptr = AFUNPTR(replacementPthreadCreate);
@@ -859,6 +860,14 @@ void replacementDisableModels(CONTEXT* ctxt)
    retFromReplacedRtn(ctxt, ret_val);
 }
 
+void replacementCheckpoint(CONTEXT* ctxt)
+{
+   CarbonCheckpoint();
+
+   ADDRINT ret_val = PIN_GetContextReg(ctxt, REG_GAX);
+   retFromReplacedRtn(ctxt, ret_val);
+}
+
 void replacementCarbonGetTime(CONTEXT *ctxt)
 {
    UInt64 ret_val = CarbonGetTime();
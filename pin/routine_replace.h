@@ -57,6 +57,7 @@ void replacementPthreadExitNull(CONTEXT *ctxt);
 // Enable/Disable Models
 void replacementEnableModels(CONTEXT* ctxt);
 void replacementDisableModels(CONTEXT* ctxt);
+void replacementCheckpoint(CONTEXT* ctxt);
 
 // Cache Counters
 void replacementResetCacheCounters(CONTEXT *ctxt);
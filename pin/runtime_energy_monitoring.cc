@@ -8,9 +8,9 @@
 #include "tile.h"
 #include "core.h"
 #include "tile_energy_monitor.h"
-#include "hash_map.h"
+#include "core_map.h"
 
-extern HashMap core_map;
+extern CoreMap core_map;
 
 static bool enabled()
 {
@@ -22,7 +22,7 @@ void handleRuntimeEnergyMonitoring(THREADID thread_id)
    if (!Sim()->isEnabled())
       return;
 
-   Core* core = core_map.get<Core>(thread_id);
+   Core* core = core_map.get(thread_id);
    assert(core);
    Tile* tile = core->getTile();
    if (tile->getId() >= (tile_id_t) Sim()->getConfig()->getApplicationTiles())
@@ -0,0 +1,72 @@
+// Measures the host time taken by the history-list and history-tree queue
+// models per computeQueueDelay() call, against the number of free intervals
+// kept by each model (max_list_size), at several offered loads
+#include <cstdio>
+#include <cstdlib>
+#include <sys/time.h>
+#include "carbon_user.h"
+#include "simulator.h"
+#include "fixed_types.h"
+#include "queue_model_history_tree.h"
+#include "queue_model_history_list.h"
+
+#define NUM_PACKETS        250000
+#define MAX_PROCESSING_TIME 20
+#define MIN_LIST_SIZE       16
+#define MAX_LIST_SIZE       4096
+
+static UInt64 getHostTime()
+{
+   struct timeval t;
+   gettimeofday(&t, NULL);
+   return ((UInt64) t.tv_sec) * 1000000 + t.tv_usec;
+}
+
+// Packets arrive out of order around a slowly advancing time, so that
+// the queue stays congested and keeps many free intervals
+template <class QueueModel>
+void runBenchmark(const char* name, UInt32 list_size, UInt32 load_percent)
+{
+   QueueModel queue_model(1);
+   srand(1);
+
+   UInt64 total_delay = 0;
+   UInt64 start_time = getHostTime();
+   for (UInt32 i = 0; i < NUM_PACKETS; i++)
+   {
+      UInt64 processing_time = 1 + (rand() % MAX_PROCESSING_TIME);
+      UInt64 base_time = ((UInt64) i) * (MAX_PROCESSING_TIME / 2) * 100 / load_percent;
+      UInt64 pkt_time = base_time + (rand() % 1000);
+      total_delay += queue_model.computeQueueDelay(pkt_time, processing_time);
+   }
+   UInt64 end_time = getHostTime();
+
+   printf("%s: List Size(%u), Load(%u%%), Time per Packet(%.1f ns), Total Delay(%llu)\n",
+          name, list_size, load_percent,
+          ((double) (end_time - start_time)) * 1000 / NUM_PACKETS,
+          (long long unsigned int) total_delay);
+}
+
+int main(int argc, char* argv[])
+{
+   CarbonStartSim(argc, argv);
+   printf("Starting Queue Model benchmark\n");
+
+   // The models read their list size from the config when they are built
+   UInt32 load_percent_list[] = {50, 90, 100};
+   for (UInt32 list_size = MIN_LIST_SIZE; list_size <= MAX_LIST_SIZE; list_size *= 2)
+   {
+      Sim()->getCfg()->set("queue_model/history_list/max_list_size", (int) list_size);
+      Sim()->getCfg()->set("queue_model/history_tree/max_list_size", (int) list_size);
+      for (UInt32 i = 0; i < sizeof(load_percent_list) / sizeof(UInt32); i++)
+      {
+         runBenchmark<QueueModelHistoryList>("History-List", list_size, load_percent_list[i]);
+         runBenchmark<QueueModelHistoryTree>("History-Tree", list_size, load_percent_list[i]);
+      }
+   }
+
+   printf("Queue Model benchmark: DONE\n");
+   CarbonStopSim();
+
+   return 0;
+}
@@ -0,0 +1,537 @@
+// Replays the memory accesses recorded with [caching_protocol] memory_trace =
+// true (see common/tile/memory_subsystem/memory_trace.h) through the L1-I,
+// L1-D and L2 caches of many cache configurations at once, without cores,
+// the network or Pin. The configurations are split among host threads, and
+// each thread makes a single pass over the traces for all of its
+// configurations.
+//
+// Usage: cache_replay -t <output directory of the recording> [-f <configurations>] [-j <threads>] -c <config> [...]
+//   or:  make -C tools/cache_replay TRACE_DIR=<output directory of the recording> CONFIGS=<configurations>
+//
+// Each line of the configurations file is
+//   <name> <L1-I size> <L1-I associativity> <L1-D size> <L1-D associativity> <L2 size> <L2 associativity>
+// with the sizes in KB. The other cache parameters (line size, replacement
+// policy, ...) are the ones of tile 0 in the simulator configuration. Without
+// a configurations file, the caches of the simulator configuration are used.
+//
+// The caches of every tile are private, as in pr_l1_pr_l2_dram_directory_msi:
+// the L2 is inclusive of the L1 caches, a write invalidates the line in the
+// other tiles, and a read downgrades it there. The accesses of the tiles are
+// merged by time. Only the cache contents and counters are modeled: there are
+// no latencies, directory or network.
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <pthread.h>
+#include <queue>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <functional>
+
+#include "carbon_user.h"
+#include "simulator.h"
+#include "config.h"
+#include "cache.h"
+#include "cache_line_info.h"
+#include "cache_replacement_policy.h"
+#include "cache_hash_fn.h"
+#include "pr_l1_pr_l2_dram_directory_msi/cache_level.h"
+#include "memory_trace.h"
+#include "statistics_registry.h"
+#include "log.h"
+
+using namespace std;
+
+// Parameters of one cache, read from a section of the config file
+class CacheParams
+{
+public:
+   CacheParams(string section)
+   {
+      try
+      {
+         _line_size = Sim()->getCfg()->getInt(section + "/cache_line_size");
+         _size = Sim()->getCfg()->getInt(section + "/cache_size");
+         _associativity = Sim()->getCfg()->getInt(section + "/associativity");
+         _num_banks = Sim()->getCfg()->getInt(section + "/num_banks");
+         _replacement_policy = Sim()->getCfg()->getString(section + "/replacement_policy");
+         _data_access_cycles = Sim()->getCfg()->getInt(section + "/data_access_time");
+         _tags_access_cycles = Sim()->getCfg()->getInt(section + "/tags_access_time");
+         _perf_model_type = Sim()->getCfg()->getString(section + "/perf_model_type");
+         _track_miss_types = Sim()->getCfg()->getBool(section + "/track_miss_types");
+      }
+      catch (...)
+      {
+         LOG_PRINT_ERROR("Error reading cache parameters from [%s] in the config file", section.c_str());
+      }
+   }
+
+   UInt32 _line_size;
+   UInt32 _size;                 // In KB
+   UInt32 _associativity;
+   UInt32 _num_banks;
+   string _replacement_policy;
+   UInt32 _data_access_cycles;
+   UInt32 _tags_access_cycles;
+   string _perf_model_type;
+   bool _track_miss_types;
+};
+
+class CacheConfig
+{
+public:
+   CacheConfig(string name, const CacheParams& l1_icache, const CacheParams& l1_dcache, const CacheParams& l2_cache)
+      : _name(name), _l1_icache(l1_icache), _l1_dcache(l1_dcache), _l2_cache(l2_cache) {}
+
+   string _name;
+   CacheParams _l1_icache;
+   CacheParams _l1_dcache;
+   CacheParams _l2_cache;
+};
+
+// A cache with the replacement policy and hash function it uses
+class ReplayCache
+{
+public:
+   ReplayCache(string name, Cache::CacheCategory cache_category, SInt32 cache_level, Cache::WritePolicy write_policy,
+               const CacheParams& params)
+   {
+      _replacement_policy = CacheReplacementPolicy::create(params._replacement_policy, params._size,
+                                                           params._associativity, params._line_size);
+      _hash_fn = new CacheHashFn(params._size, params._associativity, params._line_size);
+      _cache = new Cache(name, PR_L1_PR_L2_DRAM_DIRECTORY_MSI, cache_category, cache_level, write_policy,
+                         params._size, params._associativity, params._line_size, params._num_banks,
+                         _replacement_policy, _hash_fn, params._data_access_cycles, params._tags_access_cycles,
+                         params._perf_model_type, params._track_miss_types);
+      _line_info = CacheLineInfo::create(PR_L1_PR_L2_DRAM_DIRECTORY_MSI, cache_level);
+      _evicted_line_info = CacheLineInfo::create(PR_L1_PR_L2_DRAM_DIRECTORY_MSI, cache_level);
+   }
+
+   ~ReplayCache()
+   {
+      delete _line_info;
+      delete _evicted_line_info;
+      delete _cache;
+      delete _replacement_policy;
+      delete _hash_fn;
+   }
+
+   Cache* getCache() { return _cache; }
+
+   CacheState::Type getCState(IntPtr address)
+   {
+      _line_info->invalidate();
+      _cache->getCacheLineInfo(address, _line_info);
+      return _line_info->getCState();
+   }
+
+   // Call after getCState() on the same address
+   void setCState(IntPtr address, CacheState::Type cstate)
+   {
+      _line_info->setCState(cstate);
+      _cache->setCacheLineInfo(address, _line_info);
+   }
+
+   void invalidate(IntPtr address)
+   {
+      if (getCState(address) == CacheState::INVALID)
+         return;
+      _line_info->invalidate();
+      _cache->setCacheLineInfo(address, _line_info);
+   }
+
+   // Returns the address of the evicted line, or INVALID_ADDRESS
+   IntPtr insert(IntPtr address, CacheState::Type cstate)
+   {
+      _line_info->invalidate();
+      _line_info->setTag(_cache->getTag(address));
+      _line_info->setCState(cstate);
+
+      bool eviction;
+      IntPtr evicted_address;
+      _cache->insertCacheLine(address, _line_info, NULL, &eviction, &evicted_address, _evicted_line_info, NULL);
+      return eviction ? evicted_address : INVALID_ADDRESS;
+   }
+
+private:
+   Cache* _cache;
+   CacheReplacementPolicy* _replacement_policy;
+   CacheHashFn* _hash_fn;
+   CacheLineInfo* _line_info;
+   CacheLineInfo* _evicted_line_info;
+};
+
+// The private caches of a tile
+class CacheHierarchy
+{
+public:
+   CacheHierarchy(const CacheConfig& config)
+      : _enabled(false)
+   {
+      _l1_icache = new ReplayCache("L1-I", Cache::INSTRUCTION_CACHE, PrL1PrL2DramDirectoryMSI::L1,
+                                   Cache::UNDEFINED_WRITE_POLICY, config._l1_icache);
+      _l1_dcache = new ReplayCache("L1-D", Cache::DATA_CACHE, PrL1PrL2DramDirectoryMSI::L1,
+                                   Cache::WRITE_THROUGH, config._l1_dcache);
+      _l2_cache = new ReplayCache("L2", Cache::UNIFIED_CACHE, PrL1PrL2DramDirectoryMSI::L2,
+                                  Cache::WRITE_BACK, config._l2_cache);
+   }
+
+   ~CacheHierarchy()
+   {
+      delete _l1_icache;
+      delete _l1_dcache;
+      delete _l2_cache;
+   }
+
+   void setEnabled(bool enabled)
+   {
+      if (enabled == _enabled)
+         return;
+      _enabled = enabled;
+      Cache* caches[] = { _l1_icache->getCache(), _l1_dcache->getCache(), _l2_cache->getCache() };
+      for (UInt32 i = 0; i < 3; i++)
+      {
+         if (enabled)
+            caches[i]->enable();
+         else
+            caches[i]->disable();
+      }
+   }
+
+   // Returns true if the line had to be requested from the other tiles
+   bool access(MemComponent::Type mem_component, Core::mem_op_t mem_op, IntPtr address)
+   {
+      ReplayCache* l1_cache = (mem_component == MemComponent::L1_ICACHE) ? _l1_icache : _l1_dcache;
+      bool write = (mem_op != Core::READ);
+      bool l2_miss = false;
+
+      CacheState l1_cstate = l1_cache->getCState(address);
+      bool l1_hit = write ? l1_cstate.writable() : l1_cstate.readable();
+      l1_cache->getCache()->updateMissCounters(address, mem_op, !l1_hit);
+
+      if (!l1_hit)
+      {
+         l1_cache->invalidate(address);
+
+         CacheState::Type l2_cstate = _l2_cache->getCState(address);
+         bool l2_hit = write ? CacheState(l2_cstate).writable() : CacheState(l2_cstate).readable();
+         _l2_cache->getCache()->updateMissCounters(address, mem_op, !l2_hit);
+
+         CacheState::Type cstate = l2_cstate;
+         if (!l2_hit)
+         {
+            l2_miss = true;
+            cstate = write ? CacheState::MODIFIED : CacheState::SHARED;
+            if (l2_cstate != CacheState::INVALID)
+            {
+               _l2_cache->setCState(address, cstate);
+            }
+            else
+            {
+               // The L2 is inclusive of the L1 caches
+               IntPtr evicted_address = _l2_cache->insert(address, cstate);
+               if (evicted_address != INVALID_ADDRESS)
+               {
+                  _l1_icache->invalidate(evicted_address);
+                  _l1_dcache->invalidate(evicted_address);
+               }
+            }
+         }
+         _l2_cache->getCache()->accessCacheLine(address, Cache::LOAD);
+
+         l1_cache->insert(address, cstate);
+      }
+
+      l1_cache->getCache()->accessCacheLine(address, write ? Cache::STORE : Cache::LOAD);
+      return l2_miss;
+   }
+
+   // Requests from the other tiles
+   void invalidate(IntPtr address)
+   {
+      _l1_icache->invalidate(address);
+      _l1_dcache->invalidate(address);
+      _l2_cache->invalidate(address);
+   }
+
+   void downgrade(IntPtr address)
+   {
+      if (_l2_cache->getCState(address) != CacheState::MODIFIED)
+         return;
+      _l2_cache->setCState(address, CacheState::SHARED);
+      ReplayCache* l1_caches[] = { _l1_icache, _l1_dcache };
+      for (UInt32 i = 0; i < 2; i++)
+      {
+         if (l1_caches[i]->getCState(address) == CacheState::MODIFIED)
+            l1_caches[i]->setCState(address, CacheState::SHARED);
+      }
+   }
+
+   void registerStatistics(StatisticsRegistry* registry)
+   {
+      _l1_icache->getCache()->registerStatistics(registry);
+      _l1_dcache->getCache()->registerStatistics(registry);
+      _l2_cache->getCache()->registerStatistics(registry);
+   }
+
+private:
+   bool _enabled;
+   ReplayCache* _l1_icache;
+   ReplayCache* _l1_dcache;
+   ReplayCache* _l2_cache;
+};
+
+// The caches of all the tiles for one configuration
+class CacheSweep
+{
+public:
+   CacheSweep(const CacheConfig& config, SInt32 num_tiles)
+      : _config(config)
+   {
+      for (SInt32 i = 0; i < num_tiles; i++)
+      {
+         _hierarchies.push_back(new CacheHierarchy(config));
+         _registries.push_back(new StatisticsRegistry(i));
+         _hierarchies.back()->registerStatistics(_registries.back());
+      }
+   }
+
+   ~CacheSweep()
+   {
+      for (UInt32 i = 0; i < _hierarchies.size(); i++)
+      {
+         delete _registries[i];
+         delete _hierarchies[i];
+      }
+   }
+
+   const string& getName() const { return _config._name; }
+
+   void access(tile_id_t tile_id, const MemoryTrace::Record& record)
+   {
+      CacheHierarchy* hierarchy = _hierarchies[tile_id];
+      hierarchy->setEnabled(record.enabled);
+      if (!hierarchy->access(record.mem_component, record.mem_op, record.address))
+         return;
+
+      for (tile_id_t i = 0; i < (tile_id_t) _hierarchies.size(); i++)
+      {
+         if (i == tile_id)
+            continue;
+         if (record.mem_op == Core::READ)
+            _hierarchies[i]->downgrade(record.address);
+         else
+            _hierarchies[i]->invalidate(record.address);
+      }
+   }
+
+   // Sum of a counter of a cache over all the tiles
+   UInt64 getTotal(const string& component, const string& name) const
+   {
+      UInt64 total = 0;
+      for (UInt32 i = 0; i < _registries.size(); i++)
+      {
+         for (UInt32 j = 0; j < _registries[i]->getNumCounters(); j++)
+         {
+            if ( (_registries[i]->getComponent(j) == component) && (_registries[i]->getName(j) == name) )
+               total += _registries[i]->read(j);
+         }
+      }
+      return total;
+   }
+
+   void outputCSV(ostream& os) const
+   {
+      vector<StatisticsRegistry::ValueList> tile_values(_registries.size());
+      for (UInt32 i = 0; i < _registries.size(); i++)
+      {
+         ostringstream serialized;
+         _registries[i]->serialize(serialized);
+         StatisticsRegistry::deserialize(serialized.str(), tile_values[i]);
+      }
+      StatisticsRegistry::outputCSV(os, tile_values);
+   }
+
+private:
+   CacheConfig _config;
+   vector<CacheHierarchy*> _hierarchies;
+   vector<StatisticsRegistry*> _registries;
+};
+
+static string _trace_directory;
+static string _configs_filename;
+static SInt32 _num_threads = 0;
+static SInt32 _num_tiles;
+
+class Shard
+{
+public:
+   vector<CacheSweep*> _sweeps;
+   UInt64 _num_records;
+};
+
+// Single pass over the traces for all the configurations of a shard
+static void* replayShard(void* arg)
+{
+   Shard* shard = (Shard*) arg;
+
+   vector<MemoryTraceReader*> readers;
+   vector<MemoryTrace::Record> records(_num_tiles);
+   // Next record of every tile, earliest first
+   typedef pair<UInt64, tile_id_t> Event;
+   priority_queue<Event, vector<Event>, greater<Event> > events;
+   for (tile_id_t i = 0; i < _num_tiles; i++)
+   {
+      ostringstream filename;
+      filename << _trace_directory << "/memory_trace_" << i << ".trc";
+      readers.push_back(new MemoryTraceReader(filename.str()));
+      if (readers[i]->next(records[i]))
+         events.push(make_pair(records[i].time, i));
+   }
+
+   shard->_num_records = 0;
+   while (!events.empty())
+   {
+      tile_id_t tile_id = events.top().second;
+      events.pop();
+
+      for (vector<CacheSweep*>::iterator it = shard->_sweeps.begin(); it != shard->_sweeps.end(); it++)
+         (*it)->access(tile_id, records[tile_id]);
+      shard->_num_records ++;
+
+      if (readers[tile_id]->next(records[tile_id]))
+         events.push(make_pair(records[tile_id].time, tile_id));
+   }
+
+   for (tile_id_t i = 0; i < _num_tiles; i++)
+      delete readers[i];
+   return NULL;
+}
+
+static void readConfigs(vector<CacheConfig>& configs)
+{
+   CacheParams l1_icache("l1_icache/" + Config::getSingleton()->getL1ICacheType(0));
+   CacheParams l1_dcache("l1_dcache/" + Config::getSingleton()->getL1DCacheType(0));
+   CacheParams l2_cache("l2_cache/" + Config::getSingleton()->getL2CacheType(0));
+
+   if (_configs_filename == "")
+   {
+      configs.push_back(CacheConfig("default", l1_icache, l1_dcache, l2_cache));
+      return;
+   }
+
+   ifstream file(_configs_filename.c_str());
+   LOG_ASSERT_ERROR(file.good(), "Could not open configurations file(%s)", _configs_filename.c_str());
+
+   string line;
+   while (getline(file, line))
+   {
+      if (line.find('#') != string::npos)
+         line = line.substr(0, line.find('#'));
+
+      istringstream fields(line);
+      string name;
+      if (!(fields >> name))
+         continue;
+
+      CacheConfig config(name, l1_icache, l1_dcache, l2_cache);
+      fields >> config._l1_icache._size >> config._l1_icache._associativity
+             >> config._l1_dcache._size >> config._l1_dcache._associativity
+             >> config._l2_cache._size >> config._l2_cache._associativity;
+      LOG_ASSERT_ERROR(!fields.fail(), "Invalid configuration(%s) in %s", line.c_str(), _configs_filename.c_str());
+      configs.push_back(config);
+   }
+   LOG_ASSERT_ERROR(!configs.empty(), "No configurations in %s", _configs_filename.c_str());
+}
+
+static void printHelpMessage()
+{
+   fprintf(stderr, "[Usage]: ./cache_replay -t <arg1> -f <arg2> -j <arg3>\n");
+   fprintf(stderr, "where <arg1> = Output directory of a simulation run with [caching_protocol] memory_trace = true\n");
+   fprintf(stderr, " and  <arg2> = Cache configurations, one per line: <name> <L1-I KB> <L1-I ways> <L1-D KB> <L1-D ways> <L2 KB> <L2 ways> (default: the caches of the config file)\n");
+   fprintf(stderr, " and  <arg3> = Number of host threads (default: one per processor)\n");
+}
+
+int main(int argc, char* argv[])
+{
+   CarbonStartSim(argc, argv);
+
+   // Read Command Line Arguments
+   for (SInt32 i = 1; i < argc-1; i += 2)
+   {
+      if (string(argv[i]) == "-t")
+         _trace_directory = argv[i+1];
+      else if (string(argv[i]) == "-f")
+         _configs_filename = argv[i+1];
+      else if (string(argv[i]) == "-j")
+         _num_threads = atoi(argv[i+1]);
+      else if (string(argv[i]) == "-c") // Simulator arguments
+         break;
+      else if (string(argv[i]) == "-h")
+      {
+         printHelpMessage();
+         exit(0);
+      }
+      else
+      {
+         fprintf(stderr, "** ERROR **\n");
+         printHelpMessage();
+         exit(-1);
+      }
+   }
+   LOG_ASSERT_ERROR(_trace_directory != "", "No trace directory (-t <dir>)");
+
+   _num_tiles = Config::getSingleton()->getTotalTiles();
+
+   vector<CacheConfig> configs;
+   readConfigs(configs);
+
+   if (_num_threads <= 0)
+      _num_threads = std::max(sysconf(_SC_NPROCESSORS_ONLN), 1L);
+   _num_threads = std::min<SInt32>(_num_threads, configs.size());
+
+   // Configurations are dealt round-robin to the shards
+   vector<Shard> shards(_num_threads);
+   vector<CacheSweep*> sweeps;
+   for (UInt32 i = 0; i < configs.size(); i++)
+   {
+      sweeps.push_back(new CacheSweep(configs[i], _num_tiles));
+      shards[i % _num_threads]._sweeps.push_back(sweeps.back());
+   }
+
+   vector<pthread_t> threads(_num_threads);
+   for (SInt32 i = 0; i < _num_threads; i++)
+   {
+      __attribute__((unused)) int ret = pthread_create(&threads[i], NULL, replayShard, &shards[i]);
+      LOG_ASSERT_ERROR(ret == 0, "pthread_create() returned(%i)", ret);
+   }
+   for (SInt32 i = 0; i < _num_threads; i++)
+      pthread_join(threads[i], NULL);
+
+   printf("Replayed %llu memory accesses through %u configurations on %i threads\n",
+          (unsigned long long) shards[0]._num_records, (UInt32) configs.size(), _num_threads);
+   printf("%-16s %12s %12s %12s\n", "Configuration", "L1-I miss %", "L1-D miss %", "L2 miss %");
+   const char* components[] = { "L1-I", "L1-D", "L2" };
+   for (UInt32 i = 0; i < sweeps.size(); i++)
+   {
+      printf("%-16s", sweeps[i]->getName().c_str());
+      for (UInt32 j = 0; j < 3; j++)
+      {
+         UInt64 accesses = sweeps[i]->getTotal(components[j], "accesses");
+         UInt64 misses = sweeps[i]->getTotal(components[j], "misses");
+         printf(" %11.2f%%", (accesses > 0) ? (100.0 * misses / accesses) : 0.0);
+      }
+      printf("\n");
+
+      ofstream csv(Config::getSingleton()->formatOutputFileName("cache_replay_" + sweeps[i]->getName() + ".csv").c_str());
+      sweeps[i]->outputCSV(csv);
+      delete sweeps[i];
+   }
+
+   CarbonStopSim();
+
+   return 0;
+}
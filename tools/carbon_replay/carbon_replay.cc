@@ -0,0 +1,275 @@
+// Replays the per-thread traces recorded with [trace] record = true (see
+// common/system/trace_format.h) through the tile, core, memory and network
+// models, without Pin. The replay uses the configuration it is given, so the
+// same traces can be replayed against other memory and network models.
+//
+// Usage: carbon_replay -c <config> --general/mode=lite --trace/directory=<output directory of the recording>
+//   or:  make -C tools/carbon_replay TRACE_DIR=<output directory of the recording>
+//
+// The simulation must have at least as many cores as the recording: threads
+// are replayed on the tiles they ran on. Only the calls into the models are
+// replayed: data values, system calls and user network messages are not.
+
+#include <stdio.h>
+#include <pthread.h>
+#include <map>
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include "carbon_user.h"
+#include "thread_support_private.h"
+#include "simulator.h"
+#include "tile_manager.h"
+#include "core.h"
+#include "core_model.h"
+#include "trace_reader.h"
+#include "lock.h"
+#include "cond.h"
+#include "log.h"
+
+using namespace std;
+
+// Synchronization objects and threads get new ids when replaying
+class IdMap
+{
+public:
+   enum Kind
+   {
+      MUTEX = 0,
+      COND,
+      BARRIER,
+      THREAD
+   };
+
+   void set(Kind kind, SInt32 recorded_id, SInt32 id)
+   {
+      ScopedLock sl(m_lock);
+      m_ids[make_pair(kind, recorded_id)] = id;
+      m_cond.broadcast();
+   }
+
+   // The replayed synchronization orders the creation of an object before
+   // its use in other threads, as it did when recording. Wait for it anyway
+   // in case the application relied on other means (e.g. flags).
+   SInt32 get(Kind kind, SInt32 recorded_id)
+   {
+      ScopedLock sl(m_lock);
+      map<pair<Kind, SInt32>, SInt32>::iterator it;
+      while ((it = m_ids.find(make_pair(kind, recorded_id))) == m_ids.end())
+         m_cond.wait(m_lock);
+      return it->second;
+   }
+
+private:
+   map<pair<Kind, SInt32>, SInt32> m_ids;
+   Lock m_lock;
+   ConditionVariable m_cond;
+};
+
+static string trace_directory;
+static IdMap ids;
+
+// The core models may still refer to the instructions of a trace after its
+// thread is done, so the traces are only closed at the end of the simulation
+static vector<TraceReader*> readers;
+static Lock readers_lock;
+
+static void* replayThread(void* arg);
+
+static void* startThread(void*)
+{
+   // This is what the Pin tool does for the threads of the application in
+   // lite mode
+   ThreadSpawnRequest req;
+   CarbonGetThreadToSpawn(&req);
+   CarbonDequeueThreadSpawnReq(&req);
+   CarbonThreadStart(&req);
+
+   req.func(req.arg);
+
+   CarbonThreadExit();
+   return NULL;
+}
+
+static void spawnThread(thread_id_t recorded_thread_id, tile_id_t tile_id)
+{
+   carbon_thread_t thread_id = CarbonSpawnThreadOnTile(tile_id, replayThread, (void*) (long) recorded_thread_id);
+   LOG_ASSERT_ERROR(thread_id >= 0, "Could not spawn thread(%i) on tile(%i)", recorded_thread_id, tile_id);
+   ids.set(IdMap::THREAD, recorded_thread_id, thread_id);
+
+   pthread_t thread;
+   pthread_attr_t attr;
+   pthread_attr_init(&attr);
+   pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+   __attribute__((unused)) int ret = pthread_create(&thread, &attr, startThread, NULL);
+   LOG_ASSERT_ERROR(ret == 0, "pthread_create() returned(%i)", ret);
+   pthread_attr_destroy(&attr);
+}
+
+static void* replayThread(void* arg)
+{
+   thread_id_t recorded_thread_id = (thread_id_t) (long) arg;
+
+   ostringstream filename;
+   filename << trace_directory << "/trace_" << recorded_thread_id << ".trc";
+   TraceReader* reader = new TraceReader(filename.str());
+   {
+      ScopedLock sl(readers_lock);
+      readers.push_back(reader);
+   }
+
+   // Threads only move to other cores when they synchronize
+   Core* core = Sim()->getTileManager()->getCurrentCore();
+   CoreModel* core_model = core->getModel();
+   vector<Byte> data_buf;
+
+   TraceReader::Record record;
+   while (reader->next(record))
+   {
+      switch (record.type)
+      {
+      case TraceFormat::INSTRUCTION:
+         if (core_model)
+         {
+            core_model->queueInstruction(record.instruction);
+            core_model->iterate();
+         }
+         continue;
+
+      case TraceFormat::BRANCH_TAKEN:
+      case TraceFormat::BRANCH_NOT_TAKEN:
+         if (core_model)
+            core_model->pushDynamicBranchInfo(DynamicBranchInfo(record.type == TraceFormat::BRANCH_TAKEN, record.address));
+         continue;
+
+      case TraceFormat::MEMORY_ACCESS:
+         if (data_buf.size() < record.size)
+            data_buf.resize(record.size);
+         core->initiateMemoryAccess(MemComponent::L1_DCACHE, (Core::lock_signal_t) record.lock_signal,
+                                    (Core::mem_op_t) record.mem_op, record.address,
+                                    data_buf.empty() ? NULL : &data_buf[0], record.size, true);
+         continue;
+
+      case TraceFormat::MUTEX_INIT:
+         {
+            carbon_mutex_t mux;
+            CarbonMutexInit(&mux);
+            ids.set(IdMap::MUTEX, record.arg0, mux);
+         }
+         break;
+
+      case TraceFormat::MUTEX_LOCK:
+         {
+            carbon_mutex_t mux = ids.get(IdMap::MUTEX, record.arg0);
+            CarbonMutexLock(&mux);
+         }
+         break;
+
+      case TraceFormat::MUTEX_UNLOCK:
+         {
+            carbon_mutex_t mux = ids.get(IdMap::MUTEX, record.arg0);
+            CarbonMutexUnlock(&mux);
+         }
+         break;
+
+      case TraceFormat::COND_INIT:
+         {
+            carbon_cond_t cond;
+            CarbonCondInit(&cond);
+            ids.set(IdMap::COND, record.arg0, cond);
+         }
+         break;
+
+      case TraceFormat::COND_WAIT:
+         {
+            carbon_cond_t cond = ids.get(IdMap::COND, record.arg0);
+            carbon_mutex_t mux = ids.get(IdMap::MUTEX, record.arg1);
+            CarbonCondWait(&cond, &mux);
+         }
+         break;
+
+      case TraceFormat::COND_SIGNAL:
+         {
+            carbon_cond_t cond = ids.get(IdMap::COND, record.arg0);
+            CarbonCondSignal(&cond);
+         }
+         break;
+
+      case TraceFormat::COND_BROADCAST:
+         {
+            carbon_cond_t cond = ids.get(IdMap::COND, record.arg0);
+            CarbonCondBroadcast(&cond);
+         }
+         break;
+
+      case TraceFormat::BARRIER_INIT:
+         {
+            carbon_barrier_t barrier;
+            CarbonBarrierInit(&barrier, record.arg1);
+            ids.set(IdMap::BARRIER, record.arg0, barrier);
+         }
+         break;
+
+      case TraceFormat::BARRIER_WAIT:
+         {
+            carbon_barrier_t barrier = ids.get(IdMap::BARRIER, record.arg0);
+            CarbonBarrierWait(&barrier);
+         }
+         break;
+
+      case TraceFormat::THREAD_SPAWN:
+         spawnThread(record.arg0, record.arg1);
+         break;
+
+      case TraceFormat::THREAD_JOIN:
+         CarbonJoinThread(ids.get(IdMap::THREAD, record.arg0));
+         break;
+
+      case TraceFormat::ENABLE_MODELS:
+         CarbonEnableModels();
+         break;
+
+      case TraceFormat::DISABLE_MODELS:
+         CarbonDisableModels();
+         break;
+
+      default:
+         LOG_PRINT_ERROR("Unexpected trace record(%u) in %s", record.type, filename.str().c_str());
+         break;
+      }
+
+      core = Sim()->getTileManager()->getCurrentCore();
+      core_model = core->getModel();
+   }
+
+   return NULL;
+}
+
+int main(int argc, char* argv[])
+{
+   CarbonStartSim(argc, argv);
+
+   LOG_ASSERT_ERROR(Sim()->getConfig()->getSimulationMode() == Config::LITE,
+                    "carbon_replay runs in lite mode (--general/mode=lite)");
+   trace_directory = Sim()->getCfg()->getString("trace/directory");
+   LOG_ASSERT_ERROR(trace_directory != "", "No trace directory (--trace/directory=<dir>)");
+
+   // Like the Pin tool does around main()
+   bool trigger_models = Sim()->getCfg()->getBool("general/trigger_models_within_application", false);
+   if (!trigger_models)
+      Simulator::enablePerformanceModelsInCurrentProcess();
+
+   // The main thread of the application is thread 0
+   replayThread((void*) 0);
+
+   if (!trigger_models)
+      Simulator::disablePerformanceModelsInCurrentProcess();
+
+   CarbonStopSim();
+
+   for (vector<TraceReader*>::iterator it = readers.begin(); it != readers.end(); it++)
+      delete *it;
+
+   return 0;
+}
@@ -0,0 +1,137 @@
+#!/usr/bin/env python
+
+# Decodes the binary log files (log_<tid>.bin) written with [log] mode = binary
+# into the text format of the regular log files. Records of several files are
+# merged by their timestamp.
+#
+# Usage: decode_log.py <output_dir>/log_*.bin > log_all
+
+from __future__ import print_function
+
+import re
+import struct
+import sys
+
+MAGIC = 0x474f4c47
+VERSION = 1
+FORMAT, MODULE, RECORD = 1, 2, 3
+
+# Keep in sync with LogRecord (common/misc/log_buffer.h)
+MAX_ARGS = 12
+STRINGS_SIZE = 96
+RECORD_STRUCT = struct.Struct("<QQiHBBiHH%dQ%ds" % (MAX_ARGS, STRINGS_SIZE))
+
+CONVERSION = re.compile(r"%([-+ #0']*)(\*|\d*)(?:\.(\*|\d*))?(hh|h|ll|l|q|L|j|z|t)?([diouxXcsfFeEgGaApn%])")
+
+def to_signed(value, length):
+   bits = 64 if length in ("l", "ll", "q", "L", "j", "z", "t") else { "hh": 8, "h": 16 }.get(length, 32)
+   value &= (1 << bits) - 1
+   return value - (1 << bits) if value >> (bits - 1) else value
+
+def to_unsigned(value, length):
+   bits = 64 if length in ("l", "ll", "q", "L", "j", "z", "t") else { "hh": 8, "h": 16 }.get(length, 32)
+   return value & ((1 << bits) - 1)
+
+def format_record(fmt, args, strings):
+   args = list(args)
+   out = []
+   pos = 0
+   for match in CONVERSION.finditer(fmt):
+      out.append(fmt[pos:match.start()])
+      pos = match.end()
+      flags, width, precision, length, conv = match.groups()
+      if conv == "%":
+         out.append("%")
+         continue
+
+      needed = 1 + (width == "*") + (precision == "*")
+      if len(args) < needed:
+         out.append("<?>")
+         args = []
+         continue
+      if width == "*":
+         width = str(to_signed(args.pop(0), None))
+      if precision == "*":
+         precision = str(to_signed(args.pop(0), None))
+      value = args.pop(0)
+
+      spec = "%" + flags.replace("'", "") + width + ("." + precision if precision is not None else "")
+      if conv in "di":
+         out.append((spec + "d") % to_signed(value, length))
+      elif conv in "ouxX":
+         out.append((spec + (conv if conv != "u" else "d")) % to_unsigned(value, length))
+      elif conv == "c":
+         out.append((spec + "c") % chr(value & 0xff))
+      elif conv in "fFeEgGaA":
+         double = struct.unpack("<d", struct.pack("<Q", value))[0]
+         out.append((spec + (conv if conv not in "aA" else "e")) % double)
+      elif conv == "s":
+         end = strings.find(b"\0", value)
+         out.append((spec + "s") % strings[value:end].decode("latin-1"))
+      elif conv == "p":
+         out.append("0x%x" % value)
+   out.append(fmt[pos:])
+   return "".join(out)
+
+def read_file(filename):
+   records = []
+   formats = {}
+   modules = {}
+
+   with open(filename, "rb") as f:
+      data = f.read()
+
+   magic, version, record_size, tid = struct.unpack_from("<IIII", data, 0)
+   if magic != MAGIC or version != VERSION or record_size != RECORD_STRUCT.size:
+      sys.stderr.write("%s: not a binary log file (version %d)\n" % (filename, VERSION))
+      return records
+
+   offset = 16
+   while offset + 4 <= len(data):
+      entry_type, = struct.unpack_from("<I", data, offset)
+      offset += 4
+      if entry_type == FORMAT:
+         length, address = struct.unpack_from("<IQ", data, offset)
+         offset += 12
+         formats[address] = data[offset:offset + length].decode("latin-1")
+         offset += length
+      elif entry_type == MODULE:
+         length, module_id = struct.unpack_from("<II", data, offset)
+         offset += 8
+         modules[module_id] = data[offset:offset + length].decode("latin-1")
+         offset += length
+      elif entry_type == RECORD:
+         if offset + RECORD_STRUCT.size > len(data):
+            break
+         fields = RECORD_STRUCT.unpack_from(data, offset)
+         offset += RECORD_STRUCT.size
+         timestamp, address, tile_id, module_id, err, sim_thread, line, num_args, strings_size = fields[:9]
+         args = fields[9:9 + num_args]
+         strings = fields[9 + MAX_ARGS]
+         message = format_record(formats[address], args, strings)
+         tile = "[%2i]" % tile_id if tile_id != -1 else "[  ]"
+         prefix = { 1: "*WARNING* ", 2: "*ERROR* " }.get(err, "")
+         records.append((timestamp, "%-10u [%5d]  %s%s[%s:%4d]  %s%s" %
+                         (timestamp, tid, tile, "* " if sim_thread else "  ",
+                          modules[module_id], line, prefix, message)))
+      else:
+         sys.stderr.write("%s: corrupt entry at offset %d\n" % (filename, offset - 4))
+         break
+
+   return records
+
+def main():
+   if len(sys.argv) < 2:
+      sys.stderr.write("Usage: %s log_<tid>.bin...\n" % sys.argv[0])
+      sys.exit(1)
+
+   records = []
+   for filename in sys.argv[1:]:
+      records.extend(read_file(filename))
+   records.sort(key=lambda record: record[0])
+
+   for timestamp, line in records:
+      print(line)
+
+if __name__ == "__main__":
+   main()
@@ -0,0 +1,413 @@
+// Routes packets through the user and memory network models alone, without
+// cores, caches, the transport or Pin. The packets come either from the
+// packet traces recorded with [network] packet_trace = true (see
+// common/network/packet_trace.h), or from the traffic patterns of
+// tests/benchmarks/synthetic_network. The network models are the ones of the
+// configuration given, so that the same traffic can be swept over the
+// parameters of emesh_hop_by_hop, atac, etc.
+//
+// Usage: network_replay -t <output directory of the recording> -c <config> [--network/memory=atac ...]
+//   or:  network_replay -p <pattern> -l <load> -s <size> -N <packets> -n <user|memory> -c <config> [...]
+//   or:  make -C tools/network_replay TRACE_DIR=<output directory of the recording>
+//
+// The replay is open loop: packets are injected at the times they were sent
+// in the recorded run, whatever latency the replayed models give them.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <queue>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+
+#include "carbon_user.h"
+#include "simulator.h"
+#include "tile_manager.h"
+#include "tile.h"
+#include "network.h"
+#include "network_model.h"
+#include "packet_trace.h"
+#include "config.h"
+#include "random.h"
+#include "utils.h"
+#include "log.h"
+
+using namespace std;
+
+enum NetworkTrafficType
+{
+   UNIFORM_RANDOM = 0,
+   BIT_COMPLEMENT,
+   SHUFFLE,
+   TRANSPOSE,
+   TORNADO,
+   NEAREST_NEIGHBOR,
+   NUM_NETWORK_TRAFFIC_TYPES
+};
+
+class NetworkReplayStats
+{
+public:
+   NetworkReplayStats()
+      : _total_packets_received(0), _total_packet_latency(0), _total_contention_delay(0), _completion_time(0) {}
+
+   UInt64 _total_packets_received;
+   Time _total_packet_latency;
+   Time _total_contention_delay;
+   Time _completion_time;
+};
+
+// The replayed models, indexed by static network and tile
+static vector<NetworkModel*> _models[NUM_STATIC_NETWORKS];
+static NetworkReplayStats _stats[NUM_STATIC_NETWORKS];
+static tile_id_t _num_application_tiles;
+
+static string _trace_directory;
+static NetworkTrafficType _traffic_pattern_type = UNIFORM_RANDOM;
+static double _offered_load = 0.1;
+static SInt32 _packet_size = 8;
+static UInt64 _total_packets = 10000;
+static EStaticNetwork _static_network = STATIC_NETWORK_USER;
+
+static void printHelpMessage()
+{
+   fprintf(stderr, "[Usage]: ./network_replay -t <arg0> | -p <arg1> -l <arg2> -s <arg3> -N <arg4> -n <arg5>\n");
+   fprintf(stderr, "where <arg0> = Output directory of a simulation run with [network] packet_trace = true\n");
+   fprintf(stderr, " or   <arg1> = Network Traffic Pattern Type (uniform_random, bit_complement, shuffle, transpose, tornado, nearest_neighbor) (default uniform_random)\n");
+   fprintf(stderr, " and  <arg2> = Number of Packets injected into the Network per Core per Cycle (default 0.1)\n");
+   fprintf(stderr, " and  <arg3> = Size of each Packet in Bytes (default 8)\n");
+   fprintf(stderr, " and  <arg4> = Total Number of Packets injected into the Network per Core (default 10000)\n");
+   fprintf(stderr, " and  <arg5> = Network to inject the packets into (user, memory) (default user)\n");
+}
+
+static NetworkTrafficType parseTrafficPattern(string traffic_pattern)
+{
+   if (traffic_pattern == "uniform_random")
+      return UNIFORM_RANDOM;
+   else if (traffic_pattern == "bit_complement")
+      return BIT_COMPLEMENT;
+   else if (traffic_pattern == "shuffle")
+      return SHUFFLE;
+   else if (traffic_pattern == "transpose")
+      return TRANSPOSE;
+   else if (traffic_pattern == "tornado")
+      return TORNADO;
+   else if (traffic_pattern == "nearest_neighbor")
+      return NEAREST_NEIGHBOR;
+   else
+   {
+      fprintf(stderr, "** ERROR **\n");
+      fprintf(stderr, "Unrecognized Network Traffic Pattern Type (Use uniform_random, bit_complement, shuffle, transpose, tornado, nearest_neighbor)\n");
+      exit(-1);
+   }
+}
+
+static EStaticNetwork parseStaticNetwork(string network)
+{
+   if (network == "user")
+      return STATIC_NETWORK_USER;
+   else if (network == "memory")
+      return STATIC_NETWORK_MEMORY;
+   else
+   {
+      fprintf(stderr, "** ERROR **\n");
+      fprintf(stderr, "Unrecognized Network (Use user, memory)\n");
+      exit(-1);
+   }
+}
+
+// -- Routing -- //
+
+static NetworkModel* getModel(tile_id_t tile_id, UInt32 static_network)
+{
+   LOG_ASSERT_ERROR(0 <= tile_id && tile_id < (tile_id_t) _models[static_network].size(),
+                    "Invalid tile(%i)", tile_id);
+   return _models[static_network][tile_id];
+}
+
+static void receivePacket(NetPacket& pkt, NetworkModel* model, UInt32 static_network, tile_id_t tile_id)
+{
+   model->__processReceivedPacket(pkt);
+
+   // Same packets as counted by the model
+   tile_id_t sender = TILE_ID(pkt.sender);
+   if ( (sender >= _num_application_tiles) || (tile_id >= _num_application_tiles) || (sender == tile_id) )
+      return;
+
+   NetworkReplayStats& stats = _stats[static_network];
+   stats._total_packets_received ++;
+   stats._total_packet_latency += pkt.zero_load_delay + pkt.contention_delay;
+   stats._total_contention_delay += pkt.contention_delay;
+   if (pkt.time > stats._completion_time)
+      stats._completion_time = pkt.time;
+}
+
+// Network::forwardBuffer() with the shared memory shortcut: every hop is
+// routed by the model of the next tile until the packet is received
+static void routePacket(const NetPacket& packet, UInt32 static_network)
+{
+   queue<NetworkModel::Hop> hop_queue;
+   getModel(TILE_ID(packet.sender), static_network)->__routePacket(packet, hop_queue);
+
+   while (!hop_queue.empty())
+   {
+      NetworkModel::Hop hop = hop_queue.front();
+      hop_queue.pop();
+
+      NetPacket pkt(packet);
+      pkt.node_type = hop._next_node_type;
+      pkt.time = hop._time;
+      pkt.zero_load_delay = hop._zero_load_delay;
+      pkt.contention_delay = hop._contention_delay;
+
+      NetworkModel* model = getModel(hop._next_tile_id, static_network);
+      if (model->isPacketReadyToBeReceived(pkt))
+         receivePacket(pkt, model, static_network, hop._next_tile_id);
+      else
+         model->__routePacket(pkt, hop_queue);
+   }
+}
+
+// Network::netSend()
+static void sendPacket(NetPacket& packet, UInt32 static_network)
+{
+   NetworkModel* model = getModel(TILE_ID(packet.sender), static_network);
+
+   if ( (TILE_ID(packet.receiver) == NetPacket::BROADCAST) && (!model->hasBroadcastCapability()) )
+   {
+      for (tile_id_t i = 0; i < (tile_id_t) _models[static_network].size(); i++)
+      {
+         packet.receiver = CORE_ID(i);
+         routePacket(packet, static_network);
+      }
+   }
+   else
+   {
+      routePacket(packet, static_network);
+   }
+}
+
+// -- Packet traces -- //
+
+static bool isEarlier(const PacketTrace::Record& lhs, const PacketTrace::Record& rhs)
+{
+   return lhs.time < rhs.time;
+}
+
+static void replayPacketTraces()
+{
+   // The packets of a tile are sent by several threads, so the traces are
+   // not sorted by time
+   vector<PacketTrace::Record> records;
+   SInt32 num_traces = 0;
+   for (tile_id_t i = 0; i < (tile_id_t) Config::getSingleton()->getTotalTiles(); i++)
+   {
+      ostringstream filename;
+      filename << _trace_directory << "/packet_trace_" << i << ".trc";
+      if (PacketTrace::read(filename.str(), records))
+         num_traces ++;
+   }
+   LOG_ASSERT_ERROR(num_traces > 0, "No packet traces in %s", _trace_directory.c_str());
+   stable_sort(records.begin(), records.end(), isEarlier);
+
+   for (vector<PacketTrace::Record>::iterator it = records.begin(); it != records.end(); it++)
+   {
+      LOG_ASSERT_ERROR(it->static_network < NUM_STATIC_NETWORKS && it->type < NUM_PACKET_TYPES,
+                       "Corrupt packet trace: network(%u), type(%u)", it->static_network, it->type);
+      NetPacket packet(Time(it->time), (PacketType) it->type, it->sender, it->receiver, it->length, &it->modeled_length);
+      sendPacket(packet, it->static_network);
+   }
+
+   printf("Replayed %lu packets from %i packet traces\n", (unsigned long) records.size(), num_traces);
+}
+
+// -- Synthetic traffic (as in tests/benchmarks/synthetic_network) -- //
+
+static void computeEMeshTopologyParams(int num_tiles, int& mesh_width, int& mesh_height)
+{
+   mesh_width = (int) sqrt(1.0 * num_tiles);
+   mesh_height = (int) ceil(1.0 * num_tiles / mesh_width);
+   LOG_ASSERT_ERROR(num_tiles == (mesh_width * mesh_height), "Tile count(%i) is not a mesh", num_tiles);
+}
+
+static tile_id_t computeDestination(tile_id_t tile_id, Random<double>& rand_num)
+{
+   int mesh_width, mesh_height;
+   int sx, sy;
+
+   switch (_traffic_pattern_type)
+   {
+   case UNIFORM_RANDOM:
+      {
+         tile_id_t dst_tile = (tile_id_t) rand_num.next(_num_application_tiles - 1);
+         return (dst_tile >= tile_id) ? (dst_tile + 1) : dst_tile;
+      }
+
+   case BIT_COMPLEMENT:
+      LOG_ASSERT_ERROR(isPower2(_num_application_tiles), "bit_complement needs a power of 2 tiles");
+      return (~tile_id) & (_num_application_tiles - 1);
+
+   case SHUFFLE:
+      {
+         LOG_ASSERT_ERROR(isPower2(_num_application_tiles), "shuffle needs a power of 2 tiles");
+         int nbits = floorLog2(_num_application_tiles);
+         return ((tile_id >> (nbits-1)) & 1) | ((tile_id << 1) & (_num_application_tiles - 1));
+      }
+
+   case TRANSPOSE:
+      computeEMeshTopologyParams(_num_application_tiles, mesh_width, mesh_height);
+      sx = tile_id % mesh_width;
+      sy = tile_id / mesh_width;
+      return (sx * mesh_width) + sy;
+
+   case TORNADO:
+      computeEMeshTopologyParams(_num_application_tiles, mesh_width, mesh_height);
+      sx = tile_id % mesh_width;
+      sy = tile_id / mesh_width;
+      return (((sy + mesh_height/2) % mesh_height) * mesh_width) + ((sx + mesh_width/2) % mesh_width);
+
+   case NEAREST_NEIGHBOR:
+      computeEMeshTopologyParams(_num_application_tiles, mesh_width, mesh_height);
+      sx = tile_id % mesh_width;
+      sy = tile_id / mesh_width;
+      return (((sy+1) % mesh_height) * mesh_width) + ((sx+1) % mesh_width);
+
+   default:
+      LOG_PRINT_ERROR("Unrecognized traffic pattern (%u)", _traffic_pattern_type);
+      return INVALID_TILE_ID;
+   }
+}
+
+static void injectSyntheticTraffic()
+{
+   PacketType packet_type = (_static_network == STATIC_NETWORK_MEMORY) ? SHARED_MEM : USER;
+   double frequency = getModel(0, _static_network)->getFrequency();
+   Random<double> rand_num;
+   rand_num.seed(0);
+
+   // Every tile injects a packet with probability _offered_load every cycle
+   UInt64 total_packets = _total_packets * _num_application_tiles;
+   UInt64 total_packets_sent = 0;
+   for (UInt64 cycle = 0; total_packets_sent < total_packets; cycle++)
+   {
+      for (tile_id_t i = 0; i < _num_application_tiles; i++)
+      {
+         if (rand_num.next(1) >= _offered_load)
+            continue;
+
+         tile_id_t receiver = computeDestination(i, rand_num);
+         NetPacket packet(Time(Latency(cycle, frequency)), packet_type, i, receiver, _packet_size, NULL);
+         UInt32 modeled_length = packet.bufferSize() * 8;
+         packet.data = &modeled_length;
+         sendPacket(packet, _static_network);
+         total_packets_sent ++;
+      }
+   }
+
+   printf("Injected %llu packets\n", (unsigned long long) total_packets_sent);
+}
+
+// -- Summary -- //
+
+static void outputSummary()
+{
+   ofstream out(Config::getSingleton()->formatOutputFileName("network_replay.out").c_str());
+
+   for (UInt32 network_id = STATIC_NETWORK_USER; network_id <= STATIC_NETWORK_MEMORY; network_id++)
+   {
+      const NetworkReplayStats& stats = _stats[network_id];
+      string name = g_static_network_name_list[network_id];
+
+      printf("Network (%s): %s\n", name.c_str(), Config::getSingleton()->getNetworkType(network_id).c_str());
+      printf("  Total Packets Received: %llu\n", (unsigned long long) stats._total_packets_received);
+      if (stats._total_packets_received > 0)
+      {
+         printf("  Average Packet Latency (in nanoseconds): %g\n",
+                ((double) stats._total_packet_latency.toNanosec()) / stats._total_packets_received);
+         printf("  Average Contention Delay (in nanoseconds): %g\n",
+                ((double) stats._total_contention_delay.toNanosec()) / stats._total_packets_received);
+      }
+      printf("  Completion Time (in nanoseconds): %llu\n", (unsigned long long) stats._completion_time.toNanosec());
+
+      for (tile_id_t i = 0; i < _num_application_tiles; i++)
+      {
+         out << "Tile " << i << " Network (" << name << "):" << endl;
+         _models[network_id][i]->outputSummary(out, stats._completion_time);
+      }
+   }
+}
+
+int main(int argc, char* argv[])
+{
+   CarbonStartSim(argc, argv);
+
+   // Read Command Line Arguments
+   for (SInt32 i = 1; i < argc-1; i += 2)
+   {
+      if (string(argv[i]) == "-t")
+         _trace_directory = argv[i+1];
+      else if (string(argv[i]) == "-p")
+         _traffic_pattern_type = parseTrafficPattern(string(argv[i+1]));
+      else if (string(argv[i]) == "-l")
+         _offered_load = (double) atof(argv[i+1]);
+      else if (string(argv[i]) == "-s")
+         _packet_size = (SInt32) atoi(argv[i+1]);
+      else if (string(argv[i]) == "-N")
+         _total_packets = (UInt64) atoi(argv[i+1]);
+      else if (string(argv[i]) == "-n")
+         _static_network = parseStaticNetwork(string(argv[i+1]));
+      else if (string(argv[i]) == "-c") // Simulator arguments
+         break;
+      else if (string(argv[i]) == "-h")
+      {
+         printHelpMessage();
+         exit(0);
+      }
+      else
+      {
+         fprintf(stderr, "** ERROR **\n");
+         printHelpMessage();
+         exit(-1);
+      }
+   }
+
+   LOG_ASSERT_ERROR(Config::getSingleton()->getProcessCount() == 1,
+                    "network_replay runs in a single process (%i)", Config::getSingleton()->getProcessCount());
+   _num_application_tiles = (tile_id_t) Config::getSingleton()->getApplicationTiles();
+
+   // Models of their own, so that the packets of the simulator itself do not
+   // reach them. The networks of the tiles only give them their tile id.
+   for (UInt32 network_id = STATIC_NETWORK_USER; network_id <= STATIC_NETWORK_MEMORY; network_id++)
+   {
+      UInt32 network_type = NetworkModel::parseNetworkType(Config::getSingleton()->getNetworkType(network_id));
+      for (tile_id_t i = 0; i < (tile_id_t) Config::getSingleton()->getTotalTiles(); i++)
+      {
+         Tile* tile = Sim()->getTileManager()->getTileFromID(i);
+         LOG_ASSERT_ERROR(tile, "Could not find tile(%i)", i);
+         NetworkModel* model = NetworkModel::createModel(tile->getNetwork(), network_id, network_type);
+         model->enableReplay();
+         model->enable();
+         _models[network_id].push_back(model);
+      }
+   }
+
+   if (_trace_directory != "")
+      replayPacketTraces();
+   else
+      injectSyntheticTraffic();
+
+   outputSummary();
+
+   for (UInt32 network_id = STATIC_NETWORK_USER; network_id <= STATIC_NETWORK_MEMORY; network_id++)
+   {
+      for (vector<NetworkModel*>::iterator it = _models[network_id].begin(); it != _models[network_id].end(); it++)
+         delete *it;
+   }
+
+   CarbonStopSim();
+
+   return 0;
+}
@@ -0,0 +1,116 @@
+#!/usr/bin/env python
+
+# Reads the counter samples (counter_samples.bin) written with
+# [statistics_trace] statistics = "counters" and prints them as CSV: one row
+# per sample, one column per counter (tile/component/counter).
+#
+# Usage: read_counter_samples.py [--delta] [--component <name>]... [--tile <id>]... <output_dir>/counter_samples.bin
+#   --delta       print the change of each counter over each sampling interval
+#   --component   only print the counters of these components
+#   --tile        only print the counters of these tiles
+#
+# As a module, read_samples(filename) returns (columns, times, values) with
+# 'values' holding one list of samples per column.
+
+from __future__ import print_function
+
+import struct
+import sys
+
+MAGIC = 0x544e4347
+VERSION = 1
+UINT64, DOUBLE, TIME = 0, 1, 2
+
+def decode_column(data, offset, count):
+   values = []
+   value = 0
+   for i in range(count):
+      zigzag = 0
+      shift = 0
+      while True:
+         byte = data[offset]
+         if not isinstance(byte, int):
+            byte = ord(byte)
+         offset += 1
+         zigzag |= (byte & 0x7f) << shift
+         shift += 7
+         if not byte & 0x80:
+            break
+      delta = (zigzag >> 1) ^ -(zigzag & 1)
+      value = (value + delta) & 0xffffffffffffffff
+      values.append(value)
+   return values, offset
+
+def read_samples(filename):
+   with open(filename, "rb") as f:
+      data = f.read()
+
+   magic, version, num_columns = struct.unpack_from("<III", data, 0)
+   if magic != MAGIC or version != VERSION:
+      raise ValueError("%s: not a counter samples file (version %d)" % (filename, VERSION))
+   offset = 12
+
+   columns = []
+   for i in range(num_columns):
+      tile_id, counter_type, length = struct.unpack_from("<iII", data, offset)
+      offset += 12
+      component = data[offset:offset + length].decode("latin-1")
+      offset += length
+      length, = struct.unpack_from("<I", data, offset)
+      offset += 4
+      name = data[offset:offset + length].decode("latin-1")
+      offset += length
+      columns.append((tile_id, counter_type, component, name))
+
+   times = []
+   values = [[] for column in columns]
+   while offset + 4 <= len(data):
+      num_samples, = struct.unpack_from("<I", data, offset)
+      offset += 4
+      block_times, offset = decode_column(data, offset, num_samples)
+      times.extend(block_times)
+      for c in range(num_columns):
+         block_values, offset = decode_column(data, offset, num_samples)
+         if columns[c][1] == DOUBLE:
+            block_values = [struct.unpack("<d", struct.pack("<Q", v))[0] for v in block_values]
+         values[c].extend(block_values)
+
+   return columns, times, values
+
+def main():
+   args = sys.argv[1:]
+   delta = False
+   components = []
+   tiles = []
+   while len(args) > 1:
+      if args[0] == "--delta":
+         delta = True
+         args = args[1:]
+      elif args[0] == "--component":
+         components.append(args[1])
+         args = args[2:]
+      elif args[0] == "--tile":
+         tiles.append(int(args[1]))
+         args = args[2:]
+      else:
+         break
+   if len(args) != 1:
+      sys.stderr.write("Usage: %s [--delta] [--component <name>]... [--tile <id>]... counter_samples.bin\n" % sys.argv[0])
+      sys.exit(1)
+
+   columns, times, values = read_samples(args[0])
+   selected = [c for c in range(len(columns))
+               if (not components or columns[c][2] in components) and (not tiles or columns[c][0] in tiles)]
+
+   print(",".join(["time_ns"] + ["%d/%s/%s" % (columns[c][0], columns[c][2], columns[c][3]) for c in selected]))
+   for s in range(len(times)):
+      row = [times[s]]
+      for c in selected:
+         value = values[c][s]
+         if delta:
+            value = value - (values[c][s-1] if s > 0 else 0)
+         row.append(value)
+      print(",".join(str(v) for v in row))
+
+if __name__ == "__main__":
+   main()